@@ -0,0 +1,262 @@
+//-----------------------------------------------------------------------------
+// BenchUtil.h
+//
+// Helpers shared by the benchmark programs: synthetic map generation,
+// timing and memory statistics.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef USE_MINIZ
+#define MINIZ_HEADER_FILE_ONLY
+#include "miniz.c"
+#else
+#include <zlib.h>
+#endif
+
+#ifdef TMX_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "base64/base64.h"
+
+namespace Bench
+{
+    /// Generate the raw gids of a layer; roughly a quarter of the cells are empty.
+    inline std::vector<uint32_t> MakeGids(int width, int height, uint32_t seed)
+    {
+        std::vector<uint32_t> gids(static_cast<size_t>(width) * height);
+        for (auto &gid : gids)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            const auto r = seed >> 16;
+            gid = (r & 3) == 0 ? 0 : 1 + r % 96;
+        }
+        return gids;
+    }
+
+    /// Compress the bytes of gids as "zlib", "gzip" or, if the benchmarks are
+    /// built with it, "zstd" data.
+    inline std::vector<unsigned char> Compress(const std::vector<uint32_t> &gids,
+        const std::string &compression)
+    {
+        const auto size = gids.size() * sizeof(uint32_t);
+#ifdef TMX_HAVE_ZSTD
+        if (compression == "zstd")
+        {
+            std::vector<unsigned char> packed(ZSTD_compressBound(size));
+            packed.resize(ZSTD_compress(packed.data(), packed.size(), gids.data(), size,
+                ZSTD_CLEVEL_DEFAULT));
+            return packed;
+        }
+#endif
+        std::vector<unsigned char> packed(compressBound(size) + 32);
+
+        z_stream strm{};
+        const int windowBits = compression == "gzip" ? 15 + 16 : 15;
+        deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8,
+            Z_DEFAULT_STRATEGY);
+        strm.next_in = reinterpret_cast<unsigned char *>(const_cast<uint32_t *>(gids.data()));
+        strm.avail_in = static_cast<unsigned>(size);
+        strm.next_out = packed.data();
+        strm.avail_out = static_cast<unsigned>(packed.size());
+        deflate(&strm, Z_FINISH);
+        packed.resize(strm.total_out);
+        deflateEnd(&strm);
+
+        return packed;
+    }
+
+    /// Encode gids the way Tiled writes the <data> element contents.
+    inline std::string EncodeGids(const std::vector<uint32_t> &gids,
+        const std::string &encoding, const std::string &compression)
+    {
+        if (encoding == "csv")
+        {
+            std::string out;
+            out.reserve(gids.size() * 3);
+            for (size_t i = 0; i < gids.size(); ++i)
+            {
+                out += std::to_string(gids[i]);
+                if (i + 1 != gids.size())
+                {
+                    out += ',';
+                }
+            }
+            return out;
+        }
+
+        const auto bytes = reinterpret_cast<const unsigned char *>(gids.data());
+        const auto size = gids.size() * sizeof(uint32_t);
+
+        if (!compression.empty())
+        {
+            const auto packed = Compress(gids, compression);
+            return base64_encode(packed.data(), static_cast<unsigned>(packed.size()));
+        }
+
+        return base64_encode(bytes, size);
+    }
+
+    /// Build a complete TMX document with the given number of tile layers.
+    inline std::string MakeMap(int width, int height, int numLayers,
+        const std::string &encoding = "base64", const std::string &compression = "zlib")
+    {
+        std::ostringstream ss;
+        ss << R"(<?xml version="1.0" encoding="UTF-8"?>)" << "\n";
+        ss << R"(<map version="1.10" orientation="orthogonal" renderorder="right-down" )"
+           << "width=\"" << width << "\" height=\"" << height << "\" "
+           << R"(tilewidth="32" tileheight="32" infinite="0" nextobjectid="1">)" << "\n";
+        ss << R"( <tileset firstgid="1" name="a" tilewidth="32" tileheight="32" )"
+           << R"(tilecount="48" columns="8"/>)" << "\n";
+        ss << R"( <tileset firstgid="49" name="b" tilewidth="32" tileheight="32" )"
+           << R"(tilecount="48" columns="8"/>)" << "\n";
+
+        for (int i = 0; i < numLayers; ++i)
+        {
+            ss << " <layer id=\"" << i + 1 << "\" name=\"layer" << i << "\" "
+               << "width=\"" << width << "\" height=\"" << height << "\">\n";
+            ss << "  <data encoding=\"" << encoding << "\"";
+            if (encoding == "base64" && !compression.empty())
+            {
+                ss << " compression=\"" << compression << "\"";
+            }
+            ss << ">\n   " << EncodeGids(MakeGids(width, height, i + 1), encoding, compression)
+               << "\n  </data>\n </layer>\n";
+        }
+
+        ss << "</map>\n";
+        return ss.str();
+    }
+
+    /// Build the Tiled JSON equivalent of MakeMap. "csv" layers are written
+    /// as arrays of gids.
+    inline std::string MakeJsonMap(int width, int height, int numLayers,
+        const std::string &encoding = "base64", const std::string &compression = "zlib")
+    {
+        std::ostringstream ss;
+        ss << "{\"compressionlevel\":-1,\"height\":" << height << ",\"infinite\":false,\n";
+        ss << " \"layers\":[\n";
+
+        for (int i = 0; i < numLayers; ++i)
+        {
+            const auto gids = MakeGids(width, height, i + 1);
+
+            ss << (i ? ",\n" : "") << "  {\"data\":";
+            if (encoding == "csv")
+            {
+                ss << '[' << EncodeGids(gids, "csv", "") << ']';
+            }
+            else
+            {
+                ss << '"' << EncodeGids(gids, encoding, compression) << "\", \"encoding\":\"base64\"";
+                if (!compression.empty())
+                {
+                    ss << ", \"compression\":\"" << compression << '"';
+                }
+            }
+            ss << ", \"height\":" << height << ", \"id\":" << i + 1
+               << ", \"name\":\"layer" << i << "\", \"opacity\":1, \"type\":\"tilelayer\""
+               << ", \"visible\":true, \"width\":" << width << ", \"x\":0, \"y\":0}";
+        }
+
+        ss << "\n ],\n \"nextlayerid\":" << numLayers + 1 << ", \"nextobjectid\":1,";
+        ss << " \"orientation\":\"orthogonal\", \"renderorder\":\"right-down\",\n";
+        ss << " \"tileheight\":32, \"tilesets\":[\n";
+        ss << "  {\"columns\":8, \"firstgid\":1, \"name\":\"a\", \"tilecount\":48,"
+           << " \"tileheight\":32, \"tilewidth\":32},\n";
+        ss << "  {\"columns\":8, \"firstgid\":49, \"name\":\"b\", \"tilecount\":48,"
+           << " \"tileheight\":32, \"tilewidth\":32}],\n";
+        ss << " \"tilewidth\":32, \"type\":\"map\", \"version\":\"1.10\", \"width\":"
+           << width << "}\n";
+        return ss.str();
+    }
+
+    /// Build a TMX document with numObjects objects spread over object groups
+    /// of a thousand. Like in real maps the objects share a handful of types
+    /// and property names; every fourth one is a polygon.
+    inline std::string MakeObjectMap(int numObjects)
+    {
+        static const char *types[] = { "enemy", "pickup", "spawn", "trigger", "door" };
+
+        std::ostringstream ss;
+        ss << R"(<?xml version="1.0" encoding="UTF-8"?>)" << "\n";
+        ss << R"(<map version="1.10" orientation="orthogonal" renderorder="right-down" )"
+           << R"(width="256" height="256" tilewidth="32" tileheight="32" infinite="0" )"
+           << "nextobjectid=\"" << numObjects + 1 << "\">\n";
+
+        for (int i = 0; i < numObjects; ++i)
+        {
+            if (i % 1000 == 0)
+            {
+                ss << (i ? " </objectgroup>\n" : "") << " <objectgroup id=\"" << i / 1000 + 1
+                   << "\" name=\"objects" << i / 1000 << "\">\n";
+            }
+
+            ss << "  <object id=\"" << i + 1 << "\" name=\"object" << i % 50 << "\" type=\""
+               << types[i % 5] << "\" x=\"" << i % 8192 << "\" y=\"" << i / 8192 * 32
+               << "\" width=\"32\" height=\"32\">\n";
+            ss << "   <properties>\n"
+               << "    <property name=\"health\" type=\"int\" value=\"" << i % 100 << "\"/>\n"
+               << "    <property name=\"faction\" value=\"" << types[i % 3] << "\"/>\n"
+               << "    <property name=\"respawn\" type=\"bool\" value=\"true\"/>\n"
+               << "   </properties>\n";
+            if (i % 4 == 0)
+            {
+                ss << "   <polygon points=\"0,0 32,0 32,32 16,48 0,32\"/>\n";
+            }
+            ss << "  </object>\n";
+        }
+
+        ss << (numObjects ? " </objectgroup>\n" : "") << "</map>\n";
+        return ss.str();
+    }
+
+    inline void WriteFile(const std::string &fileName, const std::string &text)
+    {
+        std::ofstream{ fileName, std::ios::binary } << text;
+    }
+
+    /// Run fn the given number of times and return the best wall time in milliseconds.
+    template <typename T>
+    double BestOf(int runs, T &&fn)
+    {
+        double best = 1e300;
+        for (int i = 0; i < runs; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            const std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - start;
+            best = elapsed.count() < best ? elapsed.count() : best;
+        }
+        return best;
+    }
+
+    /// Peak resident set size of this process, in kilobytes (0 if unsupported).
+    inline long PeakRssKb()
+    {
+#ifdef _WIN32
+        return 0;
+#else
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024;
+#else
+        return usage.ru_maxrss;
+#endif
+#endif
+    }
+}
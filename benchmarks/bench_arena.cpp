@@ -0,0 +1,141 @@
+//-----------------------------------------------------------------------------
+// bench_arena.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <optional>
+#include <string>
+
+#include "Tmx.h"
+
+#include "BenchUtil.h"
+
+namespace
+{
+    std::size_t heapAllocations = 0;
+}
+
+void *operator new(std::size_t size)
+{
+    ++heapAllocations;
+    if (void *p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++heapAllocations;
+    const auto align = static_cast<std::size_t>(alignment);
+    if (void *p = std::aligned_alloc(align, (size + align - 1) / align * align))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    double Milliseconds(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>{ duration }.count();
+    }
+
+    void Run(const std::string &fileName, const char *mode, bool arena)
+    {
+        Tmx::ParseOptions options;
+        options.arena = arena;
+        Tmx::MapLoader loader{ options };
+
+        double parse = 1e300;
+        double release = 1e300;
+        int objects = 0;
+        std::size_t allocations = 0;
+        for (int run = 0; run < 5; ++run)
+        {
+            std::optional<Tmx::Map> map;
+
+            const std::size_t allocated = heapAllocations;
+            const auto start = std::chrono::steady_clock::now();
+            map.emplace(loader.ParseFile(fileName));
+            const auto parsed = std::chrono::steady_clock::now();
+            allocations = heapAllocations - allocated;
+            objects = 0;
+            for (const auto &group : map->GetObjectGroups())
+            {
+                objects += group.GetNumObjects();
+            }
+
+            const auto releasing = std::chrono::steady_clock::now();
+            map.reset();
+            const auto released = std::chrono::steady_clock::now();
+
+            parse = std::min(parse, Milliseconds(parsed - start));
+            release = std::min(release, Milliseconds(released - releasing));
+        }
+
+        std::printf("%-6s parse %9.2f ms   free %8.2f ms   %9zu heap allocations   (%d objects)\n",
+            mode, parse, release, allocations, objects);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string fileName = argc > 1 ? argv[1] : "";
+    if (fileName.empty())
+    {
+        fileName = "bench_arena.tmx";
+        Bench::WriteFile(fileName, Bench::MakeObjectMap(200000));
+    }
+
+    Run(fileName, "heap", false);
+    Run(fileName, "arena", true);
+    return 0;
+}
@@ -0,0 +1,112 @@
+//-----------------------------------------------------------------------------
+// bench_base64.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Tmx.h"
+
+#include "BenchUtil.h"
+
+// Decodes the base-64 text of one uncompressed layer with the reference
+// decoder the parser used to call and with the vectorized decoder at every
+// instruction set the CPU supports.
+
+namespace
+{
+    using Tmx::Util::SimdLevel;
+
+    // Decode returns the decoded bytes as a string_view, into a buffer that
+    // is kept between runs so that only the first run pays the page faults.
+    template <typename Decode>
+    bool Run(const char *name, const std::string &text, const std::vector<uint32_t> &gids,
+        Decode decode)
+    {
+        std::string_view decoded;
+        double best = 1e300;
+        for (int run = 0; run < 5; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            decoded = decode(text);
+            best = std::min(best, std::chrono::duration<double, std::milli>{
+                std::chrono::steady_clock::now() - start }.count());
+        }
+
+        const bool same = decoded.size() == gids.size() * sizeof(uint32_t)
+            && std::memcmp(decoded.data(), gids.data(), decoded.size()) == 0;
+        std::printf("%-10s %9.2f ms %9.1f MB/s%s\n", name, best,
+            text.size() / (best * 1000.0), same ? "" : "   MISMATCH");
+        return same;
+    }
+
+    auto Reference()
+    {
+        return [decoded = std::string{}](const std::string &text) mutable {
+            decoded = base64_decode(text);
+            return std::string_view{ decoded };
+        };
+    }
+
+    auto Vectorized(SimdLevel level)
+    {
+        return [level, decoded = std::string{}](const std::string &text) mutable {
+            decoded.resize(Tmx::Util::Base64DecodedSize(text.size()));
+            const auto size = Tmx::Util::DecodeBase64(text, decoded.data(), level);
+            return std::string_view{ decoded.data(), size };
+        };
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int width = argc > 1 ? std::atoi(argv[1]) : 4096;
+    const int height = argc > 2 ? std::atoi(argv[2]) : width;
+
+    const auto gids = Bench::MakeGids(width, height, 1);
+    const auto text = Bench::EncodeGids(gids, "base64", "");
+    std::printf("%dx%d layer, %.1f MB of base-64\n", width, height,
+        text.size() / (1024.0 * 1024.0));
+
+    bool ok = Run("reference", text, gids, Reference());
+    ok &= Run("scalar", text, gids, Vectorized(SimdLevel::Scalar));
+
+    const auto level = Tmx::Util::GetSimdLevel();
+    if (level >= SimdLevel::SSE41)
+    {
+        ok &= Run("sse4.1", text, gids, Vectorized(SimdLevel::SSE41));
+    }
+    if (level >= SimdLevel::AVX2)
+    {
+        ok &= Run("avx2", text, gids, Vectorized(SimdLevel::AVX2));
+    }
+
+    return ok ? 0 : 1;
+}
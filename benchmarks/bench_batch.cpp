@@ -0,0 +1,69 @@
+//-----------------------------------------------------------------------------
+// bench_batch.cpp
+//
+// Parses a set of map files one after the other with MapLoader::ParseFile and
+// all at once with MapLoader::ParseFiles, and reports the speed-up.
+//
+// Usage: bench_batch [files] [width] [height]
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Tmx.h"
+#include "BenchUtil.h"
+
+int main(int argc, char *argv[])
+{
+    const int files = argc > 1 ? std::atoi(argv[1]) : 64;
+    const int width = argc > 2 ? std::atoi(argv[2]) : 256;
+    const int height = argc > 3 ? std::atoi(argv[3]) : 256;
+
+    const auto directory = std::filesystem::temp_directory_path() / "tmx_bench_batch";
+    std::filesystem::create_directories(directory);
+
+    std::vector<std::string> fileNames;
+    for (int i = 0; i < files; ++i)
+    {
+        // Alternate the sizes a little so that the work is uneven.
+        const auto text = Bench::MakeMap(width, height * (1 + i % 3), 4, "base64", "zlib");
+        fileNames.push_back((directory / ("map" + std::to_string(i) + ".tmx")).string());
+        Bench::WriteFile(fileNames.back(), text);
+    }
+
+    std::printf("%d files of %dx%d..%d, 4 layers, %u hardware threads\n",
+        files, width, height, height * 3, std::thread::hardware_concurrency());
+
+    const auto check = [](const Tmx::Map &map) {
+        if (map.HasError())
+        {
+            std::fprintf(stderr, "%s\n", map.GetErrorText().c_str());
+            std::exit(1);
+        }
+    };
+
+    Tmx::MapLoader loader;
+
+    const auto sequential = Bench::BestOf(3, [&] {
+        for (const auto &fileName : fileNames)
+        {
+            check(loader.ParseFile(fileName));
+        }
+    });
+
+    const auto batch = Bench::BestOf(3, [&] {
+        for (const auto &map : loader.ParseFiles(fileNames))
+        {
+            check(map);
+        }
+    });
+
+    std::printf("ParseFile  %10.2f ms\n", sequential);
+    std::printf("ParseFiles %10.2f ms  %5.2fx\n", batch, sequential / batch);
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
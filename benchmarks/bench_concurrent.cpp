@@ -0,0 +1,225 @@
+//-----------------------------------------------------------------------------
+// bench_concurrent.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Tmx.h"
+
+#include "BenchUtil.h"
+
+// Parses the same files on more and more threads at once, checking every map
+// against a parse made alone. Build with SANITIZE_THREAD to have the races,
+// if any, reported by ThreadSanitizer.
+
+namespace
+{
+    const char *tilesetText = R"(<?xml version="1.0" encoding="UTF-8"?>
+<tileset version="1.10" name="shared" tilewidth="32" tileheight="32" tilecount="4" columns="2">
+ <tile id="1">
+  <properties>
+   <property name="solid" type="bool" value="true"/>
+  </properties>
+  <objectgroup draworder="index">
+   <object id="1" x="0" y="0" width="32" height="16"/>
+  </objectgroup>
+ </tile>
+</tileset>
+)";
+
+    const char *templateText = R"(<?xml version="1.0" encoding="UTF-8"?>
+<template>
+ <object name="slime" type="enemy" width="16" height="12">
+  <properties>
+   <property name="health" type="int" value="3"/>
+  </properties>
+  <ellipse/>
+ </object>
+</template>
+)";
+
+    // A map using the shared tileset and template, with a group layer.
+    std::string MakeSharedMap(int numObjects)
+    {
+        std::string text = R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.10" orientation="orthogonal" renderorder="right-down" width="2" height="2" tilewidth="32" tileheight="32" infinite="0">
+ <tileset firstgid="1" source="shared.tsx"/>
+ <layer id="1" name="ground" width="2" height="2">
+  <data encoding="csv">1,2,3,4</data>
+ </layer>
+ <group id="2" name="world">
+  <objectgroup id="3" name="things">
+)";
+        for (int i = 0; i < numObjects; ++i)
+        {
+            text += "   <object id=\"" + std::to_string(i + 1) + "\" template=\"slime.tx\" x=\""
+                + std::to_string(i) + "\" y=\"0\"/>\n";
+        }
+
+        return text + "  </objectgroup>\n </group>\n</map>\n";
+    }
+
+    // What every parse of a file must agree on.
+    std::string Describe(const Tmx::Map &map)
+    {
+        std::string text = map.GetErrorText();
+        const auto add = [&](auto &self, const Tmx::Layer *layer) -> void {
+            text += layer->GetName() + "@" + std::to_string(layer->GetParseOrder()) + ";";
+            if (layer->GetLayerType() == Tmx::TMX_LAYERTYPE_GROUP_LAYER)
+            {
+                const auto group = static_cast<const Tmx::GroupLayer *>(layer);
+                for (int i = 0; i < group->GetNumChildren(); ++i)
+                {
+                    self(self, group->GetChild(i));
+                }
+            }
+        };
+
+        for (const auto layer : map.GetLayers())
+        {
+            add(add, layer);
+        }
+
+        unsigned long long objects = 0;
+        for (const auto &group : map.GetObjectGroups())
+        {
+            for (const auto &object : group.GetObjects())
+            {
+                objects = objects * 31 + std::hash<std::string>{}(object.GetType())
+                    + static_cast<unsigned>(object.GetProperties().GetIntProperty("health"));
+            }
+        }
+
+        unsigned long long gids = 0;
+        for (int i = 0; i < map.GetNumTileLayers(); ++i)
+        {
+            const auto layer = map.GetTileLayer(i);
+            for (int j = 0; j < layer->GetWidth() * layer->GetHeight(); ++j)
+            {
+                gids = gids * 31 + layer->GetTile(j).gid;
+            }
+        }
+
+        return text + std::to_string(objects) + "/" + std::to_string(gids);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 8;
+    const unsigned maxThreads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2]))
+        : std::max(4u, 2 * std::thread::hardware_concurrency());
+
+    const auto directory = std::filesystem::temp_directory_path() / "tmx_bench_concurrent";
+    std::filesystem::create_directories(directory);
+    Bench::WriteFile((directory / "shared.tsx").string(), tilesetText);
+    Bench::WriteFile((directory / "slime.tx").string(), templateText);
+
+    std::vector<std::string> fileNames;
+    const auto add = [&](const std::string &name, const std::string &text) {
+        fileNames.push_back((directory / name).string());
+        Bench::WriteFile(fileNames.back(), text);
+    };
+
+    add("tiles.tmx", Bench::MakeMap(128, 128, 4, "base64", "zlib"));
+    add("csv.tmx", Bench::MakeMap(128, 128, 2, "csv"));
+    add("tiles.tmj", Bench::MakeJsonMap(128, 128, 2, "base64", "zlib"));
+    add("objects.tmx", Bench::MakeObjectMap(5000));
+    add("shared.tmx", MakeSharedMap(500));
+
+    std::vector<std::string> expected;
+    for (const auto &fileName : fileNames)
+    {
+        const auto map = Tmx::Map::ParseFile(fileName);
+        if (map.HasError())
+        {
+            std::fprintf(stderr, "%s: %s\n", fileName.c_str(), map.GetErrorText().c_str());
+            return 1;
+        }
+
+        expected.push_back(Describe(map));
+    }
+
+    std::printf("%zu files, %d rounds per thread, %u hardware threads\n",
+        fileNames.size(), rounds, std::thread::hardware_concurrency());
+
+    std::atomic<int> mismatches{ 0 };
+    double single = 0.0;
+    for (unsigned numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+    {
+        // Every other thread shares a loader, and so its caches, with the others.
+        Tmx::MapLoader loader;
+        const auto elapsed = Bench::BestOf(1, [&] {
+            std::vector<std::thread> threads;
+            for (unsigned t = 0; t < numThreads; ++t)
+            {
+                threads.emplace_back([&, t] {
+                    for (int round = 0; round < rounds; ++round)
+                    {
+                        for (std::size_t i = 0; i < fileNames.size(); ++i)
+                        {
+                            // Start each thread on a different file.
+                            const auto file = (i + t) % fileNames.size();
+                            const auto map = t % 2
+                                ? loader.ParseFile(fileNames[file])
+                                : Tmx::Map::ParseFile(fileNames[file]);
+                            if (Describe(map) != expected[file])
+                            {
+                                ++mismatches;
+                            }
+                        }
+                    }
+                });
+            }
+
+            for (auto &thread : threads)
+            {
+                thread.join();
+            }
+        });
+
+        const double maps = static_cast<double>(numThreads) * rounds * fileNames.size();
+        const double perSecond = maps * 1000.0 / elapsed;
+        single = numThreads == 1 ? perSecond : single;
+        std::printf("%3u threads %10.2f ms %10.1f maps/s  %5.2fx\n",
+            numThreads, elapsed, perSecond, perSecond / single);
+    }
+
+    std::filesystem::remove_all(directory);
+
+    if (mismatches)
+    {
+        std::fprintf(stderr, "%d parses differed from a parse made alone\n", mismatches.load());
+        return 1;
+    }
+
+    return 0;
+}
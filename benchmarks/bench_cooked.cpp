@@ -0,0 +1,89 @@
+//-----------------------------------------------------------------------------
+// bench_cooked
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "Tmx.h"
+#include "BenchUtil.h"
+
+// Compares loading a map from TMX with loading it cooked, up to the point
+// where every gid of every layer has been read once.
+int main(int argc, char *argv[])
+{
+    const int width = argc > 1 ? std::atoi(argv[1]) : 512;
+    const int height = argc > 2 ? std::atoi(argv[2]) : 512;
+    const int layers = 8;
+
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto tmxFile = (directory / "bench_cooked.tmx").string();
+    const auto cookedFile = (directory / "bench_cooked.tmxc").string();
+
+    const auto text = Bench::MakeMap(width, height, layers, "base64", "zlib");
+    Bench::WriteFile(tmxFile, text);
+
+    const auto cooked = Tmx::CookedMap::Cook(Tmx::Map::ParseFile(tmxFile));
+    std::ofstream(cookedFile, std::ios::binary).write(cooked.data(), cooked.size());
+
+    std::printf("%dx%d, %d layers: %zu KB as TMX, %zu KB cooked\n",
+        width, height, layers, text.size() / 1024, cooked.size() / 1024);
+
+    std::uint64_t sum = 0;
+    const auto tmxMs = Bench::BestOf(5, [&] {
+        const auto map = Tmx::Map::ParseFile(tmxFile);
+        for (const auto &layer : map.GetTileLayers())
+        {
+            for (int i = 0; i < layer.GetWidth() * layer.GetHeight(); ++i)
+            {
+                sum += layer.GetTile(i).gid;
+            }
+        }
+    });
+
+    std::uint64_t cookedSum = 0;
+    const auto cookedMs = Bench::BestOf(5, [&] {
+        const auto map = Tmx::CookedMap::Open(cookedFile);
+        for (const auto &layer : map.GetLayers())
+        {
+            for (const auto gid : map.GetGids(layer))
+            {
+                cookedSum += gid;
+            }
+        }
+    });
+
+    std::printf("tmx    %10.2f ms\ncooked %10.2f ms (%.1fx)\n",
+        tmxMs, cookedMs, tmxMs / cookedMs);
+
+    std::filesystem::remove(tmxFile);
+    std::filesystem::remove(cookedFile);
+
+    // The gids are only flags apart if the two agree.
+    return sum == cookedSum ? 0 : 1;
+}
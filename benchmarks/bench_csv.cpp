@@ -0,0 +1,122 @@
+//-----------------------------------------------------------------------------
+// bench_csv.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Tmx.h"
+
+#include "BenchUtil.h"
+
+// Parses the csv data of one layer, written in rows as Tiled writes it, the
+// way the parser used to (a strtoul per value) and with the vectorized
+// parser at every instruction set the CPU supports. Then parses a map with
+// csv layers.
+
+namespace
+{
+    using Tmx::Util::SimdLevel;
+
+    template <typename F>
+    double Best(int runs, F &&f)
+    {
+        double best = 1e300;
+        for (int run = 0; run < runs; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            f();
+            best = std::min(best, std::chrono::duration<double, std::milli>{
+                std::chrono::steady_clock::now() - start }.count());
+        }
+        return best;
+    }
+
+    bool Report(const char *name, double ms, const std::string &text,
+        const std::vector<uint32_t> &values, const std::vector<uint32_t> &gids)
+    {
+        const bool same = values == gids;
+        std::printf("%-10s %9.2f ms %9.1f MB/s%s\n", name, ms,
+            text.size() / (ms * 1000.0), same ? "" : "   MISMATCH");
+        return same;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int width = argc > 1 ? std::atoi(argv[1]) : 4096;
+    const int height = argc > 2 ? std::atoi(argv[2]) : width;
+
+    const auto gids = Bench::MakeGids(width, height, 1);
+    std::string text;
+    text.reserve(gids.size() * 4);
+    for (size_t i = 0; i < gids.size(); ++i)
+    {
+        text += std::to_string(gids[i]);
+        if (i + 1 != gids.size())
+        {
+            text += ',';
+        }
+        if ((i + 1) % width == 0)
+        {
+            text += '\n';
+        }
+    }
+    std::printf("%dx%d layer, %.1f MB of csv\n", width, height, text.size() / (1024.0 * 1024.0));
+
+    std::vector<uint32_t> values;
+    values.reserve(gids.size());
+    bool ok = Report("strtoul", Best(5, [&] {
+        values.clear();
+        Tmx::Util::Iterate(text, ',', [&values](auto first, auto) {
+            values.push_back(static_cast<uint32_t>(std::strtoul(first, nullptr, 10)));
+        });
+    }), text, values, gids);
+
+    const std::pair<const char *, SimdLevel> levels[] = {
+        { "scalar", SimdLevel::Scalar }, { "sse4.1", SimdLevel::SSE41 }, { "avx2", SimdLevel::AVX2 } };
+    for (const auto &[name, level] : levels)
+    {
+        if (level > Tmx::Util::GetSimdLevel())
+        {
+            continue;
+        }
+
+        values.resize(gids.size());
+        ok &= Report(name, Best(5, [&] {
+            values.resize(Tmx::Util::ParseCsv(text, values.data(), gids.size(), level));
+        }), text, values, gids);
+    }
+
+    const auto mapText = Bench::MakeMap(width / 2, height / 2, 4, "csv", "");
+    std::printf("\nmap of 4 %dx%d csv layers %9.2f ms\n", width / 2, height / 2,
+        Best(3, [&] { Tmx::Map::ParseText(mapText); }));
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+//-----------------------------------------------------------------------------
+// bench_decompress.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Tmx.h"
+
+#include "BenchUtil.h"
+
+// Decompresses one layer with every backend built into the library, then
+// parses a map with each, and the same map compressed with each codec.
+// Configure with USE_LIBDEFLATE and USE_ZLIB_NG to have those compared with
+// zlib, and with USE_ZSTD for zstd.
+
+namespace
+{
+    template <typename F>
+    double Best(int runs, F &&f)
+    {
+        double best = 1e300;
+        for (int run = 0; run < runs; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            f();
+            best = std::min(best, std::chrono::duration<double, std::milli>{
+                std::chrono::steady_clock::now() - start }.count());
+        }
+        return best;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int width = argc > 1 ? std::atoi(argv[1]) : 4096;
+    const int height = argc > 2 ? std::atoi(argv[2]) : width;
+
+    const auto gids = Bench::MakeGids(width, height, 1);
+    const auto outSize = gids.size() * sizeof(uint32_t);
+    std::vector<char> out(outSize);
+    bool ok = true;
+
+    std::printf("%dx%d layer, %.1f MB of gids\n", width, height, outSize / (1024.0 * 1024.0));
+    for (const std::string compression : { "zlib", "gzip", "zstd" })
+    {
+        if (compression == "zstd" && !Tmx::Decompressor::HasZstd())
+        {
+            continue;
+        }
+
+        const auto packed = Bench::Compress(gids, compression);
+        // Every backend reads zstd with libzstd, so it is timed once.
+        auto names = Tmx::Decompressor::GetNames();
+        if (compression == "zstd")
+        {
+            names.resize(1);
+        }
+
+        for (const auto name : names)
+        {
+            const auto backend = Tmx::Decompressor::Find(name);
+            const auto label = compression == "zstd" ? "libzstd" : std::string{ name };
+            const auto decompress =
+                compression == "zlib" ? &Tmx::Decompressor::DecompressZlib :
+                compression == "gzip" ? &Tmx::Decompressor::DecompressGzip
+                                      : &Tmx::Decompressor::DecompressZstd;
+
+            std::ptrdiff_t written = 0;
+            const auto ms = Best(5, [&] {
+                written = (backend->*decompress)(packed.data(), packed.size(),
+                    out.data(), out.size());
+            });
+
+            const bool same = written == static_cast<std::ptrdiff_t>(outSize)
+                && std::memcmp(out.data(), gids.data(), outSize) == 0;
+            ok &= same;
+            std::printf("%-5s %-12s %9.2f ms %9.1f MB/s %6.1f MB packed%s\n",
+                compression.c_str(), label.c_str(), ms, outSize / (ms * 1000.0),
+                packed.size() / (1024.0 * 1024.0),
+                same ? "" : "   MISMATCH");
+        }
+    }
+
+    // Whole maps, where decompressing is one step among others.
+    const auto text = Bench::MakeMap(width / 2, height / 2, 4, "base64", "zlib");
+    std::printf("\nmap of 4 %dx%d zlib layers\n", width / 2, height / 2);
+    for (const auto name : Tmx::Decompressor::GetNames())
+    {
+        Tmx::ParseOptions options;
+        options.decompressor = Tmx::Decompressor::Find(name);
+        Tmx::MapLoader loader{ options };
+
+        const auto ms = Best(3, [&] { loader.ParseText(text); });
+        std::printf("parse %-12s %9.2f ms\n", std::string{ name }.c_str(), ms);
+    }
+
+    // The same map with each codec, through the default backend.
+    std::printf("\nsame map by codec, %s\n", Tmx::Decompressor::GetDefault().GetName());
+    for (const std::string compression : { "", "zlib", "gzip", "zstd" })
+    {
+        if (compression == "zstd" && !Tmx::Decompressor::HasZstd())
+        {
+            continue;
+        }
+
+        const auto codecText = Bench::MakeMap(width / 2, height / 2, 4, "base64", compression);
+        const auto ms = Best(3, [&] { Tmx::Map::ParseText(codecText); });
+        std::printf("parse %-12s %9.2f ms %9.1f MB of text\n",
+            compression.empty() ? "none" : compression.c_str(), ms,
+            codecText.size() / (1024.0 * 1024.0));
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+//-----------------------------------------------------------------------------
+// bench_json
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+
+#include "Tmx.h"
+#include "BenchUtil.h"
+
+namespace
+{
+    std::uint64_t SumGids(const Tmx::Map &map)
+    {
+        std::uint64_t sum = 0;
+        for (const auto &layer : map.GetTileLayers())
+        {
+            for (int i = 0; i < layer.GetWidth() * layer.GetHeight(); ++i)
+            {
+                sum += layer.GetTile(i).gid;
+            }
+        }
+        return sum;
+    }
+}
+
+// Compares parsing the same map from TMX and from Tiled JSON, with the gids
+// as text (csv / arrays) and as compressed base64.
+int main(int argc, char *argv[])
+{
+    const int width = argc > 1 ? std::atoi(argv[1]) : 512;
+    const int height = argc > 2 ? std::atoi(argv[2]) : 512;
+    const int layers = 8;
+
+    int failures = 0;
+    for (const auto &[encoding, compression] : {
+        std::pair<std::string, std::string>{ "csv", "" }, { "base64", "zlib" } })
+    {
+        const auto tmx = Bench::MakeMap(width, height, layers, encoding, compression);
+        const auto json = Bench::MakeJsonMap(width, height, layers, encoding, compression);
+
+        std::uint64_t tmxSum = 0;
+        const auto tmxMs = Bench::BestOf(5, [&] {
+            tmxSum = SumGids(Tmx::Map::ParseText(tmx));
+        });
+
+        std::uint64_t jsonSum = 0;
+        const auto jsonMs = Bench::BestOf(5, [&] {
+            jsonSum = SumGids(Tmx::Map::ParseText(json));
+        });
+
+        std::printf("%dx%d, %d layers, %s%s%s: %zu KB TMX, %zu KB JSON\n",
+            width, height, layers, encoding.c_str(), compression.empty() ? "" : "+",
+            compression.c_str(), tmx.size() / 1024, json.size() / 1024);
+        std::printf("  tmx  %10.2f ms\n  json %10.2f ms (%.2fx)\n",
+            tmxMs, jsonMs, tmxMs / jsonMs);
+
+        failures += tmxSum != jsonSum;
+    }
+
+    // Both front-ends must produce the same tiles.
+    return failures;
+}
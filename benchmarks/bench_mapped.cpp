@@ -0,0 +1,84 @@
+//-----------------------------------------------------------------------------
+// bench_mapped.cpp
+//
+// Compares Map::ParseFile against Map::ParseFileMapped and the streaming
+// front-end (ParseOptions::streaming): wall time and peak resident memory.
+// Each mode runs in its own process so that the peak RSS of one does not
+// hide the other.
+//
+// Usage: bench_mapped [file.tmx] [file|mapped|streamed]
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "Tmx.h"
+#include "BenchUtil.h"
+
+namespace
+{
+    int RunMode(const std::string &fileName, const char *mode)
+    {
+        const bool mapped = std::strcmp(mode, "mapped") == 0;
+        const bool streamed = std::strcmp(mode, "streamed") == 0;
+        int layers = 0;
+
+        Tmx::ParseOptions options;
+        options.streaming = true;
+        Tmx::MapLoader loader{ options };
+
+        const auto ms = Bench::BestOf(5, [&] {
+            const auto map =
+                streamed ? loader.ParseFile(fileName) :
+                mapped   ? Tmx::Map::ParseFileMapped(fileName)
+                         : Tmx::Map::ParseFile(fileName);
+            layers = map.GetNumTileLayers();
+        });
+
+        std::printf("%-8s %10.2f ms %10ld KB peak RSS (%d layers)\n",
+            mode, ms, Bench::PeakRssKb(), layers);
+        return 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string fileName = argc > 1 ? argv[1] : "";
+    if (fileName.empty())
+    {
+        fileName = "bench_mapped.tmx";
+        Bench::WriteFile(fileName, Bench::MakeMap(1024, 1024, 8, "base64", ""));
+    }
+
+    if (argc > 2)
+    {
+        return RunMode(fileName, argv[2]);
+    }
+
+#ifdef _WIN32
+    RunMode(fileName, "file");
+    RunMode(fileName, "mapped");
+    RunMode(fileName, "streamed");
+#else
+    for (const char *mode : { "file", "mapped", "streamed" })
+    {
+        const pid_t pid = fork();
+        if (pid == 0)
+        {
+            const int result = RunMode(fileName, mode);
+            std::fflush(stdout);
+            _exit(result);
+        }
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+    }
+#endif
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+//-----------------------------------------------------------------------------
+// bench_parallel_layers.cpp
+//
+// Decodes one map with many large tile layers using an increasing number of
+// decode threads (ParseOptions::decodeThreads) and reports the speed-up over
+// the sequential parse.
+//
+// Usage: bench_parallel_layers [layers] [width] [height]
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "Tmx.h"
+#include "BenchUtil.h"
+
+int main(int argc, char *argv[])
+{
+    const int layers = argc > 1 ? std::atoi(argv[1]) : 32;
+    const int width = argc > 2 ? std::atoi(argv[2]) : 512;
+    const int height = argc > 3 ? std::atoi(argv[3]) : 512;
+
+    const auto text = Bench::MakeMap(width, height, layers, "base64", "zlib");
+    const unsigned cores = std::thread::hardware_concurrency();
+
+    std::printf("%d layers of %dx%d, zlib, %u hardware threads\n", layers, width, height, cores);
+
+    double sequential = 0.0;
+    for (unsigned threads = 1; threads <= cores || threads == 1; threads *= 2)
+    {
+        Tmx::ParseOptions options;
+        options.decodeThreads = threads;
+        Tmx::MapLoader loader{ options };
+
+        const auto ms = Bench::BestOf(3, [&] {
+            const auto map = loader.ParseText(text);
+            if (map.GetNumTileLayers() != layers)
+            {
+                std::fprintf(stderr, "unexpected layer count\n");
+                std::exit(1);
+            }
+        });
+
+        sequential = threads == 1 ? ms : sequential;
+        std::printf("%3u threads %10.2f ms  %5.2fx\n", threads, ms, sequential / ms);
+    }
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+//-----------------------------------------------------------------------------
+// bench_region.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Tmx.h"
+
+#include "BenchUtil.h"
+
+// Copies the gids of a layer into a buffer, as a renderer uploading it would,
+// once tile by tile through GetTile and once with TileLayer::CopyRegion, for
+// both layouts of ParseOptions::tileStorage. Once for the whole layer and
+// once for screen-sized windows moving over it.
+
+namespace
+{
+    struct Window
+    {
+        int width;
+        int height;
+    };
+
+    template <typename Copy>
+    double CopyWindows(const Tmx::TileLayer &layer, Window window, Copy copy)
+    {
+        return Bench::BestOf(5, [&] {
+            for (int y = 0; y + window.height <= layer.GetHeight(); y += window.height / 2)
+            {
+                for (int x = 0; x + window.width <= layer.GetWidth(); x += window.width / 2)
+                {
+                    copy(Tmx::TileRect{ x, y, window.width, window.height });
+                }
+            }
+        });
+    }
+
+    bool Run(const std::string &text, Tmx::TileLayerStorageType storage, const char *name)
+    {
+        Tmx::ParseOptions options;
+        options.tileStorage = storage;
+        Tmx::MapLoader loader{ options };
+        const auto map = loader.ParseText(text);
+        const auto &layer = map.GetTileLayers().front();
+
+        const auto width = layer.GetWidth();
+        const auto height = layer.GetHeight();
+        std::vector<uint32_t> byTile(static_cast<size_t>(width) * height);
+        std::vector<uint32_t> byRegion(byTile.size());
+
+        const auto getTile = [&](const Tmx::TileRect &rect) {
+            for (int j = 0; j < rect.height; ++j)
+            {
+                for (int i = 0; i < rect.width; ++i)
+                {
+                    byTile[static_cast<size_t>(j) * rect.width + i] =
+                        layer.GetTile(rect.x + i, rect.y + j).GetRawGid();
+                }
+            }
+        };
+        const auto copyRegion = [&](const Tmx::TileRect &rect) {
+            layer.CopyRegion(rect, byRegion.data(), rect.width);
+        };
+
+        const Tmx::TileRect all{ 0, 0, width, height };
+        const auto tileMs = Bench::BestOf(5, [&] { getTile(all); });
+        const auto regionMs = Bench::BestOf(5, [&] { copyRegion(all); });
+        const bool same = byTile == byRegion;
+
+        const Window window{ 80, 45 };
+        const auto windowTileMs = CopyWindows(layer, window, getTile);
+        const auto windowRegionMs = CopyWindows(layer, window, copyRegion);
+
+        std::printf("%-6s layer: GetTile %7.2f ms  CopyRegion %6.2f ms   "
+            "%dx%d windows: GetTile %7.2f ms  CopyRegion %6.2f ms%s\n",
+            name, tileMs, regionMs, window.width, window.height, windowTileMs, windowRegionMs,
+            same ? "" : "   MISMATCH");
+        return same;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int width = argc > 1 ? std::atoi(argv[1]) : 4096;
+    const int height = argc > 2 ? std::atoi(argv[2]) : width;
+
+    const auto text = Bench::MakeMap(width, height, 1, "base64", "zlib");
+    std::printf("%dx%d layer\n", width, height);
+
+    bool ok = Run(text, Tmx::TMX_STORAGE_TILES, "tiles");
+    ok &= Run(text, Tmx::TMX_STORAGE_GIDS, "gids");
+    return ok ? 0 : 1;
+}
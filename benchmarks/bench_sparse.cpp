@@ -0,0 +1,180 @@
+//-----------------------------------------------------------------------------
+// bench_sparse.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Tmx.h"
+
+#include "BenchUtil.h"
+
+// Parses a map with a scattered decal layer, a painted overlay layer, both
+// 95% empty, and a ground layer that is mostly full, with each storage of
+// ParseOptions::tileStorage. For each layer prints the memory its tiles take,
+// the time to read every cell with GetTileGid, to copy it with CopyRegion and
+// to visit its tiles with IterateNonEmptyTiles.
+
+namespace
+{
+    // One cell in twenty has a tile.
+    std::vector<uint32_t> MakeDecals(int width, int height)
+    {
+        std::vector<uint32_t> gids(static_cast<size_t>(width) * height);
+        uint32_t seed = 7;
+        for (auto &gid : gids)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            gid = (seed >> 16) % 20 == 0 ? 1 + (seed >> 8) % 96 : 0;
+        }
+        return gids;
+    }
+
+    // Rectangles of one tile covering a twentieth of the layer.
+    std::vector<uint32_t> MakeOverlay(int width, int height)
+    {
+        std::vector<uint32_t> gids(static_cast<size_t>(width) * height);
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                if (x % 64 < 16 && y % 64 < 13)
+                {
+                    gids[static_cast<size_t>(y) * width + x] = 1 + (x / 64 + y / 64) % 96;
+                }
+            }
+        }
+        return gids;
+    }
+
+    std::string MakeSparseMap(int width, int height)
+    {
+        std::ostringstream ss;
+        ss << R"(<map version="1.10" orientation="orthogonal" )"
+           << "width=\"" << width << "\" height=\"" << height << "\" "
+           << R"(tilewidth="32" tileheight="32">)" << "\n";
+        ss << R"( <tileset firstgid="1" name="a" tilewidth="32" tileheight="32" )"
+           << R"(tilecount="96" columns="8"/>)" << "\n";
+
+        const auto layer = [&](const char *name, const std::vector<uint32_t> &gids) {
+            ss << " <layer name=\"" << name << "\" width=\"" << width << "\" height=\"" << height
+               << "\">\n  <data encoding=\"base64\" compression=\"zlib\">\n   "
+               << Bench::EncodeGids(gids, "base64", "zlib") << "\n  </data>\n </layer>\n";
+        };
+        layer("decals", MakeDecals(width, height));
+        layer("overlay", MakeOverlay(width, height));
+        layer("ground", Bench::MakeGids(width, height, 1));
+
+        ss << "</map>\n";
+        return ss.str();
+    }
+
+    const char *StorageName(Tmx::TileLayerStorageType storage)
+    {
+        switch (storage)
+        {
+        case Tmx::TMX_STORAGE_TILES: return "tiles";
+        case Tmx::TMX_STORAGE_GIDS: return "gids";
+        case Tmx::TMX_STORAGE_RUNS: return "runs";
+        case Tmx::TMX_STORAGE_SPARSE: return "sparse";
+        default: return "auto";
+        }
+    }
+
+    bool Run(const std::string &text, Tmx::TileLayerStorageType storage)
+    {
+        Tmx::ParseOptions options;
+        options.tileStorage = storage;
+        Tmx::MapLoader loader{ options };
+        const auto map = loader.ParseText(text);
+
+        bool ok = true;
+        for (const auto &layer : map.GetTileLayers())
+        {
+            const auto width = layer.GetWidth();
+            const auto height = layer.GetHeight();
+
+            // Each way of reading the layer sums up its gids.
+            uint64_t getSum = 0;
+            const auto getMs = Bench::BestOf(3, [&] {
+                getSum = 0;
+                for (int y = 0; y < height; ++y)
+                {
+                    for (int x = 0; x < width; ++x)
+                    {
+                        getSum += layer.GetTileGid(x, y);
+                    }
+                }
+            });
+
+            std::vector<uint32_t> region(static_cast<size_t>(width) * height);
+            const auto copyMs = Bench::BestOf(3, [&] {
+                layer.CopyRegion(Tmx::TileRect{ 0, 0, width, height }, region.data(), width);
+            });
+            uint64_t copySum = 0;
+            for (const auto gid : region)
+            {
+                copySum += gid;
+            }
+
+            uint64_t iterateSum = 0;
+            const auto iterateMs = Bench::BestOf(3, [&] {
+                iterateSum = 0;
+                layer.IterateNonEmptyTiles([&](int, int, const Tmx::MapTile &tile) {
+                    iterateSum += tile.gid;
+                });
+            });
+
+            const bool same = getSum == copySum && getSum == iterateSum;
+            std::printf("%-6s %-8s as %-6s %7.2f MB (saves %6.2f MB)  GetTileGid %7.2f ms  "
+                "CopyRegion %6.2f ms  IterateNonEmptyTiles %6.2f ms%s\n",
+                StorageName(storage), layer.GetName().c_str(), StorageName(layer.GetStorage()),
+                layer.GetTileMemory() / 1048576.0, layer.GetTileMemorySaved() / 1048576.0,
+                getMs, copyMs, iterateMs, same ? "" : "   MISMATCH");
+            ok &= same;
+        }
+        return ok;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int width = argc > 1 ? std::atoi(argv[1]) : 4096;
+    const int height = argc > 2 ? std::atoi(argv[2]) : width;
+
+    const auto text = MakeSparseMap(width, height);
+    std::printf("%dx%d layers\n", width, height);
+
+    bool ok = true;
+    for (const auto storage : { Tmx::TMX_STORAGE_TILES, Tmx::TMX_STORAGE_GIDS,
+        Tmx::TMX_STORAGE_RUNS, Tmx::TMX_STORAGE_SPARSE, Tmx::TMX_STORAGE_AUTO })
+    {
+        ok &= Run(text, storage);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+//-----------------------------------------------------------------------------
+// bench_storage.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Tmx.h"
+
+#include "BenchUtil.h"
+
+// Parses a map of several tile layers keeping MapTiles and keeping raw gids
+// (ParseOptions::tileStorage), and reports the memory held by the tiles and
+// the time to read every tile through the TileLayer getters. Layers of gids
+// are also read a whole layer at a time through TilesetLookup::Resolve.
+
+namespace
+{
+    struct Result
+    {
+        double parse;
+        size_t bytes;
+        uint64_t checksum;
+    };
+
+    Result Run(const std::string &text, Tmx::TileLayerStorageType storage, const char *name)
+    {
+        Tmx::ParseOptions options;
+        options.tileStorage = storage;
+        Tmx::MapLoader loader{ options };
+
+        const auto parse = Bench::BestOf(3, [&] { loader.ParseText(text); });
+        const auto map = loader.ParseText(text);
+
+        size_t bytes = 0;
+        for (const auto &layer : map.GetTileLayers())
+        {
+            bytes += layer.GetTiles().size_bytes() + layer.GetGids().size_bytes();
+        }
+
+        uint64_t gidSum = 0;
+        const auto gids = Bench::BestOf(5, [&] {
+            gidSum = 0;
+            for (const auto &layer : map.GetTileLayers())
+            {
+                for (int y = 0; y < layer.GetHeight(); ++y)
+                {
+                    for (int x = 0; x < layer.GetWidth(); ++x)
+                    {
+                        gidSum += layer.GetTileGid(x, y);
+                    }
+                }
+            }
+        });
+
+        uint64_t tileSum = 0;
+        const auto tiles = Bench::BestOf(5, [&] {
+            tileSum = 0;
+            for (const auto &layer : map.GetTileLayers())
+            {
+                for (int y = 0; y < layer.GetHeight(); ++y)
+                {
+                    for (int x = 0; x < layer.GetWidth(); ++x)
+                    {
+                        const auto tile = layer.GetTile(x, y);
+                        tileSum += tile.id + tile.tilesetId + tile.flippedHorizontally;
+                    }
+                }
+            }
+        });
+
+        std::printf("%-6s parse %8.2f ms  tiles %7.1f MB  GetTileGid %7.2f ms  GetTile %7.2f ms\n",
+            name, parse, bytes / (1024.0 * 1024.0), gids, tiles);
+
+        if (storage == Tmx::TMX_STORAGE_GIDS)
+        {
+            std::vector<int32_t> indices(map.GetTileLayers().front().GetGids().size());
+            std::vector<uint32_t> ids(indices.size());
+            std::vector<uint8_t> flags(indices.size());
+
+            uint64_t resolvedSum = 0;
+            const auto resolve = Bench::BestOf(5, [&] {
+                resolvedSum = 0;
+                for (const auto &layer : map.GetTileLayers())
+                {
+                    map.GetTilesetLookup().Resolve(layer.GetGids(), indices, ids, flags);
+                    for (size_t i = 0; i < ids.size(); ++i)
+                    {
+                        resolvedSum += ids[i] + indices[i] + (flags[i] >> 2);
+                    }
+                }
+            });
+
+            std::printf("%-6s %52s Resolve %7.2f ms%s\n", "", "", resolve,
+                resolvedSum == tileSum ? "" : "   MISMATCH");
+        }
+
+        return { parse, bytes, gidSum + tileSum };
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int width = argc > 1 ? std::atoi(argv[1]) : 2048;
+    const int height = argc > 2 ? std::atoi(argv[2]) : width;
+    const int layers = argc > 3 ? std::atoi(argv[3]) : 8;
+
+    const auto text = Bench::MakeMap(width, height, layers, "base64", "zlib");
+    std::printf("%d layers of %dx%d\n", layers, width, height);
+
+    const auto tiles = Run(text, Tmx::TMX_STORAGE_TILES, "tiles");
+    const auto gids = Run(text, Tmx::TMX_STORAGE_GIDS, "gids");
+    std::printf("gids take %.0f%% of the memory of tiles\n", 100.0 * gids.bytes / tiles.bytes);
+
+    return tiles.checksum == gids.checksum ? 0 : 1;
+}
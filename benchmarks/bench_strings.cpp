@@ -0,0 +1,159 @@
+//-----------------------------------------------------------------------------
+// bench_strings.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <malloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "Tmx.h"
+
+#include "BenchUtil.h"
+
+namespace
+{
+    long long heapBytes = 0;
+
+    void *Allocate(void *p)
+    {
+        if (!p)
+        {
+            throw std::bad_alloc{};
+        }
+
+        heapBytes += malloc_usable_size(p);
+        return p;
+    }
+
+    void Free(void *p)
+    {
+        if (p)
+        {
+            heapBytes -= malloc_usable_size(p);
+            std::free(p);
+        }
+    }
+}
+
+void *operator new(std::size_t size)
+{
+    return Allocate(std::malloc(size ? size : 1));
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    const auto align = static_cast<std::size_t>(alignment);
+    return Allocate(std::aligned_alloc(align, (size + align - 1) / align * align));
+}
+
+void operator delete(void *p) noexcept { Free(p); }
+void operator delete(void *p, std::size_t) noexcept { Free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { Free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { Free(p); }
+
+namespace
+{
+    double Milliseconds(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>{ duration }.count();
+    }
+
+    // Counts the objects of a type, comparing the text of the types.
+    int CountByText(const Tmx::Map &map, const std::string &type)
+    {
+        int count = 0;
+        for (const auto &group : map.GetObjectGroups())
+        {
+            for (const auto &object : group.GetObjects())
+            {
+                count += object.GetType() == type;
+            }
+        }
+
+        return count;
+    }
+
+    // Counts the objects of a type, comparing interned types by address.
+    int CountByAddress(const Tmx::Map &map, const std::string &type)
+    {
+        const auto interned = map.GetStringPool().Find(type);
+        int count = 0;
+        for (const auto &group : map.GetObjectGroups())
+        {
+            for (const auto &object : group.GetObjects())
+            {
+                count += &object.GetType() == interned;
+            }
+        }
+
+        return count;
+    }
+
+    template <typename Count>
+    void Compare(const char *mode, const Tmx::Map &map, Count count)
+    {
+        int found = 0;
+        double best = 1e300;
+        for (int run = 0; run < 20; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            found = count(map, "trigger");
+            best = std::min(best, Milliseconds(std::chrono::steady_clock::now() - start));
+        }
+
+        std::printf("type compare by %-7s %8.3f ms   (%d found)\n", mode, best, found);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string fileName = argc > 1 ? argv[1] : "";
+    if (fileName.empty())
+    {
+        fileName = "bench_strings.tmx";
+        Bench::WriteFile(fileName, Bench::MakeObjectMap(200000));
+    }
+
+    const long long before = heapBytes;
+    const auto map = Tmx::Map::ParseFile(fileName);
+    const long long after = heapBytes;
+
+    int objects = 0;
+    for (const auto &group : map.GetObjectGroups())
+    {
+        objects += group.GetNumObjects();
+    }
+
+    std::printf("heap in use by the map %10.2f MB   (%d objects, %zu interned strings)\n",
+        (after - before) / (1024.0 * 1024.0), objects, map.GetStringPool().GetSize());
+
+    Compare("text", map, CountByText);
+    Compare("address", map, CountByAddress);
+    return 0;
+}
@@ -0,0 +1,135 @@
+//-----------------------------------------------------------------------------
+// bench_tilesets.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Tmx.h"
+
+#include "BenchUtil.h"
+
+// Finds the tilesets of a layer's worth of gids spread over many tilesets,
+// by walking the tilesets from the last as the map used to, one gid at a
+// time through the lookup, and all at once with TilesetLookup::Resolve.
+// Once with tilesets that start at small gids, which get a table, and once
+// with tilesets far enough apart to be searched.
+
+namespace
+{
+    Tmx::Map MakeMap(int numTilesets, uint32_t spacing)
+    {
+        std::string text = R"(<map version="1.10" orientation="orthogonal" width="1" height="1" )"
+            R"(tilewidth="32" tileheight="32">)";
+        for (int i = 0; i < numTilesets; ++i)
+        {
+            text += R"(<tileset firstgid=")" + std::to_string(1 + i * spacing)
+                + R"(" name="t" tilewidth="32" tileheight="32" tilecount="64" columns="8"/>)";
+        }
+        text += "</map>";
+        return Tmx::Map::ParseText(text);
+    }
+
+    int Scan(const Tmx::Map &map, uint32_t gid)
+    {
+        gid &= ~(Tmx::FlippedHorizontallyFlag | Tmx::FlippedVerticallyFlag
+            | Tmx::FlippedDiagonallyFlag);
+        const auto &tilesets = map.GetTilesets();
+        for (int i = static_cast<int>(tilesets.size()) - 1; i > -1; --i)
+        {
+            if (static_cast<int>(gid) >= tilesets[i].GetFirstGid())
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    bool Run(int numTilesets, uint32_t spacing, size_t count)
+    {
+        const auto map = MakeMap(numTilesets, spacing);
+        const auto &lookup = map.GetTilesetLookup();
+
+        std::vector<uint32_t> gids(count);
+        uint32_t seed = 7;
+        for (auto &gid : gids)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            const auto r = seed >> 8;
+            gid = (r & 7) == 0 ? 0 : 1 + r % numTilesets * spacing + r % 64;
+        }
+
+        std::vector<int32_t> indices(count);
+        std::vector<uint32_t> ids(count);
+        std::vector<uint8_t> flags(count);
+        std::vector<int32_t> expected(count);
+
+        const auto scan = Bench::BestOf(5, [&] {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const auto index = Scan(map, gids[i]);
+                expected[i] = index;
+                ids[i] = gids[i] - (index == -1 ? 0 : map.GetTileset(index)->GetFirstGid());
+            }
+        });
+
+        const auto find = Bench::BestOf(5, [&] {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const auto index = lookup.FindIndex(gids[i]);
+                indices[i] = index;
+                ids[i] = gids[i] - lookup.GetFirstGid(index);
+            }
+        });
+        bool ok = indices == expected;
+
+        const auto resolve = Bench::BestOf(5, [&] {
+            lookup.Resolve(gids, indices, ids, flags);
+        });
+        ok = ok && indices == expected;
+
+        std::printf("%3d tilesets %s  scan %7.2f ms  find %6.2f ms  resolve %6.2f ms%s\n",
+            numTilesets, lookup.HasTable() ? "table " : "search", scan, find, resolve,
+            ok ? "" : "   MISMATCH");
+        return ok;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096 * 4096;
+    std::printf("%zu gids\n", count);
+
+    bool ok = true;
+    for (const int numTilesets : { 2, 16, 64, 256 })
+    {
+        ok &= Run(numTilesets, 64, count);
+        ok &= Run(numTilesets, 100000, count);
+    }
+
+    return ok ? 0 : 1;
+}
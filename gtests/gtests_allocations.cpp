@@ -0,0 +1,174 @@
+//-----------------------------------------------------------------------------
+// gtests_allocations
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#ifdef USE_MINIZ
+#define MINIZ_HEADER_FILE_ONLY
+#include "miniz.c"
+#else
+#include <zlib.h>
+#endif
+
+#include "Tmx.h"
+#include "base64/base64.h"
+
+namespace
+{
+    std::atomic<long> allocations{ 0 };
+}
+
+void *operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (const auto p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace
+{
+    std::string Compress(const std::string &bytes, int windowBits)
+    {
+        std::string packed(compressBound(static_cast<uLong>(bytes.size())) + 32, '\0');
+
+        z_stream strm{};
+        deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+        strm.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(bytes.data()));
+        strm.avail_in = static_cast<uInt>(bytes.size());
+        strm.next_out = reinterpret_cast<Bytef *>(packed.data());
+        strm.avail_out = static_cast<uInt>(packed.size());
+        deflate(&strm, Z_FINISH);
+        packed.resize(strm.total_out);
+        deflateEnd(&strm);
+        return packed;
+    }
+
+    unsigned GidAt(int index)
+    {
+        return index % 5 == 0 ? 0 : 1 + index % 7;
+    }
+
+    // A map with one size x size layer, laid out the way Tiled writes it.
+    std::string MakeMap(int size, const std::string &encoding, const std::string &compression)
+    {
+        std::string data;
+        if (encoding == "csv")
+        {
+            for (int i = 0; i < size * size; ++i)
+            {
+                data += std::to_string(GidAt(i)) + (i + 1 < size * size ? "," : "");
+            }
+        }
+        else
+        {
+            std::string bytes;
+            for (int i = 0; i < size * size; ++i)
+            {
+                const uint32_t gid = GidAt(i);
+                bytes.append(reinterpret_cast<const char *>(&gid), sizeof gid);
+            }
+
+            if (compression == "zlib")
+            {
+                bytes = Compress(bytes, 15);
+            }
+            else if (compression == "gzip")
+            {
+                bytes = Compress(bytes, 15 + 16);
+            }
+
+            data = base64_encode(reinterpret_cast<const unsigned char *>(bytes.data()),
+                static_cast<unsigned>(bytes.size()));
+        }
+
+        const auto dimensions = "width=\"" + std::to_string(size)
+            + "\" height=\"" + std::to_string(size) + "\"";
+        return R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.10" orientation="orthogonal" )" + dimensions + R"( tilewidth="16" tileheight="16">
+ <tileset firstgid="1" name="tiles" tilewidth="16" tileheight="16" tilecount="8" columns="4"/>
+ <layer id="1" name="ground" )" + dimensions + R"(>
+  <data encoding=")" + encoding + "\""
+            + (compression.empty() ? "" : " compression=\"" + compression + "\"") + R"(>
+   )" + data + R"(
+  </data>
+ </layer>
+</map>
+)";
+    }
+
+    // Parses the map, checking its tiles, and returns the allocations made.
+    long CountAllocations(int size, const std::string &encoding, const std::string &compression)
+    {
+        const auto text = MakeMap(size, encoding, compression);
+
+        const long before = allocations.load();
+        const auto map = Tmx::Map::ParseText(text);
+        const long made = allocations.load() - before;
+
+        EXPECT_FALSE(map.HasError()) << map.GetErrorText();
+        const auto layer = map.GetTileLayer(0);
+        for (int i = 0; i < size * size; ++i)
+        {
+            EXPECT_EQ(GidAt(i), layer->GetTileGid(i % size, i / size));
+            if (testing::Test::HasFailure())
+            {
+                break;
+            }
+        }
+
+        return made;
+    }
+}
+
+TEST(TmxAllocations, ConstantPerLayer)
+{
+    const std::pair<const char *, const char *> formats[] = {
+        { "base64", "" }, { "base64", "zlib" }, { "base64", "gzip" }, { "csv", "" } };
+
+    for (const auto &[encoding, compression] : formats)
+    {
+        SCOPED_TRACE(std::string{ encoding } + " " + compression);
+
+        // Once first, so that what is set up once per process is not counted.
+        CountAllocations(4, encoding, compression);
+
+        const auto small = CountAllocations(4, encoding, compression);
+        EXPECT_EQ(small, CountAllocations(64, encoding, compression));
+        EXPECT_EQ(small, CountAllocations(512, encoding, compression));
+    }
+}
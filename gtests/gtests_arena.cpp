@@ -0,0 +1,230 @@
+//-----------------------------------------------------------------------------
+// gtests_arena
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+
+namespace
+{
+    const std::string exampleFile = std::string{ TMX_EXAMPLE_DIR } + "/example.tmx";
+
+    // Counts what is allocated from it and not yet given back.
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        std::size_t allocations = 0;
+        std::size_t outstanding = 0;
+
+    private:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            ++allocations;
+            outstanding += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override
+        {
+            outstanding -= bytes;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    void ExpectSameProperties(const Tmx::PropertySet &a, const Tmx::PropertySet &b)
+    {
+        ASSERT_EQ(a.GetSize(), b.GetSize());
+        for (const auto &[name, property] : a.GetPropertyMap())
+        {
+            ASSERT_TRUE(b.HasProperty(name)) << name;
+            const auto &other = b.GetPropertyMap().at(name);
+            ASSERT_EQ(other.GetType(), property.GetType()) << name;
+            EXPECT_EQ(other.GetIntValue(), property.GetIntValue()) << name;
+            EXPECT_EQ(other.GetFloatValue(), property.GetFloatValue()) << name;
+            EXPECT_EQ(other.GetBoolValue(), property.GetBoolValue()) << name;
+            if (property.IsOfType(Tmx::TMX_PROPERTY_STRING))
+            {
+                EXPECT_EQ(other.GetValue(), property.GetValue()) << name;
+            }
+        }
+    }
+
+    void ExpectSameObjects(const Tmx::Map &a, const Tmx::Map &b)
+    {
+        ExpectSameProperties(a.GetProperties(), b.GetProperties());
+        ASSERT_EQ(a.GetNumObjectGroups(), b.GetNumObjectGroups());
+        for (int i = 0; i < a.GetNumObjectGroups(); ++i)
+        {
+            const auto &objectsA = a.GetObjectGroup(i)->GetObjects();
+            const auto &objectsB = b.GetObjectGroup(i)->GetObjects();
+            ASSERT_EQ(objectsA.size(), objectsB.size());
+            for (size_t j = 0; j < objectsA.size(); ++j)
+            {
+                const auto &objectA = objectsA[j];
+                const auto &objectB = objectsB[j];
+                EXPECT_EQ(objectA.GetName(), objectB.GetName());
+                EXPECT_EQ(objectA.GetX(), objectB.GetX());
+                EXPECT_EQ(objectA.GetEllipse() != nullptr, objectB.GetEllipse() != nullptr);
+                ExpectSameProperties(objectA.GetProperties(), objectB.GetProperties());
+
+                const auto polygonA = objectA.GetPolygon();
+                const auto polygonB = objectB.GetPolygon();
+                ASSERT_EQ(polygonA != nullptr, polygonB != nullptr);
+                if (polygonA)
+                {
+                    ASSERT_EQ(polygonA->GetNumPoints(), polygonB->GetNumPoints());
+                    for (int k = 0; k < polygonA->GetNumPoints(); ++k)
+                    {
+                        EXPECT_EQ(polygonA->GetPoint(k).x, polygonB->GetPoint(k).x);
+                        EXPECT_EQ(polygonA->GetPoint(k).y, polygonB->GetPoint(k).y);
+                    }
+                }
+
+                const auto polylineA = objectA.GetPolyline();
+                const auto polylineB = objectB.GetPolyline();
+                ASSERT_EQ(polylineA != nullptr, polylineB != nullptr);
+                if (polylineA)
+                {
+                    EXPECT_EQ(polylineA->GetNumPoints(), polylineB->GetNumPoints());
+                }
+            }
+        }
+    }
+
+    const char *jsonMap = R"({"height":1, "infinite":false, "orientation":"orthogonal",
+ "layers":[{"id":1, "name":"things", "type":"objectgroup", "objects":[
+   {"id":1, "name":"door", "x":4, "y":8, "width":16, "height":16,
+    "properties":[{"name":"locked", "type":"bool", "value":true}]},
+   {"id":2, "name":"wall", "x":0, "y":0, "polygon":[{"x":0, "y":0}, {"x":8, "y":0}, {"x":8, "y":8}]},
+   {"id":3, "name":"path", "x":0, "y":0, "polyline":[{"x":0, "y":0}, {"x":4, "y":4}]},
+   {"id":4, "name":"pond", "x":2, "y":2, "width":6, "height":4, "ellipse":true}]}],
+ "tilesets":[], "tileheight":16, "tilewidth":16, "type":"map", "version":"1.10", "width":2})";
+
+    const char *tmxMap = R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.10" orientation="orthogonal" renderorder="right-down" width="2" height="1" tilewidth="16" tileheight="16" infinite="0">
+ <objectgroup id="1" name="things">
+  <object id="1" name="door" x="4" y="8">
+   <properties>
+    <property name="locked" type="bool" value="true"/>
+   </properties>
+   <polygon points="0,0 8,0 8,8"/>
+  </object>
+ </objectgroup>
+</map>)";
+}
+
+TEST(Arena, MatchesHeapMap)
+{
+    for (const bool streaming : { false, true })
+    {
+        Tmx::ParseOptions options;
+        options.streaming = streaming;
+        Tmx::MapLoader heapLoader{ options };
+        options.arena = true;
+        Tmx::MapLoader arenaLoader{ options };
+
+        const auto heap = heapLoader.ParseFile(exampleFile);
+        const auto arena = arenaLoader.ParseFile(exampleFile);
+        ASSERT_FALSE(arena.HasError()) << arena.GetErrorText();
+        EXPECT_EQ(heap.GetMemoryResource(), std::pmr::new_delete_resource());
+        EXPECT_NE(arena.GetMemoryResource(), std::pmr::new_delete_resource());
+        ExpectSameObjects(heap, arena);
+    }
+}
+
+TEST(Arena, MatchesHeapJsonMap)
+{
+    Tmx::ParseOptions options;
+    options.arena = true;
+    Tmx::MapLoader loader{ options };
+
+    const auto heap = Tmx::Map::ParseText(std::string_view{ jsonMap });
+    const auto arena = loader.ParseText(jsonMap);
+    ASSERT_FALSE(arena.HasError()) << arena.GetErrorText();
+    ASSERT_EQ(arena.GetObjectGroup(0)->GetNumObjects(), 4);
+    ExpectSameObjects(heap, arena);
+}
+
+TEST(Arena, UsesGivenMemoryResource)
+{
+    CountingResource resource;
+    Tmx::ParseOptions options;
+    options.memoryResource = &resource;
+
+    // Given the resource wins over the arena.
+    options.arena = true;
+    Tmx::MapLoader loader{ options };
+
+    std::optional<Tmx::Map> map{ loader.ParseFile(exampleFile) };
+    ASSERT_FALSE(map->HasError()) << map->GetErrorText();
+    EXPECT_EQ(map->GetMemoryResource(), &resource);
+    EXPECT_GT(resource.allocations, 0u);
+    EXPECT_GT(resource.outstanding, 0u);
+
+    // Tiles and tilesets are shared beyond the map, so they are not in it.
+    map.reset();
+    EXPECT_EQ(resource.outstanding, 0u);
+
+    const auto again = loader.ParseFile(exampleFile);
+    ASSERT_FALSE(again.HasError()) << again.GetErrorText();
+    EXPECT_TRUE(again.GetTileset(1)->GetTile(0)->HasObjects());
+}
+
+TEST(Arena, MovedAndReloadedMapsKeepTheArena)
+{
+    Tmx::ParseOptions options;
+    options.arena = true;
+    options.trackChanges = true;
+    Tmx::MapLoader loader{ options };
+
+    auto parsed = loader.ParseText(tmxMap);
+    ASSERT_FALSE(parsed.HasError()) << parsed.GetErrorText();
+    const auto resource = parsed.GetMemoryResource();
+
+    Tmx::Map map = std::move(parsed);
+    EXPECT_EQ(map.GetMemoryResource(), resource);
+
+    std::string text = tmxMap;
+    text.replace(text.find("8,8"), 3, "9,9");
+    const auto changes = loader.ReloadText(map, text);
+    ASSERT_FALSE(changes.HasError()) << changes.errorText;
+    EXPECT_EQ(map.GetMemoryResource(), resource);
+
+    const auto polygon = map.GetObjectGroup(0)->GetObject(0).GetPolygon();
+    ASSERT_NE(polygon, nullptr);
+    EXPECT_EQ(polygon->GetPoint(2).x, 9);
+    EXPECT_TRUE(map.GetObjectGroup(0)->GetObject(0).GetProperties().GetBoolProperty("locked"));
+}
@@ -0,0 +1,256 @@
+//-----------------------------------------------------------------------------
+// gtests_async
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+
+namespace
+{
+    const std::string exampleFile = std::string{ TMX_EXAMPLE_DIR } + "/example.tmx";
+
+    // Keeps the tasks it is given until told to run them.
+    struct DeferredExecutor
+    {
+        std::vector<std::function<void()>> tasks;
+
+        Tmx::Executor Get()
+        {
+            return [this](std::function<void()> task) { tasks.push_back(std::move(task)); };
+        }
+
+        void RunAll()
+        {
+            for (auto &task : tasks)
+            {
+                task();
+            }
+            tasks.clear();
+        }
+    };
+
+    void ExpectSameMap(const Tmx::Map &a, const Tmx::Map &b)
+    {
+        ASSERT_FALSE(a.HasError()) << a.GetErrorText();
+        ASSERT_FALSE(b.HasError()) << b.GetErrorText();
+        EXPECT_EQ(a.GetNumTilesets(), b.GetNumTilesets());
+        ASSERT_EQ(a.GetNumLayers(), b.GetNumLayers());
+        for (int i = 0; i < a.GetNumLayers(); ++i)
+        {
+            EXPECT_EQ(a.GetLayer(i)->GetName(), b.GetLayer(i)->GetName());
+        }
+        ASSERT_EQ(a.GetNumTileLayers(), b.GetNumTileLayers());
+        for (int i = 0; i < a.GetNumTileLayers(); ++i)
+        {
+            const auto ta = a.GetTileLayer(i);
+            const auto tb = b.GetTileLayer(i);
+            for (int j = 0; j < ta->GetWidth() * ta->GetHeight(); ++j)
+            {
+                EXPECT_EQ(ta->GetTile(j).gid, tb->GetTile(j).gid);
+            }
+        }
+    }
+}
+
+TEST(TmxAsync, FutureMatchesParseFile)
+{
+    auto future = Tmx::Map::ParseFileAsync(exampleFile);
+    ExpectSameMap(Tmx::Map::ParseFile(exampleFile), future.get());
+}
+
+TEST(TmxAsync, CallbackRunsOnExecutor)
+{
+    DeferredExecutor executor;
+    int calls = 0;
+    Tmx::Map::ParseFileAsync(exampleFile, [&](Tmx::Map map) {
+        ++calls;
+        ExpectSameMap(Tmx::Map::ParseFile(exampleFile), map);
+    }, {}, executor.Get());
+
+    // Nothing runs until the executor says so.
+    EXPECT_EQ(calls, 0);
+    ASSERT_EQ(executor.tasks.size(), 1u);
+    executor.RunAll();
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(TmxAsync, RunsOnThreadPool)
+{
+    Tmx::ThreadPool pool{ 2 };
+    const Tmx::Executor executor = [&pool](std::function<void()> task) {
+        pool.Submit(std::move(task));
+    };
+
+    std::vector<std::future<Tmx::Map>> futures;
+    for (int i = 0; i < 4; ++i)
+    {
+        futures.push_back(Tmx::Map::ParseFileAsync(exampleFile, {}, executor));
+    }
+
+    const auto expected = Tmx::Map::ParseFile(exampleFile);
+    for (auto &future : futures)
+    {
+        ExpectSameMap(expected, future.get());
+    }
+}
+
+TEST(TmxAsync, CancelledBeforeRunning)
+{
+    DeferredExecutor executor;
+    Tmx::CancellationToken token;
+    auto future = Tmx::Map::ParseFileAsync(exampleFile, token, executor.Get());
+
+    // A copy of the token cancels the parse as well.
+    const auto copy = token;
+    copy.Cancel();
+    EXPECT_TRUE(token.IsCancelled());
+    executor.RunAll();
+
+    const auto map = future.get();
+    EXPECT_TRUE(map.HasError());
+    EXPECT_EQ(map.GetErrorCode(), Tmx::TMX_CANCELLED);
+    EXPECT_EQ(map.GetNumLayers(), 0);
+}
+
+TEST(TmxAsync, CancelWhileParsing)
+{
+    // A map large enough that the cancel usually lands in the middle of it.
+    const auto fileName =
+        (std::filesystem::path{ testing::TempDir() } / "gtests_async.tmx").string();
+    {
+        std::ofstream out{ fileName, std::ios::binary };
+        out << R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.10" orientation="orthogonal" width="256" height="256" tilewidth="16" tileheight="16">
+ <tileset firstgid="1" name="t" tilewidth="16" tileheight="16" tilecount="4" columns="2"/>
+)";
+        for (int i = 0; i < 64; ++i)
+        {
+            out << " <layer name=\"l" << i << "\" width=\"256\" height=\"256\">\n"
+                << "  <data encoding=\"csv\">";
+            for (int j = 0; j < 256 * 256; ++j)
+            {
+                out << (j ? "," : "") << j % 5;
+            }
+            out << "</data>\n </layer>\n";
+        }
+        out << "</map>\n";
+    }
+
+    Tmx::CancellationToken token;
+    std::atomic<bool> started{ false };
+    auto future = Tmx::Map::ParseFileAsync(fileName, token,
+        [&](std::function<void()> task) {
+            std::thread{ [&started, task = std::move(task)] {
+                started = true;
+                task();
+            } }.detach();
+        });
+
+    while (!started)
+    {
+        std::this_thread::yield();
+    }
+    token.Cancel();
+
+    // Either the cancel came in time, or the map is complete.
+    const auto map = future.get();
+    if (map.HasError())
+    {
+        EXPECT_EQ(map.GetErrorCode(), Tmx::TMX_CANCELLED);
+    }
+    else
+    {
+        EXPECT_EQ(map.GetNumTileLayers(), 64);
+    }
+
+    std::filesystem::remove(fileName);
+}
+
+TEST(TmxAsync, LoaderParsesOnItsThreads)
+{
+    Tmx::MapLoader loader;
+    auto a = loader.ParseFileAsync(exampleFile);
+
+    std::promise<Tmx::Map> done;
+    loader.ParseFileAsync(exampleFile, [&done](Tmx::Map map) {
+        done.set_value(std::move(map));
+    });
+
+    const auto expected = Tmx::Map::ParseFile(exampleFile);
+    ExpectSameMap(expected, a.get());
+    ExpectSameMap(expected, done.get_future().get());
+
+    Tmx::CancellationToken token;
+    token.Cancel();
+    EXPECT_EQ(loader.ParseFileAsync(exampleFile, token).get().GetErrorCode(),
+        Tmx::TMX_CANCELLED);
+}
+
+TEST(TmxAsync, CallbackMayThrow)
+{
+    std::promise<int> done;
+    Tmx::Map::ParseFileAsync(exampleFile, [&done](Tmx::Map map) {
+        done.set_value(map.GetNumLayers());
+        throw std::runtime_error{ "not handled" };
+    });
+    EXPECT_GT(done.get_future().get(), 0);
+
+    // The threads are still there for the next parse.
+    std::promise<bool> next;
+    Tmx::Map::ParseFileAsync(exampleFile, [&next](Tmx::Map map) {
+        next.set_value(map.HasError());
+    });
+    EXPECT_FALSE(next.get_future().get());
+}
+
+TEST(TmxAsync, LoaderWaitsForItsParses)
+{
+    std::atomic<int> done{ 0 };
+    {
+        Tmx::MapLoader loader;
+        for (int i = 0; i < 8; ++i)
+        {
+            loader.ParseFileAsync(exampleFile, [&done](Tmx::Map map) {
+                if (!map.HasError())
+                {
+                    ++done;
+                }
+            });
+        }
+    }
+
+    EXPECT_EQ(done, 8);
+}
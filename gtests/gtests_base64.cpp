@@ -0,0 +1,118 @@
+//-----------------------------------------------------------------------------
+// gtests_base64
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+#include "base64/base64.h"
+
+namespace
+{
+    using Tmx::Util::SimdLevel;
+
+    const SimdLevel levels[] = { SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2 };
+
+    std::string MakeBytes(size_t size, uint32_t seed)
+    {
+        std::string bytes(size, '\0');
+        for (auto &byte : bytes)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            byte = static_cast<char>(seed >> 24);
+        }
+        return bytes;
+    }
+
+    std::string Encode(const std::string &bytes)
+    {
+        return base64_encode(reinterpret_cast<const unsigned char *>(bytes.data()),
+            static_cast<unsigned>(bytes.size()));
+    }
+
+    std::string Decode(const std::string &text, SimdLevel level)
+    {
+        std::string decoded(Tmx::Util::Base64DecodedSize(text.size()), '\0');
+        decoded.resize(Tmx::Util::DecodeBase64(text, decoded.data(), level));
+        return decoded;
+    }
+}
+
+TEST(TmxBase64, DecodesEveryLengthAtEveryLevel)
+{
+    // Lengths either side of the vector block sizes, padded or not.
+    for (size_t size = 0; size < 200; ++size)
+    {
+        const auto bytes = MakeBytes(size, static_cast<uint32_t>(size));
+        const auto text = Encode(bytes);
+        for (const auto level : levels)
+        {
+            ASSERT_EQ(bytes, Decode(text, level)) << "size " << size;
+        }
+    }
+}
+
+TEST(TmxBase64, SkipsWhitespace)
+{
+    const auto bytes = MakeBytes(3000, 7);
+    const auto text = Encode(bytes);
+
+    // Wrapped at 76 columns like MIME, with a blank and a tab thrown in.
+    std::string wrapped = "\n   ";
+    for (size_t i = 0; i < text.size(); i += 76)
+    {
+        wrapped += text.substr(i, 76) + (i % 3 ? "\r\n" : " \t\n");
+    }
+
+    for (const auto level : levels)
+    {
+        EXPECT_EQ(bytes, Decode(wrapped, level));
+    }
+}
+
+TEST(TmxBase64, StopsOutsideTheAlphabet)
+{
+    const auto bytes = MakeBytes(300, 11);
+    const auto text = Encode(bytes);
+    const auto expected = base64_decode(text.substr(0, 200));
+
+    for (const auto level : levels)
+    {
+        EXPECT_EQ(expected, Decode(text.substr(0, 200) + "*" + text.substr(200), level));
+        EXPECT_EQ(expected, Decode(text.substr(0, 200) + "=" + text.substr(200), level));
+    }
+}
+
+TEST(TmxBase64, MatchesTheReferenceDecoder)
+{
+    for (const auto size : { 1, 2, 3, 1000, 4096 })
+    {
+        const auto text = Encode(MakeBytes(size, 3));
+        EXPECT_EQ(base64_decode(text), Tmx::Util::DecodeBase64(text));
+    }
+}
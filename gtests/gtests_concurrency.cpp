@@ -0,0 +1,237 @@
+//-----------------------------------------------------------------------------
+// gtests_concurrency
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+
+namespace
+{
+    const std::string exampleFile = std::string{ TMX_EXAMPLE_DIR } + "/example.tmx";
+
+    // The parse orders of the layers of a map, group children included.
+    std::vector<int> GetParseOrders(const Tmx::Map &map)
+    {
+        std::vector<int> orders;
+        const auto add = [&](auto &self, const Tmx::Layer *layer) -> void {
+            orders.push_back(layer->GetParseOrder());
+            if (layer->GetLayerType() == Tmx::TMX_LAYERTYPE_GROUP_LAYER)
+            {
+                const auto group = static_cast<const Tmx::GroupLayer *>(layer);
+                for (int i = 0; i < group->GetNumChildren(); ++i)
+                {
+                    self(self, group->GetChild(i));
+                }
+            }
+        };
+
+        for (const auto layer : map.GetLayers())
+        {
+            add(add, layer);
+        }
+
+        return orders;
+    }
+
+    // What two parses of the same file must agree on.
+    std::string Describe(const Tmx::Map &map)
+    {
+        std::string text = map.GetErrorText();
+        for (const auto order : GetParseOrders(map))
+        {
+            text += std::to_string(order) + ",";
+        }
+
+        for (const auto &group : map.GetObjectGroups())
+        {
+            for (const auto &object : group.GetObjects())
+            {
+                text += object.GetName() + "/" + object.GetType() + ";";
+            }
+        }
+
+        for (int i = 0; i < map.GetNumTileLayers(); ++i)
+        {
+            const auto layer = map.GetTileLayer(i);
+            for (int j = 0; j < layer->GetWidth() * layer->GetHeight(); ++j)
+            {
+                text += std::to_string(layer->GetTile(j).gid) + " ";
+            }
+        }
+
+        return text;
+    }
+}
+
+TEST(TmxConcurrency, ParseOrderIsCountedPerMap)
+{
+    const auto first = Tmx::Map::ParseFile(exampleFile);
+    const auto second = Tmx::Map::ParseFile(exampleFile);
+    ASSERT_FALSE(first.HasError()) << first.GetErrorText();
+
+    const auto orders = GetParseOrders(first);
+    ASSERT_FALSE(orders.empty());
+    EXPECT_EQ(orders, GetParseOrders(second));
+
+    // Group children come right after their group, so document order is 0, 1, 2...
+    std::vector<int> sorted = orders;
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t i = 0; i < sorted.size(); ++i)
+    {
+        EXPECT_EQ(sorted[i], static_cast<int>(i));
+    }
+}
+
+TEST(TmxConcurrency, IndependentParsesAgree)
+{
+    const auto expected = Describe(Tmx::Map::ParseFile(exampleFile));
+
+    // Half of the threads share a loader, with its tileset and template
+    // caches, the others parse on their own.
+    Tmx::MapLoader loader;
+    std::vector<std::string> results(8);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        threads.emplace_back([&, i] {
+            for (int run = 0; run < 10; ++run)
+            {
+                const auto map = i % 2
+                    ? loader.ParseFile(exampleFile)
+                    : Tmx::Map::ParseFile(exampleFile);
+                const auto description = Describe(map);
+                if (description != expected)
+                {
+                    results[i] = description;
+                    return;
+                }
+            }
+
+            results[i] = expected;
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const auto &result : results)
+    {
+        EXPECT_EQ(result, expected);
+    }
+}
+
+namespace
+{
+    // A 32x32 map with a layer of scattered tiles, one painted in stripes and
+    // a full one, so that TMX_STORAGE_AUTO picks each layout once.
+    std::string MakeStorageMapText()
+    {
+        std::string scattered, painted, full;
+        for (int i = 0; i < 32 * 32; ++i)
+        {
+            const auto sep = i + 1 < 32 * 32 ? "," : "";
+            scattered += std::to_string(i % 29 == 0 ? 2147483649u + i % 3 : 0u) + sep;
+            painted += std::to_string(i / 32 % 4 == 0 ? 0 : 2 + i / 128) + sep;
+            full += std::to_string(1 + i % 5) + sep;
+        }
+
+        const auto layer = [](const std::string &name, const std::string &data) {
+            return "<layer name=\"" + name + "\" width=\"32\" height=\"32\"><data encoding=\"csv\">"
+                + data + "</data></layer>";
+        };
+
+        return R"(<map version="1.0" orientation="orthogonal" width="32" height="32" tilewidth="16" tileheight="16">)"
+            R"(<tileset firstgid="1" name="a" tilewidth="16" tileheight="16" tilecount="48" columns="8"/>)"
+            + layer("scattered", scattered) + layer("painted", painted) + layer("full", full)
+            + "</map>";
+    }
+
+    // Sums up the cells of every layer through the getters that read the layout.
+    unsigned long long SumTiles(const Tmx::Map &map)
+    {
+        unsigned long long sum = 0;
+        for (const auto &layer : map.GetTileLayers())
+        {
+            for (int y = 0; y < layer.GetHeight(); ++y)
+            {
+                for (int x = 0; x < layer.GetWidth(); ++x)
+                {
+                    sum = sum * 31 + layer.GetTileGid(x, y) + layer.GetTile(x, y).id
+                        + layer.IsTileFlippedHorizontally(x, y);
+                }
+            }
+        }
+        return sum;
+    }
+}
+
+TEST(TmxConcurrency, LazyLayersOfEveryStorageDecodeOnce)
+{
+    const auto text = MakeStorageMapText();
+    const auto expected = SumTiles(Tmx::Map::ParseText(text));
+
+    for (const auto storage : { Tmx::TMX_STORAGE_TILES, Tmx::TMX_STORAGE_GIDS,
+        Tmx::TMX_STORAGE_RUNS, Tmx::TMX_STORAGE_SPARSE, Tmx::TMX_STORAGE_AUTO })
+    {
+        // The threads race to decode, and pack, every layer on first access.
+        Tmx::ParseOptions options;
+        options.lazyDecode = true;
+        options.tileStorage = storage;
+        const auto map = Tmx::MapLoader{ options }.ParseText(text);
+        ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+        std::vector<unsigned long long> sums(4);
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < sums.size(); ++i)
+        {
+            threads.emplace_back([&, i] { sums[i] = SumTiles(map); });
+        }
+
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        for (const auto sum : sums)
+        {
+            EXPECT_EQ(expected, sum) << storage;
+        }
+    }
+
+    Tmx::ParseOptions options;
+    options.tileStorage = Tmx::TMX_STORAGE_AUTO;
+    const auto map = Tmx::MapLoader{ options }.ParseText(text);
+    EXPECT_EQ(Tmx::TMX_STORAGE_SPARSE, map.GetTileLayer(0)->GetStorage());
+    EXPECT_EQ(Tmx::TMX_STORAGE_RUNS, map.GetTileLayer(1)->GetStorage());
+    EXPECT_EQ(Tmx::TMX_STORAGE_GIDS, map.GetTileLayer(2)->GetStorage());
+}
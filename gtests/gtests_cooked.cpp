@@ -0,0 +1,240 @@
+//-----------------------------------------------------------------------------
+// gtests_cooked
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+
+namespace
+{
+    const std::string exampleFile = std::string{ TMX_EXAMPLE_DIR } + "/example.tmx";
+
+    void ExpectSameLayer(const Tmx::CookedMap &cooked, const Tmx::Cooked::Layer &c,
+        const Tmx::Layer &layer)
+    {
+        SCOPED_TRACE(layer.GetName());
+        EXPECT_EQ(static_cast<std::uint32_t>(layer.GetLayerType()), c.type);
+        EXPECT_EQ(layer.GetName(), cooked.GetString(c.name));
+        EXPECT_EQ(layer.GetOffsetX(), c.offsetX);
+        EXPECT_EQ(layer.GetProperties().GetSize(),
+            static_cast<int>(cooked.GetProperties(c.properties).size()));
+
+        switch (layer.GetLayerType())
+        {
+        case Tmx::TMX_LAYERTYPE_TILE:
+        {
+            const auto &tiles = static_cast<const Tmx::TileLayer &>(layer);
+            const auto gids = cooked.GetGids(c);
+            ASSERT_EQ(static_cast<size_t>(tiles.GetWidth() * tiles.GetHeight()), gids.size());
+            for (int i = 0; i < tiles.GetWidth() * tiles.GetHeight(); ++i)
+            {
+                EXPECT_EQ(tiles.GetTile(i).gid, gids[i] & ~Tmx::FlippedDiagonallyFlag
+                    & ~Tmx::FlippedHorizontallyFlag & ~Tmx::FlippedVerticallyFlag);
+            }
+            break;
+        }
+
+        case Tmx::TMX_LAYERTYPE_OBJECTGROUP:
+        {
+            const auto &objects = static_cast<const Tmx::ObjectGroup &>(layer).GetObjects();
+            const auto cookedObjects = cooked.GetObjects(c);
+            ASSERT_EQ(objects.size(), cookedObjects.size());
+            for (size_t i = 0; i < objects.size(); ++i)
+            {
+                EXPECT_EQ(objects[i].GetId(), cookedObjects[i].id);
+                EXPECT_EQ(objects[i].GetType(), cooked.GetString(cookedObjects[i].type));
+                EXPECT_EQ(objects[i].GetX(), cookedObjects[i].x);
+                EXPECT_EQ(objects[i].GetGid(), static_cast<int>(cookedObjects[i].gid));
+                EXPECT_EQ(objects[i].IsVisible(), cookedObjects[i].visible != 0);
+            }
+            break;
+        }
+
+        case Tmx::TMX_LAYERTYPE_GROUP_LAYER:
+        {
+            const auto &group = static_cast<const Tmx::GroupLayer &>(layer);
+            const auto children = cooked.GetChildren(c);
+            ASSERT_EQ(static_cast<size_t>(group.GetNumChildren()), children.size());
+            for (int i = 0; i < group.GetNumChildren(); ++i)
+            {
+                ExpectSameLayer(cooked, children[i], *group.GetChild(i));
+            }
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+}
+
+TEST(CookedMap, RoundTripsExampleMap)
+{
+    const auto map = Tmx::Map::ParseFile(exampleFile);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    const auto data = Tmx::CookedMap::Cook(map);
+    const auto cooked = Tmx::CookedMap::FromMemory(data);
+    ASSERT_FALSE(cooked.HasError()) << cooked.GetErrorText();
+
+    const auto &header = cooked.GetHeader();
+    EXPECT_EQ(static_cast<std::uint32_t>(map.GetOrientation()), header.orientation);
+    EXPECT_EQ(map.GetWidth(), header.width);
+    EXPECT_EQ(map.GetHeight(), header.height);
+    EXPECT_EQ(map.GetTileWidth(), header.tileWidth);
+    EXPECT_EQ(map.GetNextObjectId(), header.nextObjectId);
+    EXPECT_EQ(0u, header.infinite);
+
+    const auto range = header.properties;
+    EXPECT_EQ(map.GetProperties().GetSize(), static_cast<int>(range.count));
+    ASSERT_NE(nullptr, cooked.FindProperty(range, "IntProperty"));
+    EXPECT_EQ(1234, static_cast<std::int32_t>(cooked.FindProperty(range, "IntProperty")->value));
+    EXPECT_EQ(-1234, static_cast<std::int32_t>(cooked.FindProperty(range, "NegativeIntProperty")->value));
+    EXPECT_EQ(1u, cooked.FindProperty(range, "TrueProperty")->value);
+    EXPECT_EQ(0xffffff00u, cooked.FindProperty(range, "YellowProperty")->value);
+    EXPECT_EQ("A string value", cooked.GetString(cooked.FindProperty(range, "StringProperty")->text));
+    EXPECT_EQ("torches.png", cooked.GetString(cooked.FindProperty(range, "FileProperty")->text));
+    EXPECT_EQ(1u, cooked.FindProperty(range, "EmptyProperty")->isEmpty);
+    EXPECT_EQ(nullptr, cooked.FindProperty(range, "NoSuchProperty"));
+
+    const auto tilesets = cooked.GetTilesets();
+    ASSERT_EQ(static_cast<size_t>(map.GetNumTilesets()), tilesets.size());
+    EXPECT_EQ("torches", cooked.GetString(tilesets[1].name));
+    EXPECT_EQ(49, tilesets[1].firstGid);
+    EXPECT_EQ("torches.png", cooked.GetString(tilesets[1].image));
+    EXPECT_EQ(0, cooked.FindTilesetIndex(48));
+    EXPECT_EQ(1, cooked.FindTilesetIndex(49));
+    EXPECT_EQ(1, cooked.FindTilesetIndex(Tmx::FlippedVerticallyFlag | 50));
+    EXPECT_EQ(-1, cooked.FindTilesetIndex(0));
+
+    const auto layers = cooked.GetLayers();
+    ASSERT_EQ(static_cast<size_t>(map.GetNumLayers()), layers.size());
+    for (int i = 0; i < map.GetNumLayers(); ++i)
+    {
+        ExpectSameLayer(cooked, layers[i], *map.GetLayer(i));
+    }
+
+    const auto polygons = *std::find_if(layers.begin(), layers.end(), [&](const auto &l) {
+        return cooked.GetString(l.name) == "Polygon Testing";
+    });
+    const auto objects = cooked.GetObjects(polygons);
+    ASSERT_EQ(5u, objects.size());
+    EXPECT_EQ(Tmx::Cooked::SHAPE_POLYGON, objects[0].shape);
+    ASSERT_EQ(3u, cooked.GetPoints(objects[0]).size());
+    EXPECT_EQ(51.0f, cooked.GetPoints(objects[0])[1].x);
+    EXPECT_EQ(Tmx::Cooked::SHAPE_POLYLINE, objects[2].shape);
+    EXPECT_EQ(4u, cooked.GetPoints(objects[2]).size());
+    EXPECT_EQ(Tmx::Cooked::SHAPE_TEXT, objects[4].shape);
+    EXPECT_EQ("Hello World", cooked.GetString(objects[4].text));
+}
+
+TEST(CookedMap, RoundTripsChunksAndFlipFlags)
+{
+    const auto map = Tmx::Map::ParseText(R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.0" orientation="orthogonal" width="8" height="8" tilewidth="16" tileheight="16" infinite="1">
+ <tileset firstgid="1" name="t" tilewidth="16" tileheight="16" tilecount="8" columns="4"/>
+ <layer name="ground" width="8" height="8">
+  <data encoding="csv">
+   <chunk x="4" y="0" width="2" height="2">1,0,0,2</chunk>
+   <chunk x="-2" y="0" width="2" height="2">0,0,3,0</chunk>
+   <chunk x="0" y="-2" width="2" height="2">0,2147483652,0,0</chunk>
+  </data>
+ </layer>
+</map>
+)");
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    const auto data = Tmx::CookedMap::Cook(map);
+    const auto cooked = Tmx::CookedMap::FromMemory(data);
+    ASSERT_FALSE(cooked.HasError()) << cooked.GetErrorText();
+    EXPECT_EQ(1u, cooked.GetHeader().infinite);
+
+    const auto &layer = cooked.GetLayers()[0];
+    EXPECT_EQ(2, layer.chunkWidth);
+    EXPECT_TRUE(cooked.GetGids(layer).empty());
+
+    // Row by row.
+    const auto chunks = cooked.GetChunks(layer);
+    ASSERT_EQ(3u, chunks.size());
+    EXPECT_EQ(0, chunks[0].x);
+    EXPECT_EQ(-2, chunks[0].y);
+    EXPECT_EQ(-2, chunks[1].x);
+    EXPECT_EQ(4, chunks[2].x);
+
+    EXPECT_EQ(Tmx::FlippedHorizontallyFlag | 4u, cooked.GetGids(chunks[0])[1]);
+    EXPECT_EQ(3u, cooked.GetGids(chunks[1])[2]);
+    EXPECT_EQ(2u, cooked.GetGids(chunks[2])[3]);
+}
+
+TEST(CookedMap, OpensCookedFile)
+{
+    const auto map = Tmx::Map::ParseFile(exampleFile);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    const auto data = Tmx::CookedMap::Cook(map);
+    const std::string fileName = testing::TempDir() + "example.tmxc";
+    std::ofstream(fileName, std::ios::binary).write(data.data(), data.size());
+
+    auto cooked = Tmx::CookedMap::Open(fileName);
+    ASSERT_FALSE(cooked.HasError()) << cooked.GetErrorText();
+    EXPECT_EQ(static_cast<size_t>(map.GetNumLayers()), cooked.GetLayers().size());
+
+    const auto moved = std::move(cooked);
+    EXPECT_EQ(map.GetLayer(6)->GetName(), moved.GetString(moved.GetLayers()[6].name));
+
+    std::remove(fileName.c_str());
+
+    EXPECT_TRUE(Tmx::CookedMap::Open(fileName + ".missing").HasError());
+}
+
+TEST(CookedMap, RejectsBadData)
+{
+    const auto map = Tmx::Map::ParseFile(exampleFile);
+    const auto data = Tmx::CookedMap::Cook(map);
+
+    EXPECT_TRUE(Tmx::CookedMap::FromMemory(std::string_view{}).HasError());
+
+    const std::string truncated = data.substr(0, data.size() - 4);
+    EXPECT_TRUE(Tmx::CookedMap::FromMemory(truncated).HasError());
+
+    std::string badMagic = data;
+    badMagic[0] = 'X';
+    EXPECT_TRUE(Tmx::CookedMap::FromMemory(badMagic).HasError());
+
+    std::string badVersion = data;
+    reinterpret_cast<Tmx::Cooked::Header *>(badVersion.data())->version = Tmx::Cooked::Version + 1;
+    EXPECT_TRUE(Tmx::CookedMap::FromMemory(badVersion).HasError());
+
+    std::string badRange = data;
+    reinterpret_cast<Tmx::Cooked::Header *>(badRange.data())->layers.count = 1000;
+    const auto rejected = Tmx::CookedMap::FromMemory(badRange);
+    ASSERT_TRUE(rejected.HasError());
+    EXPECT_NE(std::string::npos, rejected.GetErrorText().find("reference"));
+}
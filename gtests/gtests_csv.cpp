@@ -0,0 +1,127 @@
+//-----------------------------------------------------------------------------
+// gtests_csv
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+
+namespace
+{
+    using Tmx::Util::SimdLevel;
+
+    const SimdLevel levels[] = { SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2 };
+
+    std::vector<uint32_t> Parse(const std::string &text, SimdLevel level, size_t outSize = 1000)
+    {
+        std::vector<uint32_t> values(outSize);
+        values.resize(Tmx::Util::ParseCsv(text, values.data(), values.size(), level));
+        return values;
+    }
+
+    // What the parser did before, one strtoul per value.
+    std::vector<uint32_t> Reference(const std::string &text)
+    {
+        std::vector<uint32_t> values;
+        Tmx::Util::Iterate(text, ',', [&values](auto first, auto) {
+            values.push_back(static_cast<uint32_t>(std::strtoul(first, nullptr, 10)));
+        });
+        return values;
+    }
+}
+
+TEST(TmxCsv, MatchesStrtoulAtEveryLevel)
+{
+    // Values of every length up to flipped gids, laid out in rows as Tiled
+    // writes them.
+    uint32_t seed = 5;
+    for (int rows = 0; rows < 12; ++rows)
+    {
+        std::string text;
+        for (int row = 0; row < rows; ++row)
+        {
+            for (int column = 0; column < 7; ++column)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                const auto digits = 1 + seed % 10;
+                uint32_t value = seed >> 8;
+                for (uint32_t d = digits; d < 10; ++d)
+                {
+                    value /= 10;
+                }
+                if (digits == 10)
+                {
+                    value |= 0x80000000;
+                }
+                text += std::to_string(value);
+                text += row + 1 < rows || column < 6 ? "," : "";
+            }
+            text += "\n";
+        }
+
+        for (const auto level : levels)
+        {
+            EXPECT_EQ(Reference(text), Parse(text, level)) << text;
+        }
+    }
+}
+
+TEST(TmxCsv, SkipsWhitespaceAndReadsEmptyValuesAsZero)
+{
+    const std::string text = "\n  1, 22 ,\t333,,\r\n4444,55555,666666,7777777,88888888,999999999,\n0";
+    const std::vector<uint32_t> expected{ 1, 22, 333, 0, 4444, 55555, 666666, 7777777,
+        88888888, 999999999, 0 };
+
+    for (const auto level : levels)
+    {
+        EXPECT_EQ(expected, Parse(text, level));
+        EXPECT_EQ(std::vector<uint32_t>(expected.begin(), expected.begin() + 5),
+            Parse(text, level, 5));
+        EXPECT_TRUE(Parse("", level).empty());
+    }
+}
+
+TEST(TmxCsv, LongLayers)
+{
+    std::string text;
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < 5000; ++i)
+    {
+        expected.push_back(i % 9 == 0 ? 0 : 1 + i * 7919 % 300);
+        text += std::to_string(expected.back()) + (i % 100 == 99 ? ",\n" : ",");
+    }
+    text.pop_back();
+    text.pop_back();
+    text += "\n";
+
+    for (const auto level : levels)
+    {
+        EXPECT_EQ(expected, Parse(text, level, expected.size()));
+    }
+}
@@ -0,0 +1,289 @@
+//-----------------------------------------------------------------------------
+// gtests_decompressor
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#ifdef USE_MINIZ
+#define MINIZ_HEADER_FILE_ONLY
+#include "miniz.c"
+#else
+#include <zlib.h>
+#endif
+
+#include "Tmx.h"
+#include "base64/base64.h"
+
+namespace
+{
+    std::string Compress(const std::string &bytes, int windowBits)
+    {
+        std::string packed(compressBound(static_cast<uLong>(bytes.size())) + 32, '\0');
+
+        z_stream strm{};
+        deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+        strm.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(bytes.data()));
+        strm.avail_in = static_cast<uInt>(bytes.size());
+        strm.next_out = reinterpret_cast<Bytef *>(packed.data());
+        strm.avail_out = static_cast<uInt>(packed.size());
+        deflate(&strm, Z_FINISH);
+        packed.resize(strm.total_out);
+        deflateEnd(&strm);
+        return packed;
+    }
+
+    std::string MakeGids(int count)
+    {
+        std::string bytes;
+        for (int i = 0; i < count; ++i)
+        {
+            const uint32_t gid = 1 + i % 3;
+            bytes.append(reinterpret_cast<const char *>(&gid), sizeof gid);
+        }
+        return bytes;
+    }
+
+    // Passes everything on to the default backend, counting the calls.
+    class CountingDecompressor : public Tmx::Decompressor
+    {
+    public:
+        const char *GetName() const override { return "counting"; }
+
+        std::ptrdiff_t DecompressZlib(const void *data, size_t size,
+            void *out, size_t outSize) const override
+        {
+            ++calls;
+            return Tmx::Decompressor::GetDefault().DecompressZlib(data, size, out, outSize);
+        }
+
+        std::ptrdiff_t DecompressGzip(const void *data, size_t size,
+            void *out, size_t outSize) const override
+        {
+            ++calls;
+            return Tmx::Decompressor::GetDefault().DecompressGzip(data, size, out, outSize);
+        }
+
+        mutable std::atomic<int> calls{ 0 };
+    };
+
+    // Reads any zstd data as gid 2 in every cell, as a backend bringing its
+    // own zstd would read real data.
+    class FakeZstdDecompressor : public CountingDecompressor
+    {
+    public:
+        std::ptrdiff_t DecompressZstd(const void *, size_t, void *out, size_t outSize) const override
+        {
+            const uint32_t gid = 2;
+            for (size_t i = 0; i + sizeof gid <= outSize; i += sizeof gid)
+            {
+                std::memcpy(static_cast<char *>(out) + i, &gid, sizeof gid);
+            }
+            return static_cast<std::ptrdiff_t>(outSize);
+        }
+
+        bool CanDecompressZstd() const override { return true; }
+    };
+
+    // Runs out of memory on every layer.
+    class FailingDecompressor : public CountingDecompressor
+    {
+    public:
+        std::ptrdiff_t DecompressZlib(const void *, size_t, void *, size_t) const override
+        {
+            throw std::bad_alloc{};
+        }
+    };
+}
+
+TEST(TmxDecompressor, BuiltInBackendsDecompressWholeBuffers)
+{
+    const auto names = Tmx::Decompressor::GetNames();
+    ASSERT_FALSE(names.empty());
+    EXPECT_EQ(names.front(), Tmx::Decompressor::GetDefault().GetName());
+    EXPECT_EQ(nullptr, Tmx::Decompressor::Find("no such backend"));
+
+    const auto bytes = MakeGids(4096);
+    for (const auto name : names)
+    {
+        SCOPED_TRACE(std::string{ name });
+        const auto backend = Tmx::Decompressor::Find(name);
+        ASSERT_NE(nullptr, backend);
+
+        for (const auto windowBits : { 15, 15 + 16 })
+        {
+            const auto packed = Compress(bytes, windowBits);
+            const auto decompress = windowBits == 15
+                ? &Tmx::Decompressor::DecompressZlib
+                : &Tmx::Decompressor::DecompressGzip;
+
+            std::string out(bytes.size(), '\0');
+            EXPECT_EQ(static_cast<std::ptrdiff_t>(bytes.size()),
+                (backend->*decompress)(packed.data(), packed.size(), out.data(), out.size()));
+            EXPECT_EQ(bytes, out);
+
+            // Too little room and broken data are both errors.
+            EXPECT_EQ(-1, (backend->*decompress)(packed.data(), packed.size(),
+                out.data(), out.size() - 4));
+            EXPECT_EQ(-1, (backend->*decompress)(bytes.data(), 64, out.data(), out.size()));
+        }
+    }
+}
+
+TEST(TmxDecompressor, ParseOptionsPickTheBackend)
+{
+    const auto packed = Compress(MakeGids(16), 15);
+    const auto data = base64_encode(reinterpret_cast<const unsigned char *>(packed.data()),
+        static_cast<unsigned>(packed.size()));
+
+    const std::string text = R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.10" orientation="orthogonal" width="4" height="4" tilewidth="16" tileheight="16">
+ <tileset firstgid="1" name="tiles" tilewidth="16" tileheight="16" tilecount="4" columns="2"/>
+ <layer id="1" name="ground" width="4" height="4">
+  <data encoding="base64" compression="zlib">)" + data + R"(</data>
+ </layer>
+</map>
+)";
+
+    CountingDecompressor counting;
+    Tmx::ParseOptions options;
+    options.decompressor = &counting;
+    options.lazyDecode = true;
+
+    const auto map = Tmx::MapLoader{ options }.ParseText(text);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+    EXPECT_EQ(0, counting.calls);
+
+    const auto layer = map.GetTileLayer(0);
+    EXPECT_EQ(3u, layer->GetTileGid(2, 0));
+    EXPECT_EQ(1u, layer->GetTileGid(3, 3));
+    EXPECT_EQ(1, counting.calls);
+}
+
+TEST(TmxDecompressor, FailuresReachTheCallerOfParallelDecoding)
+{
+    const auto packed = Compress(MakeGids(16), 15);
+    const auto data = base64_encode(reinterpret_cast<const unsigned char *>(packed.data()),
+        static_cast<unsigned>(packed.size()));
+
+    std::string text = R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.10" orientation="orthogonal" width="4" height="4" tilewidth="16" tileheight="16">
+ <tileset firstgid="1" name="tiles" tilewidth="16" tileheight="16" tilecount="4" columns="2"/>
+)";
+    for (int i = 0; i < 8; ++i)
+    {
+        text += R"( <layer name="l" width="4" height="4"><data encoding="base64" compression="zlib">)"
+            + data + "</data></layer>\n";
+    }
+    text += "</map>\n";
+
+    FailingDecompressor failing;
+    Tmx::ParseOptions options;
+    options.decompressor = &failing;
+    options.decodeThreads = 3;
+
+    EXPECT_THROW(Tmx::MapLoader{ options }.ParseText(text), std::bad_alloc);
+}
+
+TEST(TmxDecompressor, ReadsZstdLayers)
+{
+    // 4x4 gids: 0 where the index is a multiple of 5, otherwise 1 + index % 3,
+    // with the eighth tile flipped horizontally.
+    const std::string data = "KLUv/SBALQEAoAAAAAACAAAAAwAAAAGAAwIAAAAABwAgCyAAAYCMIANY4Fn5Ag==";
+
+    const auto xml = Tmx::Map::ParseText(R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.10" orientation="orthogonal" width="4" height="4" tilewidth="16" tileheight="16">
+ <tileset firstgid="1" name="tiles" tilewidth="16" tileheight="16" tilecount="4" columns="2"/>
+ <layer id="1" name="ground" width="4" height="4">
+  <data encoding="base64" compression="zstd">
+   )" + data + R"(
+  </data>
+ </layer>
+</map>
+)");
+
+    const auto json = Tmx::Map::ParseText(R"({ "type":"map", "version":"1.10",
+ "orientation":"orthogonal", "width":4, "height":4, "tilewidth":16, "tileheight":16,
+ "tilesets":[ { "firstgid":1, "name":"tiles", "tilewidth":16, "tileheight":16,
+   "tilecount":4, "columns":2 } ],
+ "layers":[ { "type":"tilelayer", "id":1, "name":"ground", "width":4, "height":4,
+   "data":")" + data + R"(", "encoding":"base64", "compression":"zstd" } ] })", "zstd.tmj");
+
+    for (const auto map : { &xml, &json })
+    {
+        // Without zstd the data cannot be read, which is an error rather
+        // than an empty layer.
+        if (!Tmx::Decompressor::HasZstd())
+        {
+            EXPECT_TRUE(map->HasError());
+            EXPECT_EQ(Tmx::TMX_UNSUPPORTED_COMPRESSION, map->GetErrorCode());
+            EXPECT_EQ("layer 'ground': zstd support not built in", map->GetErrorText());
+            continue;
+        }
+
+        ASSERT_FALSE(map->HasError()) << map->GetErrorText();
+        const auto layer = map->GetTileLayer(0);
+        EXPECT_EQ(Tmx::TMX_COMPRESSION_ZSTD, layer->GetCompression());
+        for (int i = 0; i < 16; ++i)
+        {
+            EXPECT_EQ(i % 5 == 0 ? 0u : 1u + i % 3, layer->GetTileGid(i % 4, i / 4)) << "tile " << i;
+        }
+        EXPECT_TRUE(layer->IsTileFlippedHorizontally(3, 1));
+    }
+}
+
+TEST(TmxDecompressor, BackendsMayBringTheirOwnZstd)
+{
+    const std::string text = R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.10" orientation="orthogonal" width="2" height="2" tilewidth="16" tileheight="16">
+ <tileset firstgid="1" name="tiles" tilewidth="16" tileheight="16" tilecount="4" columns="2"/>
+ <group name="decals">
+  <layer id="1" name="ground" width="2" height="2">
+   <data encoding="base64" compression="zstd">KLUv/SAQgQAAAQAAAAIAAAA=</data>
+  </layer>
+ </group>
+</map>
+)";
+
+    FakeZstdDecompressor fake;
+    Tmx::ParseOptions options;
+    options.decompressor = &fake;
+    const auto map = Tmx::MapLoader{ options }.ParseText(text);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+    const auto layer = map.GetGroupLayer(0)->GetChild(0);
+    ASSERT_EQ(Tmx::TMX_LAYERTYPE_TILE, layer->GetLayerType());
+    EXPECT_EQ(2u, static_cast<const Tmx::TileLayer *>(layer)->GetTileGid(1, 1));
+
+    // Layers in groups are checked too.
+    CountingDecompressor counting;
+    options.decompressor = &counting;
+    const auto failed = Tmx::MapLoader{ options }.ParseText(text);
+    EXPECT_EQ(!Tmx::Decompressor::HasZstd(), failed.HasError());
+}
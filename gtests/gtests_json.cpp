@@ -0,0 +1,537 @@
+//-----------------------------------------------------------------------------
+// gtests_json
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+
+namespace
+{
+    const char *tmxMap = R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.10" orientation="orthogonal" renderorder="right-down" width="4" height="2"
+     tilewidth="16" tileheight="16" infinite="0" backgroundcolor="#ff102030" nextobjectid="5">
+ <properties>
+  <property name="title" value="level &quot;one&quot;"/>
+  <property name="lives" type="int" value="3"/>
+  <property name="gravity" type="float" value="9.5"/>
+  <property name="hard" type="bool" value="true"/>
+  <property name="tint" type="color" value="#ff00ff00"/>
+ </properties>
+ <tileset firstgid="1" name="terrain" tilewidth="16" tileheight="16" tilecount="8" columns="4">
+  <tileoffset x="2" y="-3"/>
+  <image source="terrain.png" width="64" height="32"/>
+  <tile id="1" type="water">
+   <properties>
+    <property name="deep" type="bool" value="true"/>
+   </properties>
+   <animation>
+    <frame tileid="1" duration="100"/>
+    <frame tileid="2" duration="150"/>
+   </animation>
+  </tile>
+ </tileset>
+ <tileset firstgid="9" name="props" tilewidth="16" tileheight="16" tilecount="4" columns="2">
+  <image source="props.png" width="32" height="32"/>
+ </tileset>
+ <layer id="1" name="ground" width="4" height="2" opacity="0.5" offsetx="3" offsety="4">
+  <data encoding="csv">1,2,0,9,2147483650,1073741833,3,4</data>
+ </layer>
+ <layer id="2" name="packed" width="4" height="2" visible="0">
+  <data encoding="base64" compression="zlib">eJxjZWBgYANidiDmYEAARiBmAmIAAsAAHg==</data>
+ </layer>
+ <objectgroup id="3" name="things" color="#a0b0c0">
+  <object id="1" name="spawn" type="start" x="10" y="20" width="16" height="16"/>
+  <object id="2" name="zone" x="5" y="6">
+   <polygon points="0,0 10,0 10,5"/>
+  </object>
+  <object id="3" name="ring" x="40" y="40" width="8" height="4">
+   <ellipse/>
+  </object>
+  <object id="4" name="sign" x="1" y="2" width="50" height="20" rotation="45">
+   <text fontfamily="serif" pixelsize="12" bold="1" halign="center" color="#ff0000">Hi "there"</text>
+  </object>
+ </objectgroup>
+ <group id="4" name="parts" offsetx="8" offsety="9">
+  <imagelayer id="5" name="sky">
+   <image source="sky.png" width="640" height="480"/>
+  </imagelayer>
+  <layer id="6" name="detail" width="4" height="2">
+   <data encoding="csv">0,0,0,0,0,0,0,10</data>
+  </layer>
+ </group>
+</map>
+)";
+
+    // The same map as Tiled writes it, with the keys in alphabetical order.
+    const char *jsonMap = R"({ "backgroundcolor":"#ff102030",
+ "compressionlevel":-1,
+ "height":2,
+ "infinite":false,
+ "layers":[
+  {"data":[1, 2, 0, 9, 2147483650, 1073741833, 3, 4],
+   "height":2, "id":1, "name":"ground", "offsetx":3, "offsety":4, "opacity":0.5,
+   "type":"tilelayer", "visible":true, "width":4, "x":0, "y":0},
+  {"compression":"zlib",
+   "data":"eJxjZWBgYANidiDmYEAARiBmAmIAAsAAHg==",
+   "encoding":"base64",
+   "height":2, "id":2, "name":"packed", "opacity":1, "type":"tilelayer",
+   "visible":false, "width":4, "x":0, "y":0},
+  {"color":"#a0b0c0", "draworder":"topdown", "id":3, "name":"things",
+   "objects":[
+    {"height":16, "id":1, "name":"spawn", "rotation":0, "type":"start",
+     "visible":true, "width":16, "x":10, "y":20},
+    {"height":0, "id":2, "name":"zone",
+     "polygon":[{"x":0, "y":0}, {"x":10, "y":0}, {"x":10, "y":5}],
+     "rotation":0, "type":"", "visible":true, "width":0, "x":5, "y":6},
+    {"ellipse":true, "height":4, "id":3, "name":"ring", "rotation":0, "type":"",
+     "visible":true, "width":8, "x":40, "y":40},
+    {"height":20, "id":4, "name":"sign", "rotation":45,
+     "text":{"bold":true, "color":"#ff0000", "fontfamily":"serif", "halign":"center",
+             "pixelsize":12, "text":"Hi \"there\""},
+     "type":"", "visible":true, "width":50, "x":1, "y":2}],
+   "opacity":1, "type":"objectgroup", "visible":true, "x":0, "y":0},
+  {"id":4,
+   "layers":[
+    {"id":5, "image":"sky.png", "imageheight":480, "imagewidth":640, "name":"sky",
+     "opacity":1, "type":"imagelayer", "visible":true, "x":0, "y":0},
+    {"data":[0, 0, 0, 0, 0, 0, 0, 10],
+     "height":2, "id":6, "name":"detail", "opacity":1, "type":"tilelayer",
+     "visible":true, "width":4, "x":0, "y":0}],
+   "name":"parts", "offsetx":8, "offsety":9, "opacity":1, "type":"group",
+   "visible":true, "x":0, "y":0}],
+ "nextlayerid":7,
+ "nextobjectid":5,
+ "orientation":"orthogonal",
+ "properties":[
+  {"name":"gravity", "type":"float", "value":9.5},
+  {"name":"hard", "type":"bool", "value":true},
+  {"name":"lives", "type":"int", "value":3},
+  {"name":"tint", "type":"color", "value":"#ff00ff00"},
+  {"name":"title", "type":"string", "value":"level \"one\""}],
+ "renderorder":"right-down",
+ "tiledversion":"1.10.2",
+ "tileheight":16,
+ "tilesets":[
+  {"columns":4, "firstgid":1, "image":"terrain.png", "imageheight":32, "imagewidth":64,
+   "margin":0, "name":"terrain", "spacing":0, "tilecount":8, "tileheight":16,
+   "tileoffset":{"x":2, "y":-3},
+   "tiles":[
+    {"animation":[{"duration":100, "tileid":1}, {"duration":150, "tileid":2}],
+     "id":1,
+     "properties":[{"name":"deep", "type":"bool", "value":true}],
+     "type":"water"}],
+   "tilewidth":16},
+  {"columns":2, "firstgid":9, "image":"props.png", "imageheight":32, "imagewidth":32,
+   "margin":0, "name":"props", "spacing":0, "tilecount":4, "tileheight":16,
+   "tilewidth":16}],
+ "tilewidth":16,
+ "type":"map",
+ "version":"1.10",
+ "width":4
+}
+)";
+
+    void WriteFile(const std::string &fileName, const char *text)
+    {
+        std::ofstream{ fileName, std::ios::binary } << text;
+    }
+
+    // Reads every value of the next one, so that all of it is checked.
+    void Walk(Tmx::JsonReader &json)
+    {
+        switch (json.Peek())
+        {
+        case Tmx::TMX_JSON_OBJECT:
+            json.ReadObject([&](const auto) { Walk(json); });
+            break;
+        case Tmx::TMX_JSON_ARRAY:
+            json.ReadArray([&] { Walk(json); });
+            break;
+        default:
+            json.Skip();
+            break;
+        }
+    }
+
+    void ExpectSameLayer(const Tmx::Layer *a, const Tmx::Layer *b)
+    {
+        SCOPED_TRACE(a->GetName());
+        ASSERT_EQ(a->GetLayerType(), b->GetLayerType());
+        EXPECT_EQ(a->GetName(), b->GetName());
+        EXPECT_EQ(a->GetWidth(), b->GetWidth());
+        EXPECT_EQ(a->GetHeight(), b->GetHeight());
+        EXPECT_EQ(a->GetOpacity(), b->GetOpacity());
+        EXPECT_EQ(a->IsVisible(), b->IsVisible());
+        EXPECT_EQ(a->GetProperties().GetSize(), b->GetProperties().GetSize());
+
+        switch (a->GetLayerType())
+        {
+        case Tmx::TMX_LAYERTYPE_TILE:
+        {
+            const auto ta = static_cast<const Tmx::TileLayer *>(a);
+            const auto tb = static_cast<const Tmx::TileLayer *>(b);
+            EXPECT_EQ(ta->GetOffsetX(), tb->GetOffsetX());
+            EXPECT_EQ(ta->GetOffsetY(), tb->GetOffsetY());
+            for (int i = 0; i < a->GetWidth() * a->GetHeight(); ++i)
+            {
+                const auto &x = ta->GetTile(i);
+                const auto &y = tb->GetTile(i);
+                EXPECT_EQ(x.gid, y.gid);
+                EXPECT_EQ(x.id, y.id);
+                EXPECT_EQ(x.tilesetId, y.tilesetId);
+                EXPECT_EQ(x.flippedHorizontally, y.flippedHorizontally);
+                EXPECT_EQ(x.flippedVertically, y.flippedVertically);
+                EXPECT_EQ(x.flippedDiagonally, y.flippedDiagonally);
+            }
+            break;
+        }
+        case Tmx::TMX_LAYERTYPE_OBJECTGROUP:
+        {
+            const auto &oa = static_cast<const Tmx::ObjectGroup *>(a)->GetObjects();
+            const auto &ob = static_cast<const Tmx::ObjectGroup *>(b)->GetObjects();
+            EXPECT_EQ(static_cast<const Tmx::ObjectGroup *>(a)->GetColor(),
+                static_cast<const Tmx::ObjectGroup *>(b)->GetColor());
+            ASSERT_EQ(oa.size(), ob.size());
+            for (size_t i = 0; i < oa.size(); ++i)
+            {
+                EXPECT_EQ(oa[i].GetId(), ob[i].GetId());
+                EXPECT_EQ(oa[i].GetName(), ob[i].GetName());
+                EXPECT_EQ(oa[i].GetType(), ob[i].GetType());
+                EXPECT_EQ(oa[i].GetX(), ob[i].GetX());
+                EXPECT_EQ(oa[i].GetY(), ob[i].GetY());
+                EXPECT_EQ(oa[i].GetWidth(), ob[i].GetWidth());
+                EXPECT_EQ(oa[i].GetHeight(), ob[i].GetHeight());
+                EXPECT_EQ(oa[i].GetRot(), ob[i].GetRot());
+                EXPECT_EQ(oa[i].GetGid(), ob[i].GetGid());
+                EXPECT_EQ(oa[i].GetEllipse() != nullptr, ob[i].GetEllipse() != nullptr);
+                EXPECT_EQ(oa[i].GetPolygon() != nullptr, ob[i].GetPolygon() != nullptr);
+                EXPECT_EQ(oa[i].GetText() != nullptr, ob[i].GetText() != nullptr);
+            }
+            break;
+        }
+        case Tmx::TMX_LAYERTYPE_IMAGE_LAYER:
+        {
+            const auto ia = static_cast<const Tmx::ImageLayer *>(a)->GetImage();
+            const auto ib = static_cast<const Tmx::ImageLayer *>(b)->GetImage();
+            ASSERT_TRUE(ia && ib);
+            EXPECT_EQ(ia->GetSource(), ib->GetSource());
+            EXPECT_EQ(ia->GetWidth(), ib->GetWidth());
+            EXPECT_EQ(ia->GetHeight(), ib->GetHeight());
+            break;
+        }
+        case Tmx::TMX_LAYERTYPE_GROUP_LAYER:
+        {
+            const auto ga = static_cast<const Tmx::GroupLayer *>(a);
+            const auto gb = static_cast<const Tmx::GroupLayer *>(b);
+            EXPECT_EQ(ga->GetOffsetX(), gb->GetOffsetX());
+            EXPECT_EQ(ga->GetOffsetY(), gb->GetOffsetY());
+            ASSERT_EQ(ga->GetNumChildren(), gb->GetNumChildren());
+            for (int i = 0; i < ga->GetNumChildren(); ++i)
+            {
+                ExpectSameLayer(ga->GetChild(i), gb->GetChild(i));
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+TEST(JsonMap, MatchesTmxMap)
+{
+    const auto tmx = Tmx::Map::ParseText(tmxMap);
+    const auto json = Tmx::Map::ParseText(jsonMap);
+    ASSERT_FALSE(tmx.HasError()) << tmx.GetErrorText();
+    ASSERT_FALSE(json.HasError()) << json.GetErrorText();
+
+    EXPECT_DOUBLE_EQ(tmx.GetVersion(), json.GetVersion());
+    EXPECT_EQ(tmx.GetOrientation(), json.GetOrientation());
+    EXPECT_EQ(tmx.GetRenderOrder(), json.GetRenderOrder());
+    EXPECT_EQ(tmx.GetWidth(), json.GetWidth());
+    EXPECT_EQ(tmx.GetHeight(), json.GetHeight());
+    EXPECT_EQ(tmx.GetTileWidth(), json.GetTileWidth());
+    EXPECT_EQ(tmx.GetNextObjectId(), json.GetNextObjectId());
+    EXPECT_EQ(tmx.GetBackgroundColor(), json.GetBackgroundColor());
+
+    const auto &tp = tmx.GetProperties();
+    const auto &jp = json.GetProperties();
+    EXPECT_EQ(tp.GetSize(), jp.GetSize());
+    EXPECT_EQ(jp.GetStringProperty("title"), "level \"one\"");
+    EXPECT_EQ(jp.GetIntProperty("lives"), tp.GetIntProperty("lives"));
+    EXPECT_EQ(jp.GetFloatProperty("gravity"), tp.GetFloatProperty("gravity"));
+    EXPECT_EQ(jp.GetBoolProperty("hard"), tp.GetBoolProperty("hard"));
+    EXPECT_EQ(jp.GetColorProperty("tint"), tp.GetColorProperty("tint"));
+
+    ASSERT_EQ(tmx.GetNumTilesets(), json.GetNumTilesets());
+    for (int i = 0; i < tmx.GetNumTilesets(); ++i)
+    {
+        const auto a = tmx.GetTileset(i);
+        const auto b = json.GetTileset(i);
+        EXPECT_EQ(a->GetName(), b->GetName());
+        EXPECT_EQ(a->GetFirstGid(), b->GetFirstGid());
+        EXPECT_EQ(a->GetTileCount(), b->GetTileCount());
+        EXPECT_EQ(a->GetColumns(), b->GetColumns());
+        EXPECT_EQ(a->GetTileOffset().GetX(), b->GetTileOffset().GetX());
+        EXPECT_EQ(a->GetTileOffset().GetY(), b->GetTileOffset().GetY());
+        EXPECT_EQ(a->GetImage()->GetSource(), b->GetImage()->GetSource());
+        EXPECT_EQ(a->GetImage()->GetWidth(), b->GetImage()->GetWidth());
+        EXPECT_EQ(a->GetTiles().size(), b->GetTiles().size());
+    }
+
+    const auto water = json.GetTileset(0)->GetTile(1);
+    ASSERT_NE(water, nullptr);
+    EXPECT_EQ(water->GetType(), "water");
+    EXPECT_TRUE(water->GetProperties().GetBoolProperty("deep"));
+    EXPECT_EQ(water->GetFrameCount(), 2);
+    EXPECT_EQ(water->GetTotalDuration(), 250u);
+
+    ASSERT_EQ(tmx.GetNumLayers(), json.GetNumLayers());
+    for (int i = 0; i < tmx.GetNumLayers(); ++i)
+    {
+        ExpectSameLayer(tmx.GetLayer(i), json.GetLayer(i));
+    }
+}
+
+TEST(JsonMap, ReadsTileFlagsAndCompressedData)
+{
+    const auto map = Tmx::Map::ParseText(jsonMap);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    const auto &ground = map.GetTileLayers()[0];
+    EXPECT_EQ(ground.GetOffsetX(), 3.0f);
+    EXPECT_EQ(ground.GetTileGid(3, 0), 9u);
+    EXPECT_EQ(ground.GetTileTilesetIndex(3, 0), 1);
+    EXPECT_TRUE(ground.GetTile(0, 1).flippedHorizontally);
+    EXPECT_EQ(ground.GetTileGid(0, 1), 2u);
+    EXPECT_TRUE(ground.GetTile(1, 1).flippedVertically);
+    EXPECT_EQ(ground.GetTileId(1, 1), 0u);
+
+    const auto &packed = map.GetTileLayers()[1];
+    EXPECT_EQ(packed.GetEncoding(), Tmx::TMX_ENCODING_BASE64);
+    EXPECT_EQ(packed.GetCompression(), Tmx::TMX_COMPRESSION_ZLIB);
+    EXPECT_FALSE(packed.IsVisible());
+    EXPECT_EQ(packed.GetTileGid(0, 0), 5u);
+    EXPECT_EQ(packed.GetTileGid(3, 1), 2u);
+
+    const auto &objects = map.GetObjectGroups()[0].GetObjects();
+    ASSERT_EQ(objects.size(), 4u);
+    ASSERT_NE(objects[1].GetPolygon(), nullptr);
+    EXPECT_EQ(objects[1].GetPolygon()->GetNumPoints(), 3);
+    EXPECT_EQ(objects[1].GetPolygon()->GetPoint(2).y, 5.0f);
+    ASSERT_NE(objects[2].GetEllipse(), nullptr);
+    EXPECT_EQ(objects[2].GetEllipse()->GetRadiusX(), 4);
+    const auto text = objects[3].GetText();
+    ASSERT_NE(text, nullptr);
+    EXPECT_EQ(text->GetContents(), "Hi \"there\"");
+    EXPECT_EQ(text->GetFontFamily(), "serif");
+    EXPECT_EQ(text->GetPixelSize(), 12);
+    EXPECT_TRUE(text->IsBold());
+    EXPECT_EQ(text->GetHorizontalAlignment(), Tmx::HCENTER);
+}
+
+TEST(JsonMap, MatchesInfiniteTmxMap)
+{
+    const auto tmx = Tmx::Map::ParseText(R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.10" orientation="orthogonal" width="4" height="2" tilewidth="16"
+     tileheight="16" infinite="1">
+ <tileset firstgid="1" name="t" tilewidth="16" tileheight="16" tilecount="4" columns="2"/>
+ <layer id="1" name="inf" width="4" height="2">
+  <data encoding="csv">
+   <chunk x="-2" y="0" width="2" height="2">1,2,3,4</chunk>
+   <chunk x="0" y="0" width="2" height="2">0,4,0,2</chunk>
+  </data>
+ </layer>
+</map>
+)");
+    const auto json = Tmx::Map::ParseText(R"({"height":2, "infinite":true,
+ "layers":[
+  {"chunks":[
+    {"data":[1, 2, 3, 4], "height":2, "width":2, "x":-2, "y":0},
+    {"data":[0, 4, 0, 2], "height":2, "width":2, "x":0, "y":0}],
+   "height":2, "id":1, "name":"inf", "opacity":1, "startx":-2, "starty":0,
+   "type":"tilelayer", "visible":true, "width":4, "x":0, "y":0}],
+ "orientation":"orthogonal", "tileheight":16,
+ "tilesets":[{"columns":2, "firstgid":1, "name":"t", "tilecount":4, "tileheight":16,
+              "tilewidth":16}],
+ "tilewidth":16, "type":"map", "version":"1.10", "width":4})");
+    ASSERT_FALSE(tmx.HasError()) << tmx.GetErrorText();
+    ASSERT_FALSE(json.HasError()) << json.GetErrorText();
+
+    EXPECT_TRUE(json.IsInfinite());
+    const auto &a = tmx.GetTileLayers()[0];
+    const auto &b = json.GetTileLayers()[0];
+    EXPECT_TRUE(b.IsChunked());
+    EXPECT_EQ(a.GetNumChunks(), b.GetNumChunks());
+    for (int y = -1; y < 3; ++y)
+    {
+        for (int x = -3; x < 3; ++x)
+        {
+            const auto ta = a.FindTile(x, y);
+            const auto tb = b.FindTile(x, y);
+            ASSERT_EQ(ta.has_value(), tb.has_value()) << x << "," << y;
+            if (ta)
+            {
+                EXPECT_EQ(ta->gid, tb->gid) << x << "," << y;
+            }
+        }
+    }
+    EXPECT_EQ(b.FindTile(-2, 0)->gid, 1u);
+    EXPECT_EQ(b.FindTile(1, 1)->gid, 2u);
+}
+
+TEST(JsonMap, LoadsExternalJsonTilesets)
+{
+    const auto directory = std::filesystem::path{ testing::TempDir() };
+    const auto tilesetFile = (directory / "gtests_json.tsj").string();
+    const auto mapFile = (directory / "gtests_json.tmj").string();
+    const auto tmxFile = (directory / "gtests_json.tmx").string();
+
+    WriteFile(tilesetFile, R"({"columns":4, "image":"ext.png", "imageheight":64,
+ "imagewidth":64, "margin":1, "name":"ext", "spacing":2, "tilecount":16,
+ "tileheight":16, "tilewidth":16, "type":"tileset", "version":"1.10"})");
+    WriteFile(mapFile, R"({"height":1, "infinite":false,
+ "layers":[{"data":[3, 0], "height":1, "id":1, "name":"l", "type":"tilelayer",
+            "width":2, "x":0, "y":0}],
+ "orientation":"orthogonal", "tileheight":16,
+ "tilesets":[{"firstgid":1, "source":"gtests_json.tsj"}],
+ "tilewidth":16, "type":"map", "width":2})");
+    WriteFile(tmxFile, R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.10" orientation="orthogonal" width="2" height="1" tilewidth="16" tileheight="16">
+ <tileset firstgid="1" source="gtests_json.tsj"/>
+ <layer id="1" name="l" width="2" height="1"><data encoding="csv">3,0</data></layer>
+</map>
+)");
+
+    for (const auto &file : { mapFile, tmxFile })
+    {
+        SCOPED_TRACE(file);
+        const auto map = Tmx::Map::ParseFile(file);
+        ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+        ASSERT_EQ(map.GetNumTilesets(), 1);
+        const auto tileset = map.GetTileset(0);
+        EXPECT_EQ(tileset->GetName(), "ext");
+        EXPECT_EQ(tileset->GetMargin(), 1);
+        EXPECT_EQ(tileset->GetSpacing(), 2);
+        EXPECT_EQ(tileset->GetTileCount(), 16);
+        EXPECT_EQ(tileset->GetImage()->GetSource(), "ext.png");
+        EXPECT_EQ(map.GetTileLayers()[0].GetTileId(0, 0), 2u);
+    }
+
+    std::filesystem::remove(tilesetFile);
+    std::filesystem::remove(mapFile);
+    std::filesystem::remove(tmxFile);
+}
+
+TEST(JsonMap, ReportsMalformedText)
+{
+    const auto truncated = Tmx::Map::ParseText(R"({"width":4, "layers":[{"data":[1, 2)");
+    EXPECT_TRUE(truncated.HasError());
+    EXPECT_EQ(truncated.GetErrorCode(), Tmx::TMX_PARSING_ERROR);
+    EXPECT_NE(truncated.GetErrorText().find("json"), std::string::npos);
+
+    EXPECT_TRUE(Tmx::Map::ParseText(R"({"width":4} 12)").HasError());
+    EXPECT_TRUE(Tmx::Map::ParseText(R"({"width":4,})").HasError());
+    EXPECT_FALSE(Tmx::Map::ParseText("  {}\n").HasError());
+}
+
+TEST(JsonReader, ReadsValues)
+{
+    Tmx::JsonReader json{ R"({"s":"a\"b\\c\né😀", "i":-42, "f":3.5e2,
+        "t":7.9, "u":4294967295, "b":false, "n":null, "skip":{"x":[1, {"y":"}"}]},
+        "last":"end"})" };
+
+    std::string s, last;
+    int i = 0, t = 0;
+    double f = 0;
+    unsigned u = 0;
+    bool b = true;
+    json.ReadObject([&](const auto key) {
+        if (key == "s") {
+            s = json.ReadString();
+        }
+        else if (key == "i") {
+            i = json.ReadInt();
+        }
+        else if (key == "f") {
+            f = json.ReadDouble();
+        }
+        else if (key == "t") {
+            t = json.ReadInt();
+        }
+        else if (key == "u") {
+            u = json.ReadUnsigned();
+        }
+        else if (key == "b") {
+            b = json.ReadBool();
+        }
+        else if (key == "n") {
+            EXPECT_EQ(json.Peek(), Tmx::TMX_JSON_NULL);
+        }
+        else if (key == "last") {
+            last = json.ReadString();
+        }
+    });
+
+    ASSERT_FALSE(json.HasError()) << json.GetErrorText();
+    EXPECT_TRUE(json.AtEnd());
+    EXPECT_EQ(s, "a\"b\\c\n\xC3\xA9\xF0\x9F\x98\x80");
+    EXPECT_EQ(i, -42);
+    EXPECT_EQ(f, 350.0);
+    EXPECT_EQ(t, 7);
+    EXPECT_EQ(u, 4294967295u);
+    EXPECT_FALSE(b);
+    EXPECT_EQ(last, "end");
+}
+
+TEST(JsonReader, FindsStringsWithoutConsuming)
+{
+    Tmx::JsonReader json{ R"({"data":[1, 2], "nested":{"type":"no"}, "type":"tilelayer"})" };
+
+    EXPECT_EQ(json.FindString("type"), "tilelayer");
+    EXPECT_EQ(json.FindString("missing"), "");
+    EXPECT_EQ(json.Peek(), Tmx::TMX_JSON_OBJECT);
+
+    int count = 0;
+    json.ReadObject([&](const auto) { ++count; });
+    EXPECT_EQ(count, 3);
+    EXPECT_FALSE(json.HasError());
+}
+
+TEST(JsonReader, ReportsErrors)
+{
+    for (const auto text : { "[1,]", R"({"a" 1})", R"(["open)", "[1 2]", "{\"a\":tru}", "-" })
+    {
+        SCOPED_TRACE(text);
+        Tmx::JsonReader json{ text };
+        Walk(json);
+        EXPECT_TRUE(json.HasError());
+        EXPECT_EQ(json.ReadInt(), 0);
+    }
+}
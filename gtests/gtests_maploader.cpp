@@ -0,0 +1,556 @@
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+#include "base64/base64.h"
+
+namespace
+{
+    const auto tilesetText = R"(<?xml version="1.0" encoding="UTF-8"?>
+<tileset version="1.8" name="shared" tilewidth="16" tileheight="16" tilecount="4" columns="2">
+ <tile id="1">
+  <properties>
+   <property name="solid" type="bool" value="true"/>
+  </properties>
+ </tile>
+</tileset>
+)";
+
+    std::string MakeMapText(int firstGid)
+    {
+        return R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.0" orientation="orthogonal" width="2" height="1" tilewidth="16" tileheight="16">
+ <tileset firstgid=")" + std::to_string(firstGid) + R"(" source="shared.tsx"/>
+ <layer name="ground" width="2" height="1">
+  <data encoding="csv">)" + std::to_string(firstGid) + "," + std::to_string(firstGid + 1) +
+            R"(</data>
+ </layer>
+</map>
+)";
+    }
+
+    const auto templateText = R"(<?xml version="1.0" encoding="UTF-8"?>
+<template>
+ <object name="enemy" type="slime" width="16" height="12">
+  <ellipse/>
+ </object>
+</template>
+)";
+
+    const auto templatedMapText = R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.0" orientation="orthogonal" width="2" height="1" tilewidth="16" tileheight="16">
+ <objectgroup name="objects">
+  <object id="1" template="enemy.tx" x="10" y="20"/>
+  <object id="2" template="enemy.tx" name="boss" x="30" y="40">
+   <polygon points="0,0 1,1 2,0"/>
+  </object>
+  <object id="3" template="missing.tx" x="1" y="2"/>
+ </objectgroup>
+</map>
+)";
+
+    std::string MakeLayeredMapText()
+    {
+        const auto width = 16;
+        const auto height = 8;
+
+        std::string text = R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.0" orientation="orthogonal" width="16" height="8" tilewidth="16" tileheight="16">
+ <tileset firstgid="1" name="a" tilewidth="16" tileheight="16" tilecount="10" columns="5"/>
+ <tileset firstgid="11" name="b" tilewidth="16" tileheight="16" tilecount="10" columns="5"/>
+)";
+
+        for (int layer = 0; layer < 6; ++layer)
+        {
+            std::vector<unsigned> gids;
+            for (int i = 0; i < width * height; ++i)
+            {
+                gids.push_back((i * (layer + 3)) % 21 | (i % 7 == 0 ? 0x80000000u : 0u));
+            }
+
+            std::string data;
+            if (layer % 2 == 0)
+            {
+                data = "<data encoding=\"base64\">" + base64_encode(
+                    reinterpret_cast<const unsigned char *>(gids.data()),
+                    gids.size() * sizeof(unsigned)) + "</data>";
+            }
+            else
+            {
+                data = "<data encoding=\"csv\">";
+                for (const auto gid : gids)
+                {
+                    data += std::to_string(gid) + ",";
+                }
+                data.back() = '<';
+                data += "/data>";
+            }
+
+            const auto layerText = "<layer name=\"l" + std::to_string(layer) +
+                "\" width=\"16\" height=\"8\">" + data + "</layer>\n";
+
+            text += layer == 3
+                ? "<group name=\"g\"><objectgroup name=\"o\"/>" + layerText + "</group>\n"
+                : layerText;
+        }
+
+        return text + "</map>";
+    }
+
+    class TmxMapLoader : public testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            // A directory of its own, as ctest may run the tests of both
+            // test programs side by side.
+            directory = std::filesystem::temp_directory_path()
+                / ("tmx_maploader_" + std::to_string(std::random_device{}()));
+            std::filesystem::create_directories(directory);
+            std::ofstream{ directory / "shared.tsx" } << tilesetText;
+            std::ofstream{ directory / "enemy.tx" } << templateText;
+            path = directory.string() + "/";
+        }
+
+        void TearDown() override
+        {
+            std::filesystem::remove_all(directory);
+        }
+
+        std::filesystem::path directory;
+        std::string path;
+    };
+}
+
+TEST_F(TmxMapLoader, SharesExternalTilesets)
+{
+    Tmx::MapLoader loader;
+
+    const auto a = loader.ParseText(MakeMapText(1), path);
+    const auto b = loader.ParseText(MakeMapText(5), path);
+
+    ASSERT_FALSE(a.HasError()) << a.GetErrorText();
+    ASSERT_FALSE(b.HasError()) << b.GetErrorText();
+    EXPECT_EQ(1u, loader.GetTilesetCacheMisses());
+    EXPECT_EQ(1u, loader.GetTilesetCacheHits());
+
+    // The first gid belongs to the map, everything else is shared.
+    EXPECT_EQ(1, a.GetTileset(0)->GetFirstGid());
+    EXPECT_EQ(5, b.GetTileset(0)->GetFirstGid());
+    EXPECT_EQ("shared", b.GetTileset(0)->GetName());
+    EXPECT_EQ(&a.GetTileset(0)->GetTiles(), &b.GetTileset(0)->GetTiles());
+    EXPECT_TRUE(b.GetTileset(0)->GetTile(1)->GetProperties().GetBoolProperty("solid"));
+
+    EXPECT_EQ(1u, b.GetTileLayer(0)->GetTileId(1, 0));
+    EXPECT_EQ(0, b.GetTileLayer(0)->GetTileTilesetIndex(1, 0));
+}
+
+TEST_F(TmxMapLoader, ReloadsModifiedTilesets)
+{
+    Tmx::MapLoader loader;
+    loader.ParseText(MakeMapText(1), path);
+
+    const auto tsx = directory / "shared.tsx";
+    std::filesystem::last_write_time(tsx,
+        std::filesystem::last_write_time(tsx) + std::chrono::seconds{ 10 });
+
+    const auto map = loader.ParseText(MakeMapText(1), path);
+    EXPECT_EQ(2u, loader.GetTilesetCacheMisses());
+    EXPECT_EQ(0u, loader.GetTilesetCacheHits());
+    EXPECT_EQ("shared", map.GetTileset(0)->GetName());
+}
+
+TEST_F(TmxMapLoader, ClearCache)
+{
+    Tmx::MapLoader loader;
+    const auto map = loader.ParseText(MakeMapText(1), path);
+    loader.ClearCache();
+    loader.ParseText(MakeMapText(1), path);
+
+    EXPECT_EQ(2u, loader.GetTilesetCacheMisses());
+    EXPECT_EQ("shared", map.GetTileset(0)->GetName());
+}
+
+TEST_F(TmxMapLoader, MissingTileset)
+{
+    Tmx::MapLoader loader;
+    const auto map = loader.ParseText(MakeMapText(1), path + "missing/");
+
+    ASSERT_FALSE(map.HasError());
+    EXPECT_EQ(0u, loader.GetTilesetCacheMisses());
+    EXPECT_EQ("", map.GetTileset(0)->GetName());
+}
+
+TEST_F(TmxMapLoader, SharesTemplates)
+{
+    Tmx::MapLoader loader;
+
+    const auto a = loader.ParseText(templatedMapText, path);
+    const auto b = loader.ParseText(templatedMapText, path);
+    ASSERT_FALSE(a.HasError()) << a.GetErrorText();
+
+    // The missing template is not cached.
+    const auto &cache = *loader.GetTemplateCache();
+    EXPECT_EQ(1u, cache.GetSize());
+    EXPECT_EQ(1u, cache.GetMisses());
+    EXPECT_EQ(3u, cache.GetHits());
+
+    const auto &enemy = a.GetObjectGroup(0)->GetObject(0);
+    EXPECT_EQ("enemy", enemy.GetName());
+    EXPECT_EQ("slime", enemy.GetType());
+    EXPECT_EQ(10, enemy.GetX());
+    EXPECT_EQ(16, enemy.GetWidth());
+    ASSERT_NE(nullptr, enemy.GetTemplate());
+    ASSERT_NE(nullptr, enemy.GetEllipse());
+    EXPECT_EQ(nullptr, enemy.GetPolygon());
+
+    // Both maps point at the very same template object.
+    const auto &other = b.GetObjectGroup(0)->GetObject(0);
+    EXPECT_EQ(enemy.GetTemplate(), other.GetTemplate());
+    EXPECT_EQ(enemy.GetEllipse(), other.GetEllipse());
+
+    const auto &boss = a.GetObjectGroup(0)->GetObject(1);
+    EXPECT_EQ("boss", boss.GetName());
+    EXPECT_EQ("slime", boss.GetType());
+    EXPECT_NE(nullptr, boss.GetEllipse());
+    EXPECT_NE(nullptr, boss.GetPolygon());
+
+    const auto &missing = a.GetObjectGroup(0)->GetObject(2);
+    EXPECT_EQ(nullptr, missing.GetTemplate());
+    EXPECT_EQ(1, missing.GetX());
+}
+
+TEST_F(TmxMapLoader, TemplateCacheOutlivesLoader)
+{
+    const auto cache = std::make_shared<Tmx::TemplateCache>();
+
+    {
+        Tmx::MapLoader loader{ cache };
+        loader.ParseText(templatedMapText, path);
+    }
+
+    Tmx::MapLoader loader{ cache };
+    const auto map = loader.ParseText(templatedMapText, path);
+
+    EXPECT_EQ(1u, cache->GetMisses());
+    EXPECT_EQ(&map.GetTemplates(), cache.get());
+    EXPECT_EQ("enemy", map.GetObjectGroup(0)->GetObject(0).GetName());
+}
+
+TEST_F(TmxMapLoader, ReloadsModifiedTemplates)
+{
+    Tmx::MapLoader loader;
+    const auto first = loader.ParseText(templatedMapText, path);
+    EXPECT_EQ(nullptr, first.GetObjectGroup(0)->GetObject(2).GetTemplate());
+
+    // An edited template is parsed again, a new one is found.
+    std::string edited = templateText;
+    edited.replace(edited.find("slime"), 5, "snail");
+    const auto tx = directory / "enemy.tx";
+    std::ofstream{ tx } << edited;
+    std::filesystem::last_write_time(tx,
+        std::filesystem::last_write_time(tx) + std::chrono::seconds{ 10 });
+    std::filesystem::copy_file(tx, directory / "missing.tx");
+
+    const auto map = loader.ParseText(templatedMapText, path);
+    const auto &cache = *loader.GetTemplateCache();
+    EXPECT_EQ(3u, cache.GetMisses());
+    EXPECT_EQ(2u, cache.GetSize());
+    EXPECT_EQ("snail", map.GetObjectGroup(0)->GetObject(0).GetType());
+    EXPECT_EQ("slime", first.GetObjectGroup(0)->GetObject(0).GetType());
+    EXPECT_NE(nullptr, map.GetObjectGroup(0)->GetObject(2).GetTemplate());
+}
+
+TEST_F(TmxMapLoader, ConcurrentTemplateLookups)
+{
+    Tmx::TemplateCache cache;
+    const auto fileName = path + "enemy.tx";
+
+    std::vector<std::thread> threads;
+    std::vector<const Tmx::Object *> seen(4);
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&, i] {
+            for (int j = 0; j < 64; ++j)
+            {
+                seen[i] = cache.FindOrLoad(fileName).get();
+            }
+        });
+    }
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    ASSERT_NE(nullptr, seen[0]);
+    EXPECT_EQ("slime", seen[0]->GetType());
+    EXPECT_EQ(1u, cache.GetSize());
+    EXPECT_EQ(256u, cache.GetHits() + cache.GetMisses());
+    for (const auto s : seen)
+    {
+        EXPECT_EQ(seen[0], s);
+    }
+}
+
+TEST(TmxMapLoaderOptions, ParallelDecodeMatchesSequential)
+{
+    const auto text = MakeLayeredMapText();
+    const auto expected = Tmx::Map::ParseText(text);
+
+    Tmx::ParseOptions options;
+    options.decodeThreads = 4;
+    Tmx::MapLoader loader{ options };
+    ASSERT_NE(nullptr, loader.GetThreadPool());
+
+    const auto map = loader.ParseText(text);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+    ASSERT_EQ(expected.GetNumLayers(), map.GetNumLayers());
+    ASSERT_EQ(5, map.GetNumTileLayers());
+
+    const auto compare = [](const Tmx::TileLayer *a, const Tmx::TileLayer *b) {
+        ASSERT_EQ(a->GetName(), b->GetName());
+        for (int y = 0; y < a->GetHeight(); ++y)
+        {
+            for (int x = 0; x < a->GetWidth(); ++x)
+            {
+                EXPECT_EQ(a->GetTileGid(x, y), b->GetTileGid(x, y));
+                EXPECT_EQ(a->GetTileId(x, y), b->GetTileId(x, y));
+                EXPECT_EQ(a->GetTileTilesetIndex(x, y), b->GetTileTilesetIndex(x, y));
+                EXPECT_EQ(a->IsTileFlippedHorizontally(x, y),
+                    b->IsTileFlippedHorizontally(x, y));
+            }
+        }
+    };
+
+    for (int i = 0; i < map.GetNumTileLayers(); ++i)
+    {
+        compare(expected.GetTileLayer(i), map.GetTileLayer(i));
+    }
+
+    // Relative parse order is kept, including the layer nested in the group.
+    for (int i = 1; i < map.GetNumTileLayers(); ++i)
+    {
+        EXPECT_LT(map.GetTileLayer(i - 1)->GetParseOrder(), map.GetTileLayer(i)->GetParseOrder());
+    }
+
+    const auto group = map.GetGroupLayer(0);
+    ASSERT_EQ(2, group->GetNumChildren());
+    EXPECT_LT(map.GetTileLayer(2)->GetParseOrder(), group->GetParseOrder());
+    EXPECT_LT(group->GetParseOrder(), map.GetTileLayer(3)->GetParseOrder());
+    compare(static_cast<const Tmx::TileLayer *>(expected.GetGroupLayer(0)->GetChild(1)),
+        static_cast<const Tmx::TileLayer *>(group->GetChild(1)));
+}
+
+TEST_F(TmxMapLoader, ParseFilesShareTilesets)
+{
+    // A tileset slow enough to parse that the maps get to it together.
+    {
+        std::ofstream tsx{ directory / "shared.tsx" };
+        tsx << R"(<tileset name="shared" tilewidth="16" tileheight="16" )"
+            << R"(tilecount="5000" columns="100">)";
+        for (int i = 0; i < 5000; ++i)
+        {
+            tsx << "<tile id=\"" << i << "\"><properties>"
+                << R"(<property name="solid" type="bool" value="true"/>)"
+                << "</properties></tile>";
+        }
+        tsx << "</tileset>";
+    }
+
+    std::vector<std::string> fileNames;
+    for (int i = 0; i < 16; ++i)
+    {
+        fileNames.push_back(path + "map" + std::to_string(i) + ".tmx");
+        std::ofstream{ fileNames.back() } << MakeMapText(1);
+    }
+
+    // Maps parsed side by side all miss at first; one tileset is kept.
+    for (int round = 0; round < 4; ++round)
+    {
+        Tmx::MapLoader loader;
+        const auto maps = loader.ParseFiles(fileNames);
+
+        EXPECT_EQ(1u, loader.GetTilesetCacheMisses());
+        EXPECT_EQ(fileNames.size() - 1, loader.GetTilesetCacheHits());
+        for (const auto &map : maps)
+        {
+            ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+            EXPECT_EQ(&maps[0].GetTileset(0)->GetTiles(), &map.GetTileset(0)->GetTiles());
+        }
+    }
+}
+
+TEST_F(TmxMapLoader, ParseFilesKeepsInputOrder)
+{
+    std::vector<std::string> fileNames;
+    for (int i = 0; i < 12; ++i)
+    {
+        fileNames.push_back(path + "map" + std::to_string(i) + ".tmx");
+        std::ofstream{ fileNames.back() } << MakeMapText(i + 1);
+    }
+    fileNames.insert(fileNames.begin() + 5, path + "missing.tmx");
+
+    Tmx::MapLoader loader;
+    const auto maps = loader.ParseFiles(fileNames);
+    ASSERT_EQ(fileNames.size(), maps.size());
+
+    EXPECT_TRUE(maps[5].HasError());
+
+    for (std::size_t i = 0; i < maps.size(); ++i)
+    {
+        if (i == 5)
+        {
+            continue;
+        }
+
+        const auto &map = maps[i];
+        ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+        const auto firstGid = static_cast<int>(i < 5 ? i + 1 : i);
+        ASSERT_EQ(1, map.GetNumTilesets());
+        EXPECT_EQ(firstGid, map.GetTileset(0)->GetFirstGid());
+        EXPECT_EQ(firstGid, map.GetTileLayer(0)->GetTileGid(0, 0));
+        EXPECT_EQ(&map, map.GetTileLayer(0)->mapGetMap());
+    }
+
+    EXPECT_EQ(1u, loader.GetTilesetCacheMisses());
+    EXPECT_EQ(11u, loader.GetTilesetCacheHits());
+}
+
+TEST(TmxMapLoaderOptions, MovedMapKeepsLayers)
+{
+    auto map = Tmx::Map::ParseText(MakeLayeredMapText());
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    const auto moved = std::move(map);
+    for (const auto layer : moved.GetLayers())
+    {
+        EXPECT_EQ(&moved, layer->mapGetMap());
+    }
+
+    const auto group = moved.GetGroupLayer(0);
+    for (int i = 0; i < group->GetNumChildren(); ++i)
+    {
+        EXPECT_EQ(&moved, group->GetChild(i)->mapGetMap());
+    }
+}
+
+TEST(TmxMapLoaderOptions, LazyDecodeMatchesEager)
+{
+    const auto text = MakeLayeredMapText();
+    const auto expected = Tmx::Map::ParseText(text);
+
+    Tmx::ParseOptions options;
+    options.lazyDecode = true;
+    Tmx::MapLoader loader{ options };
+
+    const auto map = loader.ParseText(text);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+    ASSERT_EQ(expected.GetNumTileLayers(), map.GetNumTileLayers());
+
+    for (int i = 0; i < map.GetNumTileLayers(); ++i)
+    {
+        const auto a = expected.GetTileLayer(i);
+        const auto b = map.GetTileLayer(i);
+        EXPECT_TRUE(a->IsDecoded());
+        EXPECT_FALSE(b->IsDecoded());
+
+        for (int y = 0; y < a->GetHeight(); ++y)
+        {
+            for (int x = 0; x < a->GetWidth(); ++x)
+            {
+                EXPECT_EQ(a->GetTileGid(x, y), b->GetTileGid(x, y));
+                EXPECT_EQ(a->GetTileTilesetIndex(x, y), b->GetTileTilesetIndex(x, y));
+                EXPECT_EQ(a->IsTileFlippedHorizontally(x, y), b->IsTileFlippedHorizontally(x, y));
+            }
+        }
+
+        EXPECT_TRUE(b->IsDecoded());
+    }
+}
+
+TEST(TmxMapLoaderOptions, LazyDecodeRelease)
+{
+    Tmx::ParseOptions options;
+    options.lazyDecode = true;
+    Tmx::MapLoader loader{ options };
+
+    const auto map = loader.ParseText(R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.0" orientation="orthogonal" width="2" height="1" tilewidth="16" tileheight="16">
+ <tileset firstgid="1" name="t" tilewidth="16" tileheight="16" tilecount="4" columns="2"/>
+ <layer name="xml" width="2" height="1">
+  <data><tile gid="3"/><tile gid="2147483652"/></data>
+ </layer>
+</map>
+)");
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    const auto layer = map.GetTileLayer(0);
+    EXPECT_EQ(Tmx::TMX_ENCODING_XML, layer->GetEncoding());
+    EXPECT_FALSE(layer->IsDecoded());
+
+    layer->Decode();
+    EXPECT_TRUE(layer->IsDecoded());
+    EXPECT_EQ(3u, layer->GetTileGid(0, 0));
+
+    layer->Release();
+    EXPECT_FALSE(layer->IsDecoded());
+
+    EXPECT_EQ(3u, layer->GetTileId(1, 0));
+    EXPECT_TRUE(layer->IsTileFlippedHorizontally(1, 0));
+    EXPECT_TRUE(layer->IsDecoded());
+}
+
+TEST(TmxMapLoaderOptions, LazyDecodeConcurrentFirstAccess)
+{
+    const auto text = MakeLayeredMapText();
+    const auto expected = Tmx::Map::ParseText(text);
+
+    Tmx::ParseOptions options;
+    options.lazyDecode = true;
+    const auto map = Tmx::MapLoader{ options }.ParseText(text);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    std::vector<std::thread> threads;
+    std::vector<unsigned> sums(4);
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < map.GetNumTileLayers(); ++i)
+            {
+                const auto layer = map.GetTileLayer(i);
+                for (int j = 0; j < layer->GetWidth() * layer->GetHeight(); ++j)
+                {
+                    sums[t] += layer->GetTile(j).gid;
+                }
+            }
+        });
+    }
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    unsigned expectedSum = 0;
+    for (int i = 0; i < expected.GetNumTileLayers(); ++i)
+    {
+        const auto layer = expected.GetTileLayer(i);
+        for (int j = 0; j < layer->GetWidth() * layer->GetHeight(); ++j)
+        {
+            expectedSum += layer->GetTile(j).gid;
+        }
+    }
+
+    for (const auto sum : sums)
+    {
+        EXPECT_EQ(expectedSum, sum);
+    }
+}
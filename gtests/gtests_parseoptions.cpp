@@ -0,0 +1,264 @@
+//-----------------------------------------------------------------------------
+// gtests_parseoptions
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+
+namespace
+{
+    const std::string exampleFile = std::string{ TMX_EXAMPLE_DIR } + "/example.tmx";
+
+    // Parses the example with the given options, read as a whole and
+    // element by element.
+    std::vector<Tmx::Map> ParseExample(Tmx::ParseOptions options)
+    {
+        std::vector<Tmx::Map> maps;
+        for (const bool streaming : { false, true })
+        {
+            options.streaming = streaming;
+            Tmx::MapLoader loader{ options };
+            maps.push_back(loader.ParseFile(exampleFile));
+        }
+
+        return maps;
+    }
+
+    std::vector<std::string> GetLayerNames(const Tmx::Map &map)
+    {
+        std::vector<std::string> names;
+        const auto add = [&](auto &self, const Tmx::Layer *layer) -> void {
+            names.push_back(layer->GetName());
+            if (layer->GetLayerType() == Tmx::TMX_LAYERTYPE_GROUP_LAYER)
+            {
+                const auto group = static_cast<const Tmx::GroupLayer *>(layer);
+                for (int i = 0; i < group->GetNumChildren(); ++i)
+                {
+                    self(self, group->GetChild(i));
+                }
+            }
+        };
+
+        for (const auto layer : map.GetLayers())
+        {
+            add(add, layer);
+        }
+
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    const char *jsonMap = R"({"height":1, "infinite":false, "orientation":"orthogonal",
+ "properties":[{"name":"p", "type":"int", "value":1}],
+ "layers":[{"data":[1, 0], "height":1, "id":1, "name":"ground", "type":"tilelayer", "width":2},
+           {"id":2, "name":"things", "objects":[], "type":"objectgroup"},
+           {"id":3, "layers":[{"data":[0, 1], "height":1, "id":4, "name":"walls",
+                               "type":"tilelayer", "width":2}],
+            "name":"world", "type":"group"}],
+ "tilesets":[{"columns":2, "firstgid":1, "image":"a.png", "imageheight":32, "imagewidth":32,
+              "name":"a", "tilecount":4, "tileheight":16, "tilewidth":16,
+              "tiles":[{"id":0, "animation":[{"tileid":1, "duration":100}],
+                        "objectgroup":{"objects":[], "type":"objectgroup"},
+                        "properties":[{"name":"q", "type":"string", "value":"x"}]}]}],
+ "tileheight":16, "tilewidth":16, "type":"map", "version":"1.10", "width":2})";
+}
+
+TEST(ParseOptions, SkipLayerTypes)
+{
+    Tmx::ParseOptions options;
+    options.skipLayerTypes = Tmx::TMX_LAYERTYPE_OBJECTGROUP | Tmx::TMX_LAYERTYPE_IMAGE_LAYER;
+
+    for (const auto &map : ParseExample(options))
+    {
+        ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+        EXPECT_EQ(map.GetNumObjectGroups(), 0);
+        EXPECT_EQ(map.GetNumImageLayers(), 0);
+        EXPECT_EQ(map.GetNumTileLayers(), 6);
+        ASSERT_EQ(map.GetNumGroupLayers(), 1);
+
+        // Inside groups as well.
+        EXPECT_EQ(GetLayerNames(map), (std::vector<std::string>{ "Testing Child Child Layer",
+            "Testing Child Group Layer", "Testing Child Tile Layer", "Testing Group Layer",
+            "Testing Name 1", "Testing Name 2", "Testing Name 3", "Testing Name 4",
+            "Testing Name 5", "Testing Torches" }));
+
+        // Tiles keep their collision shapes, which are not layers of the map.
+        EXPECT_TRUE(map.GetTileset(1)->GetTile(0)->HasObjects());
+    }
+}
+
+TEST(ParseOptions, LayerNames)
+{
+    Tmx::ParseOptions options;
+    options.layerNames = { "Testing Name 2", "Testing Child Child Layer", "Polygon Testing" };
+
+    const auto full = Tmx::Map::ParseFile(exampleFile);
+    const auto expected = full.GetTileLayer(1);
+    ASSERT_EQ(expected->GetName(), "Testing Name 2");
+
+    for (const auto &map : ParseExample(options))
+    {
+        ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+        EXPECT_EQ(GetLayerNames(map), (std::vector<std::string>{ "Polygon Testing",
+            "Testing Child Child Layer", "Testing Child Group Layer", "Testing Group Layer",
+            "Testing Name 2" }));
+
+        const auto layer = map.GetTileLayer(0);
+        EXPECT_EQ(layer->GetName(), "Testing Name 2");
+        for (int i = 0; i < layer->GetWidth() * layer->GetHeight(); ++i)
+        {
+            EXPECT_EQ(layer->GetTile(i).gid, expected->GetTile(i).gid);
+        }
+    }
+}
+
+TEST(ParseOptions, LayerFilter)
+{
+    Tmx::ParseOptions options;
+    std::vector<std::pair<std::string, Tmx::LayerType>> asked;
+    options.layerFilter = [&asked](std::string_view name, Tmx::LayerType type) {
+        asked.emplace_back(name, type);
+        return type != Tmx::TMX_LAYERTYPE_GROUP_LAYER && name != "Testing Torches";
+    };
+
+    for (const auto &map : ParseExample(options))
+    {
+        ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+        // Leaving out the group leaves out what is in it.
+        EXPECT_EQ(map.GetNumGroupLayers(), 0);
+        EXPECT_EQ(map.GetNumTileLayers(), 5);
+        EXPECT_EQ(map.GetNumObjectGroups(), 1);
+        const auto names = GetLayerNames(map);
+        EXPECT_EQ(std::count(names.begin(), names.end(), "Testing Child Tile Layer"), 0);
+    }
+
+    // Every top-level layer is asked about once in each of the two parses.
+    ASSERT_EQ(asked.size(), 16u);
+    EXPECT_EQ(asked[0].first, "Testing Group Layer");
+    EXPECT_EQ(asked[0].second, Tmx::TMX_LAYERTYPE_GROUP_LAYER);
+    EXPECT_EQ(asked[8], asked[0]);
+}
+
+TEST(ParseOptions, SkipPropertiesAndTileDetails)
+{
+    // Without a loader nothing is left out.
+    const auto full = Tmx::Map::ParseFile(exampleFile);
+    ASSERT_FALSE(full.GetProperties().Empty());
+    ASSERT_TRUE(full.GetTileset(1)->GetTile(0)->IsAnimated());
+
+    Tmx::ParseOptions options;
+    options.skipProperties = true;
+    options.skipTileAnimations = true;
+    options.skipTileCollisions = true;
+
+    for (const auto &map : ParseExample(options))
+    {
+        ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+        EXPECT_TRUE(map.GetProperties().Empty());
+
+        for (const auto &tileset : map.GetTilesets())
+        {
+            EXPECT_TRUE(tileset.GetProperties().Empty());
+            for (const auto &tile : tileset.GetTiles())
+            {
+                EXPECT_TRUE(tile.GetProperties().Empty());
+                EXPECT_FALSE(tile.IsAnimated());
+                EXPECT_TRUE(tile.GetFrames().empty());
+                EXPECT_EQ(tile.GetObjectGroup(), nullptr);
+            }
+        }
+
+        for (const auto &group : map.GetObjectGroups())
+        {
+            for (const auto &object : group.GetObjects())
+            {
+                EXPECT_TRUE(object.GetProperties().Empty());
+            }
+        }
+
+        // What is left is read as before.
+        EXPECT_EQ(map.GetNumLayers(), full.GetNumLayers());
+        EXPECT_EQ(map.GetTileset(0)->GetTiles().size(), full.GetTileset(0)->GetTiles().size());
+        EXPECT_EQ(map.GetTileLayer(0)->GetTileGid(0, 0), full.GetTileLayer(0)->GetTileGid(0, 0));
+    }
+}
+
+TEST(ParseOptions, Json)
+{
+    Tmx::ParseOptions options;
+    options.layerNames = { "walls" };
+    options.skipProperties = true;
+    options.skipTileAnimations = true;
+    options.skipTileCollisions = true;
+
+    Tmx::MapLoader loader{ options };
+    const auto map = loader.ParseText(jsonMap);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    EXPECT_EQ(map.GetNumTileLayers(), 0);
+    EXPECT_EQ(map.GetNumObjectGroups(), 0);
+    ASSERT_EQ(map.GetNumGroupLayers(), 1);
+    ASSERT_EQ(map.GetGroupLayer(0)->GetNumChildren(), 1);
+    EXPECT_EQ(map.GetGroupLayer(0)->GetChild(0)->GetName(), "walls");
+    EXPECT_TRUE(map.GetProperties().Empty());
+
+    const auto tile = map.GetTileset(0)->GetTile(0);
+    ASSERT_NE(tile, nullptr);
+    EXPECT_FALSE(tile->IsAnimated());
+    EXPECT_EQ(tile->GetObjectGroup(), nullptr);
+    EXPECT_TRUE(tile->GetProperties().Empty());
+
+    const auto full = Tmx::MapLoader{}.ParseText(jsonMap);
+    ASSERT_FALSE(full.HasError()) << full.GetErrorText();
+    EXPECT_EQ(full.GetNumLayers(), 3);
+    EXPECT_TRUE(full.GetTileset(0)->GetTile(0)->IsAnimated());
+    EXPECT_EQ(full.GetProperties().GetSize(), 1);
+}
+
+TEST(ParseOptions, ReloadKeepsLayersLeftOut)
+{
+    Tmx::ParseOptions options;
+    options.trackChanges = true;
+    options.layerNames = { "Testing Name 1" };
+
+    Tmx::MapLoader loader{ options };
+    auto map = loader.ParseFile(exampleFile);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+    ASSERT_EQ(map.GetNumTileLayers(), 1);
+
+    const auto changes = loader.Reload(map, exampleFile);
+    ASSERT_FALSE(changes.HasError()) << changes.errorText;
+    EXPECT_FALSE(changes.HasChanges());
+    EXPECT_EQ(map.GetNumTileLayers(), 1);
+    EXPECT_EQ(map.GetNumObjectGroups(), 0);
+    EXPECT_EQ(map.GetNumGroupLayers(), 1);
+}
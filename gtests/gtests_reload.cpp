@@ -0,0 +1,361 @@
+//-----------------------------------------------------------------------------
+// gtests_reload
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+
+namespace
+{
+    const char *tilesetA = R"(<tileset firstgid="1" name="a" tilewidth="16" tileheight="16" tilecount="4" columns="2"><image source="a.png" width="32" height="32"/></tileset>)";
+    const char *tilesetB = R"(<tileset firstgid="5" name="b" tilewidth="16" tileheight="16" tilecount="4" columns="2"><image source="b.png" width="32" height="32"/></tileset>)";
+    const char *ground = R"(<layer id="1" name="ground" width="2" height="1"><data encoding="csv">1,2</data></layer>)";
+    const char *things = R"(<objectgroup id="2" name="things"><object id="1" x="1" y="2"/></objectgroup>)";
+    const char *top = R"(<layer id="3" name="top" width="2" height="1"><data encoding="csv">3,0</data></layer>)";
+
+    std::string MakeMap(const std::string &children)
+    {
+        return R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.10" orientation="orthogonal" renderorder="right-down" width="2" height="1" tilewidth="16" tileheight="16" infinite="0" nextlayerid="5" nextobjectid="2">
+)" + children + "\n</map>\n";
+    }
+
+    Tmx::ParseOptions TrackChanges()
+    {
+        Tmx::ParseOptions options;
+        options.trackChanges = true;
+        return options;
+    }
+
+    void WriteFile(const std::string &fileName, const std::string &text)
+    {
+        std::ofstream{ fileName, std::ios::binary } << text;
+    }
+
+    // Moves the modification time on, as a save within the same tick of
+    // the file system clock may not.
+    void Touch(const std::string &fileName)
+    {
+        const auto time = std::filesystem::last_write_time(fileName);
+        std::filesystem::last_write_time(fileName, time + std::chrono::seconds{ 1 });
+    }
+
+    void ExpectLayerNames(const Tmx::Map &map, std::vector<std::string> names)
+    {
+        ASSERT_EQ(map.GetNumLayers(), static_cast<int>(names.size()));
+        for (int i = 0; i < map.GetNumLayers(); ++i)
+        {
+            EXPECT_EQ(map.GetLayer(i)->GetName(), names[i]);
+        }
+    }
+
+    // The layers of a fresh parse are numbered in document order.
+    void ExpectDocumentOrder(const Tmx::Map &map, std::vector<std::string> names)
+    {
+        std::vector<const Tmx::Layer *> layers{ map.GetLayers().begin(), map.GetLayers().end() };
+        std::sort(layers.begin(), layers.end(), [](const auto a, const auto b) {
+            return a->GetParseOrder() < b->GetParseOrder();
+        });
+
+        ASSERT_EQ(layers.size(), names.size());
+        for (std::size_t i = 0; i < layers.size(); ++i)
+        {
+            EXPECT_EQ(layers[i]->GetName(), names[i]);
+            EXPECT_EQ(layers[i]->GetZOrder(), layers[i]->GetParseOrder());
+        }
+    }
+}
+
+TEST(Reload, UnchangedMapIsKept)
+{
+    Tmx::MapLoader loader{ TrackChanges() };
+    const auto text = MakeMap(std::string{ tilesetA } + ground + things + top);
+    auto map = loader.ParseText(text);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    const auto tiles = map.GetTileLayer(0)->GetTiles().data();
+    const auto changes = loader.ReloadText(map, text);
+
+    EXPECT_FALSE(changes.HasError());
+    EXPECT_FALSE(changes.HasChanges());
+    EXPECT_EQ(changes.reusedElements, 4);
+    EXPECT_EQ(map.GetTileLayer(0)->GetTiles().data(), tiles);
+    ExpectLayerNames(map, { "ground", "top", "things" });
+    EXPECT_EQ(map.GetTileLayer(1)->GetTile(0).gid, 3u);
+}
+
+TEST(Reload, OnlyChangedLayerIsRead)
+{
+    Tmx::MapLoader loader{ TrackChanges() };
+    auto map = loader.ParseText(MakeMap(std::string{ tilesetA } + ground + things + top));
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    const auto tiles = map.GetTileLayer(0)->GetTiles().data();
+    const auto changes = loader.ReloadText(map, MakeMap(std::string{ tilesetA } + ground + things
+        + R"(<layer id="3" name="top" width="2" height="1"><data encoding="csv">4,1</data></layer>)"));
+
+    ASSERT_FALSE(changes.HasError()) << changes.errorText;
+    EXPECT_FALSE(changes.mapChanged);
+    EXPECT_TRUE(changes.tilesets.empty());
+    ASSERT_EQ(changes.layers.size(), 1u);
+    EXPECT_EQ(changes.layers[0], map.GetTileLayer(1));
+    EXPECT_EQ(changes.reusedElements, 3);
+    EXPECT_EQ(map.GetTileLayer(0)->GetTiles().data(), tiles);
+    EXPECT_EQ(map.GetTileLayer(1)->GetTile(0).gid, 4u);
+    EXPECT_EQ(map.GetTileLayer(1)->GetTile(1).gid, 1u);
+}
+
+TEST(Reload, AddedAndRemovedLayersKeepDocumentOrder)
+{
+    Tmx::MapLoader loader{ TrackChanges() };
+    auto map = loader.ParseText(MakeMap(std::string{ tilesetA } + ground + things + top));
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    const auto changes = loader.ReloadText(map, MakeMap(std::string{ tilesetA } + ground
+        + R"(<imagelayer id="4" name="sky"><image source="sky.png" width="8" height="8"/></imagelayer>)"
+        + top));
+
+    ASSERT_FALSE(changes.HasError()) << changes.errorText;
+    EXPECT_EQ(changes.removedLayers, 1);
+    ASSERT_EQ(changes.layers.size(), 1u);
+    EXPECT_EQ(changes.layers[0]->GetName(), "sky");
+    ExpectDocumentOrder(map, { "ground", "sky", "top" });
+    EXPECT_EQ(map.GetNumObjectGroups(), 0);
+}
+
+TEST(Reload, MovedFirstGidsRebuildTileLayers)
+{
+    const std::string layer = R"(<layer id="1" name="ground" width="2" height="1"><data encoding="csv">1,6</data></layer>)";
+
+    Tmx::MapLoader loader{ TrackChanges() };
+    auto map = loader.ParseText(MakeMap(std::string{ tilesetA } + tilesetB + layer + things));
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+    EXPECT_EQ(map.GetTileLayer(0)->GetTileTilesetIndex(1, 0), 1);
+
+    // The second tileset now starts after the tile of the layer.
+    const auto changes = loader.ReloadText(map, MakeMap(std::string{ tilesetA }
+        + R"(<tileset firstgid="7" name="b" tilewidth="16" tileheight="16" tilecount="4" columns="2"><image source="b.png" width="32" height="32"/></tileset>)"
+        + layer + things));
+
+    ASSERT_FALSE(changes.HasError()) << changes.errorText;
+    ASSERT_EQ(changes.tilesets.size(), 1u);
+    EXPECT_EQ(changes.tilesets[0], map.GetTileset(1));
+    EXPECT_EQ(changes.removedTilesets, 1);
+    ASSERT_EQ(changes.layers.size(), 1u);
+    EXPECT_EQ(changes.layers[0], map.GetTileLayer(0));
+    EXPECT_EQ(map.GetTileset(1)->GetFirstGid(), 7);
+    EXPECT_EQ(map.GetTileLayer(0)->GetTileTilesetIndex(1, 0), 0);
+    EXPECT_EQ(changes.reusedElements, 2);
+}
+
+TEST(Reload, MalformedTextLeavesMapAlone)
+{
+    Tmx::MapLoader loader{ TrackChanges() };
+    auto map = loader.ParseText(MakeMap(std::string{ tilesetA } + ground + things + top));
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    const auto changes = loader.ReloadText(map, MakeMap(std::string{ tilesetA } + ground + things
+        + R"(<layer id="3" name="top" width="2" height="1"><data encoding="csv">4,1</data></lay>)"));
+
+    EXPECT_TRUE(changes.HasError());
+    EXPECT_FALSE(changes.HasChanges());
+    ExpectLayerNames(map, { "ground", "top", "things" });
+    EXPECT_EQ(map.GetTileLayer(1)->GetTile(0).gid, 3u);
+}
+
+TEST(Reload, UntrackedMapIsReadAgain)
+{
+    Tmx::MapLoader loader;
+    auto map = loader.ParseText(MakeMap(std::string{ tilesetA } + ground + things + top));
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    const auto changes = loader.ReloadText(map, MakeMap(std::string{ tilesetA } + ground + top));
+
+    ASSERT_FALSE(changes.HasError()) << changes.errorText;
+    EXPECT_TRUE(changes.mapChanged);
+    EXPECT_EQ(changes.removedTilesets, 1);
+    EXPECT_EQ(changes.removedLayers, 3);
+    EXPECT_EQ(changes.tilesets.size(), 1u);
+    EXPECT_EQ(changes.layers.size(), 2u);
+    EXPECT_EQ(changes.reusedElements, 0);
+    ExpectLayerNames(map, { "ground", "top" });
+}
+
+TEST(Reload, ModifiedExternalTilesetIsReadAgain)
+{
+    const auto tilesetFile = testing::TempDir() + "reload_ext.tsx";
+    const auto mapFile = testing::TempDir() + "reload_ext.tmx";
+    WriteFile(tilesetFile, R"(<?xml version="1.0" encoding="UTF-8"?>
+<tileset version="1.10" name="ext" tilewidth="16" tileheight="16" tilecount="4" columns="2"><image source="ext.png" width="32" height="32"/></tileset>
+)");
+    WriteFile(mapFile, MakeMap(std::string{ R"(<tileset firstgid="1" source="reload_ext.tsx"/>)" } + ground));
+
+    Tmx::MapLoader loader{ TrackChanges() };
+    auto map = loader.ParseFile(mapFile);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+    EXPECT_EQ(map.GetTileset(0)->GetName(), "ext");
+
+    WriteFile(tilesetFile, R"(<?xml version="1.0" encoding="UTF-8"?>
+<tileset version="1.10" name="renamed" tilewidth="16" tileheight="16" tilecount="4" columns="2"><image source="ext.png" width="32" height="32"/></tileset>
+)");
+    Touch(tilesetFile);
+
+    const auto changes = loader.Reload(map, mapFile);
+
+    ASSERT_FALSE(changes.HasError()) << changes.errorText;
+    ASSERT_EQ(changes.tilesets.size(), 1u);
+    EXPECT_TRUE(changes.layers.empty());
+    EXPECT_EQ(map.GetTileset(0)->GetName(), "renamed");
+}
+
+TEST(Reload, WatcherReloadsSavedFile)
+{
+    const auto mapFile = testing::TempDir() + "reload_watched.tmx";
+    WriteFile(mapFile, MakeMap(std::string{ tilesetA } + ground + top));
+
+    Tmx::MapLoader loader{ TrackChanges() };
+    auto map = loader.ParseFile(mapFile);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    Tmx::MapWatcher watcher{ loader };
+    int calls = 0;
+    watcher.Watch(mapFile, map, [&](const std::string &fileName, const Tmx::MapChangeSet &changes) {
+        EXPECT_EQ(fileName, mapFile);
+        EXPECT_FALSE(changes.HasError()) << changes.errorText;
+        EXPECT_EQ(changes.layers.size(), 1u);
+        ++calls;
+    });
+
+    EXPECT_EQ(watcher.Poll(), 0);
+
+    WriteFile(mapFile, MakeMap(std::string{ tilesetA } + ground + things + top));
+    Touch(mapFile);
+
+    EXPECT_EQ(watcher.Poll(std::chrono::seconds{ 5 }), 1);
+    EXPECT_EQ(calls, 1);
+    ExpectLayerNames(map, { "ground", "top", "things" });
+
+    watcher.Unwatch(mapFile);
+    WriteFile(mapFile, MakeMap(std::string{ tilesetA } + ground));
+    Touch(mapFile);
+    EXPECT_EQ(watcher.Poll(std::chrono::milliseconds{ 100 }), 0);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(Reload, WatcherCallbacksMayWatchAgain)
+{
+    const auto mapFile = testing::TempDir() + "reload_rewatched.tmx";
+    WriteFile(mapFile, MakeMap(std::string{ tilesetA } + ground));
+
+    Tmx::MapLoader loader{ TrackChanges() };
+    auto map = loader.ParseFile(mapFile);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    // The first callback replaces itself with the second one.
+    Tmx::MapWatcher watcher{ loader };
+    std::vector<std::string> calls;
+    const auto second = [&](const std::string &, const Tmx::MapChangeSet &) {
+        calls.push_back("second");
+    };
+    watcher.Watch(mapFile, map, [&, marker = std::string{ "first" }](const std::string &fileName,
+        const Tmx::MapChangeSet &) {
+        watcher.Unwatch(fileName);
+        calls.push_back(marker);
+        watcher.Watch(fileName, map, second);
+    });
+
+    WriteFile(mapFile, MakeMap(std::string{ tilesetA } + ground + top));
+    Touch(mapFile);
+    EXPECT_EQ(watcher.Poll(std::chrono::seconds{ 5 }), 1);
+
+    WriteFile(mapFile, MakeMap(std::string{ tilesetA } + ground));
+    Touch(mapFile);
+    EXPECT_EQ(watcher.Poll(std::chrono::seconds{ 5 }), 1);
+
+    EXPECT_EQ(calls, (std::vector<std::string>{ "first", "second" }));
+    ExpectLayerNames(map, { "ground" });
+}
+
+TEST(Reload, WatcherReloadsSavedTilesetsAndTemplates)
+{
+    const auto tilesetFile = testing::TempDir() + "reload_watched_ext.tsx";
+    const auto templateFile = testing::TempDir() + "reload_watched.tx";
+    const auto mapFile = testing::TempDir() + "reload_watched_refs.tmx";
+    const auto writeTileset = [&](const std::string &name) {
+        WriteFile(tilesetFile, R"(<?xml version="1.0" encoding="UTF-8"?>
+<tileset version="1.10" name=")" + name + R"(" tilewidth="16" tileheight="16" tilecount="4" columns="2"><image source="ext.png" width="32" height="32"/></tileset>
+)");
+    };
+    const auto writeTemplate = [&](const std::string &type) {
+        WriteFile(templateFile, R"(<?xml version="1.0" encoding="UTF-8"?>
+<template><object type=")" + type + R"(" width="16" height="16"/></template>
+)");
+    };
+
+    writeTileset("ext");
+    writeTemplate("slime");
+    WriteFile(mapFile, MakeMap(std::string{ R"(<tileset firstgid="1" source="reload_watched_ext.tsx"/>)" }
+        + ground + R"(<objectgroup id="2" name="things"><object id="1" template="reload_watched.tx" x="1" y="2"/></objectgroup>)"));
+
+    Tmx::MapLoader loader{ TrackChanges() };
+    auto map = loader.ParseFile(mapFile);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+    EXPECT_EQ(map.GetObjectGroup(0)->GetObject(0).GetType(), "slime");
+
+    Tmx::MapWatcher watcher{ loader };
+    std::vector<Tmx::MapChangeSet> reloads;
+    watcher.Watch(mapFile, map, [&](const std::string &fileName, const Tmx::MapChangeSet &changes) {
+        EXPECT_EQ(fileName, mapFile);
+        reloads.push_back(changes);
+    });
+
+    // Only the object group using the template is read again.
+    writeTemplate("snail");
+    Touch(templateFile);
+    EXPECT_EQ(watcher.Poll(std::chrono::seconds{ 5 }), 1);
+    ASSERT_EQ(reloads.size(), 1u);
+    EXPECT_EQ(reloads[0].layers.size(), 1u);
+    EXPECT_TRUE(reloads[0].tilesets.empty());
+    EXPECT_EQ(map.GetObjectGroup(0)->GetObject(0).GetType(), "snail");
+
+    writeTileset("renamed");
+    Touch(tilesetFile);
+    EXPECT_EQ(watcher.Poll(std::chrono::seconds{ 5 }), 1);
+    ASSERT_EQ(reloads.size(), 2u);
+    EXPECT_EQ(reloads[1].tilesets.size(), 1u);
+    EXPECT_EQ(map.GetTileset(0)->GetName(), "renamed");
+
+    watcher.Unwatch(mapFile);
+    writeTemplate("slime");
+    Touch(templateFile);
+    EXPECT_EQ(watcher.Poll(std::chrono::milliseconds{ 100 }), 0);
+}
@@ -0,0 +1,201 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+
+namespace
+{
+    std::vector<std::string> SplitChildren(Tmx::ElementStream &stream)
+    {
+        std::vector<std::string> children;
+        std::string_view child;
+        while (stream.Next(&child))
+        {
+            children.emplace_back(child);
+        }
+
+        return children;
+    }
+
+    void ExpectSameLayer(const Tmx::Layer *a, const Tmx::Layer *b)
+    {
+        ASSERT_EQ(a->GetLayerType(), b->GetLayerType());
+        EXPECT_EQ(a->GetName(), b->GetName());
+        EXPECT_EQ(a->GetWidth(), b->GetWidth());
+        EXPECT_EQ(a->GetHeight(), b->GetHeight());
+        EXPECT_EQ(a->GetOpacity(), b->GetOpacity());
+        EXPECT_EQ(a->GetOffsetX(), b->GetOffsetX());
+        EXPECT_EQ(a->GetOffsetY(), b->GetOffsetY());
+        EXPECT_EQ(a->GetProperties().GetSize(), b->GetProperties().GetSize());
+
+        switch (a->GetLayerType())
+        {
+        case Tmx::TMX_LAYERTYPE_TILE:
+        {
+            const auto ta = static_cast<const Tmx::TileLayer *>(a);
+            const auto tb = static_cast<const Tmx::TileLayer *>(b);
+            for (int y = 0; y < a->GetHeight(); ++y)
+            {
+                for (int x = 0; x < a->GetWidth(); ++x)
+                {
+                    EXPECT_EQ(ta->GetTileGid(x, y), tb->GetTileGid(x, y));
+                    EXPECT_EQ(ta->GetTileTilesetIndex(x, y), tb->GetTileTilesetIndex(x, y));
+                }
+            }
+            break;
+        }
+        case Tmx::TMX_LAYERTYPE_OBJECTGROUP:
+        {
+            const auto oa = static_cast<const Tmx::ObjectGroup *>(a);
+            const auto ob = static_cast<const Tmx::ObjectGroup *>(b);
+            ASSERT_EQ(oa->GetNumObjects(), ob->GetNumObjects());
+            for (int i = 0; i < oa->GetNumObjects(); ++i)
+            {
+                EXPECT_EQ(oa->GetObject(i).GetName(), ob->GetObject(i).GetName());
+                EXPECT_EQ(oa->GetObject(i).GetX(), ob->GetObject(i).GetX());
+                EXPECT_EQ(oa->GetObject(i).GetY(), ob->GetObject(i).GetY());
+                EXPECT_EQ(oa->GetObject(i).GetGid(), ob->GetObject(i).GetGid());
+            }
+            break;
+        }
+        case Tmx::TMX_LAYERTYPE_GROUP_LAYER:
+        {
+            const auto ga = static_cast<const Tmx::GroupLayer *>(a);
+            const auto gb = static_cast<const Tmx::GroupLayer *>(b);
+            ASSERT_EQ(ga->GetNumChildren(), gb->GetNumChildren());
+            for (int i = 0; i < ga->GetNumChildren(); ++i)
+            {
+                ExpectSameLayer(ga->GetChild(i), gb->GetChild(i));
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    void ExpectSameMap(const Tmx::Map &a, const Tmx::Map &b)
+    {
+        ASSERT_FALSE(a.HasError()) << a.GetErrorText();
+        ASSERT_FALSE(b.HasError()) << b.GetErrorText();
+
+        EXPECT_EQ(a.GetWidth(), b.GetWidth());
+        EXPECT_EQ(a.GetHeight(), b.GetHeight());
+        EXPECT_EQ(a.GetOrientation(), b.GetOrientation());
+        EXPECT_EQ(a.GetProperties().GetSize(), b.GetProperties().GetSize());
+        EXPECT_EQ(a.GetProperties().GetIntProperty("IntProperty"),
+            b.GetProperties().GetIntProperty("IntProperty"));
+
+        ASSERT_EQ(a.GetNumTilesets(), b.GetNumTilesets());
+        for (int i = 0; i < a.GetNumTilesets(); ++i)
+        {
+            EXPECT_EQ(a.GetTileset(i)->GetName(), b.GetTileset(i)->GetName());
+            EXPECT_EQ(a.GetTileset(i)->GetFirstGid(), b.GetTileset(i)->GetFirstGid());
+            EXPECT_EQ(a.GetTileset(i)->GetTiles().size(), b.GetTileset(i)->GetTiles().size());
+        }
+
+        ASSERT_EQ(a.GetNumLayers(), b.GetNumLayers());
+        ASSERT_EQ(a.GetNumTileLayers(), b.GetNumTileLayers());
+        ASSERT_EQ(a.GetNumObjectGroups(), b.GetNumObjectGroups());
+        ASSERT_EQ(a.GetNumImageLayers(), b.GetNumImageLayers());
+        ASSERT_EQ(a.GetNumGroupLayers(), b.GetNumGroupLayers());
+        for (int i = 0; i < a.GetNumLayers(); ++i)
+        {
+            ExpectSameLayer(a.GetLayer(i), b.GetLayer(i));
+            EXPECT_EQ(&b, b.GetLayer(i)->mapGetMap());
+        }
+    }
+
+    const std::string exampleFile = TMX_EXAMPLE_DIR "/example.tmx";
+}
+
+TEST(TmxElementStream, SplitsTopLevelChildren)
+{
+    Tmx::ElementStream stream{ R"(<?xml version="1.0"?>
+<!-- <map> in a comment -->
+<map width="2" note='a > b'>
+ <properties><property name="p" value="&lt;"/></properties>
+ <!-- <layer/> -->
+ <layer name="l"><data><![CDATA[</layer>]]></data></layer>
+ <imagelayer name="i"/>
+</map>
+)" };
+
+    ASSERT_FALSE(stream.HasError()) << stream.GetErrorText();
+    EXPECT_EQ(R"(<map width="2" note='a > b'/>)", stream.GetRoot());
+
+    const auto children = SplitChildren(stream);
+    EXPECT_FALSE(stream.HasError()) << stream.GetErrorText();
+    ASSERT_EQ(3u, children.size());
+    EXPECT_EQ(R"(<properties><property name="p" value="&lt;"/></properties>)", children[0]);
+    EXPECT_EQ(R"(<layer name="l"><data><![CDATA[</layer>]]></data></layer>)", children[1]);
+    EXPECT_EQ(R"(<imagelayer name="i"/>)", children[2]);
+}
+
+TEST(TmxElementStream, EmptyRoot)
+{
+    Tmx::ElementStream stream{ R"(<map width="2"/>)" };
+
+    EXPECT_EQ(R"(<map width="2"/>)", stream.GetRoot());
+    EXPECT_TRUE(SplitChildren(stream).empty());
+    EXPECT_FALSE(stream.HasError());
+}
+
+TEST(TmxElementStream, Errors)
+{
+    for (const auto text : { "", "<!-- <map>", "<map", "<map><layer>", "</map>" })
+    {
+        Tmx::ElementStream stream{ text };
+        SplitChildren(stream);
+        EXPECT_TRUE(stream.HasError()) << text;
+    }
+}
+
+TEST(TmxMapStreaming, MatchesDomOnExample)
+{
+    Tmx::ParseOptions options;
+    options.streaming = true;
+    Tmx::MapLoader loader{ options };
+
+    ExpectSameMap(Tmx::Map::ParseFile(exampleFile), loader.ParseFile(exampleFile));
+}
+
+TEST(TmxMapStreaming, MatchesDomWithDeferredDecoding)
+{
+    Tmx::ParseOptions options;
+    options.streaming = true;
+    options.decodeThreads = 2;
+    Tmx::MapLoader loader{ options };
+
+    ExpectSameMap(Tmx::Map::ParseFile(exampleFile), loader.ParseFile(exampleFile));
+}
+
+TEST(TmxMapStreaming, MappedMatchesDomOnExample)
+{
+    ExpectSameMap(Tmx::Map::ParseFile(exampleFile), Tmx::Map::ParseFileMapped(exampleFile));
+}
+
+TEST(TmxMapStreaming, MappedMatchesDomWithDeferredAndLazyDecoding)
+{
+    Tmx::ParseOptions options;
+    options.decodeThreads = 2;
+    ExpectSameMap(Tmx::Map::ParseFile(exampleFile),
+        Tmx::MapLoader{ options }.ParseFileMapped(exampleFile));
+
+    options.lazyDecode = true;
+    ExpectSameMap(Tmx::Map::ParseFile(exampleFile),
+        Tmx::MapLoader{ options }.ParseFileMapped(exampleFile));
+}
+
+TEST(TmxMapStreaming, UnclosedMap)
+{
+    Tmx::ParseOptions options;
+    options.streaming = true;
+
+    const auto map = Tmx::MapLoader{ options }.ParseText(R"(<map width="2"><imagelayer name="i"/>)");
+    EXPECT_TRUE(map.HasError());
+    EXPECT_EQ(Tmx::TMX_PARSING_ERROR, map.GetErrorCode());
+}
@@ -0,0 +1,163 @@
+//-----------------------------------------------------------------------------
+// gtests_stringpool
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+
+namespace
+{
+    const auto xmlMap = R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.10" orientation="orthogonal" width="2" height="1" tilewidth="16" tileheight="16">
+ <objectgroup id="1" name="things">
+  <object id="1" name="slime" type="enemy" x="1" y="1">
+   <properties>
+    <property name="health" type="int" value="3"/>
+   </properties>
+  </object>
+  <object id="2" name="slime" type="enemy" x="2" y="2">
+   <properties>
+    <property name="health" type="int" value="5"/>
+   </properties>
+  </object>
+  <object id="3" name="key" type="pickup" x="3" y="3"/>
+ </objectgroup>
+</map>
+)";
+
+    const auto jsonMap = R"({"height":1, "infinite":false, "orientation":"orthogonal",
+ "layers":[{"id":1, "name":"things", "type":"objectgroup", "objects":[
+   {"id":1, "name":"slime", "type":"enemy", "x":1, "y":1,
+    "properties":[{"name":"health", "type":"int", "value":3}]},
+   {"id":2, "name":"slime", "class":"enemy", "x":2, "y":2,
+    "properties":[{"name":"health", "type":"int", "value":5}]},
+   {"id":3, "name":"key", "type":"pickup", "x":3, "y":3}]}],
+ "tilesets":[], "tileheight":16, "tilewidth":16, "type":"map", "version":"1.10", "width":2})";
+
+    const auto templateText = R"(<?xml version="1.0" encoding="UTF-8"?>
+<template>
+ <object name="slime" type="enemy" width="16" height="12">
+  <properties>
+   <property name="health" type="int" value="3"/>
+  </properties>
+ </object>
+</template>
+)";
+
+    const auto templatedMapText = R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.10" orientation="orthogonal" width="2" height="1" tilewidth="16" tileheight="16">
+ <objectgroup id="1" name="things">
+  <object id="1" template="slime.tx" x="10" y="20"/>
+ </objectgroup>
+</map>
+)";
+}
+
+TEST(StringPool, InternsEachStringOnce)
+{
+    Tmx::StringPool pool;
+    const auto &enemy = pool.Intern("enemy");
+    EXPECT_EQ(enemy, "enemy");
+    EXPECT_EQ(&pool.Intern(std::string{ "enemy" }), &enemy);
+    EXPECT_NE(&pool.Intern("pickup"), &enemy);
+    EXPECT_EQ(pool.GetSize(), 2u);
+
+    EXPECT_EQ(pool.Find("enemy"), &enemy);
+    EXPECT_EQ(pool.Find("door"), nullptr);
+
+    // The empty string is shared by all pools without being added.
+    EXPECT_EQ(&pool.Intern(""), pool.Find(""));
+    EXPECT_EQ(&pool.Intern(""), &Tmx::StringPool{}.Intern(""));
+    EXPECT_EQ(pool.GetSize(), 2u);
+}
+
+TEST(StringPool, MapInternsNamesTypesAndKeys)
+{
+    for (const std::string_view text : { std::string_view{ xmlMap }, std::string_view{ jsonMap } })
+    {
+        const auto map = Tmx::Map::ParseText(text);
+        ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+        const auto &objects = map.GetObjectGroup(0)->GetObjects();
+        ASSERT_EQ(objects.size(), 3u);
+        const auto &pool = map.GetStringPool();
+
+        EXPECT_EQ(objects[0].GetType(), "enemy");
+        EXPECT_EQ(&objects[0].GetType(), &objects[1].GetType());
+        EXPECT_EQ(&objects[0].GetType(), pool.Find("enemy"));
+        EXPECT_EQ(&objects[0].GetName(), &objects[1].GetName());
+        EXPECT_NE(&objects[0].GetType(), &objects[2].GetType());
+
+        const auto &first = objects[0].GetProperties();
+        const auto &second = objects[1].GetProperties();
+        EXPECT_EQ(&first.GetStringPool(), &pool);
+        EXPECT_EQ(first.GetIntProperty("health"), 3);
+        EXPECT_EQ(second.GetIntProperty(std::string{ "health" }), 5);
+        EXPECT_EQ(first.GetPropertyMap().begin()->first.data(),
+            second.GetPropertyMap().begin()->first.data());
+        EXPECT_EQ(first.GetPropertyMap().begin()->first.data(), pool.Find("health")->data());
+    }
+}
+
+TEST(StringPool, CopiedPropertiesOutliveTheMap)
+{
+    std::optional<Tmx::Map> map{ Tmx::Map::ParseText(xmlMap) };
+    ASSERT_FALSE(map->HasError()) << map->GetErrorText();
+
+    const auto properties = map->GetObjectGroup(0)->GetObject(1).GetProperties();
+    map.reset();
+
+    EXPECT_EQ(properties.GetIntProperty("health"), 5);
+    EXPECT_EQ(properties.GetPropertyMap().begin()->first, "health");
+    EXPECT_NE(properties.GetStringPool().Find("enemy"), nullptr);
+}
+
+TEST(StringPool, TemplateStringsAreInternedInTheMap)
+{
+    const auto directory = std::filesystem::temp_directory_path() / "tmx_stringpool";
+    std::filesystem::create_directories(directory);
+    std::ofstream{ directory / "slime.tx" } << templateText;
+
+    Tmx::MapLoader loader;
+    const auto map = loader.ParseText(templatedMapText, directory.string() + "/");
+    std::filesystem::remove_all(directory);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    const auto &object = map.GetObjectGroup(0)->GetObject(0);
+    ASSERT_NE(object.GetTemplate(), nullptr);
+    EXPECT_EQ(object.GetType(), "enemy");
+    EXPECT_EQ(&object.GetType(), map.GetStringPool().Find("enemy"));
+    EXPECT_NE(&object.GetType(), &object.GetTemplate()->GetType());
+
+    // The template is shared with other maps, so it has a pool of its own.
+    EXPECT_EQ(object.GetTemplate()->GetProperties().GetStringPool().Find("enemy"),
+        &object.GetTemplate()->GetType());
+}
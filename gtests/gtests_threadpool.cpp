@@ -0,0 +1,76 @@
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+
+TEST(TmxThreadPool, ParallelForVisitsEveryIndexOnce)
+{
+    Tmx::ThreadPool pool{ 3 };
+    EXPECT_EQ(3u, pool.GetNumThreads());
+
+    std::vector<std::atomic<int>> visits(1000);
+    pool.ParallelFor(visits.size(), [&](std::size_t i) { ++visits[i]; });
+
+    for (const auto &v : visits)
+    {
+        EXPECT_EQ(1, v.load());
+    }
+}
+
+TEST(TmxThreadPool, ParallelForEmpty)
+{
+    Tmx::ThreadPool pool{ 2 };
+    pool.ParallelFor(0, [](std::size_t) { FAIL(); });
+}
+
+TEST(TmxThreadPool, NestedParallelFor)
+{
+    Tmx::ThreadPool pool{ 2 };
+
+    std::atomic<int> total{ 0 };
+    pool.ParallelFor(8, [&](std::size_t) {
+        pool.ParallelFor(8, [&](std::size_t) { ++total; });
+    });
+
+    EXPECT_EQ(64, total.load());
+}
+
+TEST(TmxThreadPool, ParallelForRethrows)
+{
+    Tmx::ThreadPool pool{ 3 };
+
+    // Thrown on the workers and on the calling thread alike.
+    std::atomic<int> calls{ 0 };
+    EXPECT_THROW(pool.ParallelFor(1000, [&](std::size_t i) {
+        ++calls;
+        if (i % 7 == 3)
+        {
+            throw std::runtime_error{ "index " + std::to_string(i) };
+        }
+    }), std::runtime_error);
+    EXPECT_LT(calls.load(), 1000);
+
+    // The pool keeps working.
+    std::atomic<int> total{ 0 };
+    pool.ParallelFor(100, [&](std::size_t) { ++total; });
+    EXPECT_EQ(100, total.load());
+}
+
+TEST(TmxThreadPool, Submit)
+{
+    std::atomic<int> total{ 0 };
+
+    {
+        Tmx::ThreadPool pool{ 2 };
+        for (int i = 0; i < 100; ++i)
+        {
+            pool.Submit([&] { ++total; });
+        }
+    }
+
+    EXPECT_EQ(100, total.load());
+}
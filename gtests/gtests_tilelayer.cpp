@@ -0,0 +1,493 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+#include "base64/base64.h"
+
+namespace
+{
+    // A 4x4 chunk of csv gids, gid 0 everywhere but at the given local position.
+    std::string MakeChunk(int x, int y, int gid, int localX = 0, int localY = 0)
+    {
+        std::string csv;
+        for (int i = 0; i < 16; ++i)
+        {
+            csv += std::to_string(i == localY * 4 + localX ? gid : 0) + (i < 15 ? "," : "");
+        }
+
+        return "<chunk x=\"" + std::to_string(x) + "\" y=\"" + std::to_string(y) +
+            "\" width=\"4\" height=\"4\">" + csv + "</chunk>\n";
+    }
+
+    std::string MakeInfiniteMap(const std::string &chunks)
+    {
+        return R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.0" orientation="orthogonal" width="8" height="8" tilewidth="16" tileheight="16" infinite="1">
+ <tileset firstgid="1" name="t" tilewidth="16" tileheight="16" tilecount="8" columns="4"/>
+ <layer name="ground" width="8" height="8">
+  <data encoding="csv">
+)" + chunks + R"(  </data>
+ </layer>
+</map>
+)";
+    }
+
+    const auto infiniteMapText = MakeInfiniteMap(
+        MakeChunk(-4, -4, 2, 3, 3) +
+        MakeChunk(0, 0, 3) +
+        MakeChunk(4, 0, 0) +
+        MakeChunk(4000000, -8000000, 5, 1, 2));
+
+    void ExpectChunkedTiles(const Tmx::Map &map)
+    {
+        ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+        ASSERT_EQ(1, map.GetNumTileLayers());
+
+        const auto layer = map.GetTileLayer(0);
+        EXPECT_TRUE(layer->IsChunked());
+        EXPECT_EQ(4, layer->GetChunkWidth());
+        EXPECT_EQ(4, layer->GetChunkHeight());
+
+        // The empty chunk is not kept.
+        EXPECT_EQ(3, layer->GetNumChunks());
+
+        ASSERT_TRUE(layer->FindTile(-1, -1));
+        EXPECT_EQ(2u, layer->FindTile(-1, -1)->gid);
+        EXPECT_EQ(0u, layer->FindTile(-4, -4)->gid);
+        EXPECT_EQ(3u, layer->FindTile(0, 0)->gid);
+        EXPECT_EQ(2u, layer->FindTile(0, 0)->id);
+        EXPECT_EQ(5u, layer->FindTile(4000001, -7999998)->gid);
+
+        EXPECT_FALSE(layer->FindTile(5, 1));
+        EXPECT_FALSE(layer->FindTile(-5, 0));
+        EXPECT_EQ(nullptr, layer->FindChunk(-2147483647, 2147483647));
+
+        const auto chunk = layer->FindChunk(-2, -3);
+        ASSERT_NE(nullptr, chunk);
+        EXPECT_EQ(-4, chunk->x);
+        EXPECT_EQ(-4, chunk->y);
+
+        int count = 0;
+        layer->IterateChunks([&count](const Tmx::TileChunk &c) {
+            EXPECT_EQ(16u, c.tiles.size());
+            ++count;
+        });
+        EXPECT_EQ(3, count);
+    }
+}
+
+TEST(TmxTileLayer, InfiniteMapChunks)
+{
+    ExpectChunkedTiles(Tmx::Map::ParseText(infiniteMapText));
+}
+
+TEST(TmxTileLayer, InfiniteMapChunksLazy)
+{
+    Tmx::ParseOptions options;
+    options.lazyDecode = true;
+
+    const auto map = Tmx::MapLoader{ options }.ParseText(infiniteMapText);
+    EXPECT_FALSE(map.GetTileLayer(0)->IsDecoded());
+    ExpectChunkedTiles(map);
+
+    map.GetTileLayer(0)->Release();
+    EXPECT_EQ(3, map.GetTileLayer(0)->GetNumChunks());
+}
+
+TEST(TmxTileLayer, InfiniteMapChunksDeferred)
+{
+    Tmx::ParseOptions options;
+    options.decodeThreads = 2;
+
+    ExpectChunkedTiles(Tmx::MapLoader{ options }.ParseText(infiniteMapText));
+}
+
+TEST(TmxTileLayer, MisalignedChunksAreSpreadOverTheGrid)
+{
+    const auto map = Tmx::Map::ParseText(MakeInfiniteMap(
+        MakeChunk(0, 0, 1) +
+        MakeChunk(2, 2, 4, 3, 3)));
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    const auto layer = map.GetTileLayer(0);
+    EXPECT_EQ(2, layer->GetNumChunks());
+    EXPECT_EQ(1u, layer->FindTile(0, 0)->gid);
+    EXPECT_EQ(4u, layer->FindTile(5, 5)->gid);
+    EXPECT_EQ(0u, layer->FindTile(4, 4)->gid);
+    EXPECT_FALSE(layer->FindTile(8, 8));
+}
+
+TEST(TmxTileLayer, FindTileOnFiniteMap)
+{
+    const auto map = Tmx::Map::ParseText(R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.0" orientation="orthogonal" width="2" height="2" tilewidth="16" tileheight="16">
+ <layer name="ground" width="2" height="2">
+  <data encoding="csv">1,2,3,4</data>
+ </layer>
+</map>
+)");
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+    const auto layer = map.GetTileLayer(0);
+    EXPECT_FALSE(layer->IsChunked());
+    EXPECT_EQ(0, layer->GetNumChunks());
+    EXPECT_EQ(nullptr, layer->FindChunk(0, 0));
+    EXPECT_EQ(4u, layer->FindTile(1, 1)->gid);
+    EXPECT_FALSE(layer->FindTile(2, 0));
+    EXPECT_FALSE(layer->FindTile(-1, 0));
+}
+
+namespace
+{
+    // Gids over two tilesets, some of them flipped.
+    const std::vector<uint32_t> storedGids{ 0, 1, 48, 49 | Tmx::FlippedHorizontallyFlag,
+        51 | Tmx::FlippedVerticallyFlag | Tmx::FlippedDiagonallyFlag, 2, 0, 50, 700 };
+
+    // A 3x3 map with the gids in a layer of each encoding.
+    std::string MakeEncodedMap()
+    {
+        std::string xml, csv;
+        for (const auto gid : storedGids)
+        {
+            xml += "<tile gid=\"" + std::to_string(gid) + "\"/>";
+            csv += std::to_string(gid) + ",";
+        }
+        csv.pop_back();
+
+        const auto base64 = base64_encode(reinterpret_cast<const unsigned char *>(storedGids.data()),
+            static_cast<unsigned>(storedGids.size() * 4));
+
+        const auto layer = [](const std::string &name, const std::string &data) {
+            return "<layer name=\"" + name + "\" width=\"3\" height=\"3\">" + data + "</layer>";
+        };
+
+        return R"(<map version="1.0" orientation="orthogonal" width="3" height="3" tilewidth="16" tileheight="16">)"
+            R"(<tileset firstgid="1" name="a" tilewidth="16" tileheight="16" tilecount="48" columns="8"/>)"
+            R"(<tileset firstgid="49" name="b" tilewidth="16" tileheight="16" tilecount="3" columns="3"/>)"
+            + layer("xml", "<data>" + xml + "</data>")
+            + layer("csv", "<data encoding=\"csv\">\n" + csv + "\n</data>")
+            + layer("base64", "<data encoding=\"base64\">\n   " + base64 + "\n  </data>")
+            + "</map>";
+    }
+
+    Tmx::Map ParseWith(Tmx::TileLayerStorageType storage, bool lazy, const std::string &text)
+    {
+        Tmx::ParseOptions options;
+        options.tileStorage = storage;
+        options.lazyDecode = lazy;
+        Tmx::MapLoader loader{ options };
+        return text.empty()
+            ? loader.ParseFile(std::string{ TMX_EXAMPLE_DIR } + "/example.tmx")
+            : loader.ParseText(text);
+    }
+
+    // Compares a layer of MapTiles with the same layer kept as storage.
+    void ExpectSameTiles(const Tmx::TileLayer &tiles, const Tmx::TileLayer &gids,
+        Tmx::TileLayerStorageType storage = Tmx::TMX_STORAGE_GIDS)
+    {
+        EXPECT_EQ(Tmx::TMX_STORAGE_TILES, tiles.GetStorage());
+        EXPECT_EQ(storage, gids.GetStorage());
+        EXPECT_TRUE(gids.GetTiles().empty());
+        EXPECT_TRUE(tiles.GetGids().empty());
+        const auto numCells = static_cast<size_t>(gids.GetWidth() * gids.GetHeight());
+        EXPECT_EQ(storage == Tmx::TMX_STORAGE_GIDS ? numCells : 0u, gids.GetGids().size());
+
+        for (int y = 0; y < tiles.GetHeight(); ++y)
+        {
+            for (int x = 0; x < tiles.GetWidth(); ++x)
+            {
+                const auto a = tiles.GetTile(x, y);
+                const auto b = gids.GetTile(x, y);
+                EXPECT_EQ(a.gid, b.gid);
+                EXPECT_EQ(a.id, b.id);
+                EXPECT_EQ(a.tilesetId, b.tilesetId);
+                EXPECT_EQ(a.flippedHorizontally, b.flippedHorizontally);
+                EXPECT_EQ(a.flippedVertically, b.flippedVertically);
+                EXPECT_EQ(a.flippedDiagonally, b.flippedDiagonally);
+
+                EXPECT_EQ(a.gid, gids.GetTileGid(x, y));
+                EXPECT_EQ(a.id, gids.GetTileId(x, y));
+                EXPECT_EQ(a.tilesetId, gids.GetTileTilesetIndex(x, y));
+                EXPECT_EQ(a.flippedHorizontally, gids.IsTileFlippedHorizontally(x, y));
+                EXPECT_EQ(a.flippedVertically, gids.IsTileFlippedVertically(x, y));
+                EXPECT_EQ(a.flippedDiagonally, gids.IsTileFlippedDiagonally(x, y));
+                EXPECT_EQ(a.gid, gids.FindTile(x, y)->gid);
+            }
+        }
+    }
+}
+
+TEST(TmxTileLayer, GidStorageReadsLikeTiles)
+{
+    const auto text = MakeEncodedMap();
+    for (const bool lazy : { false, true })
+    {
+        for (const auto &source : { text, std::string{} })
+        {
+            const auto tiles = ParseWith(Tmx::TMX_STORAGE_TILES, lazy, source);
+            const auto gids = ParseWith(Tmx::TMX_STORAGE_GIDS, lazy, source);
+            ASSERT_FALSE(gids.HasError()) << gids.GetErrorText();
+            ASSERT_EQ(tiles.GetNumTileLayers(), gids.GetNumTileLayers());
+
+            for (int i = 0; i < tiles.GetNumTileLayers(); ++i)
+            {
+                ExpectSameTiles(*tiles.GetTileLayer(i), *gids.GetTileLayer(i));
+            }
+        }
+    }
+
+    // The raw gids are kept, flip flags and all.
+    const auto gids = ParseWith(Tmx::TMX_STORAGE_GIDS, false, text);
+    for (const auto &layer : gids.GetTileLayers())
+    {
+        EXPECT_EQ(storedGids, std::vector<uint32_t>(layer.GetGids().begin(), layer.GetGids().end()))
+            << layer.GetName();
+    }
+}
+
+TEST(TmxTileLayer, GidStorageOfJsonAndInfiniteMaps)
+{
+    const std::string json = R"({"height":1, "width":3, "orientation":"orthogonal",
+ "layers":[{"data":[1, 2147483650, 0], "height":1, "name":"j", "type":"tilelayer", "width":3}],
+ "tileheight":16, "tilewidth":16,
+ "tilesets":[{"columns":2, "firstgid":1, "name":"t", "tilecount":4, "tileheight":16, "tilewidth":16}]})";
+
+    ExpectSameTiles(*ParseWith(Tmx::TMX_STORAGE_TILES, false, json).GetTileLayer(0),
+        *ParseWith(Tmx::TMX_STORAGE_GIDS, false, json).GetTileLayer(0));
+
+    // Chunks keep their MapTiles.
+    const auto map = ParseWith(Tmx::TMX_STORAGE_GIDS, false, infiniteMapText);
+    EXPECT_EQ(Tmx::TMX_STORAGE_TILES, map.GetTileLayer(0)->GetStorage());
+    ExpectChunkedTiles(map);
+}
+
+namespace
+{
+    // Copies rect with room for two more gids per row, which must be left alone.
+    std::vector<uint32_t> CopyRegion(const Tmx::TileLayer &layer, const Tmx::TileRect &rect)
+    {
+        const auto stride = static_cast<size_t>(rect.width) + 2;
+        std::vector<uint32_t> out(stride * rect.height, 0xdeadbeef);
+        layer.CopyRegion(rect, out.data(), stride);
+        return out;
+    }
+
+    void ExpectRegion(const Tmx::TileLayer &layer, const Tmx::TileRect &rect)
+    {
+        const auto out = CopyRegion(layer, rect);
+        const auto stride = static_cast<size_t>(rect.width) + 2;
+        for (int j = 0; j < rect.height; ++j)
+        {
+            for (int i = 0; i < rect.width; ++i)
+            {
+                const auto tile = layer.FindTile(rect.x + i, rect.y + j);
+                EXPECT_EQ(tile ? tile->GetRawGid() : 0u, out[j * stride + i])
+                    << rect.x + i << "," << rect.y + j;
+            }
+            EXPECT_EQ(0xdeadbeef, out[j * stride + rect.width]);
+            EXPECT_EQ(0xdeadbeef, out[j * stride + rect.width + 1]);
+        }
+    }
+}
+
+TEST(TmxTileLayer, RowsAndRegions)
+{
+    const auto text = MakeEncodedMap();
+    for (const auto storage : { Tmx::TMX_STORAGE_TILES, Tmx::TMX_STORAGE_GIDS })
+    {
+        const auto map = ParseWith(storage, false, text);
+        ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+
+        for (const auto &layer : map.GetTileLayers())
+        {
+            for (int y = 0; y < 3; ++y)
+            {
+                const auto tiles = layer.GetTileRow(y);
+                const auto gids = layer.GetGidRow(y);
+                ASSERT_EQ(3u, storage == Tmx::TMX_STORAGE_GIDS ? gids.size() : tiles.size());
+                EXPECT_TRUE(storage == Tmx::TMX_STORAGE_GIDS ? tiles.empty() : gids.empty());
+                for (int x = 0; x < 3; ++x)
+                {
+                    EXPECT_EQ(storedGids[y * 3 + x],
+                        storage == Tmx::TMX_STORAGE_GIDS ? gids[x] : tiles[x].GetRawGid());
+                }
+            }
+            EXPECT_TRUE(layer.GetTileRow(-1).empty());
+            EXPECT_TRUE(layer.GetGidRow(3).empty());
+
+            const auto row = CopyRegion(layer, { 0, 1, 2, 1 });
+            EXPECT_EQ(std::vector<uint32_t>(storedGids.begin() + 3, storedGids.begin() + 5),
+                std::vector<uint32_t>(row.begin(), row.begin() + 2));
+            ExpectRegion(layer, { 0, 0, 3, 3 });
+            ExpectRegion(layer, { -2, -1, 6, 5 });
+            ExpectRegion(layer, { 2, 1, 4, 1 });
+            ExpectRegion(layer, { 5, 5, 2, 2 });
+        }
+    }
+}
+
+TEST(TmxTileLayer, RegionsOfChunkedLayers)
+{
+    const auto map = Tmx::Map::ParseText(infiniteMapText);
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+    const auto &layer = *map.GetTileLayer(0);
+
+    ExpectRegion(layer, { -6, -6, 13, 11 });
+    ExpectRegion(layer, { -1, -1, 2, 2 });
+    ExpectRegion(layer, { 3999998, -8000001, 9, 5 });
+    EXPECT_TRUE(layer.GetTileRow(0).empty());
+}
+
+TEST(TmxTileLayer, EmptyRegionsCopyNothing)
+{
+    const auto text = MakeEncodedMap();
+    const auto chunked = Tmx::Map::ParseText(infiniteMapText);
+    std::vector<const Tmx::TileLayer *> layers{ chunked.GetTileLayer(0) };
+
+    std::vector<Tmx::Map> maps;
+    for (const auto storage : { Tmx::TMX_STORAGE_TILES, Tmx::TMX_STORAGE_GIDS,
+        Tmx::TMX_STORAGE_RUNS, Tmx::TMX_STORAGE_SPARSE })
+    {
+        maps.push_back(ParseWith(storage, false, text));
+    }
+    for (const auto &map : maps)
+    {
+        layers.push_back(map.GetTileLayer(0));
+    }
+
+    for (const auto layer : layers)
+    {
+        for (const auto &rect : { Tmx::TileRect{ 0, 0, -2, 2 }, Tmx::TileRect{ 0, 0, 2, -2 },
+            Tmx::TileRect{ 1, 1, 0, 3 }, Tmx::TileRect{ -1, 0, -1, -1 } })
+        {
+            std::vector<uint32_t> out(8, 0xdeadbeef);
+            layer->CopyRegion(rect, out.data(), 2);
+            EXPECT_EQ(std::vector<uint32_t>(8, 0xdeadbeef), out);
+        }
+    }
+}
+
+TEST(TmxTileLayer, PackedStorageReadsLikeTiles)
+{
+    const auto text = MakeEncodedMap();
+    const std::string json = R"({"height":1, "width":3, "orientation":"orthogonal",
+ "layers":[{"data":[1, 2147483650, 0], "height":1, "name":"j", "type":"tilelayer", "width":3}],
+ "tileheight":16, "tilewidth":16,
+ "tilesets":[{"columns":2, "firstgid":1, "name":"t", "tilecount":4, "tileheight":16, "tilewidth":16}]})";
+
+    for (const auto storage : { Tmx::TMX_STORAGE_RUNS, Tmx::TMX_STORAGE_SPARSE })
+    {
+        for (const bool lazy : { false, true })
+        {
+            for (const auto &source : { text, std::string{}, json })
+            {
+                const auto tiles = ParseWith(Tmx::TMX_STORAGE_TILES, lazy, source);
+                const auto packed = ParseWith(storage, lazy, source);
+                ASSERT_FALSE(packed.HasError()) << packed.GetErrorText();
+                ASSERT_EQ(tiles.GetNumTileLayers(), packed.GetNumTileLayers());
+
+                for (int i = 0; i < tiles.GetNumTileLayers(); ++i)
+                {
+                    const auto &layer = *packed.GetTileLayer(i);
+                    ExpectSameTiles(*tiles.GetTileLayer(i), layer, storage);
+                    ExpectRegion(layer, { -2, -1, layer.GetWidth() + 3, layer.GetHeight() + 2 });
+                    ExpectRegion(layer, { 1, 0, 1, 1 });
+
+                    // A released layer packs itself again.
+                    layer.Release();
+                    ExpectSameTiles(*tiles.GetTileLayer(i), layer, storage);
+                }
+            }
+        }
+    }
+
+    const auto runs = ParseWith(Tmx::TMX_STORAGE_RUNS, false, text);
+    const auto row = runs.GetTileLayer(0)->GetRunRow(1);
+    ASSERT_EQ(3u, row.size());
+    EXPECT_EQ(storedGids[3], row[0].gid);
+    EXPECT_EQ(2u, row[2].x);
+    EXPECT_TRUE(runs.GetTileLayer(0)->GetCellRow(1).empty());
+    EXPECT_TRUE(runs.GetTileLayer(0)->GetRunRow(3).empty());
+
+    const auto sparse = ParseWith(Tmx::TMX_STORAGE_SPARSE, false, text);
+    ASSERT_EQ(2u, sparse.GetTileLayer(0)->GetCellRow(0).size());
+    EXPECT_EQ(1u, sparse.GetTileLayer(0)->GetCellRow(0)[0].x);
+    EXPECT_EQ(2u, sparse.GetTileLayer(0)->GetCellRow(2).size());
+}
+
+namespace
+{
+    // A 64x64 map with a layer of scattered tiles, one painted in wide
+    // stripes and a full one.
+    std::string MakeDensityMap()
+    {
+        std::string scattered, painted, full;
+        for (int i = 0; i < 64 * 64; ++i)
+        {
+            const auto sep = i + 1 < 64 * 64 ? "," : "";
+            scattered += std::to_string(i % 37 == 0 ? 1 + i % 5 : 0) + sep;
+            painted += std::to_string(i / 64 % 8 < 2 ? 0 : 3 + i / 256) + sep;
+            full += std::to_string(1 + i % 7) + sep;
+        }
+
+        const auto layer = [](const std::string &name, const std::string &data) {
+            return "<layer name=\"" + name + "\" width=\"64\" height=\"64\"><data encoding=\"csv\">"
+                + data + "</data></layer>";
+        };
+
+        return R"(<map version="1.0" orientation="orthogonal" width="64" height="64" tilewidth="16" tileheight="16">)"
+            R"(<tileset firstgid="1" name="a" tilewidth="16" tileheight="16" tilecount="48" columns="8"/>)"
+            + layer("scattered", scattered) + layer("painted", painted) + layer("full", full)
+            + "</map>";
+    }
+}
+
+TEST(TmxTileLayer, AutoStoragePicksByDensity)
+{
+    const auto text = MakeDensityMap();
+    const auto tiles = ParseWith(Tmx::TMX_STORAGE_TILES, false, text);
+    const auto packed = ParseWith(Tmx::TMX_STORAGE_AUTO, false, text);
+    ASSERT_FALSE(packed.HasError()) << packed.GetErrorText();
+
+    const Tmx::TileLayerStorageType picked[] = {
+        Tmx::TMX_STORAGE_SPARSE, Tmx::TMX_STORAGE_RUNS, Tmx::TMX_STORAGE_GIDS };
+    for (int i = 0; i < 3; ++i)
+    {
+        const auto &layer = *packed.GetTileLayer(i);
+        ExpectSameTiles(*tiles.GetTileLayer(i), layer, picked[i]);
+        ExpectRegion(layer, { 30, 5, 40, 9 });
+
+        // Only the cells with tiles come out, in row order.
+        std::vector<uint32_t> expected, visited;
+        int last = -1;
+        for (int y = 0; y < 64; ++y)
+        {
+            for (int x = 0; x < 64; ++x)
+            {
+                if (layer.GetTileGid(x, y) != 0)
+                {
+                    expected.push_back(static_cast<uint32_t>(y * 64 + x));
+                }
+            }
+        }
+        layer.IterateNonEmptyTiles([&](int x, int y, const Tmx::MapTile &tile) {
+            EXPECT_GT(y * 64 + x, last);
+            last = y * 64 + x;
+            EXPECT_EQ(layer.GetTileGid(x, y), tile.gid);
+            visited.push_back(static_cast<uint32_t>(y * 64 + x));
+        });
+        EXPECT_EQ(expected, visited) << layer.GetName();
+
+        EXPECT_EQ(64u * 64u * sizeof(Tmx::MapTile), tiles.GetTileLayer(i)->GetTileMemory());
+        EXPECT_EQ(0u, tiles.GetTileLayer(i)->GetTileMemorySaved());
+        EXPECT_EQ(64u * 64u * sizeof(Tmx::MapTile),
+            layer.GetTileMemory() + layer.GetTileMemorySaved());
+    }
+
+    // The sparse layer takes a sliver of the gids.
+    EXPECT_LT(packed.GetTileLayer(0)->GetTileMemory() * 4, 64u * 64u * sizeof(uint32_t));
+    EXPECT_LT(packed.GetTileLayer(1)->GetTileMemory() * 8, 64u * 64u * sizeof(uint32_t));
+}
@@ -0,0 +1,153 @@
+//-----------------------------------------------------------------------------
+// gtests_tilesetlookup
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Tmx.h"
+
+namespace
+{
+    const uint32_t flags[] = { 0, Tmx::FlippedHorizontallyFlag, Tmx::FlippedVerticallyFlag,
+        Tmx::FlippedDiagonallyFlag | Tmx::FlippedHorizontallyFlag };
+
+    // A map with a tileset at each of the first gids and one csv layer.
+    Tmx::Map MakeMap(const std::vector<uint32_t> &firstGids, const std::vector<uint32_t> &gids)
+    {
+        std::string text = R"(<map version="1.0" orientation="orthogonal" width=")"
+            + std::to_string(gids.size()) + R"(" height="1" tilewidth="8" tileheight="8">)";
+        for (const auto firstGid : firstGids)
+        {
+            text += R"(<tileset firstgid=")" + std::to_string(firstGid)
+                + R"(" name="t" tilewidth="8" tileheight="8" tilecount="16" columns="4"/>)";
+        }
+
+        text += R"(<layer name="l" width=")" + std::to_string(gids.size())
+            + R"(" height="1"><data encoding="csv">)";
+        for (const auto gid : gids)
+        {
+            text += std::to_string(gid) + ",";
+        }
+        text.back() = '<';
+        text += "/data></layer></map>";
+
+        return Tmx::Map::ParseText(text);
+    }
+
+    // What the map did before, walking the tilesets from the last one.
+    int Reference(const std::vector<uint32_t> &firstGids, uint32_t gid)
+    {
+        gid &= ~(Tmx::FlippedHorizontallyFlag | Tmx::FlippedVerticallyFlag
+            | Tmx::FlippedDiagonallyFlag);
+        for (int i = static_cast<int>(firstGids.size()) - 1; i >= 0; --i)
+        {
+            if (gid >= firstGids[i])
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void ExpectResolvedLikeReference(const std::vector<uint32_t> &firstGids,
+        const std::vector<uint32_t> &ids, bool hasTable)
+    {
+        std::vector<uint32_t> gids;
+        for (const auto id : ids)
+        {
+            for (const auto flag : flags)
+            {
+                gids.push_back(id | flag);
+            }
+        }
+
+        const auto map = MakeMap(firstGids, gids);
+        ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+        const auto &lookup = map.GetTilesetLookup();
+        EXPECT_EQ(hasTable, lookup.HasTable());
+
+        std::vector<int32_t> indices(gids.size());
+        std::vector<uint32_t> localIds(gids.size());
+        std::vector<uint8_t> flipFlags(gids.size());
+        lookup.Resolve(gids, indices, localIds, flipFlags);
+
+        const auto layer = map.GetTileLayer(0);
+        for (size_t i = 0; i < gids.size(); ++i)
+        {
+            const auto gid = gids[i];
+            const auto expected = Reference(firstGids, gid);
+            const auto firstGid = expected == -1 ? 0 : firstGids[expected];
+            EXPECT_EQ(expected, map.FindTilesetIndex(static_cast<int>(gid))) << gid;
+            EXPECT_EQ(expected, indices[i]) << gid;
+            EXPECT_EQ((gid & 0x1fffffff) - firstGid, localIds[i]) << gid;
+            EXPECT_EQ(gid >> 29, flipFlags[i]) << gid;
+
+            const auto &tile = layer->GetTile(static_cast<int>(i), 0);
+            EXPECT_EQ(expected, tile.tilesetId) << gid;
+            EXPECT_EQ(localIds[i], tile.id) << gid;
+            EXPECT_EQ(expected == -1 ? nullptr : &map.GetTilesets()[expected],
+                map.FindTileset(static_cast<int>(gid)));
+        }
+    }
+}
+
+TEST(TmxTilesetLookup, SmallGidsUseTheTable)
+{
+    // Tilesets may leave gaps and two may start at the same gid.
+    const std::vector<uint32_t> firstGids{ 1, 17, 100, 100, 2000 };
+    std::vector<uint32_t> ids;
+    for (uint32_t id = 0; id < 2100; id += 3)
+    {
+        ids.push_back(id);
+    }
+    ids.insert(ids.end(), { 16, 17, 99, 100, 1999, 2000, 65536, 0x1fffffff });
+
+    ExpectResolvedLikeReference(firstGids, ids, true);
+}
+
+TEST(TmxTilesetLookup, LargeGidsAreSearched)
+{
+    const std::vector<uint32_t> firstGids{ 5, 9, 70000, 70016, 1000000, 1000001, 3000000 };
+    std::vector<uint32_t> ids{ 0, 4, 5, 8, 9, 69999, 70000, 70015, 70016, 999999,
+        1000000, 1000001, 2999999, 3000000, 0x1fffffff };
+    for (uint32_t id = 1; id < 4000000; id = id * 3 + 1)
+    {
+        ids.push_back(id);
+    }
+
+    ExpectResolvedLikeReference(firstGids, ids, false);
+}
+
+TEST(TmxTilesetLookup, MapWithoutTilesets)
+{
+    ExpectResolvedLikeReference({}, { 0, 1, 7, 0x1fffffff }, false);
+
+    const Tmx::TilesetLookup lookup;
+    EXPECT_EQ(-1, lookup.FindIndex(12));
+    EXPECT_EQ(0, lookup.GetFirstGid(-1));
+}
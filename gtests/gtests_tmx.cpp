@@ -1,12 +1,30 @@
+#include <filesystem>
+#include <fstream>
+#include <random>
 #include <sstream>
 
 #include <gtest/gtest.h>
 
 #include "Tmx.h"
 
+namespace
+{
+    // These tests also run against the streaming front-end, see tmx_gtests_streaming.
+    Tmx::Map ParseMapText(std::string_view text)
+    {
+#ifdef TMX_GTESTS_STREAMING
+        Tmx::ParseOptions options;
+        options.streaming = true;
+        return Tmx::MapLoader{ options }.ParseText(text);
+#else
+        return Tmx::Map::ParseText(text);
+#endif
+    }
+}
+
 TEST(TmxMap, Ctor)
 {
-    auto map = Tmx::Map::ParseText(R"(
+    auto map = ParseMapText(R"(
 <?xml version="1.0" encoding="UTF-8"?>
 <map version="1.0"
     tiledversion="1.1.5"
@@ -34,7 +52,7 @@ TEST(TmxMap, Ctor)
 
 TEST(TmxMap, FailureToParse)
 {
-    auto map = Tmx::Map::ParseText(R"(
+    auto map = ParseMapText(R"(
 <?xml version="1.0" encoding="UTF-8"?>
 <map 
 <map>
@@ -51,7 +69,7 @@ void testMapProperty(const char *props, T&& test)
     ss << R"(<?xml version="1.0" encoding="UTF-8"?>)";
     ss << "<map " << props << ">" << "</map>";
 
-    const auto map = Tmx::Map::ParseText(ss.str());
+    const auto map = ParseMapText(ss.str());
 
     EXPECT_EQ(0, map.GetErrorCode());
     EXPECT_EQ(0, map.GetNumLayers());
@@ -315,4 +333,54 @@ TEST(TmxMap, Infinite)
     testMapProperty(R"(infinite="1")", [](const Tmx::Map &map) {
         EXPECT_EQ(true, map.IsInfinite());
     });
-}
\ No newline at end of file
+}
+
+TEST(TmxMap, ParseFileMapped)
+{
+    // A name of its own, as ctest may run both test programs side by side.
+    const auto fileName = (std::filesystem::temp_directory_path()
+        / ("tmx_mapped_" + std::to_string(std::random_device{}()) + ".tmx")).string();
+    std::ofstream{ fileName } << R"(<?xml version="1.0" encoding="UTF-8"?>
+<map version="1.0" orientation="isometric" width="2" height="2" tilewidth="32" tileheight="16">
+ <tileset firstgid="1" name="t" tilewidth="32" tileheight="16" tilecount="4" columns="2"/>
+ <layer id="1" name="ground" width="2" height="2">
+  <data encoding="csv">1,2,3,2147483652</data>
+ </layer>
+ <layer id="2" name="tiles" width="2" height="2">
+  <properties>
+   <property name="note">&lt;data encoding="csv"&gt;</property>
+  </properties>
+  <data>
+   <tile gid="4"/><tile gid="0"/><tile gid="0"/><tile gid="1"/>
+  </data>
+ </layer>
+</map>
+)";
+
+    const auto map = Tmx::Map::ParseFileMapped(fileName);
+    std::filesystem::remove(fileName);
+
+    ASSERT_FALSE(map.HasError()) << map.GetErrorText();
+    EXPECT_EQ(Tmx::MapOrientation::TMX_MO_ISOMETRIC, map.GetOrientation());
+    ASSERT_EQ(2, map.GetNumTileLayers());
+
+    const auto layer = map.GetTileLayer(0);
+    EXPECT_EQ("ground", layer->GetName());
+    EXPECT_EQ(2u, layer->GetTileGid(1, 0));
+    EXPECT_EQ(3u, layer->GetTileId(1, 1));
+    EXPECT_TRUE(layer->IsTileFlippedHorizontally(1, 1));
+
+    const auto tiles = map.GetTileLayer(1);
+    EXPECT_EQ("<data encoding=\"csv\">", tiles->GetProperties().GetStringProperty("note"));
+    EXPECT_EQ(4u, tiles->GetTileGid(0, 0));
+    EXPECT_EQ(0u, tiles->GetTileGid(1, 0));
+    EXPECT_EQ(1u, tiles->GetTileGid(1, 1));
+}
+
+TEST(TmxMap, ParseFileMappedMissingFile)
+{
+    const auto map = Tmx::Map::ParseFileMapped("does/not/exist.tmx");
+
+    EXPECT_TRUE(map.HasError());
+    EXPECT_EQ(Tmx::TMX_COULDNT_OPEN, map.GetErrorCode());
+}
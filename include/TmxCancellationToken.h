@@ -0,0 +1,54 @@
+//-----------------------------------------------------------------------------
+// TmxCancellationToken.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace Tmx
+{
+    //-------------------------------------------------------------------------
+    /// Lets the caller of an asynchronous parse stop it early.
+    /// Copies share their state: cancelling any of them cancels them all.
+    /// The parse checks the token between its phases, see Map::ParseFileAsync.
+    //-------------------------------------------------------------------------
+    class CancellationToken
+    {
+    public:
+        CancellationToken()
+            : cancelled{ std::make_shared<std::atomic<bool>>(false) }
+        {}
+
+        /// Ask the parses holding this token to stop.
+        void Cancel() const { cancelled->store(true, std::memory_order_relaxed); }
+
+        /// Get whether Cancel was called on this token or a copy of it.
+        bool IsCancelled() const { return cancelled->load(std::memory_order_relaxed); }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+}
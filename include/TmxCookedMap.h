@@ -0,0 +1,327 @@
+//-----------------------------------------------------------------------------
+// TmxCookedMap.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace Tmx
+{
+    class Map;
+    class MappedFile;
+
+    //-------------------------------------------------------------------------
+    /// Records of the cooked map format.
+    /// A cooked file is a Header followed by tables of the records below.
+    /// Every record is made of 32-bit fields in the byte order of the machine
+    /// that cooked it, so that the file can be used in place once mapped.
+    /// Records refer to each other by index ranges into the tables.
+    //-------------------------------------------------------------------------
+    namespace Cooked
+    {
+        /// The version written by CookedMap::Cook. Other versions are rejected.
+        constexpr std::uint32_t Version = 1;
+
+        /// The tables of a cooked file.
+        enum Table : std::uint32_t
+        {
+            TABLE_STRINGS,
+            TABLE_PROPERTIES,
+            TABLE_TILESETS,
+            TABLE_TILES,
+            TABLE_LAYERS,
+            TABLE_CHUNKS,
+            TABLE_GIDS,
+            TABLE_OBJECTS,
+            TABLE_POINTS,
+            TABLE_COUNT
+        };
+
+        /// Where a table starts, in bytes from the start of the file, and
+        /// its number of records.
+        struct TableEntry
+        {
+            std::uint32_t offset;
+            std::uint32_t count;
+        };
+
+        /// A run of records in one table.
+        struct Range
+        {
+            std::uint32_t first;
+            std::uint32_t count;
+        };
+
+        /// A string of the string table, always followed by a '\0'.
+        struct String
+        {
+            std::uint32_t offset;
+            std::uint32_t size;
+        };
+
+        struct Header
+        {
+            char magic[4];
+            std::uint32_t version;
+            std::uint32_t byteOrder;
+            std::uint32_t size;
+            TableEntry tables[TABLE_COUNT];
+
+            /// Map attributes, see Tmx::Map.
+            std::uint32_t orientation;
+            std::uint32_t renderOrder;
+            std::uint32_t staggerAxis;
+            std::uint32_t staggerIndex;
+            std::int32_t width;
+            std::int32_t height;
+            std::int32_t tileWidth;
+            std::int32_t tileHeight;
+            std::int32_t nextObjectId;
+            std::int32_t hexsideLength;
+            float parallaxOriginX;
+            float parallaxOriginY;
+            std::uint32_t backgroundColor;
+            std::uint32_t infinite;
+
+            Range properties;
+
+            /// The top-level layers, in the order of Map::GetLayers.
+            Range layers;
+        };
+
+        struct Property
+        {
+            String name;
+
+            /// A Tmx::PropertyType.
+            std::uint32_t type;
+            std::uint32_t isEmpty;
+
+            /// The bits of a bool, int, object, float or color value.
+            std::uint32_t value;
+
+            /// The value of a string, file or class property.
+            String text;
+        };
+
+        struct Tileset
+        {
+            std::int32_t firstGid;
+            String name;
+            std::int32_t tileWidth;
+            std::int32_t tileHeight;
+            std::int32_t margin;
+            std::int32_t spacing;
+            std::int32_t tileCount;
+            std::int32_t columns;
+            String image;
+            std::int32_t imageWidth;
+            std::int32_t imageHeight;
+            Range properties;
+            Range tiles;
+        };
+
+        /// A tile of a tileset that has a type or properties.
+        struct Tile
+        {
+            std::int32_t id;
+            String type;
+            Range properties;
+        };
+
+        struct Layer
+        {
+            /// A Tmx::LayerType.
+            std::uint32_t type;
+            String name;
+            std::int32_t x;
+            std::int32_t y;
+            std::int32_t width;
+            std::int32_t height;
+            float opacity;
+            std::uint32_t visible;
+            float offsetX;
+            float offsetY;
+            float parallaxX;
+            float parallaxY;
+            Range properties;
+
+            /// Tile layers: the gids, flip flags included, row by row, or the
+            /// chunks on infinite maps.
+            Range gids;
+            Range chunks;
+            std::int32_t chunkWidth;
+            std::int32_t chunkHeight;
+
+            /// Object groups: the objects and the color.
+            Range objects;
+            std::uint32_t color;
+
+            /// Image layers: the image.
+            String image;
+
+            /// Group layers: the child layers.
+            Range children;
+        };
+
+        struct Chunk
+        {
+            std::int32_t x;
+            std::int32_t y;
+            std::int32_t width;
+            std::int32_t height;
+            Range gids;
+        };
+
+        enum ObjectShape : std::uint32_t
+        {
+            SHAPE_RECTANGLE,
+            SHAPE_ELLIPSE,
+            SHAPE_POLYGON,
+            SHAPE_POLYLINE,
+            SHAPE_TEXT
+        };
+
+        struct Object
+        {
+            std::int32_t id;
+            String name;
+            String type;
+            std::int32_t x;
+            std::int32_t y;
+            std::int32_t width;
+            std::int32_t height;
+            float rotation;
+            std::uint32_t gid;
+            std::uint32_t visible;
+            std::uint32_t shape;
+
+            /// The points of a polygon or polyline.
+            Range points;
+
+            /// The contents of a text object.
+            String text;
+            Range properties;
+        };
+
+        struct Point
+        {
+            float x;
+            float y;
+        };
+    }
+
+    //-------------------------------------------------------------------------
+    /// A map in the cooked binary format: a flat, fully resolved copy of a
+    /// Tmx::Map that is used in place, without parsing or allocating per
+    /// element. All records are checked once when the map is opened.
+    /// Create cooked data with Cook or the tmxcook tool.
+    //-------------------------------------------------------------------------
+    class CookedMap
+    {
+    public:
+        /// Map a cooked file into memory. Check HasError() for the result.
+        static CookedMap Open(const std::string &fileName);
+
+        /// Use cooked data in memory, which must outlive the map and be
+        /// aligned on 4 bytes.
+        static CookedMap FromMemory(std::string_view data);
+
+        /// Serialize a map to the cooked format.
+        static std::string Cook(const Tmx::Map &map);
+
+        CookedMap(CookedMap &&) noexcept;
+        CookedMap &operator=(CookedMap &&) noexcept;
+        ~CookedMap();
+
+        /// Get whether the data could not be used.
+        bool HasError() const { return !error_text.empty(); }
+
+        /// Get an error string describing what is wrong with the data.
+        const std::string &GetErrorText() const { return error_text; }
+
+        /// Get the header with the attributes of the map.
+        const Cooked::Header &GetHeader() const;
+
+        /// Get the properties of the map.
+        std::span<const Cooked::Property> GetProperties() const;
+
+        /// Get the properties in a range, as found in the records.
+        std::span<const Cooked::Property> GetProperties(Cooked::Range range) const;
+
+        /// Find a property by name in a range, or nullptr if there is none.
+        const Cooked::Property *FindProperty(Cooked::Range range, std::string_view name) const;
+
+        /// Get a string of the string table.
+        std::string_view GetString(Cooked::String s) const;
+
+        /// Get all the tilesets, ordered by first gid.
+        std::span<const Cooked::Tileset> GetTilesets() const;
+
+        /// Get the tiles of a tileset that have a type or properties.
+        std::span<const Cooked::Tile> GetTiles(const Cooked::Tileset &tileset) const;
+
+        /// Find the index of the tileset a gid belongs to, or -1.
+        int FindTilesetIndex(std::uint32_t gid) const;
+
+        /// Get the top-level layers.
+        std::span<const Cooked::Layer> GetLayers() const;
+
+        /// Get the child layers of a group layer.
+        std::span<const Cooked::Layer> GetChildren(const Cooked::Layer &group) const;
+
+        /// Get the gids of a tile layer of a finite map, row by row.
+        std::span<const std::uint32_t> GetGids(const Cooked::Layer &layer) const;
+
+        /// Get the chunks of a tile layer of an infinite map.
+        std::span<const Cooked::Chunk> GetChunks(const Cooked::Layer &layer) const;
+
+        /// Get the gids of a chunk, row by row.
+        std::span<const std::uint32_t> GetGids(const Cooked::Chunk &chunk) const;
+
+        /// Get the objects of an object group.
+        std::span<const Cooked::Object> GetObjects(const Cooked::Layer &layer) const;
+
+        /// Get the points of a polygon or polyline object.
+        std::span<const Cooked::Point> GetPoints(const Cooked::Object &object) const;
+
+    private:
+        CookedMap(std::string_view data, std::unique_ptr<Tmx::MappedFile> file);
+
+        template <typename T>
+        std::span<const T> Get(Cooked::Table table, Cooked::Range range) const;
+
+        bool Validate();
+
+        std::unique_ptr<Tmx::MappedFile> file;
+        std::string_view data;
+        std::string error_text;
+    };
+}
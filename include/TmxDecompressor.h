@@ -0,0 +1,91 @@
+//-----------------------------------------------------------------------------
+// TmxDecompressor.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace Tmx
+{
+    //-------------------------------------------------------------------------
+    /// Decompresses the zlib, gzip and zstd data of tile layers. The size of a layer
+    /// is known before its data is decompressed, so backends work on whole
+    /// buffers at once instead of streaming. Backends built into the library
+    /// are found by name; others can be made by deriving from this class and
+    /// set with ParseOptions::decompressor. Backends are used from several
+    /// threads at once when layers are decoded side by side.
+    //-------------------------------------------------------------------------
+    class Decompressor
+    {
+    public:
+        virtual ~Decompressor() = default;
+
+        /// Get the name of the backend, such as "zlib" or "libdeflate".
+        virtual const char *GetName() const = 0;
+
+        /// Decompress zlib data into out, which has room for outSize bytes.
+        /// Returns the number of bytes written, or -1 if the data is not
+        /// valid or does not fit.
+        virtual std::ptrdiff_t DecompressZlib(const void *data, size_t size,
+            void *out, size_t outSize) const = 0;
+
+        /// Decompress gzip data as DecompressZlib does zlib data.
+        virtual std::ptrdiff_t DecompressGzip(const void *data, size_t size,
+            void *out, size_t outSize) const = 0;
+
+        /// Decompress zstd data as DecompressZlib does zlib data. Every
+        /// backend uses libzstd for it, which the library is only built with
+        /// if USE_ZSTD found it; otherwise this returns -1. Backends that
+        /// bring their own zstd override CanDecompressZstd as well.
+        virtual std::ptrdiff_t DecompressZstd(const void *data, size_t size,
+            void *out, size_t outSize) const;
+
+        /// Get whether DecompressZstd can read anything. Maps with zstd
+        /// compressed layers fail to parse with TMX_UNSUPPORTED_COMPRESSION
+        /// otherwise. By default whether the library was built with zstd.
+        virtual bool CanDecompressZstd() const;
+
+        /// Get whether the library was built with zstd.
+        static bool HasZstd();
+
+        /// Get the backend used unless ParseOptions::decompressor is set: the
+        /// first of libdeflate, zlib-ng and zlib (or miniz) built in.
+        static const Decompressor &GetDefault();
+
+        /// Get a backend built into the library by its name, or nullptr.
+        static const Decompressor *Find(std::string_view name);
+
+        /// Get the names of the backends built into the library, the
+        /// default one first.
+        static std::vector<std::string_view> GetNames();
+
+    protected:
+        Decompressor() = default;
+        Decompressor(const Decompressor &) = default;
+        Decompressor &operator=(const Decompressor &) = default;
+    };
+}
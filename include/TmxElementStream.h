@@ -0,0 +1,71 @@
+//-----------------------------------------------------------------------------
+// TmxElementStream.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace Tmx
+{
+    //-------------------------------------------------------------------------
+    /// Splits XML text into the start tag of its root element and the
+    /// top-level children of the root, one at a time, without building a
+    /// document for the whole text. Only the structure is checked here; each
+    /// piece is meant to be parsed on its own afterwards.
+    //-------------------------------------------------------------------------
+    class ElementStream
+    {
+    public:
+        /// Find the root element of the text. The text must outlive the stream.
+        explicit ElementStream(std::string_view text);
+
+        /// Get the start tag of the root element, written as an empty element.
+        const std::string &GetRoot() const { return root; }
+
+        /// Get the next child of the root element along with its contents.
+        /// Returns false once the root element is closed or on error.
+        bool Next(std::string_view *element);
+
+        /// Get whether the text is malformed.
+        bool HasError() const { return !error_text.empty(); }
+
+        /// Get a description of the error.
+        const std::string &GetErrorText() const { return error_text; }
+
+    private:
+        std::size_t SkipMarkup(std::size_t start);
+        std::size_t FindTagEnd(std::size_t start);
+        bool Fail(std::string errorText);
+
+        std::string_view text;
+        std::size_t pos{ 0 };
+        bool done{ false };
+
+        std::string root;
+        std::string error_text;
+    };
+}
@@ -34,6 +34,7 @@
 
 namespace Tmx
 {
+    class JsonReader;
     class Map;
 
     //-------------------------------------------------------------------------
@@ -46,6 +47,9 @@ namespace Tmx
         /// Construct an GroupLayer on the given map.
         GroupLayer(Tmx::Map *_map, const tinyxml2::XMLElement *data);
 
+        /// Construct a group from a layer of a JSON map, children included.
+        GroupLayer(Tmx::Map *_map, Tmx::JsonReader &json);
+
         GroupLayer(GroupLayer &&) = default;
         GroupLayer& operator=(GroupLayer &&) = default;
 
@@ -43,6 +43,10 @@ namespace Tmx
     public:
         Image(const tinyxml2::XMLElement *imageElement);
 
+        /// Construct an image from the attributes of a JSON map, which has
+        /// no element of its own for it.
+        Image(std::string source, int width, int height, Tmx::Color transparentColor);
+
         /// Get the path to the file of the image (relative to the map)
         const std::string &GetSource() const { return source; }
 
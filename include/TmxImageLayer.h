@@ -32,6 +32,7 @@
 
 namespace Tmx
 {
+    class JsonReader;
     class Map;
 
     //-------------------------------------------------------------------------
@@ -44,6 +45,9 @@ namespace Tmx
         /// Construct an ImageLayer on the given map.
         ImageLayer(Tmx::Map *_map, const tinyxml2::XMLElement *data);
 
+        /// Construct an image layer from a layer of a JSON map.
+        ImageLayer(Tmx::Map *_map, Tmx::JsonReader &json);
+
         /// Returns a variable containing information
         /// about the image of the ImageLayer.
         [[nodiscard]] const Tmx::Image* GetImage() const { return image.get(); }
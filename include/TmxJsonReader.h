@@ -0,0 +1,217 @@
+//-----------------------------------------------------------------------------
+// TmxJsonReader.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace Tmx
+{
+    enum JsonType
+    {
+        TMX_JSON_NULL,
+        TMX_JSON_BOOL,
+        TMX_JSON_NUMBER,
+        TMX_JSON_STRING,
+        TMX_JSON_ARRAY,
+        TMX_JSON_OBJECT,
+        TMX_JSON_INVALID
+    };
+
+    //-------------------------------------------------------------------------
+    /// Reads JSON text value by value, as Tiled writes .tmj and .tsj files.
+    /// Nothing is built for the document as a whole: the caller walks the
+    /// objects and arrays and reads each value straight into its own storage.
+    /// After an error every read returns a default value and the walk ends.
+    //-------------------------------------------------------------------------
+    class JsonReader
+    {
+    public:
+        /// Read the given text, which must outlive the reader.
+        explicit JsonReader(std::string_view text);
+
+        /// Get the type of the next value.
+        JsonType Peek();
+
+        /// Call member(key) for each member of the next value, an object.
+        /// The callback must read or skip the value of the member. The key
+        /// is only valid until then.
+        template <typename T>
+        void ReadObject(T &&member);
+
+        /// Call element() for each element of the next value, an array.
+        /// The callback must read or skip the element.
+        template <typename T>
+        void ReadArray(T &&element);
+
+        /// Call element(value) for each element of the next value, an array
+        /// of unsigned integers such as the gids of a layer. Does the same as
+        /// ReadArray with ReadUnsigned, in a tighter loop.
+        template <typename T>
+        void ReadUnsignedArray(T &&element);
+
+        /// Read the next value as a string, with its escapes resolved.
+        std::string ReadString();
+
+        /// Read the next value as a bool.
+        bool ReadBool();
+
+        /// Read the next value as a number.
+        double ReadDouble();
+        float ReadFloat() { return static_cast<float>(ReadDouble()); }
+
+        /// Read the next value as an integer. Fractions are truncated.
+        int ReadInt();
+
+        /// Read the next value as an unsigned integer, such as a gid.
+        unsigned ReadUnsigned();
+
+        /// Skip the next value and return its text.
+        std::string_view ReadRaw();
+
+        /// Skip the next value.
+        void Skip() { ReadRaw(); }
+
+        /// Find a string member of the next value, an object, without
+        /// consuming it. Returns an empty string if there is none.
+        std::string FindString(std::string_view key);
+
+        /// Get the position of the next value, to come back to it with Seek.
+        /// Members that depend on others which come later are read this way.
+        std::size_t Tell();
+
+        /// Continue reading at a position given by Tell.
+        void Seek(std::size_t position);
+
+        /// Get whether only whitespace is left.
+        bool AtEnd();
+
+        /// Get whether the text is malformed.
+        bool HasError() const { return !error_text.empty(); }
+
+        /// Get a description of the first error.
+        const std::string &GetErrorText() const { return error_text; }
+
+    private:
+        bool BeginObject();
+        bool NextMember(std::string_view *key, bool first);
+        bool BeginArray();
+        bool NextElement(bool first);
+        bool ScanDigits(unsigned *out);
+
+        void SkipWhitespace();
+        bool Expect(char c);
+        bool ScanString(std::string *out);
+        bool ScanNumber(double *out);
+        void Fail(const char *what);
+
+        std::string_view text;
+        std::size_t pos{ 0 };
+
+        // Holds keys with escapes in them.
+        std::string key_storage;
+
+        std::string error_text;
+    };
+
+    template <typename T>
+    void JsonReader::ReadObject(T &&member)
+    {
+        if (!BeginObject())
+        {
+            return;
+        }
+
+        std::string_view key;
+        for (bool first = true; NextMember(&key, first); first = false)
+        {
+            const auto start = pos;
+            member(key);
+
+            // Values the callback left alone are skipped.
+            if (pos == start)
+            {
+                Skip();
+            }
+        }
+    }
+
+    template <typename T>
+    void JsonReader::ReadUnsignedArray(T &&element)
+    {
+        if (!BeginArray() || !NextElement(true))
+        {
+            return;
+        }
+
+        for (;;)
+        {
+            // Digits right before a comma, which is how Tiled writes gids,
+            // are read here. Anything else takes the long way.
+            const auto start = pos;
+            unsigned value = 0;
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9' && pos - start < 9)
+            {
+                value = value * 10 + (text[pos++] - '0');
+            }
+
+            if (pos != start && pos < text.size() && text[pos] == ',')
+            {
+                ++pos;
+                element(value);
+                continue;
+            }
+
+            pos = start;
+            element(ReadUnsigned());
+            if (!NextElement(false))
+            {
+                return;
+            }
+        }
+    }
+
+    template <typename T>
+    void JsonReader::ReadArray(T &&element)
+    {
+        if (!BeginArray())
+        {
+            return;
+        }
+
+        for (bool first = true; NextElement(first); first = false)
+        {
+            const auto start = pos;
+            element();
+
+            if (pos == start)
+            {
+                Skip();
+            }
+        }
+    }
+}
@@ -29,6 +29,7 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include <tinyxml2.h>
 
@@ -37,6 +38,7 @@
 
 namespace Tmx
 {
+    class JsonReader;
     class Map;
     class Tile;
 
@@ -62,6 +64,9 @@ namespace Tmx
         Layer(const Tmx::Tile *_tile, int _x, int _y,
             int _width, int _height, LayerType _layerType, const tinyxml2::XMLElement *data);
 
+        /// Group layers own their children as layers.
+        virtual ~Layer() = default;
+
         /// Get the pointer to the parent map.
         const Tmx::Map *mapGetMap() const { return map; }
 
@@ -97,7 +102,9 @@ namespace Tmx
         /// Set the zorder of the layer.
         void SetZOrder( int z ) { zOrder = z; }
 
-        /// Get the parse order of the layer.
+        /// Get the parse order of the layer: its position among the layers of
+        /// its map, group layers and their children included, in the order
+        /// they were read, from 0. Layers of a tile are numbered 0.
         int GetParseOrder() const { return parseOrder; }
 
         /// Get the type of the layer.
@@ -118,9 +125,28 @@ namespace Tmx
         const std::optional<Color> &GetTintColor() const { return tintColor; }
 
     protected:
+        friend class Map;
+
+        Layer(const Layer &) = default;
+        Layer(Layer &&) = default;
+        Layer &operator=(const Layer &) = default;
+        Layer &operator=(Layer &&) = default;
+
         Layer(Tmx::Map *_map, const Tmx::Tile *_tile, int _x, int _y,
             int _width, int _height, LayerType _layerType, const tinyxml2::XMLElement *data);
 
+        /// Construct a layer of a JSON map, whose members are then read by
+        /// the derived class with the help of ParseJsonMember.
+        Layer(Tmx::Map *_map, const Tmx::Tile *_tile, int _width, int _height,
+            LayerType _layerType);
+
+        /// Read a member of a JSON layer common to all layer types.
+        /// Returns false if the key is not one of them.
+        bool ParseJsonMember(std::string_view key, Tmx::JsonReader &json);
+
+        /// Take the next parse order, as if the layer had just been parsed.
+        void TakeNextParseOrder();
+
         /// @cond INTERNAL
         Tmx::Map *map;
         const Tmx::Tile *tile;
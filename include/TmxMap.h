@@ -27,13 +27,23 @@
 //-----------------------------------------------------------------------------
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <future>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "TmxCancellationToken.h"
+#include "TmxParseOptions.h"
 #include "TmxPropertySet.h"
+#include "TmxStringPool.h"
+#include "TmxTemplateCache.h"
+#include "TmxThreadPool.h"
+#include "TmxTilesetLookup.h"
 
 namespace tinyxml2
 {
@@ -48,7 +58,11 @@ namespace Tmx
     class Object;
     class ObjectGroup;
     class GroupLayer;
+    class JsonReader;
+    class MapLoader;
+    class MappedFile;
     class Tileset;
+    struct MapChangeSet;
 
     //-------------------------------------------------------------------------
     /// Error in handling of the Map class.
@@ -63,7 +77,14 @@ namespace Tmx
         TMX_PARSING_ERROR = 0x02,
 
         /// The size of the file is invalid.
-        TMX_INVALID_FILE_SIZE = 0x04
+        TMX_INVALID_FILE_SIZE = 0x04,
+
+        /// The parse was stopped through its CancellationToken.
+        TMX_CANCELLED = 0x08,
+
+        /// A tile layer is compressed with a codec the library was built
+        /// without, such as zstd without USE_ZSTD.
+        TMX_UNSUPPORTED_COMPRESSION = 0x10
     };
 
     //-------------------------------------------------------------------------
@@ -120,19 +141,52 @@ namespace Tmx
     /// This class is the root class of the parser.
     /// It has all of the information in regard to the TMX file.
     /// This class has a property set.
+    /// Any number of maps may be parsed at once on different threads, with a
+    /// shared MapLoader or without one. A parsed map may be read from several
+    /// threads at once, but not while it is being reloaded.
     //-------------------------------------------------------------------------
     class Map
     {
     public:
-        /// Read a file and parse it.
+        /// Read a file and parse it. Files named .tmj or .json are read as
+        /// Tiled JSON maps.
         /// Note: use '/' instead of '\\' as it is using '/' to find the path.
         static Map ParseFile(const std::string &fileName);
 
-        /// Parse text containing TMX formatted XML.
+        /// Read a file through a read-only memory mapping and parse it one
+        /// top-level element at a time. The encoded text of tile layers is
+        /// decoded straight from the mapped pages rather than copied into a
+        /// document first. The result is identical to ParseFile.
+        static Map ParseFileMapped(const std::string &fileName);
+
+        /// Read and parse a file without blocking the calling thread.
+        /// The parse is handed to the executor, or run as by std::async if
+        /// none is given, so that the future waits for it when destroyed.
+        /// It checks the token before reading the document, before each
+        /// tileset, layer and object group and before decoding the tile
+        /// layers; once cancelled it stops there and the map has the error
+        /// TMX_CANCELLED.
+        static std::future<Map> ParseFileAsync(const std::string &fileName,
+            Tmx::CancellationToken token = {}, Tmx::Executor executor = {});
+
+        /// Same as above, handing the map to onDone on the executor's thread
+        /// instead of returning a future. Without an executor the parse runs
+        /// on threads shared by all such calls, which finish the parses
+        /// still queued when the program exits. Whatever onDone throws is
+        /// caught and dropped.
+        static void ParseFileAsync(const std::string &fileName,
+            std::function<void(Map)> onDone, Tmx::CancellationToken token = {},
+            Tmx::Executor executor = {});
+
+        /// Parse text containing TMX formatted XML, or a Tiled JSON map.
         static Map ParseText(const std::string &text, const std::string &path = "");
         static Map ParseText(const char *text, const std::string &path = "");
         static Map ParseText(std::string_view text, const std::string &path = "");
 
+        /// Maps can be moved but not copied; the layers follow the moved map.
+        Map(Map &&other) noexcept;
+        Map &operator=(Map &&other) noexcept;
+
         /// Get a path to the directory of the map file if any.
         const std::string &GetFilepath() const { return file_path; }
 
@@ -204,7 +258,9 @@ namespace Tmx
         /// Get the whole collection of object groups.
         const std::vector<Tmx::ObjectGroup> &GetObjectGroups() const;
 
-        std::unordered_map<std::string, Tmx::Object> &GetTemplates() { return templates; }
+        /// Get the object templates used by this map.
+        /// Maps parsed by the same MapLoader share one cache.
+        Tmx::TemplateCache &GetTemplates() const { return *templates; }
 
         /// Get the image layer at a certain index.
         const Tmx::ImageLayer *GetImageLayer(int index) const;
@@ -221,7 +277,7 @@ namespace Tmx
         const std::vector<Tmx::GroupLayer> &GetGroupLayers() const { return group_layers; }
 
         /// Find the tileset index for a tileset using a tile gid.
-        int FindTilesetIndex(int gid) const;
+        int FindTilesetIndex(int gid) const { return tileset_lookup.FindIndex(gid); }
 
         /// Find a tileset for a specific gid.
         const Tmx::Tileset *FindTileset(int gid) const;
@@ -235,6 +291,9 @@ namespace Tmx
         /// Get the collection of tilesets.
         const std::vector<Tmx::Tileset> &GetTilesets() const { return tilesets; }
 
+        /// Get the lookup from gids to tilesets, which resolves many gids at once.
+        const Tmx::TilesetLookup &GetTilesetLookup() const { return tileset_lookup; }
+
         /// Get whether there was an error or not.
         bool HasError() const { return has_error; }
 
@@ -247,9 +306,62 @@ namespace Tmx
         /// Get the property set.
         const Tmx::PropertySet &GetProperties() const { return properties; }
 
+        /// Get the options the map was parsed with.
+        const Tmx::ParseOptions &GetParseOptions() const { return options; }
+
+        /// Get the resource the objects, shapes and properties of the map are
+        /// allocated from, see ParseOptions::arena.
+        std::pmr::memory_resource *GetMemoryResource() const;
+
+        /// Get the pool the names and types of the objects of the map and the
+        /// names of its properties are interned in.
+        const Tmx::StringPool &GetStringPool() const { return *strings; }
+
     private:
+        friend class Layer;
+        friend class MapLoader;
+
+        static Map ParseFile(const std::string &fileName, Tmx::MapLoader *loader);
+        static Map ParseFileMapped(const std::string &fileName, Tmx::MapLoader *loader);
+        static Map ParseText(std::string_view text, const std::string &path,
+            Tmx::MapLoader *loader);
+        static Map ParseStreamed(std::string_view text, const std::string &path,
+            Tmx::MapLoader *loader, Tmx::MappedFile *file = nullptr);
+        static Map ParseJson(std::string_view text, const std::string &path,
+            Tmx::MapLoader *loader);
+        static Map ParseFile(const std::string &fileName, Tmx::MapLoader *loader,
+            const Tmx::CancellationToken &token);
+        static void ParseFileAsync(const std::string &fileName, Tmx::MapLoader *loader,
+            std::function<void(Map)> onDone, Tmx::CancellationToken token,
+            Tmx::Executor executor);
+        static Tmx::MapChangeSet Reload(Map &map, std::string_view text,
+            const std::string &path, Tmx::MapLoader *loader);
+        static Tmx::MapChangeSet ReloadFile(Map &map, const std::string &fileName,
+            Tmx::MapLoader *loader);
+
         Map(std::string errorText);
-        Map(const tinyxml2::XMLElement *data, std::string filePath);
+        Map(unsigned char errorCode, std::string errorText);
+        Map(const tinyxml2::XMLElement *data, std::string filePath, Tmx::MapLoader *loader);
+        Map(Tmx::JsonReader &json, std::string filePath, Tmx::MapLoader *loader);
+
+        void ParseChild(const tinyxml2::XMLElement *element, Tmx::MapLoader *loader,
+            std::string_view dataText = {});
+        void FinishParse(Tmx::MapLoader *loader);
+        void DecodePendingLayers(Tmx::MapLoader *loader);
+        void RebindLayers();
+
+        // The layers that follow a tileset resolve their gids with it.
+        void IndexTilesets() { tileset_lookup = Tmx::TilesetLookup{ tilesets }; }
+
+        // Layers are numbered by the map they belong to, so that maps parsed
+        // side by side share nothing.
+        int TakeParseOrder() { return next_parse_order++; }
+
+        // First, so that it goes last: everything below may be allocated from it.
+        std::shared_ptr<std::pmr::memory_resource> arena;
+
+        Tmx::ParseOptions options;
+        std::shared_ptr<Tmx::StringPool> strings;
 
         std::string file_path;
 
@@ -273,18 +385,32 @@ namespace Tmx
 
         bool infinite{ false };
 
+        int next_parse_order{ 0 };
+
         std::vector<Tmx::Layer*> layers;
         std::vector<Tmx::TileLayer> tile_layers;
         std::vector<Tmx::ImageLayer> image_layers;
         std::vector<Tmx::ObjectGroup> object_groups;
         std::vector<Tmx::GroupLayer> group_layers;
         std::vector<Tmx::Tileset> tilesets;
-        std::unordered_map<std::string, Tmx::Object> templates;
+        Tmx::TilesetLookup tileset_lookup;
+        std::shared_ptr<Tmx::TemplateCache> templates{ std::make_shared<Tmx::TemplateCache>() };
 
         bool has_error{ false };
         unsigned char error_code{ 0 };
         std::string error_text;
 
         Tmx::PropertySet properties;
+
+        // The top-level elements of a map parsed with trackChanges, in
+        // document order, see Reload.
+        struct TrackedElement
+        {
+            std::string key;
+            std::size_t hash;
+        };
+
+        std::size_t root_hash{ 0 };
+        std::vector<TrackedElement> tracked_elements;
     };
 }
@@ -0,0 +1,73 @@
+//-----------------------------------------------------------------------------
+// TmxMapChangeSet.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Tmx
+{
+    class Layer;
+    class Tileset;
+
+    //-------------------------------------------------------------------------
+    /// What a MapLoader::Reload changed in a map, so that only the affected
+    /// resources need to be rebuilt. The pointers refer to the reloaded map.
+    //-------------------------------------------------------------------------
+    struct MapChangeSet
+    {
+        /// Get whether the new version could not be read. The map is then
+        /// left as it was.
+        bool HasError() const { return !errorText.empty(); }
+
+        /// Get whether anything changed at all.
+        bool HasChanges() const
+        {
+            return mapChanged || !tilesets.empty() || !layers.empty()
+                || removedTilesets != 0 || removedLayers != 0;
+        }
+
+        /// Why the new version could not be read.
+        std::string errorText;
+
+        /// The attributes or the properties of the map itself changed.
+        bool mapChanged{ false };
+
+        /// Tilesets that were added or read again.
+        std::vector<const Tmx::Tileset *> tilesets;
+
+        /// Top-level layers of any type that were added or read again.
+        /// A group layer is read again as a whole, children included.
+        std::vector<const Tmx::Layer *> layers;
+
+        /// Number of tilesets and of top-level layers that are gone.
+        int removedTilesets{ 0 };
+        int removedLayers{ 0 };
+
+        /// Number of elements taken over from the previous version as they were.
+        int reusedElements{ 0 };
+    };
+}
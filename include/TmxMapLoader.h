@@ -0,0 +1,163 @@
+//-----------------------------------------------------------------------------
+// TmxMapLoader.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "TmxCancellationToken.h"
+#include "TmxMap.h"
+#include "TmxMapChangeSet.h"
+#include "TmxParseOptions.h"
+#include "TmxTemplateCache.h"
+#include "TmxThreadPool.h"
+
+namespace Tmx
+{
+    namespace TilesetDetails
+    {
+        class TilesetContents;
+    }
+
+    //-------------------------------------------------------------------------
+    /// Parses maps and keeps what they share between them.
+    /// External tilesets (.tsx) are parsed once per canonical path and
+    /// modification time, and every map produced by the loader refers to the
+    /// same immutable tileset contents. Object templates (.tx) go through a
+    /// TemplateCache, which can be shared with other loaders. A loader may be
+    /// used from several threads at once.
+    //-------------------------------------------------------------------------
+    class MapLoader
+    {
+    public:
+        /// Create a loader. A new template cache is created if none is given.
+        explicit MapLoader(std::shared_ptr<Tmx::TemplateCache> templateCache = nullptr);
+
+        /// Create a loader parsing maps with the given options.
+        explicit MapLoader(const Tmx::ParseOptions &options,
+            std::shared_ptr<Tmx::TemplateCache> templateCache = nullptr);
+
+        /// Get the options maps are parsed with.
+        const Tmx::ParseOptions &GetOptions() const { return options; }
+
+        /// Get the threads used for decoding, or nullptr if maps are decoded
+        /// on the calling thread.
+        Tmx::ThreadPool *GetThreadPool() const { return pool.get(); }
+
+        /// Waits for the parses started by ParseFileAsync that are still running.
+        ~MapLoader();
+
+        MapLoader(const MapLoader &) = delete;
+        MapLoader &operator=(const MapLoader &) = delete;
+
+        /// Read a file and parse it. See Map::ParseFile.
+        Tmx::Map ParseFile(const std::string &fileName);
+
+        /// Read a file through a memory mapping and parse it. See Map::ParseFileMapped.
+        Tmx::Map ParseFileMapped(const std::string &fileName);
+
+        /// Parse text containing TMX formatted XML. See Map::ParseText.
+        Tmx::Map ParseText(std::string_view text, const std::string &path = "");
+
+        /// Read and parse several files at once, spread over the decode threads
+        /// of the loader, or one thread per core if it has none. The maps are
+        /// returned in the order of the file names. A file that fails yields a
+        /// map with an error set and does not affect the others.
+        std::vector<Tmx::Map> ParseFiles(std::span<const std::string> fileNames);
+
+        /// Read and parse a file on the threads ParseFiles uses, without
+        /// blocking the calling thread. See Map::ParseFileAsync. Destroying
+        /// the loader waits for the parse.
+        std::future<Tmx::Map> ParseFileAsync(const std::string &fileName,
+            Tmx::CancellationToken token = {});
+
+        /// Same as above, handing the map to onDone instead of returning a future.
+        void ParseFileAsync(const std::string &fileName, std::function<void(Tmx::Map)> onDone,
+            Tmx::CancellationToken token = {});
+
+        /// Read a new version of the file of a map and rebuild only the
+        /// tilesets and layers whose elements changed, reusing the others
+        /// as they are. Changes are found by comparing a hash of each
+        /// top-level element, so the map should have been parsed with
+        /// ParseOptions::trackChanges; otherwise, as for JSON maps, it is
+        /// read again as a whole. Tile layers are rebuilt as well when the
+        /// first gids of the tilesets change. If the new version cannot be
+        /// read the map is left as it was and the error is reported.
+        Tmx::MapChangeSet Reload(Tmx::Map &map, const std::string &fileName);
+
+        /// Rebuild a map from new text. See Reload.
+        Tmx::MapChangeSet ReloadText(Tmx::Map &map, std::string_view text,
+            const std::string &path = "");
+
+        /// Get the shared contents of an external tileset, parsing it on first use.
+        /// The source is looked up relative to path first, then as given.
+        /// Returns nullptr if the file cannot be loaded.
+        std::shared_ptr<const TilesetDetails::TilesetContents> FindOrLoadTileset(
+            const std::string &path, const std::string &source);
+
+        /// Get the number of external tilesets that were served from the cache.
+        std::size_t GetTilesetCacheHits() const;
+
+        /// Get the number of external tilesets that had to be parsed.
+        std::size_t GetTilesetCacheMisses() const;
+
+        /// Get the cache of object templates.
+        const std::shared_ptr<Tmx::TemplateCache> &GetTemplateCache() const { return templates; }
+
+        /// Drop all cached tilesets and templates. Maps already parsed keep theirs alive.
+        void ClearCache();
+
+    private:
+        struct CachedTileset
+        {
+            std::filesystem::file_time_type lastWriteTime;
+            std::shared_ptr<const TilesetDetails::TilesetContents> contents;
+        };
+
+        Tmx::ThreadPool *GetBatchPool();
+
+        Tmx::ParseOptions options;
+        std::shared_ptr<Tmx::TemplateCache> templates;
+        std::unique_ptr<Tmx::ThreadPool> pool;
+
+        std::once_flag batchPoolOnce;
+        std::unique_ptr<Tmx::ThreadPool> batchPool;
+
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, CachedTileset> tilesets;
+        std::size_t tilesetHits{ 0 };
+        std::size_t tilesetMisses{ 0 };
+    };
+}
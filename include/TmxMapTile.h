@@ -36,6 +36,35 @@ namespace Tmx
     const unsigned FlippedVerticallyFlag   = 0x40000000;
     const unsigned FlippedDiagonallyFlag   = 0x20000000;
 
+    //-------------------------------------------------------------------------
+    /// How the tiles of a tile layer are kept, see ParseOptions::tileStorage.
+    //-------------------------------------------------------------------------
+    enum TileLayerStorageType
+    {
+        /// A MapTile per cell, with its tileset and flags worked out.
+        TMX_STORAGE_TILES,
+
+        /// The raw gid of each cell, a quarter of the memory. The rest of a
+        /// MapTile is worked out from the gid on access.
+        TMX_STORAGE_GIDS,
+
+        /// Each row as runs of cells with the same gid, empty cells left out.
+        /// Suits layers painted in large areas. Random access searches the
+        /// runs of the row.
+        TMX_STORAGE_RUNS,
+
+        /// The gid and column of each non-empty cell, row by row. Suits
+        /// layers with scattered tiles. Random access searches the cells of
+        /// the row.
+        TMX_STORAGE_SPARSE,
+
+        /// Measure each layer once decoded and keep it as gids, runs or
+        /// sparse cells, whichever takes the least memory. Runs and sparse
+        /// cells are only picked when they take at most half the memory of
+        /// the gids, as their random access is slower.
+        TMX_STORAGE_AUTO
+    };
+
     //-------------------------------------------------------------------------
     /// Struct to store information about a specific tile in the map layer.
     //-------------------------------------------------------------------------
@@ -63,6 +92,15 @@ namespace Tmx
             id -= _tilesetFirstGid;
         }
 
+        /// Get the gid with its flip flags, as the map stores it.
+        unsigned GetRawGid() const
+        {
+            return gid
+                | (flippedHorizontally ? FlippedHorizontallyFlag : 0)
+                | (flippedVertically ? FlippedVerticallyFlag : 0)
+                | (flippedDiagonally ? FlippedDiagonallyFlag : 0);
+        }
+
         /// Tileset id.
         int tilesetId;
 
@@ -0,0 +1,117 @@
+//-----------------------------------------------------------------------------
+// TmxMapWatcher.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "TmxMapChangeSet.h"
+
+namespace Tmx
+{
+    class Map;
+    class MapLoader;
+
+    //-------------------------------------------------------------------------
+    /// Reloads maps through MapLoader::Reload when their files, or the
+    /// external tilesets and object templates they use, are saved.
+    /// Nothing happens behind the caller's back: Poll reloads the maps whose
+    /// files changed and reports on the calling thread, so that the maps are
+    /// only ever touched there. On Linux changes are noticed with inotify,
+    /// elsewhere Poll compares modification times.
+    //-------------------------------------------------------------------------
+    class MapWatcher
+    {
+    public:
+        /// Called after a map was reloaded, or failed to, see MapChangeSet.
+        using Callback = std::function<void(const std::string &fileName,
+            const Tmx::MapChangeSet &changes)>;
+
+        /// Watch files for the given loader, which must outlive the watcher.
+        explicit MapWatcher(Tmx::MapLoader &loader);
+        ~MapWatcher();
+
+        MapWatcher(const MapWatcher &) = delete;
+        MapWatcher &operator=(const MapWatcher &) = delete;
+
+        /// Reload map whenever fileName, or a tileset or template file it
+        /// references, is saved. The references are looked up again after
+        /// each reload. The map must stay where it is until Unwatch or the
+        /// end of the watcher.
+        void Watch(const std::string &fileName, Tmx::Map &map, Callback onReload = {});
+
+        /// Stop watching a file.
+        void Unwatch(const std::string &fileName);
+
+        /// Reload the maps whose files were saved since the last call,
+        /// waiting up to timeout for the first one. Returns the number of
+        /// maps reloaded. The callbacks are called after all of them are
+        /// reloaded and may Watch or Unwatch files.
+        int Poll(std::chrono::milliseconds timeout = std::chrono::milliseconds{ 0 });
+
+    private:
+        // A file whose saves reload a map.
+        struct WatchedFile
+        {
+            std::string fileName;
+
+            // The name without the directory, as inotify reports it.
+            std::string name;
+            std::filesystem::file_time_type lastWriteTime;
+
+            // The inotify watch of the directory, -1 where there is none.
+            int directory;
+        };
+
+        struct Watched
+        {
+            std::string fileName;
+            Tmx::Map *map;
+            Callback onReload;
+
+            // The map file first, then the files it references.
+            std::vector<WatchedFile> files;
+            bool saved;
+        };
+
+        void WatchFiles(Watched &w);
+        void ReleaseDirectories();
+        bool WaitForSaves(std::chrono::milliseconds timeout);
+        bool CheckTimes();
+
+        Tmx::MapLoader &loader;
+        std::vector<Watched> watched;
+
+        // The inotify watches of the directories the files are in.
+        std::vector<int> directories;
+
+        // The inotify instance, -1 where there is none.
+        int notify{ -1 };
+    };
+}
@@ -0,0 +1,64 @@
+//-----------------------------------------------------------------------------
+// TmxMappedFile.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace Tmx
+{
+    //-------------------------------------------------------------------------
+    /// A read-only memory mapping of a whole file.
+    /// The contents stay valid for as long as the object is alive.
+    //-------------------------------------------------------------------------
+    class MappedFile
+    {
+    public:
+        /// Map the given file. Check IsOpen() for the result.
+        explicit MappedFile(const std::string &fileName);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        /// Get whether the file was opened and mapped.
+        bool IsOpen() const { return is_open; }
+
+        /// Get the mapped contents of the file.
+        std::string_view GetView() const { return { data, size }; }
+
+        /// Let the system drop the whole pages before offset end from memory.
+        /// They stay readable and are read from the file again if needed.
+        void Discard(std::size_t end);
+
+    private:
+        const char *data{ nullptr };
+        std::size_t size{ 0 };
+        std::size_t discarded{ 0 };
+        bool is_open{ false };
+    };
+}
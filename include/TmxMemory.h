@@ -0,0 +1,61 @@
+//-----------------------------------------------------------------------------
+// TmxMemory.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+namespace Tmx
+{
+    //-------------------------------------------------------------------------
+    /// Deletes an object made by NewObject, giving its memory back to the
+    /// resource it came from.
+    //-------------------------------------------------------------------------
+    template <typename T>
+    struct ResourceDeleter
+    {
+        std::pmr::memory_resource *resource{ nullptr };
+
+        void operator()(T *object) const
+        {
+            std::pmr::polymorphic_allocator<T>{ resource }.delete_object(object);
+        }
+    };
+
+    /// An object owned like with std::unique_ptr, allocated from a memory resource.
+    template <typename T>
+    using ResourcePtr = std::unique_ptr<T, ResourceDeleter<T>>;
+
+    /// Construct an object in memory from the given resource.
+    template <typename T, typename... Args>
+    ResourcePtr<T> NewObject(std::pmr::memory_resource *resource, Args&&... args)
+    {
+        std::pmr::polymorphic_allocator<T> allocator{ resource };
+        return ResourcePtr<T>{ allocator.template new_object<T>(std::forward<Args>(args)...),
+            ResourceDeleter<T>{ resource } };
+    }
+}
@@ -35,12 +35,14 @@
 #include "TmxPropertySet.h"
 
 #include "TmxEllipse.h"
+#include "TmxMemory.h"
 #include "TmxPolygon.h"
 #include "TmxPolyline.h"
 #include "TmxText.h"
 
 namespace Tmx
 {
+    class JsonReader;
     class Map;
 
     //-------------------------------------------------------------------------
@@ -51,12 +53,14 @@ namespace Tmx
     public:
         Object();
         Object(const tinyxml2::XMLElement *data, Map *map);
+        Object(Tmx::JsonReader &json, Map *map);
 
         /// Get the name of the object.
-        const std::string &GetName() const { return name; }
+        const std::string &GetName() const { return *name; }
 
-        /// Get the type of the object.
-        const std::string &GetType() const { return type; }
+        /// Get the type of the object. Types are interned in the string pool
+        /// of the map, so objects of a type share the same string.
+        const std::string &GetType() const { return *type; }
 
         /// Get the left side of the object, in pixels.
         int GetX() const { return x; }
@@ -83,25 +87,47 @@ namespace Tmx
         bool IsVisible() const { return visible; }
 
         /// Get the ellipse.
-        const Tmx::Ellipse *GetEllipse() const { return ellipse.get(); }
+        const Tmx::Ellipse *GetEllipse() const
+        {
+            return ellipse ? ellipse.get() : pattern ? pattern->GetEllipse() : nullptr;
+        }
 
         /// Get the Polygon.
-        const Tmx::Polygon *GetPolygon() const { return polygon.get(); }
+        const Tmx::Polygon *GetPolygon() const
+        {
+            return polygon ? polygon.get() : pattern ? pattern->GetPolygon() : nullptr;
+        }
 
         /// Get the Polyline.
-        const Tmx::Polyline *GetPolyline() const { return polyline.get(); }
+        const Tmx::Polyline *GetPolyline() const
+        {
+            return polyline ? polyline.get() : pattern ? pattern->GetPolyline() : nullptr;
+        }
 
         /// Get the Text.
-        const Tmx::Text *GetText() const { return text.get(); }
+        const Tmx::Text *GetText() const
+        {
+            return text ? text.get() : pattern ? pattern->GetText() : nullptr;
+        }
 
         /// Get the property set.
         const Tmx::PropertySet &GetProperties() const { return properties; }
 
+        /// Get the template this object was created from, if any.
+        /// Templates are shared between all objects (and maps) that use them.
+        const Tmx::Object *GetTemplate() const { return pattern.get(); }
+
     private:
-        Object(const tinyxml2::XMLElement *data, const Tmx::Object *pattern);
+        Object(const tinyxml2::XMLElement *data, std::shared_ptr<const Tmx::Object> pattern);
+        Object(const tinyxml2::XMLElement *data, std::shared_ptr<const Tmx::Object> pattern,
+            const Tmx::Object &defaults);
+        Object(Tmx::JsonReader &json, std::shared_ptr<const Tmx::Object> pattern);
+
+        // Declared first, as the name and type are interned in its pool.
+        Tmx::PropertySet properties;
 
-        std::string name;
-        std::string type;
+        const std::string *name;
+        const std::string *type;
 
         int x{ 0 };
         int y{ 0 };
@@ -113,11 +139,12 @@ namespace Tmx
         float rotation{ 0.0f };
         bool visible{ true };
 
-        std::unique_ptr<Tmx::Ellipse> ellipse;
-        std::unique_ptr<Tmx::Polygon> polygon;
-        std::unique_ptr<Tmx::Polyline> polyline;
-        std::unique_ptr<Tmx::Text> text;
+        Tmx::ResourcePtr<Tmx::Ellipse> ellipse;
+        Tmx::ResourcePtr<Tmx::Polygon> polygon;
+        Tmx::ResourcePtr<Tmx::Polyline> polyline;
+        Tmx::ResourcePtr<Tmx::Text> text;
 
-        Tmx::PropertySet properties;
+        // Shapes not given by the object itself are looked up here.
+        std::shared_ptr<const Tmx::Object> pattern;
     };
 }
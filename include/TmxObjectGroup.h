@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -38,6 +39,7 @@
 
 namespace Tmx
 {
+    class JsonReader;
     class Map;
 
     //-------------------------------------------------------------------------
@@ -53,6 +55,10 @@ namespace Tmx
         /// Construct a new ObjectGroup used by a Tile
         ObjectGroup(const Tmx::Tile *_tile, const tinyxml2::XMLElement *data);
 
+        /// Construct a new ObjectGroup from a layer of a JSON map or tile.
+        ObjectGroup(Tmx::Map *_map, Tmx::JsonReader &json);
+        ObjectGroup(const Tmx::Tile *_tile, Tmx::JsonReader &json);
+
         ObjectGroup(ObjectGroup &&) = default;
         ObjectGroup& operator=(ObjectGroup &&) = default;
 
@@ -66,10 +72,12 @@ namespace Tmx
         Tmx::Color GetColor() const { return color; }
 
         /// Get the whole list of objects.
-        const std::vector<Tmx::Object> &GetObjects() const { return objects; }
+        const std::pmr::vector<Tmx::Object> &GetObjects() const { return objects; }
 
     private:
+        ObjectGroup(Tmx::Map *_map, const Tmx::Tile *_tile, Tmx::JsonReader &json);
+
         Tmx::Color color;
-        std::vector<Tmx::Object> objects;
+        std::pmr::vector<Tmx::Object> objects;
     };
 }
@@ -0,0 +1,194 @@
+//-----------------------------------------------------------------------------
+// TmxParseOptions.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TmxLayer.h"
+#include "TmxMapTile.h"
+
+namespace Tmx
+{
+    class Decompressor;
+    class JsonReader;
+    class StringPool;
+
+    //-------------------------------------------------------------------------
+    /// Settings used by a MapLoader when parsing maps.
+    //-------------------------------------------------------------------------
+    struct ParseOptions
+    {
+        /// Number of threads decoding the tile layers of a map.
+        /// With 1 every layer is decoded as soon as it is read. Otherwise the
+        /// layers are decoded side by side once the whole map has been read;
+        /// 0 uses one thread per hardware thread.
+        unsigned decodeThreads{ 1 };
+
+        /// Keep only the encoded data of tile layers and decode each layer on
+        /// the first access to its tiles, see TileLayer::Decode and
+        /// TileLayer::Release. Takes precedence over decodeThreads.
+        bool lazyDecode{ false };
+
+        /// Read the top-level elements of a map one at a time instead of
+        /// building a document for the whole file first, which lowers the peak
+        /// memory of large maps. Files are read through a memory mapping.
+        /// The resulting maps are the same either way.
+        ///
+        /// None of these apply to JSON maps, whose tile layers are always
+        /// decoded while they are read.
+        bool streaming{ false };
+
+        /// Remember a hash of each top-level element of a TMX map, so that
+        /// MapLoader::Reload can tell which of them changed. Maps are then
+        /// read element by element, as with streaming.
+        bool trackChanges{ false };
+
+        /// Layer types, a combination of LayerType values, that are left out
+        /// wherever they appear, inside groups as well.
+        int skipLayerTypes{ 0 };
+
+        /// Read only the layers with one of these names, unless it is empty.
+        /// Group layers are not matched against it, so that the layers in
+        /// them can be.
+        std::vector<std::string> layerNames;
+
+        /// Read only the layers this returns true for, given the name and the
+        /// type of each. Group layers are asked as well; leaving out a group
+        /// leaves out everything in it.
+        std::function<bool(std::string_view name, Tmx::LayerType type)> layerFilter;
+
+        /// Leave out the properties of the map and of everything in it.
+        bool skipProperties{ false };
+
+        /// Leave out the animations of tiles.
+        bool skipTileAnimations{ false };
+
+        /// Leave out the collision shapes of tiles, kept in their object groups.
+        bool skipTileCollisions{ false };
+
+        /// Allocate the objects, shapes and properties of each map from a
+        /// monotonic arena of its own, given back as a whole with the map
+        /// instead of piece by piece. Tiles stay on the heap, as lazily
+        /// decoded layers release them, and so do tilesets and templates,
+        /// which may be shared between maps.
+        bool arena{ false };
+
+        /// Allocate what arena would from this resource instead, which must
+        /// outlive the maps. Takes precedence over arena.
+        std::pmr::memory_resource *memoryResource{ nullptr };
+
+        /// Decompress tile layers with this backend instead of
+        /// Decompressor::GetDefault(). It must outlive the maps, which use it
+        /// again for layers decoded lazily.
+        const Tmx::Decompressor *decompressor{ nullptr };
+
+        /// How tile layers keep their tiles. TMX_STORAGE_GIDS keeps 4 bytes
+        /// per cell instead of a MapTile of 16; TileLayer::GetTile and the
+        /// other getters then work out the rest on each call. Mostly empty
+        /// layers take far less with TMX_STORAGE_RUNS or TMX_STORAGE_SPARSE,
+        /// and TMX_STORAGE_AUTO picks per layer. Chunks of infinite maps are
+        /// always kept as MapTiles.
+        Tmx::TileLayerStorageType tileStorage{ Tmx::TMX_STORAGE_TILES };
+
+        /// Get whether a layer is read, according to skipLayerTypes,
+        /// layerNames and layerFilter.
+        bool IncludesLayer(std::string_view name, Tmx::LayerType type) const;
+
+        /// Get whether an element is read. Elements that are not layers are.
+        bool IncludesLayer(const tinyxml2::XMLElement *element) const;
+
+        /// Get whether the layer of the given JSON type that json is at is
+        /// read. The name is only looked up if layers are filtered by it.
+        bool IncludesLayer(Tmx::JsonReader &json, std::string_view type) const;
+    };
+
+    namespace ParseOptionsDetails
+    {
+        /// Get the options of the parse running on this thread, the defaults
+        /// outside of one. Tilesets, tiles and property sets are read far
+        /// below the map, so the options are not handed down to them.
+        const ParseOptions &GetCurrent();
+
+        /// Makes options the ones of the parse running on this thread until
+        /// the end of the scope.
+        class Scope
+        {
+        public:
+            explicit Scope(const ParseOptions &options);
+            ~Scope();
+
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+        private:
+            const ParseOptions *previous;
+        };
+
+        /// Get the resource that what the parse running on this thread builds
+        /// is allocated from, the heap outside of one.
+        std::pmr::memory_resource *GetMemoryResource();
+
+        /// Makes resource the one allocated from on this thread until the
+        /// end of the scope.
+        class MemoryScope
+        {
+        public:
+            explicit MemoryScope(std::pmr::memory_resource *resource);
+            ~MemoryScope();
+
+            MemoryScope(const MemoryScope &) = delete;
+            MemoryScope &operator=(const MemoryScope &) = delete;
+
+        private:
+            std::pmr::memory_resource *previous;
+        };
+
+        /// Get the pool the strings of what the parse running on this thread
+        /// builds are interned in, a new one outside of one.
+        std::shared_ptr<StringPool> GetStringPool();
+
+        /// Makes pool the one interned in on this thread until the end of the
+        /// scope, a new one if it is null.
+        class StringPoolScope
+        {
+        public:
+            explicit StringPoolScope(std::shared_ptr<StringPool> pool = nullptr);
+            ~StringPoolScope();
+
+            StringPoolScope(const StringPoolScope &) = delete;
+            StringPoolScope &operator=(const StringPoolScope &) = delete;
+
+        private:
+            std::shared_ptr<StringPool> strings;
+            const std::shared_ptr<StringPool> *previous;
+        };
+    }
+}
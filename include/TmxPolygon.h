@@ -27,6 +27,7 @@
 //-----------------------------------------------------------------------------
 #pragma once
 
+#include <memory_resource>
 #include <string_view>
 #include <vector>
 
@@ -44,6 +45,7 @@ namespace Tmx
     public:
         Polygon(const tinyxml2::XMLElement *data);
         Polygon(std::string_view data);
+        explicit Polygon(std::pmr::vector<Tmx::Point> points);
 
         /// Get one of the vertices.
         const Tmx::Point &GetPoint(int index) const { return points[static_cast<size_t>(index)]; }
@@ -52,6 +54,6 @@ namespace Tmx
         int GetNumPoints() const { return static_cast<int>(points.size()); }
 
     private:
-        std::vector<Tmx::Point> points;
+        std::pmr::vector<Tmx::Point> points;
     };
 }
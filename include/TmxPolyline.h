@@ -27,6 +27,7 @@
 //-----------------------------------------------------------------------------
 #pragma once
 
+#include <memory_resource>
 #include <string_view>
 #include <vector>
 
@@ -44,6 +45,7 @@ namespace Tmx
     public:
         Polyline(const tinyxml2::XMLElement *data);
         Polyline(const std::string_view &data);
+        explicit Polyline(std::pmr::vector<Tmx::Point> points);
 
         /// Get one of the vertices.
         const Tmx::Point &GetPoint(int index) const { return points[index]; }
@@ -52,6 +54,6 @@ namespace Tmx
         int GetNumPoints() const { return points.size(); }
 
     private:
-        std::vector< Tmx::Point > points;
+        std::pmr::vector<Tmx::Point> points;
     };
 }
@@ -28,6 +28,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <variant>
 
 #include <tinyxml2.h>
@@ -36,6 +37,8 @@
 
 namespace Tmx
 {
+    class JsonReader;
+
     //-------------------------------------------------------------------------
     /// The type of a property.
     //-------------------------------------------------------------------------
@@ -74,6 +77,10 @@ namespace Tmx
     public:
         Property(const tinyxml2::XMLElement *data);
 
+        /// Construct a property of a JSON map from the name of its type,
+        /// reading the value from json.
+        Property(std::string_view typeName, Tmx::JsonReader &json);
+
         /// Get the type of the property (default: TMX_PROPERTY_STRING)
         PropertyType GetType() const { return type; }
 
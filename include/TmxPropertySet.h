@@ -28,15 +28,21 @@
 #pragma once
 
 #include <map>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 #include <tinyxml2.h>
 
 #include "TmxProperty.h"
+#include "TmxStringPool.h"
 
 namespace Tmx
 {
+    class JsonReader;
+    class Object;
     class Property;
 
     //-----------------------------------------------------------------------------
@@ -48,36 +54,58 @@ namespace Tmx
         PropertySet(const tinyxml2::XMLNode *propertiesNode,
             const PropertySet *pattern = nullptr);
 
+        /// Construct the set from the properties array of a JSON map.
+        PropertySet(Tmx::JsonReader &json, const PropertySet *pattern = nullptr);
+
+        PropertySet(const PropertySet &other) = default;
+        PropertySet(PropertySet &&other) noexcept = default;
+        PropertySet &operator=(const PropertySet &other) = default;
+
+        /// Take over the properties of other along with the memory resource
+        /// they are allocated from, instead of moving them one at a time into
+        /// the resource of this set.
+        PropertySet &operator=(PropertySet &&other) noexcept;
+
         /// Get a int property.
-        int GetIntProperty(const std::string &name, int defaultValue = 0) const;
+        int GetIntProperty(std::string_view name, int defaultValue = 0) const;
 
         /// Get a float property.
-        float GetFloatProperty(const std::string &name, float defaultValue = 0.0f) const;
+        float GetFloatProperty(std::string_view name, float defaultValue = 0.0f) const;
 
         /// Get a string property.
-        std::string GetStringProperty(const std::string &name,
+        std::string GetStringProperty(std::string_view name,
             const std::string &defaultValue = {}) const;
 
         /// Get a bool property.
-        bool GetBoolProperty(const std::string &name, bool defaultValue = false) const;
+        bool GetBoolProperty(std::string_view name, bool defaultValue = false) const;
 
         /// Get a color property.
-        Tmx::Color GetColorProperty(const std::string &name,
+        Tmx::Color GetColorProperty(std::string_view name,
             const Tmx::Color &defaultValue = {}) const;
 
         /// Returns the amount of properties.
         int GetSize() const { return static_cast<int>(properties.size()); }
 
         /// Checks if a property exists in the set.
-        bool HasProperty(const std::string& name) const;
+        bool HasProperty(std::string_view name) const;
 
-        /// Returns the unordered map of properties.
-        const std::unordered_map<std::string, Property> &GetPropertyMap() const;
+        /// Returns the unordered map of properties. The names are kept in
+        /// the pool of the set, see GetStringPool.
+        const std::pmr::unordered_map<std::string_view, Property> &GetPropertyMap() const;
 
         /// Returns whether there are no properties.
         bool Empty() const { return properties.empty(); }
 
+        /// Get the pool the property names are interned in, shared with the
+        /// other sets and objects of the map.
+        const Tmx::StringPool &GetStringPool() const { return *strings; }
+
     private:
-        std::unordered_map<std::string, Property> properties;
+        // Objects intern their names and types in the pool of their
+        // properties, which keeps it alive for them.
+        friend class Object;
+
+        std::shared_ptr<Tmx::StringPool> strings;
+        std::pmr::unordered_map<std::string_view, Property> properties;
     };
 }
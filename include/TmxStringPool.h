@@ -0,0 +1,67 @@
+//-----------------------------------------------------------------------------
+// TmxStringPool.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace Tmx
+{
+    //-------------------------------------------------------------------------
+    /// Keeps a single copy of the names and types of objects and the names of
+    /// properties, which repeat across the objects of a map. Strings keep
+    /// their address as long as the pool, so two strings of a pool are equal
+    /// if and only if they are the same string.
+    //-------------------------------------------------------------------------
+    class StringPool
+    {
+    public:
+        /// Get the copy of text in the pool, adding it on first use.
+        const std::string &Intern(std::string_view text);
+
+        /// Get the copy of text in the pool, or nullptr if there is none.
+        const std::string *Find(std::string_view text) const;
+
+        /// Get the number of distinct strings in the pool.
+        std::size_t GetSize() const { return strings.size(); }
+
+    private:
+        struct Hash
+        {
+            using is_transparent = void;
+
+            std::size_t operator()(std::string_view text) const
+            {
+                return std::hash<std::string_view>{}(text);
+            }
+        };
+
+        std::unordered_set<std::string, Hash, std::equal_to<>> strings;
+    };
+}
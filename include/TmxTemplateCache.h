@@ -0,0 +1,84 @@
+//-----------------------------------------------------------------------------
+// TmxTemplateCache.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Tmx
+{
+    class Object;
+
+    //-------------------------------------------------------------------------
+    /// Object templates (.tx files) by canonical path.
+    /// Each template is parsed once and shared, read-only, by every object
+    /// that uses it; it is parsed again when its file is modified. The cache
+    /// may outlive the maps that filled it and is safe to use from several
+    /// parses at once.
+    //-------------------------------------------------------------------------
+    class TemplateCache
+    {
+    public:
+        TemplateCache() = default;
+
+        TemplateCache(const TemplateCache &) = delete;
+        TemplateCache &operator=(const TemplateCache &) = delete;
+
+        /// Get the template object stored in the given file, parsing it on first
+        /// use or if the file changed since. Returns nullptr if the file cannot
+        /// be loaded; failures are not cached, so the file is tried again on
+        /// the next use.
+        std::shared_ptr<const Tmx::Object> FindOrLoad(const std::string &fileName);
+
+        /// Get the number of templates that were served from the cache.
+        std::size_t GetHits() const;
+
+        /// Get the number of template files that had to be parsed.
+        std::size_t GetMisses() const;
+
+        /// Get the number of cached template files.
+        std::size_t GetSize() const;
+
+        /// Drop all cached templates. Objects already parsed keep theirs alive.
+        void Clear();
+
+    private:
+        struct CachedTemplate
+        {
+            std::filesystem::file_time_type lastWriteTime;
+            std::shared_ptr<const Tmx::Object> pattern;
+        };
+
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, CachedTemplate> templates;
+        std::size_t hits{ 0 };
+        std::size_t misses{ 0 };
+    };
+}
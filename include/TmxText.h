@@ -35,6 +35,8 @@
 
 namespace Tmx
 {
+    class JsonReader;
+
     //--------------------------------------------------------------------------
     /// Enum to denote Horizontal Alignment of Text
     //--------------------------------------------------------------------------
@@ -64,6 +66,9 @@ namespace Tmx
         /// Construct text with the given options.
         Text(const tinyxml2::XMLElement *data);
 
+        /// Construct text from the text object of a JSON map.
+        Text(Tmx::JsonReader &json);
+
         std::string GetContents() const noexcept { return contents; }
         std::string GetFontFamily() const noexcept { return font_family; }
         int GetPixelSize() const noexcept { return pixel_size; }
@@ -0,0 +1,94 @@
+//-----------------------------------------------------------------------------
+// TmxThreadPool.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Tmx
+{
+    /// Runs a task, now or later, on some thread. Used to choose where
+    /// asynchronous parses run; ThreadPool::Submit is one.
+    using Executor = std::function<void(std::function<void()>)>;
+
+    //-------------------------------------------------------------------------
+    /// A fixed set of worker threads running submitted tasks.
+    /// Every worker has its own queue. Tasks submitted from a worker go to its
+    /// own queue and are taken newest first; idle workers steal the oldest
+    /// tasks of the others.
+    //-------------------------------------------------------------------------
+    class ThreadPool
+    {
+    public:
+        /// Start the given number of workers, or one per hardware thread if 0.
+        explicit ThreadPool(unsigned numThreads = 0);
+
+        /// Finish the queued tasks and stop the workers.
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /// Get the number of worker threads.
+        unsigned GetNumThreads() const { return static_cast<unsigned>(workers.size()); }
+
+        /// Queue a task to run on one of the workers.
+        void Submit(std::function<void()> task);
+
+        /// Call fn(i) for every i in [0, count) and return when all calls are done.
+        /// The calling thread takes part, so this may be used from within a task.
+        /// If fn throws, the calls not yet started are skipped and the first
+        /// exception is rethrown once the others are done.
+        void ParallelFor(std::size_t count, const std::function<void(std::size_t)> &fn);
+
+    private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        void Run(std::size_t index);
+        bool TryPop(std::size_t index, std::function<void()> *task);
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::atomic<std::size_t> nextQueue{ 0 };
+
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        std::size_t queued{ 0 };
+        bool stopping{ false };
+
+        std::vector<std::thread> workers;
+    };
+}
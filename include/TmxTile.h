@@ -37,6 +37,7 @@
 namespace Tmx
 {
     class AnimationFrame;
+    class JsonReader;
     class Object;
 
     //-------------------------------------------------------------------------
@@ -52,6 +53,9 @@ namespace Tmx
         /// Construct a new tile with the given id.
         Tile(const tinyxml2::XMLElement *data);
 
+        /// Construct a tile from the tiles array of a JSON tileset.
+        Tile(Tmx::JsonReader &json);
+
         /// Get the Id. (relative to the tileset)
         int GetId() const
         {
@@ -116,7 +120,7 @@ namespace Tmx
         }
 
         /// Get set of Collision Objects, convenience function
-        const std::vector<Tmx::Object> &GetObjects() const
+        const std::pmr::vector<Tmx::Object> &GetObjects() const
         {
             if (!objectGroup)
             {
@@ -0,0 +1,57 @@
+//-----------------------------------------------------------------------------
+// TmxTileChunk.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <vector>
+
+#include "TmxMapTile.h"
+
+namespace Tmx
+{
+    //-------------------------------------------------------------------------
+    /// A rectangle of tiles of a tile layer on an infinite map.
+    /// See TileLayer::FindChunk and TileLayer::IterateChunks.
+    //-------------------------------------------------------------------------
+    struct TileChunk
+    {
+        /// Position of the top-left tile of the chunk, in tiles. May be negative.
+        int x{ 0 };
+        int y{ 0 };
+
+        /// Size of the chunk, in tiles.
+        int width{ 0 };
+        int height{ 0 };
+
+        /// The tiles of the chunk, row by row.
+        std::vector<Tmx::MapTile> tiles;
+
+        /// Get the tile at a position of the map, which must lie in the chunk.
+        const Tmx::MapTile &GetTile(int mapX, int mapY) const
+        {
+            return tiles[(mapY - y) * width + (mapX - x)];
+        }
+    };
+}
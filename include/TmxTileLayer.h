@@ -27,7 +27,17 @@
 //-----------------------------------------------------------------------------
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include <tinyxml2.h>
@@ -35,9 +45,11 @@
 #include "TmxLayer.h"
 #include "TmxMapTile.h"
 #include "TmxPropertySet.h"
+#include "TmxTileChunk.h"
 
 namespace Tmx 
 {
+    class JsonReader;
     class Map;
 
     //-------------------------------------------------------------------------
@@ -57,42 +69,164 @@ namespace Tmx
     {
         TMX_COMPRESSION_NONE,
         TMX_COMPRESSION_ZLIB,
-        TMX_COMPRESSION_GZIP
+        TMX_COMPRESSION_GZIP,
+        TMX_COMPRESSION_ZSTD
+    };
+
+    //-------------------------------------------------------------------------
+    /// A rectangle of cells of a tile layer, in tiles.
+    //-------------------------------------------------------------------------
+    struct TileRect
+    {
+        int x{ 0 };
+        int y{ 0 };
+        int width{ 0 };
+        int height{ 0 };
+    };
+
+    //-------------------------------------------------------------------------
+    /// Cells of a row holding the same raw gid, see TMX_STORAGE_RUNS.
+    //-------------------------------------------------------------------------
+    struct TileRun
+    {
+        /// The column of the first cell.
+        std::uint32_t x{ 0 };
+
+        /// The number of cells.
+        std::uint32_t length{ 0 };
+
+        /// The raw gid of the cells, flip flags included. Never 0.
+        std::uint32_t gid{ 0 };
+    };
+
+    //-------------------------------------------------------------------------
+    /// A non-empty cell of a row, see TMX_STORAGE_SPARSE.
+    //-------------------------------------------------------------------------
+    struct TileCell
+    {
+        /// The column of the cell.
+        std::uint32_t x{ 0 };
+
+        /// The raw gid of the cell, flip flags included. Never 0.
+        std::uint32_t gid{ 0 };
     };
 
     //-------------------------------------------------------------------------
     /// Used for storing information about the tile ids for every tile layer.
     /// This class also have a property set.
+    /// With ParseOptions::lazyDecode the layer only keeps its encoded data
+    /// and decodes it on first access; see Decode() and Release().
+    /// Layers of infinite maps keep their tiles in chunks, see IsChunked().
     //-------------------------------------------------------------------------
     class TileLayer : public Tmx::Layer
     {
     public:
-        /// Construct a TileLayer on the given map.
-        TileLayer(Tmx::Map *_map, const tinyxml2::XMLElement *data);
+        /// Construct a TileLayer on the given map. If dataText is not empty it
+        /// is the encoded text of the <data> element, left out of the document
+        /// and decoded where it is; it must stay valid until the map is parsed.
+        TileLayer(Tmx::Map *_map, const tinyxml2::XMLElement *data,
+            std::string_view dataText = {});
+
+        /// Construct a TileLayer from a layer of a JSON map. Its tiles are
+        /// decoded as they are read.
+        TileLayer(Tmx::Map *_map, Tmx::JsonReader &json);
 
         /// Pick a specific tile id from the list.
-        unsigned GetTileId(int x, int y) const { return tile_map[y * width + x].id; }
+        unsigned GetTileId(int x, int y) const { return GetTile(x, y).id; }
 
         /// Pick a specific tile gid from the list.
-        unsigned GetTileGid(int x, int y) const { return tile_map[y * width + x].gid; }
+        unsigned GetTileGid(int x, int y) const
+        {
+            return HasTiles() ? Tiles()[y * width + x].gid : RawGid(y * width + x) & ~FlipFlags;
+        }
 
         /// Get the tileset index for a tileset from the list.
-        int GetTileTilesetIndex(int x, int y) const { return tile_map[y * width + x].tilesetId; }
+        int GetTileTilesetIndex(int x, int y) const { return GetTile(x, y).tilesetId; }
 
         /// Get whether a tile is flipped horizontally.
-        bool IsTileFlippedHorizontally(int x, int y) const { return tile_map[y * width + x].flippedHorizontally; }
+        bool IsTileFlippedHorizontally(int x, int y) const
+        {
+            return HasTiles() ? Tiles()[y * width + x].flippedHorizontally
+                : (RawGid(y * width + x) & FlippedHorizontallyFlag) != 0;
+        }
 
         /// Get whether a tile is flipped vertically.
-        bool IsTileFlippedVertically(int x, int y) const { return tile_map[y * width + x].flippedVertically; }
+        bool IsTileFlippedVertically(int x, int y) const
+        {
+            return HasTiles() ? Tiles()[y * width + x].flippedVertically
+                : (RawGid(y * width + x) & FlippedVerticallyFlag) != 0;
+        }
 
         /// Get whether a tile is flipped diagonally.
-        bool IsTileFlippedDiagonally(int x, int y) const { return tile_map[y * width + x].flippedDiagonally; }
+        bool IsTileFlippedDiagonally(int x, int y) const
+        {
+            return HasTiles() ? Tiles()[y * width + x].flippedDiagonally
+                : (RawGid(y * width + x) & FlippedDiagonallyFlag) != 0;
+        }
 
         /// Get the tile at the given position.
-        const Tmx::MapTile& GetTile(int x, int y) const { return tile_map[y * width + x]; }
+        Tmx::MapTile GetTile(int x, int y) const { return GetTile(y * width + x); }
 
         /// Get a tile by its index.
-        const Tmx::MapTile& GetTile(int index) const { return tile_map[index]; }
+        Tmx::MapTile GetTile(int index) const
+        {
+            return HasTiles() ? Tiles()[index] : MakeTile(RawGid(index));
+        }
+
+        /// Get how the tiles are kept, see ParseOptions::tileStorage. With
+        /// TMX_STORAGE_AUTO this is the layout picked for the layer, which
+        /// decodes a lazily decoded layer. Layers of infinite maps keep
+        /// MapTiles in their chunks.
+        Tmx::TileLayerStorageType GetStorage() const
+        {
+            EnsureDecoded();
+            return storage;
+        }
+
+        /// Get the tiles of the cells, row by row. Empty unless the layer
+        /// keeps MapTiles.
+        std::span<const Tmx::MapTile> GetTiles() const { return Tiles(); }
+
+        /// Get the raw gids of the cells, flip flags included, row by row.
+        /// Empty unless the layer keeps gids; TilesetLookup::Resolve works
+        /// out the tiles of many of them at once.
+        std::span<const std::uint32_t> GetGids() const { return Gids(); }
+
+        /// Get the tiles of a row, see GetTiles.
+        std::span<const Tmx::MapTile> GetTileRow(int y) const { return Row(GetTiles(), y); }
+
+        /// Get the raw gids of a row, see GetGids.
+        std::span<const std::uint32_t> GetGidRow(int y) const { return Row(GetGids(), y); }
+
+        /// Get the runs of a row, by column. Empty unless the layer keeps
+        /// runs, see TMX_STORAGE_RUNS.
+        std::span<const Tmx::TileRun> GetRunRow(int y) const { return PackedRow(Runs(), y); }
+
+        /// Get the non-empty cells of a row, by column. Empty unless the
+        /// layer keeps sparse cells, see TMX_STORAGE_SPARSE.
+        std::span<const Tmx::TileCell> GetCellRow(int y) const { return PackedRow(Cells(), y); }
+
+        /// Copy the raw gids of a rectangle of cells, flip flags included, to
+        /// dst, whose rows start stride gids apart. Cells off the layer or
+        /// without tile data are 0. Rows of a layer that keeps gids are
+        /// copied with memcpy. Works with every storage and on chunked
+        /// layers as well. Leaves dst alone if the rectangle is empty or has
+        /// a negative width or height.
+        void CopyRegion(const Tmx::TileRect &rect, std::uint32_t *dst, std::size_t stride) const;
+
+        /// Call fun(x, y, tile) with every cell holding a tile, row by row.
+        /// Runs and sparse cells skip the empty cells without reading them.
+        /// The cells of chunked layers come chunk by chunk.
+        template <typename T>
+        void IterateNonEmptyTiles(T &&fun) const;
+
+        /// Get the bytes taken by the decoded tiles, which decodes a lazily
+        /// decoded layer.
+        std::size_t GetTileMemory() const;
+
+        /// Get the bytes saved against a MapTile per cell by the storage of
+        /// a layer of a finite map; 0 for chunked layers.
+        std::size_t GetTileMemorySaved() const;
 
         /// Get the type of encoding that was used for parsing the tile layer data.
         /// See: TileLayerEncodingType
@@ -105,12 +239,183 @@ namespace Tmx
         float GetOffsetX() const { return offsetX; }
         float GetOffsetY() const { return offsetY; }
 
+        /// Get whether the tiles are stored in chunks, as on infinite maps.
+        /// The tiles of a chunked layer are read with FindTile, FindChunk and
+        /// IterateChunks; the getters above are for layers of finite maps.
+        bool IsChunked() const { return chunk_width != 0; }
+
+        /// Get the tile at a position, which may be negative on infinite maps.
+        /// Returns nothing where the layer has no tile data.
+        std::optional<Tmx::MapTile> FindTile(int x, int y) const;
+
+        /// Get the chunk holding the tile at a position, or nullptr where there
+        /// is none. Empty space is not stored.
+        const Tmx::TileChunk *FindChunk(int x, int y) const;
+
+        /// Get the number of chunks holding tiles.
+        int GetNumChunks() const;
+
+        /// Get the size of the chunks, in tiles.
+        int GetChunkWidth() const { return chunk_width; }
+        int GetChunkHeight() const { return chunk_height; }
+
+        /// Call fun with every chunk holding tiles, in no particular order.
+        template <typename T>
+        void IterateChunks(T &&fun) const;
+
+        /// Decode the tile data if it is not decoded yet. Only layers parsed
+        /// with ParseOptions::lazyDecode start out encoded; they are decoded
+        /// by the first access to a tile otherwise. Safe to call from several
+        /// threads at once.
+        void Decode() const;
+
+        /// Drop the decoded tiles of a lazily decoded layer to free their
+        /// memory. They are decoded again on the next access. Must not be
+        /// called while other threads read the layer. Does nothing for
+        /// layers that were decoded while parsing.
+        void Release() const;
+
+        /// Get whether the tiles are decoded and resident.
+        bool IsDecoded() const { return !lazy || lazy->decoded.load(std::memory_order_acquire); }
+
     private:
-        void ParseXML(const tinyxml2::XMLNode *data);
-        void ParseBase64(std::string innerText);
-        void ParseCSV(const std::string &innerText);
+        friend class Map;
+
+        struct EncodedChunk
+        {
+            int x;
+            int y;
+            int width;
+            int height;
+            std::string payload;
+        };
+
+        // The encoded tile data of a lazily decoded layer.
+        struct LazyData
+        {
+            std::string payload;
+            std::vector<EncodedChunk> chunks;
+            std::mutex mutex;
+            std::atomic<bool> decoded{ false };
+        };
+
+        void EnsureDecoded() const
+        {
+            if (!IsDecoded())
+            {
+                Decode();
+            }
+        }
+
+        static constexpr unsigned FlipFlags =
+            FlippedHorizontallyFlag | FlippedVerticallyFlag | FlippedDiagonallyFlag;
+
+        // Whether the layer keeps MapTiles rather than gids in some form.
+        // Safe to ask before the layer is decoded, unlike storage.
+        bool HasTiles() const { return requested_storage == TMX_STORAGE_TILES; }
+
+        // The raw gid of a cell of a layer without MapTiles.
+        std::uint32_t RawGid(std::size_t index) const
+        {
+            EnsureDecoded();
+            return storage == TMX_STORAGE_GIDS ? gids[index] : FindPackedGid(index);
+        }
+
+        std::uint32_t FindPackedGid(std::size_t index) const;
+
+        template <typename T>
+        std::span<const T> Row(std::span<const T> cells, int y) const
+        {
+            const auto first = static_cast<std::size_t>(y) * width;
+            return y >= 0 && y < height && first < cells.size()
+                ? cells.subspan(first, std::min<std::size_t>(width, cells.size() - first))
+                : std::span<const T>{};
+        }
+
+        const std::vector<Tmx::MapTile> &Tiles() const
+        {
+            EnsureDecoded();
+            return tile_map;
+        }
+
+        const std::vector<std::uint32_t> &Gids() const
+        {
+            EnsureDecoded();
+            return gids;
+        }
+
+        const std::vector<Tmx::TileRun> &Runs() const
+        {
+            EnsureDecoded();
+            return runs;
+        }
+
+        const std::vector<Tmx::TileCell> &Cells() const
+        {
+            EnsureDecoded();
+            return cells;
+        }
 
-        std::vector<Tmx::MapTile> tile_map;
+        // The runs or cells of a row, see row_starts.
+        template <typename T>
+        std::span<const T> PackedRow(const std::vector<T> &packed, int y) const
+        {
+            return y >= 0 && y < height && !packed.empty()
+                ? std::span<const T>{ packed }.subspan(row_starts[y], row_starts[y + 1] - row_starts[y])
+                : std::span<const T>{};
+        }
+
+        // Turns the decoded gids into runs or sparse cells if the layer is
+        // to keep them, see ParseOptions::tileStorage.
+        void Pack() const;
+
+        // The tiles are decoded as MapTiles or as gids, see storage.
+        void DecodeData(const tinyxml2::XMLElement *dataElem, std::string_view dataText = {});
+        void DecodePayload() const;
+        template <typename Tile>
+        void DecodeElement(const tinyxml2::XMLElement *dataElem, int count,
+            std::vector<Tile> &tiles) const;
+        template <typename Tile>
+        void DecodeText(std::string_view payload, int count, std::vector<Tile> &tiles) const;
+        void AddChunk(int x, int y, int w, int h, std::vector<Tmx::MapTile> tiles) const;
+        template <typename Tile>
+        void ParseXML(const tinyxml2::XMLNode *data, std::vector<Tile> &tiles) const;
+        template <typename Tile>
+        void ParseBase64(std::string_view text, int count, std::vector<Tile> &tiles) const;
+        template <typename Tile>
+        void ParseCSV(std::string_view innerText, int count, std::vector<Tile> &tiles) const;
+        template <typename Tile>
+        void ParseJsonArray(Tmx::JsonReader &json, std::vector<Tile> &tiles) const;
+        template <typename Tile>
+        Tile FromGid(unsigned gid) const;
+        Tmx::MapTile MakeTile(unsigned gid) const;
+
+        // Filled on first access when decoding lazily; one of them, see storage.
+        mutable std::vector<Tmx::MapTile> tile_map;
+        mutable std::vector<std::uint32_t> gids;
+        mutable std::vector<Tmx::TileRun> runs;
+        mutable std::vector<Tmx::TileCell> cells;
+
+        // Where the runs or cells of each row start, and the end of the last row.
+        mutable std::vector<std::uint32_t> row_starts;
+
+        // The layout asked for, settled when the layer is constructed.
+        Tmx::TileLayerStorageType requested_storage{ TMX_STORAGE_TILES };
+
+        // The layout the tiles are kept in, written only while decoding and
+        // so only read once the layer is decoded; see Pack().
+        mutable Tmx::TileLayerStorageType storage{ TMX_STORAGE_TILES };
+
+        // The chunks of an infinite map, by position on the chunk grid.
+        mutable std::unordered_map<std::uint64_t, Tmx::TileChunk> chunks;
+        int chunk_width{ 0 };
+        int chunk_height{ 0 };
+
+        // The <data> element waiting to be decoded by the map, if decoding is deferred.
+        const tinyxml2::XMLElement *pending_data{ nullptr };
+        std::string_view pending_text;
+
+        std::unique_ptr<LazyData> lazy;
 
         Tmx::TileLayerEncodingType encoding;
         Tmx::TileLayerCompressionType compression;
@@ -118,4 +423,85 @@ namespace Tmx
         float offsetX{ 0.0f };
         float offsetY{ 0.0f };
     };
+
+    template <typename T>
+    void TileLayer::IterateNonEmptyTiles(T &&fun) const
+    {
+        EnsureDecoded();
+        if (IsChunked())
+        {
+            for (const auto &c : chunks)
+            {
+                const auto &chunk = c.second;
+                for (int i = 0; i < static_cast<int>(chunk.tiles.size()); ++i)
+                {
+                    if (chunk.tiles[i].gid != 0)
+                    {
+                        fun(chunk.x + i % chunk.width, chunk.y + i / chunk.width, chunk.tiles[i]);
+                    }
+                }
+            }
+            return;
+        }
+
+        for (int y = 0; y < height; ++y)
+        {
+            switch (storage)
+            {
+            case TMX_STORAGE_TILES:
+            {
+                const auto row = Row(std::span<const Tmx::MapTile>{ tile_map }, y);
+                for (int x = 0; x < static_cast<int>(row.size()); ++x)
+                {
+                    if (row[x].gid != 0)
+                    {
+                        fun(x, y, row[x]);
+                    }
+                }
+                break;
+            }
+
+            case TMX_STORAGE_GIDS:
+            {
+                const auto row = Row(std::span<const std::uint32_t>{ gids }, y);
+                for (int x = 0; x < static_cast<int>(row.size()); ++x)
+                {
+                    if (row[x] != 0)
+                    {
+                        fun(x, y, MakeTile(row[x]));
+                    }
+                }
+                break;
+            }
+
+            case TMX_STORAGE_RUNS:
+                for (const auto &run : PackedRow(runs, y))
+                {
+                    const auto tile = MakeTile(run.gid);
+                    for (std::uint32_t i = 0; i < run.length; ++i)
+                    {
+                        fun(static_cast<int>(run.x + i), y, tile);
+                    }
+                }
+                break;
+
+            default:
+                for (const auto &cell : PackedRow(cells, y))
+                {
+                    fun(static_cast<int>(cell.x), y, MakeTile(cell.gid));
+                }
+                break;
+            }
+        }
+    }
+
+    template <typename T>
+    void TileLayer::IterateChunks(T &&fun) const
+    {
+        EnsureDecoded();
+        for (const auto &c : chunks)
+        {
+            fun(c.second);
+        }
+    }
 }
@@ -42,6 +42,7 @@ namespace Tmx
     {
     public:
         TileOffset(const tinyxml2::XMLElement *data);
+        TileOffset(int x, int y);
 
         /// Get the value of the x attribute of the tile offset. Horizontal offset in pixels.
         int GetX() const { return x; }
@@ -41,6 +41,8 @@
 namespace Tmx
 {
     class Image;
+    class JsonReader;
+    class MapLoader;
 
     namespace TilesetDetails
     {
@@ -49,6 +51,9 @@ namespace Tmx
         public:
             TilesetData(const std::string &path, const tinyxml2::XMLElement *data);
 
+            /// Load the tileset stored in an external file.
+            explicit TilesetData(const std::string &fileName);
+
             const tinyxml2::XMLElement *data{ nullptr };
             std::string filePath;
 
@@ -57,8 +62,49 @@ namespace Tmx
             const tinyxml2::XMLElement* FirstChildElement(const char* name = 0) const;
 
         private:
+            bool Load(const std::string &fileName);
+
             std::unique_ptr<tinyxml2::XMLDocument> doc;
         };
+
+        //---------------------------------------------------------------------
+        /// Everything about a tileset except its first gid.
+        /// External tilesets share one instance across all maps of a MapLoader.
+        //---------------------------------------------------------------------
+        class TilesetContents
+        {
+        public:
+            TilesetContents() = default;
+            explicit TilesetContents(TilesetData data);
+
+            /// Read a JSON tileset. The first gid of a tileset embedded in a
+            /// map is stored in firstGid if given.
+            TilesetContents(Tmx::JsonReader &json, std::string filePath,
+                int *firstGid = nullptr);
+
+            std::string file_path;
+
+            std::string name;
+
+            int tile_width{ 0 };
+            int tile_height{ 0 };
+            int margin{ 0 };
+            int spacing{ 0 };
+            int tile_count{ 0 };
+            int columns{ 0 };
+
+            Tmx::TileOffset tileOffset{ 0, 0 };
+            std::unique_ptr<Tmx::Image> image;
+
+            std::vector<Tmx::Terrain> terrainTypes;
+            std::vector<Tmx::Tile> tiles;
+
+            Tmx::PropertySet properties{ nullptr };
+        };
+
+        /// Load a tileset file, either TSX or JSON. Returns nullptr if the
+        /// file cannot be read.
+        std::shared_ptr<const TilesetContents> LoadTilesetFile(const std::string &fileName);
     }
 
     //-------------------------------------------------------------------------
@@ -69,71 +115,60 @@ namespace Tmx
     class Tileset 
     {
     public:
-        Tileset(const std::string &file_path, const tinyxml2::XMLElement *data);
+        /// Construct a tileset. External tilesets are taken from the cache of
+        /// the loader if one is given.
+        Tileset(const std::string &file_path, const tinyxml2::XMLElement *data,
+            Tmx::MapLoader *loader = nullptr);
+
+        /// Construct a tileset from the tilesets array of a JSON map.
+        Tileset(const std::string &file_path, Tmx::JsonReader &json,
+            Tmx::MapLoader *loader = nullptr);
 
         /// Returns the global id of the first tile.
         int GetFirstGid() const { return first_gid; }
 
-        const std::string &GetFilePath() const { return file_path; }
+        const std::string &GetFilePath() const { return contents->file_path; }
 
         /// Returns the name of the tileset.
-        const std::string &GetName() const { return name; }
+        const std::string &GetName() const { return contents->name; }
 
         /// Get the width of a single tile.
-        int GetTileWidth() const { return tile_width; } 
+        int GetTileWidth() const { return contents->tile_width; } 
 
         /// Get the height of a single tile.
-        int GetTileHeight() const { return tile_height; }
+        int GetTileHeight() const { return contents->tile_height; }
 
         /// Get the margin of the tileset.
-        int GetMargin() const { return margin; }
+        int GetMargin() const { return contents->margin; }
 
         /// Get the spacing of the tileset.
-        int GetSpacing() const { return spacing; }
+        int GetSpacing() const { return contents->spacing; }
 
         /// Get the number of tiles in this tileset(since 0.13)
-        int GetTileCount() const { return tile_count; }
+        int GetTileCount() const { return contents->tile_count; }
 
         /// Get the number of columns in the tileset(since 0.15)
-        int GetColumns() const { return columns;}
+        int GetColumns() const { return contents->columns;}
 
         /// Get the offset of tileset
-        const Tmx::TileOffset &GetTileOffset() const { return tileOffset; }
+        const Tmx::TileOffset &GetTileOffset() const { return contents->tileOffset; }
 
         /// Returns a variable containing information
         /// about the image of the tileset.
-        const Tmx::Image* GetImage() const { return image.get(); }
+        const Tmx::Image* GetImage() const { return contents->image.get(); }
 
         /// Returns a a single tile of the set.
         const Tmx::Tile *GetTile(int index) const;
 
         /// Returns the whole tile collection.
-        const std::vector<Tmx::Tile> &GetTiles() const { return tiles; }
+        const std::vector<Tmx::Tile> &GetTiles() const { return contents->tiles; }
         
         /// Get a set of properties regarding the tile.
-        const Tmx::PropertySet &GetProperties() const { return properties; }
+        const Tmx::PropertySet &GetProperties() const { return contents->properties; }
 
     private:
-        Tileset(TilesetDetails::TilesetData data, int firstGid);
-
         int first_gid;
-        std::string file_path;
 
-        std::string name;
-        
-        int tile_width{ 0 };
-        int tile_height{ 0 };
-        int margin{ 0 };
-        int spacing{ 0 };
-        int tile_count{ 0 };
-        int columns{ 0 };
-        
-        Tmx::TileOffset tileOffset;
-        std::unique_ptr<Tmx::Image> image;
-
-        std::vector<Tmx::Terrain> terrainTypes;
-        std::vector<Tmx::Tile> tiles;
-        
-        Tmx::PropertySet properties;
+        std::shared_ptr<const TilesetDetails::TilesetContents> contents;
     };
 }
@@ -0,0 +1,106 @@
+//-----------------------------------------------------------------------------
+// TmxTilesetLookup.h
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "TmxMapTile.h"
+
+namespace Tmx
+{
+    class Tileset;
+
+    //-------------------------------------------------------------------------
+    /// Finds the tileset of a gid without walking the tilesets. When the last
+    /// tileset starts at a gid below MaxTableGid every gid up to there has its
+    /// tileset index in a table; otherwise the first gids are searched without
+    /// branches. Gids past the start of the last tileset belong to it.
+    //-------------------------------------------------------------------------
+    class TilesetLookup
+    {
+    public:
+        /// Gids are looked up in a table when the last tileset starts below this.
+        static constexpr std::uint32_t MaxTableGid = 1 << 16;
+
+        /// A lookup without tilesets, in which every gid has the index -1.
+        TilesetLookup() = default;
+
+        /// Index the tilesets of a map, which are ordered by first gid.
+        explicit TilesetLookup(const std::vector<Tmx::Tileset> &tilesets);
+
+        /// Get the index of the tileset of a gid, -1 if it comes before the
+        /// first tileset. The flip flags of the gid are ignored.
+        int FindIndex(std::uint32_t gid) const
+        {
+            const auto id = gid
+                & ~(FlippedHorizontallyFlag | FlippedVerticallyFlag | FlippedDiagonallyFlag);
+            return !table.empty()
+                ? table[std::min<std::size_t>(id, table.size() - 1)]
+                : Search(id);
+        }
+
+        /// Get the first gid of the tileset at an index, 0 for the index -1.
+        int GetFirstGid(int index) const { return static_cast<int>(first_gids[index + 1]); }
+
+        /// Whether the gids are looked up in a table.
+        bool HasTable() const { return !table.empty(); }
+
+        /// Resolve gids in one pass. For each gid the index of its tileset
+        /// (-1 for none), its id within the tileset and its flip flags are
+        /// written at the same position of the outputs, which hold at least as
+        /// many values as there are gids. The flags are the top three bits of
+        /// the gid: 4 for horizontal, 2 for vertical and 1 for diagonal. With
+        /// AVX2, eight gids are resolved at a time.
+        void Resolve(std::span<const std::uint32_t> gids, std::span<std::int32_t> tilesetIndices,
+            std::span<std::uint32_t> ids, std::span<std::uint8_t> flags) const;
+
+    private:
+        int Search(std::uint32_t id) const
+        {
+            // The last first gid that is not past the id; the 0 in front
+            // stands for no tileset.
+            const std::uint32_t *base = first_gids.data();
+            for (auto n = first_gids.size(); n > 1;)
+            {
+                const auto half = n / 2;
+                base = base[half] <= id ? base + half : base;
+                n -= half;
+            }
+
+            return static_cast<int>(base - first_gids.data()) - 1;
+        }
+
+        // The first gid of each tileset after a 0 for no tileset.
+        std::vector<std::uint32_t> first_gids{ 0 };
+
+        // The tileset index of every gid up to the first of the last tileset.
+        std::vector<std::int32_t> table;
+    };
+}
@@ -27,6 +27,7 @@
 //-----------------------------------------------------------------------------
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -51,12 +52,56 @@ namespace Tmx
         /// Trim both leading and trailing whitespace from a string.
         std::string &Trim(std::string &str);
 
+        /// Get whether a map or tileset file is in the JSON format, going by
+        /// its extension (.tmj, .tsj or .json).
+        bool IsJsonFileName(std::string_view fileName);
+
+        /// Instruction sets the decoders can be vectorized with.
+        enum class SimdLevel
+        {
+            Scalar,
+            SSE41,
+            AVX2
+        };
+
+        /// Get the best instruction set of this CPU, which the decoders use.
+        SimdLevel GetSimdLevel();
+
+        /// Get the most bytes that size characters of base-64 can decode to.
+        size_t Base64DecodedSize(size_t size);
+
+        /// Decode base-64 text into out, which must have room for
+        /// Base64DecodedSize(text.size()) bytes. Whitespace is skipped and
+        /// decoding stops at the '=' padding or any other character outside
+        /// the alphabet. Returns the number of bytes decoded.
+        size_t DecodeBase64(std::string_view text, char *out);
+
+        /// Decode base-64 text as above with the given instruction set, or
+        /// the best one of this CPU if that is not supported.
+        size_t DecodeBase64(std::string_view text, char *out, SimdLevel level);
+
         /// Decode a base-64 encoded string.
         std::string DecodeBase64(const std::string &str);
 
+        /// Parse comma separated unsigned integers, such as the csv tile
+        /// data of layers, into out, stopping after outSize values. Whitespace
+        /// around the values is skipped and empty values are 0. Returns the
+        /// number of values parsed, one more than there are commas unless the
+        /// text is empty or out is full.
+        size_t ParseCsv(std::string_view text, uint32_t *out, size_t outSize);
+
+        /// Parse csv text as above with the given instruction set, or the best
+        /// one of this CPU if that is not supported.
+        size_t ParseCsv(std::string_view text, uint32_t *out, size_t outSize, SimdLevel level);
+
         /// Decompress a gzip encoded byte array.
         char* DecompressGZIP(const char *data, int dataSize, int expectedSize);
 
+        /// Decompress a gzip encoded byte array into out, which has room for
+        /// outSize bytes. Returns the number of bytes written, or -1 if the
+        /// data is not valid.
+        int DecompressGZIP(const char *data, int dataSize, char *out, int outSize);
+
         template <typename T>
         auto ParseOrDefault(const tinyxml2::XMLElement *data, const char *attributeName,
             T &&parser, decltype(T{}(nullptr)) defaultValue)
@@ -0,0 +1,306 @@
+//-----------------------------------------------------------------------------
+// TmxBase64.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+
+#include "TmxUtil.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define TMX_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace Tmx
+{
+    namespace
+    {
+        constexpr uint8_t kSkip = 0x40;
+        constexpr uint8_t kStop = 0x80;
+
+        // The value of every base-64 digit; whitespace is skipped and anything
+        // else, the '=' padding included, ends the data.
+        constexpr auto kDigits = [] {
+            std::array<uint8_t, 256> digits{};
+            digits.fill(kStop);
+            const char alphabet[] =
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            for (uint8_t i = 0; i < 64; ++i)
+            {
+                digits[static_cast<uint8_t>(alphabet[i])] = i;
+            }
+            for (const char c : { ' ', '\t', '\n', '\r' })
+            {
+                digits[static_cast<uint8_t>(c)] = kSkip;
+            }
+            return digits;
+        }();
+
+        uint8_t Digit(char c)
+        {
+            return kDigits[static_cast<uint8_t>(c)];
+        }
+
+        // Decodes groups of four digits for as long as there is no whitespace
+        // or end of the data among them.
+        void DecodeScalar(const char *&in, const char *end, char *&out)
+        {
+            while (end - in >= 4)
+            {
+                const uint32_t a = Digit(in[0]), b = Digit(in[1]), c = Digit(in[2]), d = Digit(in[3]);
+                if ((a | b | c | d) & (kSkip | kStop))
+                {
+                    return;
+                }
+
+                const uint32_t bits = a << 18 | b << 12 | c << 6 | d;
+                out[0] = static_cast<char>(bits >> 16);
+                out[1] = static_cast<char>(bits >> 8);
+                out[2] = static_cast<char>(bits);
+                in += 4;
+                out += 3;
+            }
+        }
+
+        // Decodes one group of four digits, skipping whitespace. At the end
+        // of the data the digits read so far are flushed and false returned.
+        bool DecodeGroup(const char *&in, const char *end, char *&out)
+        {
+            uint32_t bits = 0;
+            int digits = 0;
+            while (digits < 4 && in != end)
+            {
+                const auto digit = Digit(*in);
+                if (digit == kStop)
+                {
+                    break;
+                }
+
+                ++in;
+                if (digit != kSkip)
+                {
+                    bits = bits << 6 | digit;
+                    ++digits;
+                }
+            }
+
+            if (digits == 4)
+            {
+                out[0] = static_cast<char>(bits >> 16);
+                out[1] = static_cast<char>(bits >> 8);
+                out[2] = static_cast<char>(bits);
+                out += 3;
+                return true;
+            }
+
+            // Two digits make a byte and three make two; a lone digit is lost.
+            bits <<= 6 * (4 - digits);
+            for (int i = 0; i < digits - 1; ++i)
+            {
+                *out++ = static_cast<char>(bits >> (16 - 8 * i));
+            }
+            return false;
+        }
+
+#ifdef TMX_SIMD_X86
+        // The vector decoders follow Wojciech Muła and Daniel Lemire, "Faster
+        // Base64 Encoding and Decoding Using AVX2 Instructions" (2018): the
+        // high and low nibble of every character index two tables whose
+        // entries only share a bit for characters outside the alphabet, and
+        // a third table gives the offset from character to digit value.
+        // Blocks are decoded until one holds whitespace or the end of the
+        // data. Each store writes a few bytes past the decoded ones, which
+        // the input left over guarantees to fit in Base64DecodedSize.
+
+        __attribute__((target("sse4.1")))
+        void DecodeSse41(const char *&in, const char *end, char *&out)
+        {
+            const __m128i lutLo = _mm_setr_epi8(
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            const __m128i lutHi = _mm_setr_epi8(
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            const __m128i lutRoll = _mm_setr_epi8(
+                0, 16, 19, 4, -65, -65, -71, -71,
+                0, 0, 0, 0, 0, 0, 0, 0);
+            const __m128i mask2F = _mm_set1_epi8(0x2F);
+            const __m128i pack = _mm_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+            while (end - in >= 24)
+            {
+                __m128i str = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+                const __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask2F);
+                const __m128i loNibbles = _mm_and_si128(str, mask2F);
+                const __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+                const __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+                if (!_mm_testz_si128(lo, hi))
+                {
+                    return;
+                }
+
+                const __m128i eq2F = _mm_cmpeq_epi8(str, mask2F);
+                const __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eq2F, hiNibbles));
+                str = _mm_add_epi8(str, roll);
+
+                // Merge the 6-bit digits into 24-bit groups and put their
+                // bytes in order.
+                const __m128i pairs = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+                const __m128i groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_shuffle_epi8(groups, pack));
+
+                in += 16;
+                out += 12;
+            }
+        }
+
+        __attribute__((target("avx2")))
+        void DecodeAvx2(const char *&in, const char *end, char *&out)
+        {
+            const __m256i lutLo = _mm256_setr_epi8(
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            const __m256i lutHi = _mm256_setr_epi8(
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            const __m256i lutRoll = _mm256_setr_epi8(
+                0, 16, 19, 4, -65, -65, -71, -71,
+                0, 0, 0, 0, 0, 0, 0, 0,
+                0, 16, 19, 4, -65, -65, -71, -71,
+                0, 0, 0, 0, 0, 0, 0, 0);
+            const __m256i mask2F = _mm256_set1_epi8(0x2F);
+            const __m256i pack = _mm256_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+            const __m256i joinLanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+
+            while (end - in >= 45)
+            {
+                __m256i str = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+                const __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask2F);
+                const __m256i loNibbles = _mm256_and_si256(str, mask2F);
+                const __m256i hi = _mm256_shuffle_epi8(lutHi, hiNibbles);
+                const __m256i lo = _mm256_shuffle_epi8(lutLo, loNibbles);
+                if (!_mm256_testz_si256(lo, hi))
+                {
+                    return;
+                }
+
+                const __m256i eq2F = _mm256_cmpeq_epi8(str, mask2F);
+                const __m256i roll = _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(eq2F, hiNibbles));
+                str = _mm256_add_epi8(str, roll);
+
+                // As for SSE, then move the 12 bytes of each lane together.
+                const __m256i pairs = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+                const __m256i groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+                const __m256i bytes = _mm256_permutevar8x32_epi32(
+                    _mm256_shuffle_epi8(groups, pack), joinLanes);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), bytes);
+
+                in += 32;
+                out += 24;
+            }
+        }
+#endif
+
+        Util::SimdLevel DetectSimdLevel()
+        {
+#ifdef TMX_SIMD_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+            {
+                return Util::SimdLevel::AVX2;
+            }
+            if (__builtin_cpu_supports("sse4.1"))
+            {
+                return Util::SimdLevel::SSE41;
+            }
+#endif
+            return Util::SimdLevel::Scalar;
+        }
+
+        template <typename Kernel>
+        size_t Decode(std::string_view text, char *out, Kernel kernel)
+        {
+            const char *in = text.data();
+            const char *end = in + text.size();
+            char *const begin = out;
+
+            // The kernel stops short of whitespace, so step over it one
+            // group at a time and carry on.
+            do
+            {
+                kernel(in, end, out);
+            } while (DecodeGroup(in, end, out));
+
+            return static_cast<size_t>(out - begin);
+        }
+    }
+
+    Util::SimdLevel Util::GetSimdLevel()
+    {
+        static const SimdLevel level = DetectSimdLevel();
+        return level;
+    }
+
+    size_t Util::Base64DecodedSize(size_t size)
+    {
+        return (size + 3) / 4 * 3;
+    }
+
+    size_t Util::DecodeBase64(std::string_view text, char *out)
+    {
+        return DecodeBase64(text, out, GetSimdLevel());
+    }
+
+    size_t Util::DecodeBase64(std::string_view text, char *out, SimdLevel level)
+    {
+        switch (std::min(level, GetSimdLevel()))
+        {
+#ifdef TMX_SIMD_X86
+        case SimdLevel::AVX2:
+            return Decode(text, out, DecodeAvx2);
+        case SimdLevel::SSE41:
+            return Decode(text, out, DecodeSse41);
+#endif
+        default:
+            return Decode(text, out, DecodeScalar);
+        }
+    }
+
+    std::string Util::DecodeBase64(const std::string &str)
+    {
+        std::string decoded(Base64DecodedSize(str.size()), '\0');
+        decoded.resize(DecodeBase64(str, decoded.data()));
+        return decoded;
+    }
+}
@@ -0,0 +1,668 @@
+//-----------------------------------------------------------------------------
+// TmxCookedMap.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+
+#include "TmxCookedMap.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "TmxGroupLayer.h"
+#include "TmxImage.h"
+#include "TmxImageLayer.h"
+#include "TmxMap.h"
+#include "TmxMappedFile.h"
+#include "TmxObjectGroup.h"
+#include "TmxPolygon.h"
+#include "TmxPolyline.h"
+#include "TmxPropertySet.h"
+#include "TmxTileLayer.h"
+#include "TmxTileset.h"
+
+namespace Tmx
+{
+    namespace
+    {
+        constexpr char magic[4] = { 'T', 'M', 'X', 'C' };
+        constexpr std::uint32_t byteOrderMark = 0x01020304;
+
+        template <typename... T>
+        constexpr bool AllPlainRecords = ((std::is_trivially_copyable_v<T>
+            && std::is_standard_layout_v<T> && alignof(T) == 4 && sizeof(T) % 4 == 0) && ...);
+
+        static_assert(AllPlainRecords<Cooked::Header, Cooked::Property, Cooked::Tileset,
+            Cooked::Tile, Cooked::Layer, Cooked::Chunk, Cooked::Object, Cooked::Point>);
+
+        // Size of the records of each table, in table order.
+        constexpr std::size_t recordSizes[Cooked::TABLE_COUNT] = {
+            1,
+            sizeof(Cooked::Property),
+            sizeof(Cooked::Tileset),
+            sizeof(Cooked::Tile),
+            sizeof(Cooked::Layer),
+            sizeof(Cooked::Chunk),
+            sizeof(std::uint32_t),
+            sizeof(Cooked::Object),
+            sizeof(Cooked::Point),
+        };
+
+        template <typename T, typename F>
+        bool AllOf(std::span<const T> records, F &&check)
+        {
+            return std::all_of(records.begin(), records.end(), check);
+        }
+
+        //---------------------------------------------------------------------
+        // Collects the records of a map table by table, then lays them out.
+        //---------------------------------------------------------------------
+        class Cooker
+        {
+        public:
+            explicit Cooker(const Map &map)
+            {
+                // Unset strings of the records refer to this one.
+                AddString("");
+
+                header.orientation = map.GetOrientation();
+                header.renderOrder = map.GetRenderOrder();
+                header.staggerAxis = map.GetStaggerAxis();
+                header.staggerIndex = map.GetStaggerIndex();
+                header.width = map.GetWidth();
+                header.height = map.GetHeight();
+                header.tileWidth = map.GetTileWidth();
+                header.tileHeight = map.GetTileHeight();
+                header.nextObjectId = map.GetNextObjectId();
+                header.hexsideLength = map.GetHexsideLength();
+                header.parallaxOriginX = map.GetParallaxOriginX();
+                header.parallaxOriginY = map.GetParallaxOriginY();
+                header.backgroundColor = map.GetBackgroundColor().ToInt();
+                header.infinite = map.IsInfinite();
+                header.properties = AddProperties(map.GetProperties());
+
+                for (const auto &tileset : map.GetTilesets())
+                {
+                    AddTileset(tileset);
+                }
+
+                header.layers = AddLayers(map.GetLayers());
+            }
+
+            std::string Finish()
+            {
+                std::memcpy(header.magic, magic, sizeof(magic));
+                header.version = Cooked::Version;
+                header.byteOrder = byteOrderMark;
+
+                std::string out(sizeof(Cooked::Header), '\0');
+
+                const auto append = [&](Cooked::Table table, const void *records,
+                    std::size_t count) {
+                    out.resize((out.size() + 3) / 4 * 4, '\0');
+                    header.tables[table] = Cooked::TableEntry{
+                        static_cast<std::uint32_t>(out.size()),
+                        static_cast<std::uint32_t>(count) };
+                    out.append(static_cast<const char *>(records), count * recordSizes[table]);
+                };
+
+                append(Cooked::TABLE_STRINGS, strings.data(), strings.size());
+                append(Cooked::TABLE_PROPERTIES, properties.data(), properties.size());
+                append(Cooked::TABLE_TILESETS, tilesets.data(), tilesets.size());
+                append(Cooked::TABLE_TILES, tiles.data(), tiles.size());
+                append(Cooked::TABLE_LAYERS, layers.data(), layers.size());
+                append(Cooked::TABLE_CHUNKS, chunks.data(), chunks.size());
+                append(Cooked::TABLE_GIDS, gids.data(), gids.size());
+                append(Cooked::TABLE_OBJECTS, objects.data(), objects.size());
+                append(Cooked::TABLE_POINTS, points.data(), points.size());
+
+                header.size = static_cast<std::uint32_t>(out.size());
+                std::memcpy(out.data(), &header, sizeof(header));
+                return out;
+            }
+
+        private:
+            template <typename T>
+            static Cooked::Range RangeFrom(const std::vector<T> &table, std::size_t first)
+            {
+                return Cooked::Range{ static_cast<std::uint32_t>(first),
+                    static_cast<std::uint32_t>(table.size() - first) };
+            }
+
+            // Equal strings are stored once.
+            Cooked::String AddString(std::string_view s)
+            {
+                const auto [it, added] = stringOffsets.try_emplace(std::string{ s },
+                    static_cast<std::uint32_t>(strings.size()));
+                if (added)
+                {
+                    strings.append(s);
+                    strings.push_back('\0');
+                }
+
+                return Cooked::String{ it->second, static_cast<std::uint32_t>(s.size()) };
+            }
+
+            Cooked::Range AddProperties(const PropertySet &set)
+            {
+                // Sorted by name, so that cooking the same map gives the same bytes.
+                std::vector<const std::pair<const std::string_view, Property> *> sorted;
+                for (const auto &p : set.GetPropertyMap())
+                {
+                    sorted.push_back(&p);
+                }
+
+                std::sort(sorted.begin(), sorted.end(),
+                    [](const auto a, const auto b) { return a->first < b->first; });
+
+                const auto first = properties.size();
+                for (const auto p : sorted)
+                {
+                    const auto &property = p->second;
+
+                    Cooked::Property out{};
+                    out.name = AddString(p->first);
+                    out.type = property.GetType();
+                    out.isEmpty = property.IsValueEmpty();
+
+                    switch (property.GetType())
+                    {
+                    case TMX_PROPERTY_BOOL:
+                        out.value = property.GetBoolValue();
+                        break;
+                    case TMX_PROPERTY_INT:
+                    case TMX_PROPERTY_OBJECT:
+                        out.value = static_cast<std::uint32_t>(property.GetIntValue());
+                        break;
+                    case TMX_PROPERTY_FLOAT:
+                        out.value = std::bit_cast<std::uint32_t>(property.GetFloatValue());
+                        break;
+                    case TMX_PROPERTY_COLOR:
+                        out.value = property.GetColorValue().ToInt();
+                        break;
+                    default:
+                        out.text = AddString(property.GetValue());
+                        break;
+                    }
+
+                    properties.push_back(out);
+                }
+
+                return RangeFrom(properties, first);
+            }
+
+            void AddTileset(const Tileset &tileset)
+            {
+                Cooked::Tileset out{};
+                out.firstGid = tileset.GetFirstGid();
+                out.name = AddString(tileset.GetName());
+                out.tileWidth = tileset.GetTileWidth();
+                out.tileHeight = tileset.GetTileHeight();
+                out.margin = tileset.GetMargin();
+                out.spacing = tileset.GetSpacing();
+                out.tileCount = tileset.GetTileCount();
+                out.columns = tileset.GetColumns();
+                if (const auto image = tileset.GetImage())
+                {
+                    out.image = AddString(image->GetSource());
+                    out.imageWidth = image->GetWidth();
+                    out.imageHeight = image->GetHeight();
+                }
+                out.properties = AddProperties(tileset.GetProperties());
+
+                // Properties first, the tiles of a tileset have to be contiguous.
+                std::vector<Cooked::Tile> tilesetTiles;
+                for (const auto &tile : tileset.GetTiles())
+                {
+                    tilesetTiles.push_back(Cooked::Tile{ tile.GetId(), AddString(tile.GetType()),
+                        AddProperties(tile.GetProperties()) });
+                }
+
+                const auto first = tiles.size();
+                tiles.insert(tiles.end(), tilesetTiles.begin(), tilesetTiles.end());
+                out.tiles = RangeFrom(tiles, first);
+
+                tilesets.push_back(out);
+            }
+
+            // The layers are reserved as a block first, so that siblings stay
+            // contiguous when groups add their children.
+            template <typename Layers>
+            Cooked::Range AddLayers(const Layers &source)
+            {
+                const auto first = layers.size();
+                layers.resize(first + source.size());
+
+                std::size_t i = first;
+                for (const auto layer : source)
+                {
+                    const auto out = CookLayer(*layer);
+                    layers[i++] = out;
+                }
+
+                return Cooked::Range{ static_cast<std::uint32_t>(first),
+                    static_cast<std::uint32_t>(source.size()) };
+            }
+
+            Cooked::Layer CookLayer(const Layer &layer)
+            {
+                Cooked::Layer out{};
+                out.type = layer.GetLayerType();
+                out.name = AddString(layer.GetName());
+                out.x = layer.GetX();
+                out.y = layer.GetY();
+                out.width = layer.GetWidth();
+                out.height = layer.GetHeight();
+                out.opacity = layer.GetOpacity();
+                out.visible = layer.IsVisible();
+                out.offsetX = layer.GetOffsetX();
+                out.offsetY = layer.GetOffsetY();
+                out.parallaxX = layer.GetParallaxX();
+                out.parallaxY = layer.GetParallaxY();
+                out.properties = AddProperties(layer.GetProperties());
+
+                switch (layer.GetLayerType())
+                {
+                case TMX_LAYERTYPE_TILE:
+                    CookTiles(static_cast<const TileLayer &>(layer), out);
+                    break;
+
+                case TMX_LAYERTYPE_OBJECTGROUP:
+                {
+                    const auto &group = static_cast<const ObjectGroup &>(layer);
+                    out.color = group.GetColor().ToInt();
+                    out.objects = AddObjects(group.GetObjects());
+                    break;
+                }
+
+                case TMX_LAYERTYPE_IMAGE_LAYER:
+                    if (const auto image = static_cast<const ImageLayer &>(layer).GetImage())
+                    {
+                        out.image = AddString(image->GetSource());
+                    }
+                    break;
+
+                case TMX_LAYERTYPE_GROUP_LAYER:
+                {
+                    std::vector<const Layer *> children;
+                    static_cast<const GroupLayer &>(layer).IterateChildren(
+                        [&children](const Layer *child) { children.push_back(child); });
+                    out.children = AddLayers(children);
+                    break;
+                }
+                }
+
+                return out;
+            }
+
+            void CookTiles(const TileLayer &layer, Cooked::Layer &out)
+            {
+                if (!layer.IsChunked())
+                {
+                    const auto first = gids.size();
+                    gids.resize(first + static_cast<std::size_t>(layer.GetWidth()) * layer.GetHeight());
+                    layer.CopyRegion({ 0, 0, layer.GetWidth(), layer.GetHeight() },
+                        gids.data() + first, layer.GetWidth());
+
+                    out.gids = RangeFrom(gids, first);
+                    return;
+                }
+
+                out.chunkWidth = layer.GetChunkWidth();
+                out.chunkHeight = layer.GetChunkHeight();
+
+                // Row by row, the chunk index has no order of its own.
+                std::vector<const TileChunk *> sorted;
+                layer.IterateChunks([&sorted](const TileChunk &c) { sorted.push_back(&c); });
+                std::sort(sorted.begin(), sorted.end(), [](const auto a, const auto b) {
+                    return a->y != b->y ? a->y < b->y : a->x < b->x;
+                });
+
+                const auto firstChunk = chunks.size();
+                for (const auto chunk : sorted)
+                {
+                    const auto first = gids.size();
+                    for (const auto &tile : chunk->tiles)
+                    {
+                        gids.push_back(tile.GetRawGid());
+                    }
+
+                    chunks.push_back(Cooked::Chunk{ chunk->x, chunk->y,
+                        chunk->width, chunk->height, RangeFrom(gids, first) });
+                }
+
+                out.chunks = RangeFrom(chunks, firstChunk);
+            }
+
+            Cooked::Range AddObjects(std::span<const Object> source)
+            {
+                std::vector<Cooked::Object> group;
+                for (const auto &object : source)
+                {
+                    Cooked::Object out{};
+                    out.id = object.GetId();
+                    out.name = AddString(object.GetName());
+                    out.type = AddString(object.GetType());
+                    out.x = object.GetX();
+                    out.y = object.GetY();
+                    out.width = object.GetWidth();
+                    out.height = object.GetHeight();
+                    out.rotation = object.GetRot();
+                    out.gid = static_cast<std::uint32_t>(object.GetGid());
+                    out.visible = object.IsVisible();
+                    out.shape = Cooked::SHAPE_RECTANGLE;
+                    out.properties = AddProperties(object.GetProperties());
+
+                    const auto addPoints = [&](const auto *shape) {
+                        const auto first = points.size();
+                        for (int i = 0; i < shape->GetNumPoints(); ++i)
+                        {
+                            points.push_back(Cooked::Point{ shape->GetPoint(i).x,
+                                shape->GetPoint(i).y });
+                        }
+                        out.points = RangeFrom(points, first);
+                    };
+
+                    if (object.GetEllipse())
+                    {
+                        out.shape = Cooked::SHAPE_ELLIPSE;
+                    }
+                    else if (const auto polygon = object.GetPolygon())
+                    {
+                        out.shape = Cooked::SHAPE_POLYGON;
+                        addPoints(polygon);
+                    }
+                    else if (const auto polyline = object.GetPolyline())
+                    {
+                        out.shape = Cooked::SHAPE_POLYLINE;
+                        addPoints(polyline);
+                    }
+                    else if (const auto text = object.GetText())
+                    {
+                        out.shape = Cooked::SHAPE_TEXT;
+                        out.text = AddString(text->GetContents());
+                    }
+
+                    group.push_back(out);
+                }
+
+                const auto first = objects.size();
+                objects.insert(objects.end(), group.begin(), group.end());
+                return RangeFrom(objects, first);
+            }
+
+            Cooked::Header header{};
+
+            std::string strings;
+            std::unordered_map<std::string, std::uint32_t> stringOffsets;
+            std::vector<Cooked::Property> properties;
+            std::vector<Cooked::Tileset> tilesets;
+            std::vector<Cooked::Tile> tiles;
+            std::vector<Cooked::Layer> layers;
+            std::vector<Cooked::Chunk> chunks;
+            std::vector<std::uint32_t> gids;
+            std::vector<Cooked::Object> objects;
+            std::vector<Cooked::Point> points;
+        };
+    }
+
+    CookedMap CookedMap::Open(const std::string &fileName)
+    {
+        auto file = std::make_unique<MappedFile>(fileName);
+        if (!file->IsOpen())
+        {
+            CookedMap map{ {}, nullptr };
+            map.error_text = "failed to open file '" + fileName + "'";
+            return map;
+        }
+
+        const auto view = file->GetView();
+        return CookedMap{ view, std::move(file) };
+    }
+
+    CookedMap CookedMap::FromMemory(std::string_view data)
+    {
+        return CookedMap{ data, nullptr };
+    }
+
+    std::string CookedMap::Cook(const Map &map)
+    {
+        return Cooker{ map }.Finish();
+    }
+
+    CookedMap::CookedMap(std::string_view data, std::unique_ptr<MappedFile> file)
+        : file{ std::move(file) }
+        , data{ data }
+    {
+        Validate();
+    }
+
+    CookedMap::CookedMap(CookedMap &&) noexcept = default;
+    CookedMap &CookedMap::operator=(CookedMap &&) noexcept = default;
+    CookedMap::~CookedMap() = default;
+
+    const Cooked::Header &CookedMap::GetHeader() const
+    {
+        return *reinterpret_cast<const Cooked::Header *>(data.data());
+    }
+
+    std::span<const Cooked::Property> CookedMap::GetProperties() const
+    {
+        return GetProperties(GetHeader().properties);
+    }
+
+    std::span<const Cooked::Property> CookedMap::GetProperties(Cooked::Range range) const
+    {
+        return Get<Cooked::Property>(Cooked::TABLE_PROPERTIES, range);
+    }
+
+    const Cooked::Property *CookedMap::FindProperty(Cooked::Range range,
+        std::string_view name) const
+    {
+        for (const auto &property : GetProperties(range))
+        {
+            if (GetString(property.name) == name)
+            {
+                return &property;
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::string_view CookedMap::GetString(Cooked::String s) const
+    {
+        return { data.data() + GetHeader().tables[Cooked::TABLE_STRINGS].offset + s.offset, s.size };
+    }
+
+    std::span<const Cooked::Tileset> CookedMap::GetTilesets() const
+    {
+        return Get<Cooked::Tileset>(Cooked::TABLE_TILESETS,
+            Cooked::Range{ 0, GetHeader().tables[Cooked::TABLE_TILESETS].count });
+    }
+
+    std::span<const Cooked::Tile> CookedMap::GetTiles(const Cooked::Tileset &tileset) const
+    {
+        return Get<Cooked::Tile>(Cooked::TABLE_TILES, tileset.tiles);
+    }
+
+    int CookedMap::FindTilesetIndex(std::uint32_t gid) const
+    {
+        gid &= ~(FlippedHorizontallyFlag | FlippedVerticallyFlag | FlippedDiagonallyFlag);
+
+        const auto tilesets = GetTilesets();
+        for (auto i = static_cast<int>(tilesets.size()) - 1; i >= 0; --i)
+        {
+            if (gid >= static_cast<std::uint32_t>(tilesets[i].firstGid))
+            {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    std::span<const Cooked::Layer> CookedMap::GetLayers() const
+    {
+        return Get<Cooked::Layer>(Cooked::TABLE_LAYERS, GetHeader().layers);
+    }
+
+    std::span<const Cooked::Layer> CookedMap::GetChildren(const Cooked::Layer &group) const
+    {
+        return Get<Cooked::Layer>(Cooked::TABLE_LAYERS, group.children);
+    }
+
+    std::span<const std::uint32_t> CookedMap::GetGids(const Cooked::Layer &layer) const
+    {
+        return Get<std::uint32_t>(Cooked::TABLE_GIDS, layer.gids);
+    }
+
+    std::span<const Cooked::Chunk> CookedMap::GetChunks(const Cooked::Layer &layer) const
+    {
+        return Get<Cooked::Chunk>(Cooked::TABLE_CHUNKS, layer.chunks);
+    }
+
+    std::span<const std::uint32_t> CookedMap::GetGids(const Cooked::Chunk &chunk) const
+    {
+        return Get<std::uint32_t>(Cooked::TABLE_GIDS, chunk.gids);
+    }
+
+    std::span<const Cooked::Object> CookedMap::GetObjects(const Cooked::Layer &layer) const
+    {
+        return Get<Cooked::Object>(Cooked::TABLE_OBJECTS, layer.objects);
+    }
+
+    std::span<const Cooked::Point> CookedMap::GetPoints(const Cooked::Object &object) const
+    {
+        return Get<Cooked::Point>(Cooked::TABLE_POINTS, object.points);
+    }
+
+    template <typename T>
+    std::span<const T> CookedMap::Get(Cooked::Table table, Cooked::Range range) const
+    {
+        const auto records = reinterpret_cast<const T *>(
+            data.data() + GetHeader().tables[table].offset);
+        return { records + range.first, range.count };
+    }
+
+    bool CookedMap::Validate()
+    {
+        const auto fail = [this](const char *reason) {
+            error_text = std::string{ "invalid cooked map: " } + reason;
+            return false;
+        };
+
+        if (data.size() < sizeof(Cooked::Header)
+            || reinterpret_cast<std::uintptr_t>(data.data()) % 4 != 0)
+        {
+            return fail("too small or misaligned");
+        }
+
+        const auto &header = GetHeader();
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0)
+        {
+            return fail("not a cooked map");
+        }
+
+        if (header.byteOrder != byteOrderMark)
+        {
+            return fail("cooked with another byte order");
+        }
+
+        if (header.version != Cooked::Version)
+        {
+            return fail("unsupported version");
+        }
+
+        if (header.size != data.size())
+        {
+            return fail("truncated");
+        }
+
+        for (std::uint32_t t = 0; t < Cooked::TABLE_COUNT; ++t)
+        {
+            const auto &table = header.tables[t];
+            if (table.offset % 4 != 0 || table.offset < sizeof(Cooked::Header)
+                || table.offset > data.size()
+                || table.count > (data.size() - table.offset) / recordSizes[t])
+            {
+                return fail("table out of bounds");
+            }
+        }
+
+        // Every reference is checked here, so that the getters need not.
+        const auto count = [&](Cooked::Table t) { return header.tables[t].count; };
+        const auto inRange = [&](Cooked::Table t, Cooked::Range r) {
+            return r.first <= count(t) && r.count <= count(t) - r.first;
+        };
+        const auto stringOk = [&](Cooked::String s) {
+            return s.offset < count(Cooked::TABLE_STRINGS)
+                && s.size < count(Cooked::TABLE_STRINGS) - s.offset
+                && data[header.tables[Cooked::TABLE_STRINGS].offset + s.offset + s.size] == '\0';
+        };
+        const auto records = [&](Cooked::Table t) { return Cooked::Range{ 0, count(t) }; };
+
+        const bool ok =
+            inRange(Cooked::TABLE_PROPERTIES, header.properties)
+            && inRange(Cooked::TABLE_LAYERS, header.layers)
+            && AllOf(GetProperties(records(Cooked::TABLE_PROPERTIES)),
+                [&](const Cooked::Property &p) {
+                    return stringOk(p.name) && stringOk(p.text);
+                })
+            && AllOf(GetTilesets(), [&](const Cooked::Tileset &t) {
+                    return stringOk(t.name) && stringOk(t.image)
+                        && inRange(Cooked::TABLE_PROPERTIES, t.properties)
+                        && inRange(Cooked::TABLE_TILES, t.tiles);
+                })
+            && AllOf(Get<Cooked::Tile>(Cooked::TABLE_TILES, records(Cooked::TABLE_TILES)),
+                [&](const Cooked::Tile &t) {
+                    return stringOk(t.type)
+                        && inRange(Cooked::TABLE_PROPERTIES, t.properties);
+                })
+            && AllOf(Get<Cooked::Layer>(Cooked::TABLE_LAYERS, records(Cooked::TABLE_LAYERS)),
+                [&](const Cooked::Layer &l) {
+                    return stringOk(l.name) && stringOk(l.image)
+                        && inRange(Cooked::TABLE_PROPERTIES, l.properties)
+                        && inRange(Cooked::TABLE_GIDS, l.gids)
+                        && inRange(Cooked::TABLE_CHUNKS, l.chunks)
+                        && inRange(Cooked::TABLE_OBJECTS, l.objects)
+                        && inRange(Cooked::TABLE_LAYERS, l.children);
+                })
+            && AllOf(Get<Cooked::Chunk>(Cooked::TABLE_CHUNKS, records(Cooked::TABLE_CHUNKS)),
+                [&](const Cooked::Chunk &c) {
+                    return inRange(Cooked::TABLE_GIDS, c.gids);
+                })
+            && AllOf(Get<Cooked::Object>(Cooked::TABLE_OBJECTS, records(Cooked::TABLE_OBJECTS)),
+                [&](const Cooked::Object &o) {
+                    return stringOk(o.name) && stringOk(o.type) && stringOk(o.text)
+                        && inRange(Cooked::TABLE_POINTS, o.points)
+                        && inRange(Cooked::TABLE_PROPERTIES, o.properties);
+                });
+
+        return ok || fail("reference out of bounds");
+    }
+}
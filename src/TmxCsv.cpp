@@ -0,0 +1,208 @@
+//-----------------------------------------------------------------------------
+// TmxCsv.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+
+#include "TmxUtil.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define TMX_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace Tmx
+{
+    namespace
+    {
+        bool IsSpace(char c)
+        {
+            return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+        }
+
+        // Reads digits the way strtoul does, without the locale: from the
+        // first one to the first character that is not one.
+        uint32_t ParseDigits(const char *first, const char *last)
+        {
+            uint32_t value = 0;
+            for (; first != last && static_cast<unsigned char>(*first - '0') < 10; ++first)
+            {
+                value = value * 10 + static_cast<uint32_t>(*first - '0');
+            }
+            return value;
+        }
+
+        // Turns 8 digits, the first in the lowest byte, into their value with
+        // three multiplications instead of eight.
+        uint32_t ParseEightDigits(uint64_t digits)
+        {
+            digits = (digits * 10) + (digits >> 8);
+            digits = (((digits & 0x000000FF000000FF) * (100 + (1000000ull << 32)))
+                + (((digits >> 16) & 0x000000FF000000FF) * (1 + (10000ull << 32)))) >> 32;
+            return static_cast<uint32_t>(digits);
+        }
+
+        // Parses one value, which spans [first, last) and is followed by at
+        // least end - last readable bytes.
+        uint32_t ParseValue(const char *first, const char *last, const char *end)
+        {
+            while (first != last && IsSpace(*first))
+            {
+                ++first;
+            }
+            while (last != first && IsSpace(last[-1]))
+            {
+                --last;
+            }
+
+            const auto size = last - first;
+            if (size == 0 || size > 8 || end - first < 8)
+            {
+                return ParseDigits(first, last);
+            }
+
+            // Load 8 bytes and check that the first size are all digits.
+            uint64_t bytes;
+            std::memcpy(&bytes, first, sizeof bytes);
+            const int unused = 8 * (8 - static_cast<int>(size));
+            const uint64_t digits = (bytes - 0x3030303030303030) << unused;
+            const uint64_t overflow = (bytes + 0x4646464646464646) << unused;
+            if (((digits | overflow) & 0x8080808080808080) != 0)
+            {
+                return ParseDigits(first, last);
+            }
+
+            // The unused bytes became leading zeros.
+            return ParseEightDigits(digits);
+        }
+
+        // Parses the values ended by commas in [in, end) for as long as
+        // there is room for them in out. A kernel leaves off at a block
+        // it cannot look at whole, and value at the start of the value
+        // after the last comma it found.
+        void ParseScalar(const char *&in, const char *end, const char *&value,
+            uint32_t *&out, const uint32_t *outEnd)
+        {
+            for (; in != end && out != outEnd; ++in)
+            {
+                if (*in == ',')
+                {
+                    *out++ = ParseValue(value, in, end);
+                    value = in + 1;
+                }
+            }
+        }
+
+#ifdef TMX_SIMD_X86
+        // The vector kernels compare a block at a time against ',' and visit
+        // the commas by the bits of the mask.
+
+        __attribute__((target("sse4.1")))
+        void ParseSse41(const char *&in, const char *end, const char *&value,
+            uint32_t *&out, const uint32_t *outEnd)
+        {
+            const __m128i comma = _mm_set1_epi8(',');
+            while (end - in >= 16 && outEnd - out >= 16)
+            {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+                for (auto mask = static_cast<unsigned>(
+                    _mm_movemask_epi8(_mm_cmpeq_epi8(block, comma))); mask; mask &= mask - 1)
+                {
+                    const char *separator = in + __builtin_ctz(mask);
+                    *out++ = ParseValue(value, separator, end);
+                    value = separator + 1;
+                }
+                in += 16;
+            }
+        }
+
+        __attribute__((target("avx2")))
+        void ParseAvx2(const char *&in, const char *end, const char *&value,
+            uint32_t *&out, const uint32_t *outEnd)
+        {
+            const __m256i comma = _mm256_set1_epi8(',');
+            while (end - in >= 32 && outEnd - out >= 32)
+            {
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+                for (auto mask = static_cast<unsigned>(
+                    _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, comma))); mask; mask &= mask - 1)
+                {
+                    const char *separator = in + __builtin_ctz(mask);
+                    *out++ = ParseValue(value, separator, end);
+                    value = separator + 1;
+                }
+                in += 32;
+            }
+        }
+#endif
+
+        template <typename Kernel>
+        size_t Parse(std::string_view text, uint32_t *out, size_t outSize, Kernel kernel)
+        {
+            if (text.empty() || outSize == 0)
+            {
+                return 0;
+            }
+
+            const char *in = text.data();
+            const char *end = in + text.size();
+            const char *value = in;
+            uint32_t *const begin = out;
+            const uint32_t *const outEnd = out + outSize;
+
+            kernel(in, end, value, out, outEnd);
+            ParseScalar(in, end, value, out, outEnd);
+
+            // The last value has no comma after it.
+            if (in == end && out != outEnd)
+            {
+                *out++ = ParseValue(value, end, end);
+            }
+
+            return static_cast<size_t>(out - begin);
+        }
+    }
+
+    size_t Util::ParseCsv(std::string_view text, uint32_t *out, size_t outSize)
+    {
+        return ParseCsv(text, out, outSize, GetSimdLevel());
+    }
+
+    size_t Util::ParseCsv(std::string_view text, uint32_t *out, size_t outSize, SimdLevel level)
+    {
+        switch (std::min(level, GetSimdLevel()))
+        {
+#ifdef TMX_SIMD_X86
+        case SimdLevel::AVX2:
+            return Parse(text, out, outSize, ParseAvx2);
+        case SimdLevel::SSE41:
+            return Parse(text, out, outSize, ParseSse41);
+#endif
+        default:
+            return Parse(text, out, outSize, ParseScalar);
+        }
+    }
+}
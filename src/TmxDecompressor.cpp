@@ -0,0 +1,225 @@
+//-----------------------------------------------------------------------------
+// TmxDecompressor.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include "TmxDecompressor.h"
+
+#include <memory>
+#include <span>
+
+#ifdef USE_MINIZ
+#define MINIZ_HEADER_FILE_ONLY
+#include "miniz.c"
+#else
+#include <zlib.h>
+#endif
+
+#ifdef TMX_HAVE_LIBDEFLATE
+#include <libdeflate.h>
+#endif
+
+#ifdef TMX_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace Tmx
+{
+#ifdef TMX_HAVE_ZLIB_NG
+    // In TmxDecompressorZlibNg.cpp, as zlib-ng.h cannot be included beside zlib.h.
+    const Decompressor &GetZlibNgDecompressor();
+#endif
+
+    namespace
+    {
+        //---------------------------------------------------------------------
+        // zlib, or miniz with USE_MINIZ, which has the same interface.
+        //---------------------------------------------------------------------
+        class ZlibDecompressor : public Decompressor
+        {
+        public:
+            const char *GetName() const override
+            {
+#ifdef USE_MINIZ
+                return "miniz";
+#else
+                return "zlib";
+#endif
+            }
+
+            std::ptrdiff_t DecompressZlib(const void *data, size_t size,
+                void *out, size_t outSize) const override
+            {
+                uLongf outLen = static_cast<uLongf>(outSize);
+                const int ret = uncompress(static_cast<Bytef *>(out), &outLen,
+                    static_cast<const Bytef *>(data), static_cast<uLong>(size));
+                return ret == Z_OK ? static_cast<std::ptrdiff_t>(outLen) : -1;
+            }
+
+            std::ptrdiff_t DecompressGzip(const void *data, size_t size,
+                void *out, size_t outSize) const override
+            {
+                z_stream strm{};
+                strm.next_in = static_cast<Bytef *>(const_cast<void *>(data));
+                strm.avail_in = static_cast<uInt>(size);
+                strm.next_out = static_cast<Bytef *>(out);
+                strm.avail_out = static_cast<uInt>(outSize);
+
+                // 32 has the header detected, so zlib data is taken as well.
+                if (inflateInit2(&strm, 15 + 32) != Z_OK)
+                {
+                    return -1;
+                }
+
+                const int ret = inflate(&strm, Z_FINISH);
+                const auto written = outSize - strm.avail_out;
+                inflateEnd(&strm);
+
+                return ret == Z_STREAM_END ? static_cast<std::ptrdiff_t>(written) : -1;
+            }
+        };
+
+#ifdef TMX_HAVE_LIBDEFLATE
+        //---------------------------------------------------------------------
+        // libdeflate, which only decompresses whole buffers and is the faster
+        // for it. Its decompressors must not be shared between threads, so
+        // every thread has its own.
+        //---------------------------------------------------------------------
+        class LibdeflateDecompressor : public Decompressor
+        {
+        public:
+            const char *GetName() const override { return "libdeflate"; }
+
+            std::ptrdiff_t DecompressZlib(const void *data, size_t size,
+                void *out, size_t outSize) const override
+            {
+                size_t written = 0;
+                const auto ret = libdeflate_zlib_decompress(Get(), data, size,
+                    out, outSize, &written);
+                return ret == LIBDEFLATE_SUCCESS ? static_cast<std::ptrdiff_t>(written) : -1;
+            }
+
+            std::ptrdiff_t DecompressGzip(const void *data, size_t size,
+                void *out, size_t outSize) const override
+            {
+                size_t written = 0;
+                const auto ret = libdeflate_gzip_decompress(Get(), data, size,
+                    out, outSize, &written);
+                return ret == LIBDEFLATE_SUCCESS ? static_cast<std::ptrdiff_t>(written) : -1;
+            }
+
+        private:
+            static libdeflate_decompressor *Get()
+            {
+                thread_local const std::unique_ptr<libdeflate_decompressor,
+                    decltype(&libdeflate_free_decompressor)> decompressor{
+                        libdeflate_alloc_decompressor(), &libdeflate_free_decompressor };
+                return decompressor.get();
+            }
+        };
+#endif
+
+
+        // The backends built in, the default one first.
+        std::span<const Decompressor *const> GetBuiltIn()
+        {
+#ifdef TMX_HAVE_LIBDEFLATE
+            static const LibdeflateDecompressor libdeflate;
+#endif
+            static const ZlibDecompressor zlib;
+
+            static const Decompressor *const backends[]{
+#ifdef TMX_HAVE_LIBDEFLATE
+                &libdeflate,
+#endif
+#ifdef TMX_HAVE_ZLIB_NG
+                &GetZlibNgDecompressor(),
+#endif
+                &zlib };
+            return backends;
+        }
+    }
+
+    std::ptrdiff_t Decompressor::DecompressZstd(const void *data, size_t size,
+        void *out, size_t outSize) const
+    {
+#ifdef TMX_HAVE_ZSTD
+        // Contexts keep their tables between calls, but are not to be shared
+        // between threads.
+        thread_local const std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context{
+            ZSTD_createDCtx(), &ZSTD_freeDCtx };
+
+        const size_t written = ZSTD_decompressDCtx(context.get(), out, outSize, data, size);
+        return ZSTD_isError(written) ? -1 : static_cast<std::ptrdiff_t>(written);
+#else
+        (void)data;
+        (void)size;
+        (void)out;
+        (void)outSize;
+        return -1;
+#endif
+    }
+
+    bool Decompressor::CanDecompressZstd() const
+    {
+        return HasZstd();
+    }
+
+    bool Decompressor::HasZstd()
+    {
+#ifdef TMX_HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    const Decompressor &Decompressor::GetDefault()
+    {
+        return *GetBuiltIn().front();
+    }
+
+    const Decompressor *Decompressor::Find(std::string_view name)
+    {
+        for (const auto backend : GetBuiltIn())
+        {
+            if (name == backend->GetName())
+            {
+                return backend;
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::vector<std::string_view> Decompressor::GetNames()
+    {
+        std::vector<std::string_view> names;
+        for (const auto backend : GetBuiltIn())
+        {
+            names.push_back(backend->GetName());
+        }
+
+        return names;
+    }
+}
@@ -0,0 +1,82 @@
+//-----------------------------------------------------------------------------
+// TmxDecompressorZlibNg.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include "TmxDecompressor.h"
+
+#include <cstdint>
+
+#include <zlib-ng.h>
+
+namespace Tmx
+{
+    namespace
+    {
+        //---------------------------------------------------------------------
+        // zlib-ng through its own interface, so that it can be linked beside
+        // zlib.
+        //---------------------------------------------------------------------
+        class ZlibNgDecompressor : public Decompressor
+        {
+        public:
+            const char *GetName() const override { return "zlib-ng"; }
+
+            std::ptrdiff_t DecompressZlib(const void *data, size_t size,
+                void *out, size_t outSize) const override
+            {
+                size_t outLen = outSize;
+                const auto ret = zng_uncompress(static_cast<uint8_t *>(out), &outLen,
+                    static_cast<const uint8_t *>(data), size);
+                return ret == Z_OK ? static_cast<std::ptrdiff_t>(outLen) : -1;
+            }
+
+            std::ptrdiff_t DecompressGzip(const void *data, size_t size,
+                void *out, size_t outSize) const override
+            {
+                zng_stream strm{};
+                strm.next_in = static_cast<const uint8_t *>(data);
+                strm.avail_in = static_cast<uint32_t>(size);
+                strm.next_out = static_cast<uint8_t *>(out);
+                strm.avail_out = static_cast<uint32_t>(outSize);
+
+                if (zng_inflateInit2(&strm, 15 + 32) != Z_OK)
+                {
+                    return -1;
+                }
+
+                const auto ret = zng_inflate(&strm, Z_FINISH);
+                const auto written = outSize - strm.avail_out;
+                zng_inflateEnd(&strm);
+
+                return ret == Z_STREAM_END ? static_cast<std::ptrdiff_t>(written) : -1;
+            }
+        };
+    }
+
+    const Decompressor &GetZlibNgDecompressor()
+    {
+        static const ZlibNgDecompressor zlibNg;
+        return zlibNg;
+    }
+}
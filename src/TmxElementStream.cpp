@@ -0,0 +1,225 @@
+//-----------------------------------------------------------------------------
+// TmxElementStream.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+
+#include "TmxElementStream.h"
+
+namespace Tmx
+{
+    namespace
+    {
+        bool StartsWith(std::string_view text, std::size_t pos, std::string_view prefix)
+        {
+            return text.compare(pos, prefix.size(), prefix) == 0;
+        }
+    }
+
+    ElementStream::ElementStream(std::string_view text)
+        : text{ text }
+    {
+        for (;;)
+        {
+            const auto start = this->text.find('<', pos);
+            if (start == std::string_view::npos)
+            {
+                Fail("no root element");
+                return;
+            }
+
+            if (const auto next = SkipMarkup(start))
+            {
+                if (next == std::string_view::npos)
+                {
+                    return;
+                }
+
+                pos = next;
+                continue;
+            }
+
+            if (StartsWith(this->text, start, "</"))
+            {
+                Fail("unexpected end tag before the root element");
+                return;
+            }
+
+            const auto end = FindTagEnd(start);
+            if (end == std::string_view::npos)
+            {
+                return;
+            }
+
+            const auto tag = this->text.substr(start, end - start + 1);
+            done = tag[tag.size() - 2] == '/';
+            root = done
+                ? std::string{ tag }
+                : std::string{ tag.substr(0, tag.size() - 1) } + "/>";
+
+            pos = end + 1;
+            return;
+        }
+    }
+
+    bool ElementStream::Next(std::string_view *element)
+    {
+        if (done || HasError())
+        {
+            return false;
+        }
+
+        std::size_t depth = 0;
+        std::size_t first = 0;
+
+        for (;;)
+        {
+            const auto start = text.find('<', pos);
+            if (start == std::string_view::npos)
+            {
+                return Fail("the root element is not closed");
+            }
+
+            if (const auto next = SkipMarkup(start))
+            {
+                if (next == std::string_view::npos)
+                {
+                    return false;
+                }
+
+                pos = next;
+                continue;
+            }
+
+            const auto end = FindTagEnd(start);
+            if (end == std::string_view::npos)
+            {
+                return false;
+            }
+
+            pos = end + 1;
+
+            if (StartsWith(text, start, "</"))
+            {
+                if (depth == 0)
+                {
+                    // The end tag of the root element.
+                    done = true;
+                    return false;
+                }
+
+                if (--depth == 0)
+                {
+                    *element = text.substr(first, pos - first);
+                    return true;
+                }
+            }
+            else
+            {
+                if (depth == 0)
+                {
+                    first = start;
+                }
+
+                if (text[end - 1] != '/')
+                {
+                    ++depth;
+                }
+                else if (depth == 0)
+                {
+                    *element = text.substr(first, pos - first);
+                    return true;
+                }
+            }
+        }
+    }
+
+    // Returns the position after a comment, declaration, processing
+    // instruction or CDATA section at start, 0 if there is none there, or
+    // npos if it is not terminated.
+    std::size_t ElementStream::SkipMarkup(std::size_t start)
+    {
+        struct Markup
+        {
+            std::string_view open;
+            std::string_view close;
+        };
+
+        // Longest openings first, "<!" also covers DOCTYPE declarations.
+        static constexpr Markup markups[] = {
+            { "<![CDATA[", "]]>" },
+            { "<!--", "-->" },
+            { "<?", "?>" },
+            { "<!", ">" },
+        };
+
+        for (const auto &markup : markups)
+        {
+            if (StartsWith(text, start, markup.open))
+            {
+                const auto end = text.find(markup.close, start + markup.open.size());
+                if (end == std::string_view::npos)
+                {
+                    Fail("unterminated markup");
+                    return std::string_view::npos;
+                }
+
+                return end + markup.close.size();
+            }
+        }
+
+        return 0;
+    }
+
+    // Returns the position of the '>' closing the tag at start, skipping
+    // quoted attribute values, or npos if there is none.
+    std::size_t ElementStream::FindTagEnd(std::size_t start)
+    {
+        char quote = 0;
+        for (auto i = start + 1; i < text.size(); ++i)
+        {
+            const auto c = text[i];
+            if (quote)
+            {
+                quote = c == quote ? 0 : quote;
+            }
+            else if (c == '"' || c == '\'')
+            {
+                quote = c;
+            }
+            else if (c == '>')
+            {
+                return i;
+            }
+        }
+
+        Fail("unterminated tag");
+        return std::string_view::npos;
+    }
+
+    bool ElementStream::Fail(std::string errorText)
+    {
+        error_text = std::move(errorText);
+        return false;
+    }
+}
@@ -25,7 +25,9 @@
 #include "TmxGroupLayer.h"
 
 #include "TmxImageLayer.h"
+#include "TmxJsonReader.h"
 #include "TmxLayer.h"
+#include "TmxMap.h"
 #include "TmxObjectGroup.h"
 #include "TmxTileLayer.h"
 
@@ -42,8 +44,14 @@ namespace Tmx
         , offsetY{ data->IntAttribute("offsety") }
     {
         // Parse the group.
+        const auto &options = map->GetParseOptions();
         for (auto child = data->FirstChildElement(); child; child = child->NextSiblingElement())
         {
+            if (!options.IncludesLayer(child))
+            {
+                continue;
+            }
+
             if (strncmp(child->Value(), "group", 5) == 0)
             {
                 children.push_back(std::make_unique<GroupLayer>(map, child));
@@ -63,6 +71,48 @@ namespace Tmx
         }
     }
 
+    GroupLayer::GroupLayer(Tmx::Map *_map, JsonReader &json)
+        : Layer{ _map, nullptr, 0, 0, TMX_LAYERTYPE_GROUP_LAYER }
+        , offsetX{ 0 }
+        , offsetY{ 0 }
+    {
+        json.ReadObject([&](const auto key) {
+            if (key == "layers") {
+                json.ReadArray([&] {
+                    // The type comes late in a layer written by Tiled.
+                    const auto type = json.FindString("type");
+                    if (!map->GetParseOptions().IncludesLayer(json, type)) {
+                        return;
+                    }
+
+                    if (type == "group") {
+                        children.push_back(std::make_unique<GroupLayer>(map, json));
+                    }
+                    else if (type == "tilelayer") {
+                        children.push_back(std::make_unique<TileLayer>(map, json));
+                    }
+                    else if (type == "objectgroup") {
+                        children.push_back(std::make_unique<ObjectGroup>(map, json));
+                    }
+                    else if (type == "imagelayer") {
+                        children.push_back(std::make_unique<ImageLayer>(map, json));
+                    }
+                });
+            }
+            else if (key == "offsetx") {
+                Layer::offsetX = json.ReadFloat();
+                offsetX = static_cast<int>(Layer::offsetX);
+            }
+            else if (key == "offsety") {
+                Layer::offsetY = json.ReadFloat();
+                offsetY = static_cast<int>(Layer::offsetY);
+            }
+            else {
+                ParseJsonMember(key, json);
+            }
+        });
+    }
+
     Tmx::Layer* GroupLayer::GetChild(const int index) const
     {
         return children.at(index).get();
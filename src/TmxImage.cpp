@@ -46,4 +46,12 @@ namespace Tmx
         , transparent_color{ ParseColor(imageElement) }
     {
     }
+
+    Image::Image(std::string source, int width, int height, Tmx::Color transparentColor)
+        : source{ std::move(source) }
+        , width{ width }
+        , height{ height }
+        , transparent_color{ transparentColor }
+    {
+    }
 }
@@ -24,6 +24,8 @@
 
 #include "TmxImageLayer.h"
 
+#include "TmxJsonReader.h"
+
 namespace Tmx
 {
     namespace
@@ -40,4 +42,37 @@ namespace Tmx
         , image{ ParseImage(data->FirstChildElement("image")) }
     {
     }
+
+    ImageLayer::ImageLayer(Tmx::Map *_map, JsonReader &json)
+        : Layer{ _map, nullptr, 0, 0, TMX_LAYERTYPE_IMAGE_LAYER }
+    {
+        std::string source;
+        int imageWidth = 0;
+        int imageHeight = 0;
+        Tmx::Color transparentColor;
+
+        json.ReadObject([&](const auto key) {
+            if (key == "image") {
+                source = json.ReadString();
+            }
+            else if (key == "imagewidth") {
+                imageWidth = json.ReadInt();
+            }
+            else if (key == "imageheight") {
+                imageHeight = json.ReadInt();
+            }
+            else if (key == "transparentcolor") {
+                transparentColor = Tmx::Color{ json.ReadString() };
+            }
+            else {
+                ParseJsonMember(key, json);
+            }
+        });
+
+        if (!source.empty())
+        {
+            image = std::make_unique<Image>(std::move(source), imageWidth, imageHeight,
+                transparentColor);
+        }
+    }
 }
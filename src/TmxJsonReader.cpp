@@ -0,0 +1,607 @@
+//-----------------------------------------------------------------------------
+// TmxJsonReader.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include "TmxJsonReader.h"
+
+#include <charconv>
+#include <cstdint>
+
+namespace Tmx
+{
+    namespace
+    {
+        bool IsDigit(char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        int HexValue(char c)
+        {
+            return
+                c >= '0' && c <= '9' ? c - '0' :
+                c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+                c >= 'A' && c <= 'F' ? c - 'A' + 10
+                                     : -1;
+        }
+
+        void AppendUtf8(std::string *out, std::uint32_t cp)
+        {
+            if (cp < 0x80)
+            {
+                *out += static_cast<char>(cp);
+            }
+            else if (cp < 0x800)
+            {
+                *out += static_cast<char>(0xc0 | cp >> 6);
+                *out += static_cast<char>(0x80 | (cp & 0x3f));
+            }
+            else if (cp < 0x10000)
+            {
+                *out += static_cast<char>(0xe0 | cp >> 12);
+                *out += static_cast<char>(0x80 | (cp >> 6 & 0x3f));
+                *out += static_cast<char>(0x80 | (cp & 0x3f));
+            }
+            else
+            {
+                *out += static_cast<char>(0xf0 | cp >> 18);
+                *out += static_cast<char>(0x80 | (cp >> 12 & 0x3f));
+                *out += static_cast<char>(0x80 | (cp >> 6 & 0x3f));
+                *out += static_cast<char>(0x80 | (cp & 0x3f));
+            }
+        }
+    }
+
+    JsonReader::JsonReader(std::string_view text)
+        : text{ text }
+    {
+    }
+
+    JsonType JsonReader::Peek()
+    {
+        SkipWhitespace();
+        if (pos == text.size())
+        {
+            return TMX_JSON_INVALID;
+        }
+
+        const char c = text[pos];
+        return
+            c == '{'              ? TMX_JSON_OBJECT :
+            c == '['              ? TMX_JSON_ARRAY :
+            c == '"'              ? TMX_JSON_STRING :
+            c == 't' || c == 'f'  ? TMX_JSON_BOOL :
+            c == 'n'              ? TMX_JSON_NULL :
+            c == '-' || IsDigit(c) ? TMX_JSON_NUMBER
+                                   : TMX_JSON_INVALID;
+    }
+
+    std::string JsonReader::ReadString()
+    {
+        std::string result;
+        const auto type = Peek();
+        if (type == TMX_JSON_NULL)
+        {
+            Skip();
+        }
+        else if (type != TMX_JSON_STRING)
+        {
+            Fail("expected a string");
+        }
+        else
+        {
+            ScanString(&result);
+        }
+
+        return result;
+    }
+
+    bool JsonReader::ReadBool()
+    {
+        SkipWhitespace();
+        const auto rest = text.substr(pos);
+        if (rest.starts_with("true"))
+        {
+            pos += 4;
+            return true;
+        }
+
+        if (rest.starts_with("false"))
+        {
+            pos += 5;
+        }
+        else
+        {
+            Fail("expected a bool");
+        }
+
+        return false;
+    }
+
+    double JsonReader::ReadDouble()
+    {
+        double value = 0.0;
+        if (Peek() != TMX_JSON_NUMBER)
+        {
+            Fail("expected a number");
+            return value;
+        }
+
+        ScanNumber(&value);
+        return value;
+    }
+
+    int JsonReader::ReadInt()
+    {
+        SkipWhitespace();
+        const auto start = pos;
+        const bool negative = pos < text.size() && text[pos] == '-';
+        pos += negative;
+
+        unsigned value;
+        if (!ScanDigits(&value))
+        {
+            pos = start;
+            return static_cast<int>(ReadDouble());
+        }
+
+        return negative ? -static_cast<int>(value) : static_cast<int>(value);
+    }
+
+    unsigned JsonReader::ReadUnsigned()
+    {
+        SkipWhitespace();
+
+        unsigned value;
+        return ScanDigits(&value) ? value : static_cast<unsigned>(ReadDouble());
+    }
+
+    std::string_view JsonReader::ReadRaw()
+    {
+        const auto type = Peek();
+        const auto start = pos;
+
+        switch (type)
+        {
+        case TMX_JSON_STRING:
+            ScanString(nullptr);
+            break;
+
+        case TMX_JSON_NUMBER:
+            ScanNumber(nullptr);
+            break;
+
+        case TMX_JSON_BOOL:
+            ReadBool();
+            break;
+
+        case TMX_JSON_NULL:
+            if (text.substr(pos).starts_with("null"))
+            {
+                pos += 4;
+            }
+            else
+            {
+                Fail("expected null");
+            }
+            break;
+
+        case TMX_JSON_OBJECT:
+        case TMX_JSON_ARRAY:
+        {
+            // Only the nesting is checked, the contents are someone else's.
+            int depth = 0;
+            do
+            {
+                switch (text[pos])
+                {
+                case '"':
+                    if (!ScanString(nullptr))
+                    {
+                        return {};
+                    }
+                    continue;
+
+                case '{':
+                case '[':
+                    ++depth;
+                    break;
+
+                case '}':
+                case ']':
+                    --depth;
+                    break;
+                }
+
+                ++pos;
+            }
+            while (depth > 0 && pos < text.size());
+
+            if (depth > 0)
+            {
+                Fail("unterminated value");
+            }
+            break;
+        }
+
+        case TMX_JSON_INVALID:
+            Fail("expected a value");
+            break;
+        }
+
+        return HasError() ? std::string_view{} : text.substr(start, pos - start);
+    }
+
+    std::string JsonReader::FindString(std::string_view key)
+    {
+        const auto start = pos;
+        std::string result;
+
+        if (Peek() == TMX_JSON_OBJECT && BeginObject())
+        {
+            std::string_view k;
+            for (bool first = true; NextMember(&k, first); first = false)
+            {
+                if (k == key)
+                {
+                    if (Peek() == TMX_JSON_STRING)
+                    {
+                        result = ReadString();
+                    }
+                    break;
+                }
+
+                Skip();
+            }
+        }
+
+        if (!HasError())
+        {
+            pos = start;
+        }
+
+        return result;
+    }
+
+    std::size_t JsonReader::Tell()
+    {
+        SkipWhitespace();
+        return pos;
+    }
+
+    void JsonReader::Seek(std::size_t position)
+    {
+        // An error ends the reading for good.
+        if (!HasError())
+        {
+            pos = position;
+        }
+    }
+
+    bool JsonReader::AtEnd()
+    {
+        SkipWhitespace();
+        return pos == text.size();
+    }
+
+    bool JsonReader::BeginObject()
+    {
+        if (Peek() != TMX_JSON_OBJECT)
+        {
+            Fail("expected an object");
+            return false;
+        }
+
+        ++pos;
+        return true;
+    }
+
+    bool JsonReader::NextMember(std::string_view *key, bool first)
+    {
+        SkipWhitespace();
+        if (pos == text.size())
+        {
+            Fail("unterminated object");
+            return false;
+        }
+
+        if (text[pos] == '}')
+        {
+            ++pos;
+            return false;
+        }
+
+        if (!first && !Expect(','))
+        {
+            return false;
+        }
+
+        SkipWhitespace();
+        if (pos == text.size() || text[pos] != '"')
+        {
+            Fail("expected a key");
+            return false;
+        }
+
+        // Keys are taken from the text unless they hold escapes.
+        const auto end = text.find_first_of("\"\\", pos + 1);
+        if (end != std::string_view::npos && text[end] == '"')
+        {
+            *key = text.substr(pos + 1, end - pos - 1);
+            pos = end + 1;
+        }
+        else
+        {
+            key_storage.clear();
+            if (!ScanString(&key_storage))
+            {
+                return false;
+            }
+            *key = key_storage;
+        }
+
+        SkipWhitespace();
+        return Expect(':');
+    }
+
+    bool JsonReader::BeginArray()
+    {
+        if (Peek() != TMX_JSON_ARRAY)
+        {
+            Fail("expected an array");
+            return false;
+        }
+
+        ++pos;
+        return true;
+    }
+
+    bool JsonReader::NextElement(bool first)
+    {
+        SkipWhitespace();
+        if (pos == text.size())
+        {
+            Fail("unterminated array");
+            return false;
+        }
+
+        if (text[pos] == ']')
+        {
+            ++pos;
+            return false;
+        }
+
+        return first || Expect(',');
+    }
+
+    bool JsonReader::ScanDigits(unsigned *out)
+    {
+        // Plain integers are read in place, anything else goes through
+        // ScanNumber.
+        const auto start = pos;
+
+        std::uint64_t value = 0;
+        while (pos < text.size() && IsDigit(text[pos]) && pos - start < 18)
+        {
+            value = value * 10 + (text[pos++] - '0');
+        }
+
+        if (pos == start || (pos < text.size()
+            && (IsDigit(text[pos]) || text[pos] == '.' || text[pos] == 'e' || text[pos] == 'E')))
+        {
+            pos = start;
+            return false;
+        }
+
+        *out = static_cast<unsigned>(value);
+        return true;
+    }
+
+    void JsonReader::SkipWhitespace()
+    {
+        while (pos < text.size()
+            && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t'))
+        {
+            ++pos;
+        }
+    }
+
+    bool JsonReader::Expect(char c)
+    {
+        SkipWhitespace();
+        if (pos == text.size() || text[pos] != c)
+        {
+            Fail((std::string{ "expected '" } + c + "'").c_str());
+            return false;
+        }
+
+        ++pos;
+        return true;
+    }
+
+    bool JsonReader::ScanString(std::string *out)
+    {
+        // At the opening quote.
+        ++pos;
+
+        // Two memchr-like searches beat a search for either character on
+        // long strings such as base64 layers. The quote found is kept until
+        // the escapes before it have been resolved.
+        auto quote = std::string_view::npos;
+        while (pos < text.size())
+        {
+            if (quote == std::string_view::npos || quote < pos)
+            {
+                quote = text.find('"', pos);
+            }
+            if (quote == std::string_view::npos)
+            {
+                break;
+            }
+
+            const auto escape = text.substr(pos, quote - pos).find('\\');
+            const auto end = escape == std::string_view::npos ? quote : pos + escape;
+
+            if (out)
+            {
+                out->append(text.data() + pos, end - pos);
+            }
+            pos = end + 1;
+
+            if (text[end] == '"')
+            {
+                return true;
+            }
+
+            if (pos == text.size())
+            {
+                break;
+            }
+
+            const char e = text[pos++];
+            if (e == 'u')
+            {
+                std::uint32_t cp = 0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    const auto v = pos < text.size() ? HexValue(text[pos++]) : -1;
+                    if (v < 0)
+                    {
+                        Fail("bad unicode escape");
+                        return false;
+                    }
+                    cp = cp << 4 | v;
+                }
+
+                // A surrogate pair makes a single code point.
+                if (cp >= 0xd800 && cp < 0xdc00 && text.substr(pos).starts_with("\\u"))
+                {
+                    std::uint32_t low = 0;
+                    bool valid = true;
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        const auto v = pos + 2 + i < text.size() ? HexValue(text[pos + 2 + i]) : -1;
+                        valid = valid && v >= 0;
+                        low = low << 4 | (v & 0xf);
+                    }
+
+                    if (valid && low >= 0xdc00 && low < 0xe000)
+                    {
+                        cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                        pos += 6;
+                    }
+                }
+
+                if (out)
+                {
+                    AppendUtf8(out, cp);
+                }
+                continue;
+            }
+
+            const char c =
+                e == '"'  ? '"' :
+                e == '\\' ? '\\' :
+                e == '/'  ? '/' :
+                e == 'b'  ? '\b' :
+                e == 'f'  ? '\f' :
+                e == 'n'  ? '\n' :
+                e == 'r'  ? '\r' :
+                e == 't'  ? '\t'
+                          : '\0';
+            if (c == '\0')
+            {
+                Fail("bad escape");
+                return false;
+            }
+
+            if (out)
+            {
+                *out += c;
+            }
+        }
+
+        Fail("unterminated string");
+        return false;
+    }
+
+    bool JsonReader::ScanNumber(double *out)
+    {
+        const auto start = pos;
+
+        pos += pos < text.size() && text[pos] == '-';
+        const auto digits = pos;
+        while (pos < text.size() && IsDigit(text[pos]))
+        {
+            ++pos;
+        }
+
+        bool valid = pos > digits;
+        if (pos < text.size() && text[pos] == '.')
+        {
+            const auto fraction = ++pos;
+            while (pos < text.size() && IsDigit(text[pos]))
+            {
+                ++pos;
+            }
+            valid = valid && pos > fraction;
+        }
+
+        if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E'))
+        {
+            ++pos;
+            pos += pos < text.size() && (text[pos] == '+' || text[pos] == '-');
+            const auto exponent = pos;
+            while (pos < text.size() && IsDigit(text[pos]))
+            {
+                ++pos;
+            }
+            valid = valid && pos > exponent;
+        }
+
+        if (!valid)
+        {
+            Fail("bad number");
+            return false;
+        }
+
+        if (out)
+        {
+            std::from_chars(text.data() + start, text.data() + pos, *out);
+        }
+
+        return true;
+    }
+
+    void JsonReader::Fail(const char *what)
+    {
+        if (error_text.empty())
+        {
+            error_text = std::string{ "json: " } + what + " at offset " + std::to_string(pos);
+        }
+
+        // Stop every read that follows.
+        pos = text.size();
+    }
+}
@@ -33,18 +33,11 @@
 #include <zlib.h>
 #endif
 
+#include "TmxJsonReader.h"
 #include "TmxMap.h"
 #include "TmxTileset.h"
 #include "TmxUtil.h"
 
-namespace
-{
-    // Avoid nextParseOrder to be included in the documentation as it is an implementation detail that should not be considered as a part of the API.
-    /// @cond INTERNAL
-    int nextParseOrder = 0;
-    /// @endcond
-}
-
 namespace Tmx
 {
     namespace
@@ -108,8 +101,8 @@ namespace Tmx
         , height(_height)
         , opacity(GetFloatAttribute(data, "opacity", 1.0f))
         , visible(GetBoolAttribute(data, "visible", true))
-        , zOrder(nextParseOrder)
-        , parseOrder(nextParseOrder)
+        , zOrder(_map ? _map->TakeParseOrder() : 0)
+        , parseOrder(zOrder)
         , parallaxX{ GetFloatAttribute(data, "parallaxx", 1.0f) }
         , parallaxY{ GetFloatAttribute(data, "parallaxy", 1.0f) }
         , offsetX{ GetFloatAttribute(data, "offsetx", 1.0f) }
@@ -118,6 +111,73 @@ namespace Tmx
         , properties(data->FirstChildElement("properties"))
         , tintColor(GetColorAttribute(data, "tintcolor"))
     {
-        ++nextParseOrder;
+    }
+
+    Layer::Layer(Tmx::Map *_map, const Tmx::Tile *_tile, int _width, int _height,
+        LayerType _layerType)
+        : map(_map)
+        , tile(_tile)
+        , x(0)
+        , y(0)
+        , width(_width)
+        , height(_height)
+        , opacity(1.0f)
+        , visible(true)
+        , zOrder(_map ? _map->TakeParseOrder() : 0)
+        , parseOrder(zOrder)
+        , parallaxX{ 1.0f }
+        , parallaxY{ 1.0f }
+        , offsetX{ 1.0f }
+        , offsetY{ 1.0f }
+        , layerType(_layerType)
+        , properties(nullptr)
+    {
+    }
+
+    void Layer::TakeNextParseOrder()
+    {
+        zOrder = parseOrder = map ? map->TakeParseOrder() : 0;
+    }
+
+    bool Layer::ParseJsonMember(std::string_view key, JsonReader &json)
+    {
+        if (key == "name") {
+            name = json.ReadString();
+        }
+        else if (key == "x") {
+            x = json.ReadInt();
+        }
+        else if (key == "y") {
+            y = json.ReadInt();
+        }
+        else if (key == "opacity") {
+            opacity = json.ReadFloat();
+        }
+        else if (key == "visible") {
+            visible = json.ReadBool();
+        }
+        else if (key == "parallaxx") {
+            parallaxX = json.ReadFloat();
+        }
+        else if (key == "parallaxy") {
+            parallaxY = json.ReadFloat();
+        }
+        else if (key == "offsetx") {
+            offsetX = json.ReadFloat();
+        }
+        else if (key == "offsety") {
+            offsetY = json.ReadFloat();
+        }
+        else if (key == "properties") {
+            properties = PropertySet{ json };
+        }
+        else if (key == "tintcolor") {
+            tintColor = Color{ json.ReadString() };
+        }
+        else {
+            return false;
+        }
+
+        return true;
     }
 }
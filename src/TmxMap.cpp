@@ -29,13 +29,27 @@
 #include "TmxMap.h"
 
 #include <cassert>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 #include <tinyxml2.h>
 
+#include "TmxDecompressor.h"
+#include "TmxElementStream.h"
 #include "TmxGroupLayer.h"
 #include "TmxImageLayer.h"
+#include "TmxJsonReader.h"
 #include "TmxLayer.h"
+#include "TmxMapChangeSet.h"
+#include "TmxMapLoader.h"
+#include "TmxMappedFile.h"
 #include "TmxObjectGroup.h"
+#include "TmxThreadPool.h"
 #include "TmxTileLayer.h"
 #include "TmxTileset.h"
 #include "TmxUtil.h"
@@ -44,6 +58,48 @@ namespace Tmx
 {
     namespace
     {
+        // The token of the parse running on this thread. It is only checked
+        // between the phases of a parse, so it is not handed down through
+        // every constructor.
+        thread_local const CancellationToken *currentToken = nullptr;
+
+        bool IsCancelled()
+        {
+            return currentToken && currentToken->IsCancelled();
+        }
+
+        // Makes a token the one checked by the parse running on this thread.
+        class TokenScope
+        {
+        public:
+            explicit TokenScope(const CancellationToken &token)
+                : previous{ std::exchange(currentToken, &token) }
+            {}
+
+            ~TokenScope() { currentToken = previous; }
+
+            TokenScope(const TokenScope &) = delete;
+            TokenScope &operator=(const TokenScope &) = delete;
+
+        private:
+            const CancellationToken *previous;
+        };
+
+        // The options of a parse with the given loader.
+        const ParseOptions &GetOptions(const MapLoader *loader)
+        {
+            static const ParseOptions defaults;
+            return loader ? loader->GetOptions() : defaults;
+        }
+
+        // The arena of a map parsed with the given options, if it has one.
+        std::shared_ptr<std::pmr::memory_resource> MakeArena(const ParseOptions &options)
+        {
+            return options.arena && !options.memoryResource
+                ? std::make_shared<std::pmr::monotonic_buffer_resource>()
+                : nullptr;
+        }
+
         auto GetFilePath(const std::string &fileName)
         {
             const int lastSlash = fileName.find_last_of("/");
@@ -59,6 +115,189 @@ namespace Tmx
             return doc->FirstChildElement("map");
         }
 
+        // Runs the parses of ParseFileAsync given no executor. Its workers
+        // are joined, the queued parses done, when the program exits.
+        ThreadPool &GetAsyncPool()
+        {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        // Whether maps are read one top-level element at a time.
+        bool ReadsByElement(const MapLoader *loader)
+        {
+            return loader && (loader->GetOptions().streaming || loader->GetOptions().trackChanges);
+        }
+
+        std::string_view GetElementName(std::string_view element)
+        {
+            return element.substr(1, element.find_first_of(" \t\r\n/>", 1) - 1);
+        }
+
+        // Find an attribute in the start tag of an element as written.
+        std::string_view FindAttribute(std::string_view element, std::string_view name)
+        {
+            const auto tag = element.substr(0, element.find('>'));
+            for (auto at = tag.find(name); at != std::string_view::npos; at = tag.find(name, at + 1))
+            {
+                const auto quote = at + name.size() + 1;
+                if (quote < tag.size() && tag[at + name.size()] == '='
+                    && (tag[quote] == '"' || tag[quote] == '\'')
+                    && std::string_view{ " \t\r\n" }.find(tag[at - 1]) != std::string_view::npos)
+                {
+                    const auto end = tag.find(tag[quote], quote + 1);
+                    return end == std::string_view::npos
+                        ? std::string_view{}
+                        : tag.substr(quote + 1, end - quote - 1);
+                }
+            }
+
+            return {};
+        }
+
+        // Splits the encoded text out of the <data> element of a tile layer as
+        // written, so that it is decoded where it is instead of being copied
+        // into a document with the rest of the layer. Layers whose data holds
+        // elements, or text that would need unescaping, are left whole.
+        bool SplitLayerData(std::string_view element, std::string *rest, std::string_view *data)
+        {
+            if (GetElementName(element) != "layer")
+            {
+                return false;
+            }
+
+            auto start = element.find("<data");
+            while (start != std::string_view::npos && start + 5 < element.size()
+                && std::string_view{ " \t\r\n/>" }.find(element[start + 5]) == std::string_view::npos)
+            {
+                start = element.find("<data", start + 1);
+            }
+
+            if (start == std::string_view::npos)
+            {
+                return false;
+            }
+
+            const auto encoding = FindAttribute(element.substr(start), "encoding");
+            const auto open = element.find('>', start);
+            if ((encoding != "csv" && encoding != "base64")
+                || open == std::string_view::npos || element[open - 1] == '/')
+            {
+                return false;
+            }
+
+            const auto close = element.find("</data", open);
+            if (close == std::string_view::npos
+                || element.substr(open + 1, close - open - 1).find_first_of("<&") != std::string_view::npos)
+            {
+                return false;
+            }
+
+            *data = element.substr(open + 1, close - open - 1);
+            rest->assign(element.substr(0, open + 1));
+            rest->append(element.substr(close));
+            return true;
+        }
+
+        // Names the top-level elements of a map, so that they can be found
+        // again in the next version of the file. Layers go by their id and
+        // tilesets by their first gid. Elements the map does not read get no
+        // name.
+        class ElementKeys
+        {
+        public:
+            std::string Get(std::string_view element)
+            {
+                const auto name = std::string{ GetElementName(element) };
+                if (name == "properties")
+                {
+                    return name;
+                }
+
+                if (name == "tileset")
+                {
+                    return name + "@" + std::string{ FindAttribute(element, "firstgid") };
+                }
+
+                if (name != "layer" && name != "imagelayer" && name != "objectgroup"
+                    && name != "group")
+                {
+                    return {};
+                }
+
+                const auto id = FindAttribute(element, "id");
+                return id.empty()
+                    ? name + "@" + std::to_string(unnamed[name]++)
+                    : name + "#" + std::string{ id };
+            }
+
+        private:
+            std::unordered_map<std::string, int> unnamed;
+        };
+
+        std::string_view GetKeyKind(std::string_view key)
+        {
+            return key.substr(0, key.find_first_of("#@"));
+        }
+
+        // Get whether the options leave out an element as written by its
+        // type alone.
+        bool SkipsElementType(const ParseOptions &options, std::string_view element)
+        {
+            const auto name = GetElementName(element);
+            const int type =
+                name == "layer"       ? TMX_LAYERTYPE_TILE
+              : name == "objectgroup" ? TMX_LAYERTYPE_OBJECTGROUP
+              : name == "imagelayer"  ? TMX_LAYERTYPE_IMAGE_LAYER
+              : name == "group"       ? TMX_LAYERTYPE_GROUP_LAYER
+                                      : 0;
+            return (options.skipLayerTypes & type) != 0;
+        }
+
+        // Mixes the modification time of a referenced file into hash, looking
+        // for it next to the map first as the parse does.
+        void HashFileTime(std::size_t &hash, const std::string &path, std::string_view source)
+        {
+            for (const auto &fileName : { path + std::string{ source }, std::string{ source } })
+            {
+                std::error_code error;
+                const auto time = std::filesystem::last_write_time(fileName, error);
+                if (!error)
+                {
+                    const auto ticks = static_cast<long long>(time.time_since_epoch().count());
+                    hash ^= std::hash<long long>{}(ticks) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+                    return;
+                }
+            }
+        }
+
+        // Hash an element as written. A tileset kept in a file of its own
+        // changes with that file as well, and so does an element holding
+        // objects made from templates with the template files.
+        std::size_t HashElement(std::string_view element, const std::string &path)
+        {
+            auto hash = std::hash<std::string_view>{}(element);
+
+            const auto source = FindAttribute(element, "source");
+            if (!source.empty() && GetElementName(element) == "tileset")
+            {
+                HashFileTime(hash, path, source);
+            }
+
+            std::unordered_set<std::string_view> templates;
+            for (auto at = element.find("<object"); at != std::string_view::npos;
+                at = element.find("<object", at + 1))
+            {
+                const auto name = FindAttribute(element.substr(at), "template");
+                if (!name.empty() && templates.insert(name).second)
+                {
+                    HashFileTime(hash, path, name);
+                }
+            }
+
+            return hash;
+        }
+
         auto GetStringAttribute(const tinyxml2::XMLElement *data, const char *attribute)
         {
             if (const auto s = data->Attribute(attribute))
@@ -69,10 +308,15 @@ namespace Tmx
             return std::string_view{};
         }
 
-        auto ParseOrientation(const tinyxml2::XMLElement *data)
+        // Tiled JSON maps are objects, TMX maps start with a '<'.
+        bool IsJsonText(std::string_view text)
         {
-            const auto attribute = GetStringAttribute(data, "orientation");
+            const auto first = text.find_first_not_of(" \t\r\n");
+            return first != std::string_view::npos && text[first] == '{';
+        }
 
+        auto ParseOrientation(std::string_view attribute)
+        {
             return
                 attribute == "orthogonal" ? TMX_MO_ORTHOGONAL :
                 attribute == "isometric"  ? TMX_MO_ISOMETRIC :
@@ -81,10 +325,8 @@ namespace Tmx
                                           : TMX_MO_ORTHOGONAL;
         }
 
-        auto ParseRenderOrder(const tinyxml2::XMLElement *data)
+        auto ParseRenderOrder(std::string_view attribute)
         {
-            const auto attribute = GetStringAttribute(data, "renderorder");
-
             return
                 attribute == "right-down" ? TMX_RIGHT_DOWN :
                 attribute == "right-up"   ? TMX_RIGHT_UP :
@@ -93,20 +335,16 @@ namespace Tmx
                                           : TMX_RIGHT_DOWN;
         }
 
-        auto ParseStaggerAxis(const tinyxml2::XMLElement *data)
+        auto ParseStaggerAxis(std::string_view attribute)
         {
-            const auto attribute = GetStringAttribute(data, "staggeraxis");
-
             return
                 attribute == "x" ? TMX_SA_X :
                 attribute == "y" ? TMX_SA_Y
                                  : TMX_SA_NONE;
         }
 
-        auto ParseStaggerIndex(const tinyxml2::XMLElement *data)
+        auto ParseStaggerIndex(std::string_view attribute)
         {
-            const auto attribute = GetStringAttribute(data, "staggerindex");
-
             return
                 attribute == "even" ? TMX_SI_EVEN :
                 attribute == "odd"  ? TMX_SI_ODD
@@ -116,33 +354,570 @@ namespace Tmx
 
     Map Map::ParseFile(const std::string &fileName)
     {
+        return ParseFile(fileName, nullptr);
+    }
+
+    Map Map::ParseFileMapped(const std::string &fileName)
+    {
+        return ParseFileMapped(fileName, nullptr);
+    }
+
+    Map Map::ParseText(const std::string &text, const std::string &path)
+    {
+        return ParseText(std::string_view{ text.c_str(), text.size() }, path, nullptr);
+    }
+
+    Map Map::ParseText(const char *text, const std::string &path)
+    {
+        return ParseText(std::string_view{ text, strlen(text) }, path, nullptr);
+    }
+
+    Map Map::ParseText(std::string_view text, const std::string &path)
+    {
+        return ParseText(text, path, nullptr);
+    }
+
+    Map Map::ParseFile(const std::string &fileName, MapLoader *loader)
+    {
+        const ParseOptionsDetails::Scope scope{ GetOptions(loader) };
+
+        if (ReadsByElement(loader) || Util::IsJsonFileName(fileName))
+        {
+            return ParseFileMapped(fileName, loader);
+        }
+
         tinyxml2::XMLDocument doc;
         doc.LoadFile(fileName.c_str());
 
         return doc.Error()
             ? Map{ doc.ErrorStr() }
-            : Map{ GetMapElement(&doc), GetFilePath(fileName)};
+            : Map{ GetMapElement(&doc), GetFilePath(fileName), loader };
     }
 
-    Map Map::ParseText(const std::string &text, const std::string &path)
+    Map Map::ParseFileMapped(const std::string &fileName, MapLoader *loader)
     {
-        return ParseText(std::string_view{ text.c_str(), text.size() }, path);
+        const ParseOptionsDetails::Scope scope{ GetOptions(loader) };
+
+        MappedFile file{ fileName };
+        if (!file.IsOpen())
+        {
+            return Map{ TMX_COULDNT_OPEN, "failed to open file '" + fileName + "'" };
+        }
+
+        if (IsJsonText(file.GetView()))
+        {
+            return ParseJson(file.GetView(), GetFilePath(fileName), loader);
+        }
+
+        // Only one element at a time is copied into a document, and the pages
+        // read are let go as the stream moves past them.
+        return ParseStreamed(file.GetView(), GetFilePath(fileName), loader, &file);
     }
 
-    Map Map::ParseText(const char *text, const std::string &path)
+    std::future<Map> Map::ParseFileAsync(const std::string &fileName, CancellationToken token,
+        Executor executor)
+    {
+        if (!executor)
+        {
+            return std::async(std::launch::async, [fileName, token = std::move(token)] {
+                return ParseFile(fileName, nullptr, token);
+            });
+        }
+
+        auto promise = std::make_shared<std::promise<Map>>();
+        auto future = promise->get_future();
+
+        ParseFileAsync(fileName, nullptr,
+            [promise](Map map) { promise->set_value(std::move(map)); },
+            std::move(token), std::move(executor));
+
+        return future;
+    }
+
+    void Map::ParseFileAsync(const std::string &fileName, std::function<void(Map)> onDone,
+        CancellationToken token, Executor executor)
     {
-        return ParseText(std::string_view{ text, strlen(text) }, path);
+        ParseFileAsync(fileName, nullptr, std::move(onDone), std::move(token),
+            std::move(executor));
     }
 
-    Map Map::ParseText(std::string_view text, const std::string &path)
+    void Map::ParseFileAsync(const std::string &fileName, MapLoader *loader,
+        std::function<void(Map)> onDone, CancellationToken token, Executor executor)
+    {
+        auto task = [fileName, loader, onDone = std::move(onDone), token = std::move(token)] {
+            auto map = ParseFile(fileName, loader, token);
+
+            // Nobody is there to catch what onDone throws either.
+            try
+            {
+                onDone(std::move(map));
+            }
+            catch (...)
+            {
+            }
+        };
+
+        if (executor)
+        {
+            executor(std::move(task));
+        }
+        else
+        {
+            GetAsyncPool().Submit(std::move(task));
+        }
+    }
+
+    Map Map::ParseFile(const std::string &fileName, MapLoader *loader,
+        const CancellationToken &token)
+    {
+        const auto cancelled = [&fileName] {
+            return Map{ TMX_CANCELLED, "parsing '" + fileName + "' was cancelled" };
+        };
+
+        if (token.IsCancelled())
+        {
+            return cancelled();
+        }
+
+        // Nobody is there to catch what is thrown on another thread.
+        try
+        {
+            TokenScope scope{ token };
+            auto map = ParseFile(fileName, loader);
+            return token.IsCancelled() ? cancelled() : std::move(map);
+        }
+        catch (const std::exception &e)
+        {
+            return Map{ TMX_PARSING_ERROR, fileName + ": " + e.what() };
+        }
+    }
+
+    Map Map::ParseText(std::string_view text, const std::string &path, MapLoader *loader)
     {
+        const ParseOptionsDetails::Scope scope{ GetOptions(loader) };
+
+        if (IsJsonText(text))
+        {
+            return ParseJson(text, path, loader);
+        }
+
+        if (ReadsByElement(loader))
+        {
+            return ParseStreamed(text, path, loader);
+        }
+
         // Create a tiny xml document and use it to parse the text.
         tinyxml2::XMLDocument doc;
         doc.Parse(text.data(), text.size());
 
         return doc.Error()
             ? Map{ doc.ErrorStr() }
-            : Map{ GetMapElement(&doc), path };
+            : Map{ GetMapElement(&doc), path, loader };
+    }
+
+    Map Map::ParseStreamed(std::string_view text, const std::string &path, MapLoader *loader,
+        MappedFile *file)
+    {
+        ElementStream stream{ text };
+        if (stream.HasError())
+        {
+            return Map{ stream.GetErrorText() };
+        }
+
+        // The map itself is read from its start tag alone, the children follow.
+        tinyxml2::XMLDocument rootDoc;
+        rootDoc.Parse(stream.GetRoot().c_str(), stream.GetRoot().size());
+        if (rootDoc.Error())
+        {
+            return Map{ rootDoc.ErrorStr() };
+        }
+
+        const auto mapElement = GetMapElement(&rootDoc);
+        if (!mapElement)
+        {
+            return Map{ "no map element" };
+        }
+
+        Map map{ mapElement, path, loader };
+        const ParseOptionsDetails::MemoryScope memory{ map.GetMemoryResource() };
+        const ParseOptionsDetails::StringPoolScope interned{ map.strings };
+
+        const bool track = map.options.trackChanges;
+        ElementKeys keys;
+        if (track)
+        {
+            map.root_hash = std::hash<std::string_view>{}(stream.GetRoot());
+        }
+
+        // Tile data whose decoding is deferred points into its document,
+        // so those documents are kept until the map is finished.
+        const bool deferDecode = map.options.decodeThreads != 1 && !map.options.lazyDecode;
+        std::vector<std::unique_ptr<tinyxml2::XMLDocument>> deferred;
+        tinyxml2::XMLDocument reused;
+        std::string layerText;
+
+        std::string_view child;
+        while (!IsCancelled() && stream.Next(&child))
+        {
+            // Keys are taken in document order, left out elements included.
+            auto key = track ? keys.Get(child) : std::string{};
+
+            // Layers left out by their type are not even parsed.
+            if (!SkipsElementType(map.options, child))
+            {
+                auto doc = &reused;
+                if (deferDecode)
+                {
+                    deferred.push_back(std::make_unique<tinyxml2::XMLDocument>());
+                    doc = deferred.back().get();
+                }
+
+                std::string_view data;
+                const auto parsed = SplitLayerData(child, &layerText, &data)
+                    ? std::string_view{ layerText } : child;
+
+                doc->Parse(parsed.data(), parsed.size());
+                if (doc->Error())
+                {
+                    return Map{ doc->ErrorStr() };
+                }
+
+                if (map.options.IncludesLayer(doc->RootElement()))
+                {
+                    if (!key.empty())
+                    {
+                        map.tracked_elements.push_back({ std::move(key), HashElement(child, path) });
+                    }
+
+                    map.ParseChild(doc->RootElement(), loader, data);
+                }
+            }
+
+            // What has been read of a mapped file is not needed anymore.
+            if (file)
+            {
+                file->Discard(child.data() + child.size() - text.data());
+            }
+        }
+
+        if (stream.HasError())
+        {
+            return Map{ stream.GetErrorText() };
+        }
+
+        map.FinishParse(loader);
+        return map;
+    }
+
+    Map Map::ParseJson(std::string_view text, const std::string &path, MapLoader *loader)
+    {
+        JsonReader json{ text };
+        Map map{ json, path, loader };
+
+        if (!json.HasError() && !json.AtEnd())
+        {
+            return Map{ "json: unexpected text after the map" };
+        }
+
+        return json.HasError() ? Map{ json.GetErrorText() } : std::move(map);
+    }
+
+    MapChangeSet Map::ReloadFile(Map &map, const std::string &fileName, MapLoader *loader)
+    {
+        MappedFile file{ fileName };
+        if (!file.IsOpen())
+        {
+            MapChangeSet changes;
+            changes.errorText = "failed to open file '" + fileName + "'";
+            return changes;
+        }
+
+        return Reload(map, file.GetView(), GetFilePath(fileName), loader);
+    }
+
+    MapChangeSet Map::Reload(Map &map, std::string_view text, const std::string &path,
+        MapLoader *loader)
+    {
+        const ParseOptionsDetails::Scope scope{ GetOptions(loader) };
+
+        const auto failed = [](std::string errorText) {
+            MapChangeSet changes;
+            changes.errorText = std::move(errorText);
+            return changes;
+        };
+
+        MapChangeSet changes;
+
+        // Without hashes of the previous version, everything has changed.
+        const bool tracked = !map.tracked_elements.empty();
+        if (!tracked)
+        {
+            changes.mapChanged = true;
+            changes.removedTilesets = static_cast<int>(map.tilesets.size());
+            changes.removedLayers = static_cast<int>(map.layers.size());
+        }
+
+        if (IsJsonText(text))
+        {
+            auto next = ParseJson(text, path, loader);
+            if (next.HasError())
+            {
+                return failed(next.GetErrorText());
+            }
+
+            changes.mapChanged = true;
+            map = std::move(next);
+            for (const auto &tileset : map.tilesets)
+            {
+                changes.tilesets.push_back(&tileset);
+            }
+            changes.layers.assign(map.layers.begin(), map.layers.end());
+            return changes;
+        }
+
+        ElementStream stream{ text };
+        tinyxml2::XMLDocument rootDoc;
+        if (!stream.HasError())
+        {
+            rootDoc.Parse(stream.GetRoot().c_str(), stream.GetRoot().size());
+        }
+
+        const auto mapElement = stream.HasError() || rootDoc.Error()
+            ? nullptr
+            : GetMapElement(&rootDoc);
+        if (!mapElement)
+        {
+            return failed(stream.HasError() ? stream.GetErrorText()
+                : rootDoc.Error() ? rootDoc.ErrorStr() : "no map element");
+        }
+
+        // Where each element of the previous version is kept.
+        struct Previous
+        {
+            std::size_t hash;
+            std::size_t index;
+            bool reused;
+        };
+
+        std::unordered_map<std::string_view, Previous> previous;
+        std::unordered_map<std::string_view, std::size_t> counts;
+        for (const auto &element : map.tracked_elements)
+        {
+            previous.emplace(element.key,
+                Previous{ element.hash, counts[GetKeyKind(element.key)]++, false });
+        }
+
+        const auto previousCount = [&map](std::string_view kind) -> std::size_t {
+            return kind == "tileset"     ? map.tilesets.size()
+                 : kind == "layer"       ? map.tile_layers.size()
+                 : kind == "imagelayer"  ? map.image_layers.size()
+                 : kind == "objectgroup" ? map.object_groups.size()
+                 : kind == "group"       ? map.group_layers.size()
+                                         : 1;
+        };
+
+        // Every element is looked at before any is parsed, as the tiles of
+        // the old layers can only be kept if the tilesets still start at the
+        // same gids.
+        struct Element
+        {
+            std::string_view text;
+            std::string key;
+            std::size_t hash;
+            const Previous *reuse;
+            std::unique_ptr<tinyxml2::XMLDocument> doc;
+            bool excluded;
+        };
+
+        const auto &options = GetOptions(loader);
+        std::vector<Element> elements;
+        std::vector<int> firstGids;
+        ElementKeys keys;
+        std::string_view child;
+        while (stream.Next(&child))
+        {
+            auto key = keys.Get(child);
+            if (key.empty() || SkipsElementType(options, child))
+            {
+                continue;
+            }
+
+            if (GetKeyKind(key) == "tileset")
+            {
+                firstGids.push_back(std::atoi(key.c_str() + key.find('@') + 1));
+            }
+
+            const auto hash = HashElement(child, path);
+            elements.push_back({ child, std::move(key), hash, nullptr, nullptr, false });
+        }
+
+        if (stream.HasError())
+        {
+            return failed(stream.GetErrorText());
+        }
+
+        std::vector<int> previousFirstGids;
+        for (const auto &tileset : map.tilesets)
+        {
+            previousFirstGids.push_back(tileset.GetFirstGid());
+        }
+        const bool gidsMoved = firstGids != previousFirstGids;
+
+        for (auto &element : elements)
+        {
+            const auto kind = GetKeyKind(element.key);
+            const auto found = previous.find(element.key);
+            if (found != previous.end() && !found->second.reused
+                && found->second.hash == element.hash
+                && found->second.index < previousCount(kind)
+                && !(gidsMoved && (kind == "layer" || kind == "group")))
+            {
+                found->second.reused = true;
+                element.reuse = &found->second;
+                continue;
+            }
+
+            // The map is left alone if anything that changed is malformed.
+            element.doc = std::make_unique<tinyxml2::XMLDocument>();
+            element.doc->Parse(element.text.data(), element.text.size());
+            if (element.doc->Error())
+            {
+                return failed(element.doc->ErrorStr());
+            }
+
+            element.excluded = !options.IncludesLayer(element.doc->RootElement());
+        }
+
+        std::erase_if(elements, [](const auto &element) { return element.excluded; });
+
+        // What is kept of the map was allocated from its arena, so the new
+        // version goes there as well, and shares its strings.
+        Map next{ mapElement, path, loader };
+        next.arena = map.arena;
+        next.strings = map.strings;
+        const ParseOptionsDetails::MemoryScope memory{ next.GetMemoryResource() };
+        const ParseOptionsDetails::StringPoolScope interned{ next.strings };
+
+        next.root_hash = std::hash<std::string_view>{}(stream.GetRoot());
+        changes.mapChanged = changes.mapChanged || next.root_hash != map.root_hash;
+
+        // The position of each element in its collection of the new map.
+        std::vector<std::size_t> placed;
+        for (const auto &element : elements)
+        {
+            const auto kind = GetKeyKind(element.key);
+            placed.push_back(
+                kind == "tileset"     ? next.tilesets.size()
+              : kind == "layer"       ? next.tile_layers.size()
+              : kind == "imagelayer"  ? next.image_layers.size()
+              : kind == "objectgroup" ? next.object_groups.size()
+              : kind == "group"       ? next.group_layers.size()
+                                      : 0);
+
+            if (!element.reuse)
+            {
+                next.ParseChild(element.doc->RootElement(), loader);
+                if (kind == "properties")
+                {
+                    changes.mapChanged = true;
+                }
+            }
+            else
+            {
+                const auto index = element.reuse->index;
+                if (kind == "tileset") {
+                    next.tilesets.push_back(std::move(map.tilesets[index]));
+                    next.IndexTilesets();
+                }
+                else if (kind == "layer") {
+                    next.tile_layers.push_back(std::move(map.tile_layers[index]));
+                }
+                else if (kind == "imagelayer") {
+                    next.image_layers.push_back(std::move(map.image_layers[index]));
+                }
+                else if (kind == "objectgroup") {
+                    next.object_groups.push_back(std::move(map.object_groups[index]));
+                }
+                else if (kind == "group") {
+                    next.group_layers.push_back(std::move(map.group_layers[index]));
+                }
+                else if (kind == "properties") {
+                    next.properties = std::move(map.properties);
+                }
+                ++changes.reusedElements;
+            }
+
+            next.tracked_elements.push_back({ element.key, element.hash });
+        }
+
+        for (const auto &[key, old] : previous)
+        {
+            if (old.reused)
+            {
+                continue;
+            }
+
+            const auto kind = GetKeyKind(key);
+            if (kind == "tileset") {
+                ++changes.removedTilesets;
+            }
+            else if (kind == "properties") {
+                changes.mapChanged = true;
+            }
+            else {
+                ++changes.removedLayers;
+            }
+        }
+
+        next.FinishParse(loader);
+        if (next.HasError())
+        {
+            return failed(next.GetErrorText());
+        }
+        map = std::move(next);
+
+        // Number the layers in document order, as a fresh parse would.
+        map.next_parse_order = 0;
+        const auto renumber = [](auto &self, Layer *layer) -> void {
+            layer->TakeNextParseOrder();
+            if (layer->GetLayerType() == TMX_LAYERTYPE_GROUP_LAYER)
+            {
+                static_cast<GroupLayer *>(layer)->IterateChildren([&](Layer *child) {
+                    self(self, child);
+                });
+            }
+        };
+
+        for (std::size_t i = 0; i < elements.size(); ++i)
+        {
+            const auto kind = GetKeyKind(elements[i].key);
+            const auto index = placed[i];
+
+            Layer *layer =
+                kind == "layer"       ? static_cast<Layer *>(&map.tile_layers[index])
+              : kind == "imagelayer"  ? static_cast<Layer *>(&map.image_layers[index])
+              : kind == "objectgroup" ? static_cast<Layer *>(&map.object_groups[index])
+              : kind == "group"       ? static_cast<Layer *>(&map.group_layers[index])
+                                      : nullptr;
+            if (layer)
+            {
+                renumber(renumber, layer);
+            }
+
+            if (!elements[i].reuse)
+            {
+                if (kind == "tileset")
+                {
+                    changes.tilesets.push_back(&map.tilesets[index]);
+                }
+                else if (layer)
+                {
+                    changes.layers.push_back(layer);
+                }
+            }
+        }
+
+        return changes;
     }
 
     const Tmx::Layer *Map::GetLayer(int index) const
@@ -200,35 +975,17 @@ namespace Tmx
         return group_layers.size();
     }
 
-    int Map::FindTilesetIndex(int gid) const
+    const Tileset *Map::FindTileset(int gid) const
     {
-        // Clean up the flags from the gid (thanks marwes91).
-        gid &= ~(FlippedHorizontallyFlag | FlippedVerticallyFlag | FlippedDiagonallyFlag);
-
-        for (int i = tilesets.size() - 1; i > -1; --i)
-        {
-            // If the gid beyond the tileset gid return its index.
-            if (gid >= tilesets[i].GetFirstGid())
-            {
-                return i;
-            }
-        }
-
-        return -1;
+        const auto index = FindTilesetIndex(gid);
+        return index != -1 ? &tilesets[index] : nullptr;
     }
 
-    const Tileset *Map::FindTileset(int gid) const
+    std::pmr::memory_resource *Map::GetMemoryResource() const
     {
-        for (int i = tilesets.size() - 1; i > -1; --i)
-        {
-            // If the gid beyond the tileset gid return it.
-            if (gid >= tilesets[i].GetFirstGid())
-            {
-                return &tilesets[i];
-            }
-        }
-
-        return nullptr;
+        return options.memoryResource ? options.memoryResource
+            : arena ? arena.get()
+            : std::pmr::new_delete_resource();
     }
 
     const Tmx::Tileset *Map::GetTileset(int index) const
@@ -242,22 +999,81 @@ namespace Tmx
     }
 
     Map::Map(std::string errorText)
-        : has_error{ true }
-        , error_code{ TMX_PARSING_ERROR }
+        : Map{ TMX_PARSING_ERROR, std::move(errorText) }
+    {
+    }
+
+    Map::Map(unsigned char errorCode, std::string errorText)
+        : strings{ std::make_shared<StringPool>() }
+        , has_error{ true }
+        , error_code{ errorCode }
         , error_text{ std::move(errorText) }
         , properties{ nullptr }
     {
     }
 
-    Map::Map(const tinyxml2::XMLElement *data, std::string filePath)
-        : file_path{ std::move(filePath) }
+    Map::Map(Map &&other) noexcept
+        : properties{ nullptr }
+    {
+        *this = std::move(other);
+    }
+
+    Map &Map::operator=(Map &&other) noexcept
+    {
+        // Keep in sync with the members, the layers point back at their map.
+        options = std::move(other.options);
+        strings = std::move(other.strings);
+        file_path = std::move(other.file_path);
+        background_color = other.background_color;
+        version = other.version;
+        orientation = other.orientation;
+        render_order = other.render_order;
+        stagger_axis = other.stagger_axis;
+        stagger_index = other.stagger_index;
+        width = other.width;
+        height = other.height;
+        tile_width = other.tile_width;
+        tile_height = other.tile_height;
+        next_object_id = other.next_object_id;
+        hexside_length = other.hexside_length;
+        parallaxOriginX = other.parallaxOriginX;
+        parallaxOriginY = other.parallaxOriginY;
+        infinite = other.infinite;
+        next_parse_order = other.next_parse_order;
+        layers = std::move(other.layers);
+        tile_layers = std::move(other.tile_layers);
+        image_layers = std::move(other.image_layers);
+        object_groups = std::move(other.object_groups);
+        group_layers = std::move(other.group_layers);
+        tilesets = std::move(other.tilesets);
+        tileset_lookup = std::move(other.tileset_lookup);
+        templates = std::move(other.templates);
+        has_error = other.has_error;
+        error_code = other.error_code;
+        error_text = std::move(other.error_text);
+        properties = std::move(other.properties);
+        root_hash = other.root_hash;
+        tracked_elements = std::move(other.tracked_elements);
+
+        // Last, once nothing allocated from the previous arena is left.
+        arena = std::move(other.arena);
+
+        RebindLayers();
+        return *this;
+    }
+
+    Map::Map(const tinyxml2::XMLElement *data, std::string filePath, MapLoader *loader)
+        : arena{ MakeArena(GetOptions(loader)) }
+        , options{ GetOptions(loader) }
+        , strings{ std::make_shared<StringPool>() }
+        , file_path{ std::move(filePath) }
         , background_color{ Util::ParseOrDefault(data, "backgroundcolor",
             [](const auto s) { return Tmx::Color{ s }; }, {}) }
         , version{ data->DoubleAttribute("version") }
-        , orientation{ ParseOrientation(data) }
-        , render_order{ ParseRenderOrder(data) }
-        , stagger_axis{ ParseStaggerAxis(data) }
-        , stagger_index{ ParseStaggerIndex(data) }
+        , orientation{ ParseOrientation(GetStringAttribute(data, "orientation")) }
+        , render_order{ ParseRenderOrder(GetStringAttribute(data, "renderorder")) }
+        , stagger_axis{ ParseStaggerAxis(GetStringAttribute(data, "staggeraxis")) }
+        , stagger_index{ ParseStaggerIndex(GetStringAttribute(data, "staggerindex")) }
         , width{ data->IntAttribute("width") }
         , height{ data->IntAttribute("height") }
         , tile_width{ data->IntAttribute("tilewidth") }
@@ -267,51 +1083,275 @@ namespace Tmx
         , parallaxOriginX{ data->FloatAttribute("parallaxoriginx") }
         , parallaxOriginY{ data->FloatAttribute("parallaxoriginy") }
         , infinite{ static_cast<bool>(data->IntAttribute("infinite")) }
-        , properties{ data->FirstChildElement("properties") }
-    {
-        // read all other attributes
-        const auto *node = data->FirstChild();
-        while (node) {
-            // Iterate through all of the "layer" (tile layer) elements.
-            const auto v = node->Value();
-            if (!v) {
-                continue;
+        , templates{ loader ? loader->GetTemplateCache() : std::make_shared<TemplateCache>() }
+        , properties{ nullptr }
+    {
+        const ParseOptionsDetails::MemoryScope memory{ GetMemoryResource() };
+        const ParseOptionsDetails::StringPoolScope interned{ strings };
+
+        for (auto element = data->FirstChildElement(); element && !IsCancelled();
+            element = element->NextSiblingElement())
+        {
+            if (options.IncludesLayer(element))
+            {
+                ParseChild(element, loader);
             }
+        }
 
-            const auto element = node->ToElement();
+        FinishParse(loader);
+    }
 
-            if (strcmp(node->Value(), "tileset") == 0) {
-                tilesets.emplace_back(file_path, element);
-            }
+    Map::Map(JsonReader &json, std::string filePath, MapLoader *loader)
+        : arena{ MakeArena(GetOptions(loader)) }
+        , options{ GetOptions(loader) }
+        , strings{ std::make_shared<StringPool>() }
+        , file_path{ std::move(filePath) }
+        , templates{ loader ? loader->GetTemplateCache() : std::make_shared<TemplateCache>() }
+        , properties{ nullptr }
+    {
+        const ParseOptionsDetails::MemoryScope memory{ GetMemoryResource() };
+        const ParseOptionsDetails::StringPoolScope interned{ strings };
 
-            if (strcmp(node->Value(), "layer") == 0) {
-                tile_layers.emplace_back(this, element);
-            }
+        // The gids of the layers are resolved with the tilesets, which Tiled
+        // writes after the layers, so the layers are read last.
+        std::size_t layersAt = 0;
 
-            if (strcmp(node->Value(), "imagelayer") == 0) {
-                image_layers.emplace_back(this, element);
+        json.ReadObject([&](const auto key) {
+            if (key == "backgroundcolor") {
+                background_color = Tmx::Color{ json.ReadString() };
             }
-
-            if (strcmp(node->Value(), "objectgroup") == 0) {
-                object_groups.emplace_back(this, element);
+            else if (key == "version") {
+                version = json.Peek() == TMX_JSON_STRING
+                    ? std::strtod(json.ReadString().c_str(), nullptr)
+                    : json.ReadDouble();
             }
-
-            if (strcmp(node->Value(), "group") == 0) {
-                group_layers.emplace_back(this, element);
+            else if (key == "orientation") {
+                orientation = ParseOrientation(json.ReadString());
+            }
+            else if (key == "renderorder") {
+                render_order = ParseRenderOrder(json.ReadString());
+            }
+            else if (key == "staggeraxis") {
+                stagger_axis = ParseStaggerAxis(json.ReadString());
+            }
+            else if (key == "staggerindex") {
+                stagger_index = ParseStaggerIndex(json.ReadString());
+            }
+            else if (key == "width") {
+                width = json.ReadInt();
+            }
+            else if (key == "height") {
+                height = json.ReadInt();
+            }
+            else if (key == "tilewidth") {
+                tile_width = json.ReadInt();
+            }
+            else if (key == "tileheight") {
+                tile_height = json.ReadInt();
+            }
+            else if (key == "nextobjectid") {
+                next_object_id = json.ReadInt();
+            }
+            else if (key == "hexsidelength") {
+                hexside_length = json.ReadInt();
+            }
+            else if (key == "parallaxoriginx") {
+                parallaxOriginX = json.ReadFloat();
+            }
+            else if (key == "parallaxoriginy") {
+                parallaxOriginY = json.ReadFloat();
             }
+            else if (key == "infinite") {
+                infinite = json.ReadBool();
+            }
+            else if (key == "properties") {
+                properties = PropertySet{ json };
+            }
+            else if (key == "tilesets") {
+                json.ReadArray([&] {
+                    if (!IsCancelled()) {
+                        tilesets.emplace_back(file_path, json, loader);
+                    }
+                });
+                IndexTilesets();
+            }
+            else if (key == "layers") {
+                layersAt = json.Tell();
+                json.Skip();
+            }
+        });
 
-            node = node->NextSibling();
+        if (layersAt != 0)
+        {
+            const auto end = json.Tell();
+            json.Seek(layersAt);
+            json.ReadArray([&] {
+                // The type comes late in a layer written by Tiled.
+                const auto type = IsCancelled() ? std::string{} : json.FindString("type");
+                if (!options.IncludesLayer(json, type)) {
+                    return;
+                }
+
+                if (type == "tilelayer") {
+                    tile_layers.emplace_back(this, json);
+                }
+                else if (type == "imagelayer") {
+                    image_layers.emplace_back(this, json);
+                }
+                else if (type == "objectgroup") {
+                    object_groups.emplace_back(this, json);
+                }
+                else if (type == "group") {
+                    group_layers.emplace_back(this, json);
+                }
+            });
+            json.Seek(end);
         }
 
+        FinishParse(loader);
+    }
+
+    void Map::ParseChild(const tinyxml2::XMLElement *element, MapLoader *loader,
+        std::string_view dataText)
+    {
+        const auto v = element->Value();
+
+        if (strcmp(v, "properties") == 0) {
+            properties = PropertySet{ element };
+        }
+
+        if (strcmp(v, "tileset") == 0) {
+            tilesets.emplace_back(file_path, element, loader);
+            IndexTilesets();
+        }
+
+        if (strcmp(v, "layer") == 0) {
+            tile_layers.emplace_back(this, element, dataText);
+        }
+
+        if (strcmp(v, "imagelayer") == 0) {
+            image_layers.emplace_back(this, element);
+        }
+
+        if (strcmp(v, "objectgroup") == 0) {
+            object_groups.emplace_back(this, element);
+        }
+
+        if (strcmp(v, "group") == 0) {
+            group_layers.emplace_back(this, element);
+        }
+    }
+
+    void Map::FinishParse(MapLoader *loader)
+    {
         const auto addLayers = [this](auto &collection) {
             for (auto &v : collection) {
                 layers.push_back(&v);
             }
         };
 
+        layers.clear();
         addLayers(tile_layers);
         addLayers(image_layers);
         addLayers(object_groups);
         addLayers(group_layers);
+
+        // Layers the decompressor cannot read would silently come out empty.
+        const auto &decompressor = options.decompressor
+            ? *options.decompressor : Decompressor::GetDefault();
+        if (!decompressor.CanDecompressZstd())
+        {
+            const auto check = [this](auto &self, const Layer *layer) -> void {
+                if (layer->GetLayerType() == TMX_LAYERTYPE_TILE && !has_error
+                    && static_cast<const TileLayer *>(layer)->GetCompression() == TMX_COMPRESSION_ZSTD)
+                {
+                    has_error = true;
+                    error_code = TMX_UNSUPPORTED_COMPRESSION;
+                    error_text = "layer '" + layer->GetName() + "': zstd support not built in";
+                }
+                else if (layer->GetLayerType() == TMX_LAYERTYPE_GROUP_LAYER)
+                {
+                    static_cast<const GroupLayer *>(layer)->IterateChildren([&](const Layer *child) {
+                        self(self, child);
+                    });
+                }
+            };
+
+            for (const auto layer : layers)
+            {
+                check(check, layer);
+            }
+        }
+
+        DecodePendingLayers(loader);
+    }
+
+    void Map::DecodePendingLayers(MapLoader *loader)
+    {
+        if (IsCancelled())
+        {
+            return;
+        }
+
+        std::vector<TileLayer *> pending;
+
+        const auto collect = [&pending](auto &self, Layer *layer) -> void {
+            if (layer->GetLayerType() == TMX_LAYERTYPE_TILE)
+            {
+                const auto tileLayer = static_cast<TileLayer *>(layer);
+                if (tileLayer->pending_data)
+                {
+                    pending.push_back(tileLayer);
+                }
+            }
+            else if (layer->GetLayerType() == TMX_LAYERTYPE_GROUP_LAYER)
+            {
+                static_cast<GroupLayer *>(layer)->IterateChildren([&](Layer *child) {
+                    self(self, child);
+                });
+            }
+        };
+
+        for (auto layer : layers)
+        {
+            collect(collect, layer);
+        }
+
+        const auto decode = [&pending](std::size_t i) {
+            const auto layer = pending[i];
+            layer->DecodeData(layer->pending_data, layer->pending_text);
+            layer->pending_data = nullptr;
+            layer->pending_text = {};
+        };
+
+        if (const auto pool = loader ? loader->GetThreadPool() : nullptr)
+        {
+            pool->ParallelFor(pending.size(), decode);
+        }
+        else
+        {
+            for (std::size_t i = 0; i < pending.size(); ++i)
+            {
+                decode(i);
+            }
+        }
+    }
+
+    void Map::RebindLayers()
+    {
+        const auto rebind = [this](auto &self, Layer *layer) -> void {
+            layer->map = this;
+            if (layer->GetLayerType() == TMX_LAYERTYPE_GROUP_LAYER)
+            {
+                static_cast<GroupLayer *>(layer)->IterateChildren([&](Layer *child) {
+                    self(self, child);
+                });
+            }
+        };
+
+        for (auto layer : layers)
+        {
+            rebind(rebind, layer);
+        }
     }
 }
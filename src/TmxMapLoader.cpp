@@ -0,0 +1,248 @@
+//-----------------------------------------------------------------------------
+// TmxMapLoader.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+
+#include "TmxMapLoader.h"
+
+#include <exception>
+#include <optional>
+
+#include "TmxGroupLayer.h"
+#include "TmxImageLayer.h"
+#include "TmxObjectGroup.h"
+#include "TmxTileLayer.h"
+#include "TmxTileset.h"
+
+namespace Tmx
+{
+    namespace
+    {
+        std::unique_ptr<ThreadPool> CreateThreadPool(unsigned numThreads)
+        {
+            if (numThreads == 0)
+            {
+                numThreads = std::thread::hardware_concurrency();
+            }
+
+            // The thread calling into the loader does its share of the work.
+            return numThreads > 1 ? std::make_unique<ThreadPool>(numThreads - 1) : nullptr;
+        }
+    }
+
+    MapLoader::MapLoader(std::shared_ptr<TemplateCache> templateCache)
+        : MapLoader{ ParseOptions{}, std::move(templateCache) }
+    {
+    }
+
+    MapLoader::MapLoader(const ParseOptions &options, std::shared_ptr<TemplateCache> templateCache)
+        : options{ options }
+        , templates{ templateCache ? std::move(templateCache) : std::make_shared<TemplateCache>() }
+        , pool{ CreateThreadPool(options.decodeThreads) }
+    {
+    }
+
+    MapLoader::~MapLoader()
+    {
+        // Parses still queued on the loader's threads use its caches, so
+        // they are finished before the caches go.
+        batchPool.reset();
+        pool.reset();
+    }
+
+    Map MapLoader::ParseFile(const std::string &fileName)
+    {
+        return Map::ParseFile(fileName, this);
+    }
+
+    Map MapLoader::ParseFileMapped(const std::string &fileName)
+    {
+        return Map::ParseFileMapped(fileName, this);
+    }
+
+    Map MapLoader::ParseText(std::string_view text, const std::string &path)
+    {
+        return Map::ParseText(text, path, this);
+    }
+
+    std::vector<Map> MapLoader::ParseFiles(std::span<const std::string> fileNames)
+    {
+        std::vector<std::optional<Map>> slots(fileNames.size());
+
+        // Each file lands in its own slot, so no locking is needed.
+        const auto parse = [&](std::size_t i) {
+            try
+            {
+                slots[i].emplace(ParseFile(fileNames[i]));
+            }
+            catch (const std::exception &e)
+            {
+                slots[i].emplace(Map{ TMX_PARSING_ERROR, fileNames[i] + ": " + e.what() });
+            }
+        };
+
+        GetBatchPool()->ParallelFor(fileNames.size(), parse);
+
+        std::vector<Map> maps;
+        maps.reserve(slots.size());
+        for (auto &slot : slots)
+        {
+            maps.push_back(std::move(*slot));
+        }
+
+        return maps;
+    }
+
+    std::future<Map> MapLoader::ParseFileAsync(const std::string &fileName,
+        CancellationToken token)
+    {
+        auto promise = std::make_shared<std::promise<Map>>();
+        auto future = promise->get_future();
+
+        ParseFileAsync(fileName, [promise](Map map) { promise->set_value(std::move(map)); },
+            std::move(token));
+
+        return future;
+    }
+
+    void MapLoader::ParseFileAsync(const std::string &fileName,
+        std::function<void(Map)> onDone, CancellationToken token)
+    {
+        const auto batch = GetBatchPool();
+        Executor executor = [batch](std::function<void()> task) {
+            batch->Submit(std::move(task));
+        };
+
+        Map::ParseFileAsync(fileName, this, std::move(onDone), std::move(token),
+            std::move(executor));
+    }
+
+    MapChangeSet MapLoader::Reload(Map &map, const std::string &fileName)
+    {
+        return Map::ReloadFile(map, fileName, this);
+    }
+
+    MapChangeSet MapLoader::ReloadText(Map &map, std::string_view text, const std::string &path)
+    {
+        return Map::Reload(map, text, path, this);
+    }
+
+    ThreadPool *MapLoader::GetBatchPool()
+    {
+        if (pool)
+        {
+            return pool.get();
+        }
+
+        // A single core still gets a worker, so that ParseFileAsync does
+        // not wait on the calling thread.
+        std::call_once(batchPoolOnce, [this] {
+            batchPool = CreateThreadPool(0);
+            if (!batchPool)
+            {
+                batchPool = std::make_unique<ThreadPool>(1);
+            }
+        });
+        return batchPool.get();
+    }
+
+    std::shared_ptr<const TilesetDetails::TilesetContents> MapLoader::FindOrLoadTileset(
+        const std::string &path, const std::string &source)
+    {
+        const ParseOptionsDetails::Scope scope{ options };
+
+        for (const auto &fileName : { path + source, source })
+        {
+            std::error_code error;
+            const auto canonical = std::filesystem::canonical(fileName, error);
+            if (error)
+            {
+                continue;
+            }
+
+            const auto lastWriteTime = std::filesystem::last_write_time(canonical, error);
+            if (error)
+            {
+                continue;
+            }
+
+            const auto key = canonical.string();
+
+            {
+                std::lock_guard<std::mutex> lock{ mutex };
+
+                const auto it = tilesets.find(key);
+                if (it != tilesets.end() && it->second.lastWriteTime == lastWriteTime)
+                {
+                    ++tilesetHits;
+                    return it->second.contents;
+                }
+            }
+
+            // Parse outside of the lock, other maps may be loading meanwhile.
+            auto contents = TilesetDetails::LoadTilesetFile(key);
+            if (!contents)
+            {
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock{ mutex };
+
+            // Another map may have stored the same version meanwhile; all
+            // maps share the one that came first.
+            auto &cached = tilesets[key];
+            if (cached.contents && cached.lastWriteTime == lastWriteTime)
+            {
+                ++tilesetHits;
+                return cached.contents;
+            }
+
+            ++tilesetMisses;
+            cached = CachedTileset{ lastWriteTime, std::move(contents) };
+            return cached.contents;
+        }
+
+        return nullptr;
+    }
+
+    std::size_t MapLoader::GetTilesetCacheHits() const
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        return tilesetHits;
+    }
+
+    std::size_t MapLoader::GetTilesetCacheMisses() const
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        return tilesetMisses;
+    }
+
+    void MapLoader::ClearCache()
+    {
+        templates->Clear();
+
+        std::lock_guard<std::mutex> lock{ mutex };
+        tilesets.clear();
+    }
+}
@@ -0,0 +1,351 @@
+//-----------------------------------------------------------------------------
+// TmxMapWatcher.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include "TmxMapWatcher.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "TmxMap.h"
+#include "TmxMapLoader.h"
+
+namespace Tmx
+{
+    namespace
+    {
+        std::filesystem::file_time_type GetLastWriteTime(const std::string &fileName)
+        {
+            std::error_code error;
+            const auto time = std::filesystem::last_write_time(fileName, error);
+            return error ? std::filesystem::file_time_type{} : time;
+        }
+
+        bool IsSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        // Adds the values of an attribute, written name="value" in TMX or
+        // "name": "value" in JSON. With element set, only TMX attributes
+        // of such elements count.
+        void FindValues(std::string_view text, std::string_view name, std::string_view element,
+            std::vector<std::string> &values)
+        {
+            for (auto at = text.find(name); at != std::string_view::npos; at = text.find(name, at + 1))
+            {
+                if (at == 0 || !(IsSpace(text[at - 1]) || text[at - 1] == '"'))
+                {
+                    continue;
+                }
+
+                if (!element.empty())
+                {
+                    const auto tag = text.rfind('<', at);
+                    if (tag == std::string_view::npos || text.compare(tag + 1, element.size(), element) != 0)
+                    {
+                        continue;
+                    }
+                }
+
+                auto i = at + name.size();
+                i += i < text.size() && text[i] == '"';
+                while (i < text.size() && IsSpace(text[i]))
+                {
+                    ++i;
+                }
+                if (i >= text.size() || (text[i] != '=' && text[i] != ':'))
+                {
+                    continue;
+                }
+                ++i;
+                while (i < text.size() && IsSpace(text[i]))
+                {
+                    ++i;
+                }
+
+                const auto end = i < text.size() && text[i] == '"'
+                    ? text.find('"', i + 1) : std::string_view::npos;
+                if (end != std::string_view::npos && end > i + 1)
+                {
+                    values.emplace_back(text.substr(i + 1, end - i - 1));
+                }
+            }
+        }
+
+        // The external tilesets and object templates a map file references,
+        // found the way the parse finds them: next to the map, or as given.
+        std::vector<std::string> FindReferencedFiles(const std::string &fileName)
+        {
+            std::ifstream file{ fileName, std::ios::binary };
+            const std::string text{ std::istreambuf_iterator<char>{ file }, {} };
+
+            std::vector<std::string> values;
+            const auto first = text.find_first_not_of(" \t\r\n");
+            const bool json = first != std::string::npos && text[first] == '{';
+            FindValues(text, "source", json ? "" : "tileset", values);
+            FindValues(text, "template", "", values);
+
+            std::sort(values.begin(), values.end());
+            values.erase(std::unique(values.begin(), values.end()), values.end());
+
+            const auto directory = std::filesystem::path{ fileName }.parent_path();
+            for (auto &value : values)
+            {
+                const auto nextToMap = (directory / value).string();
+                std::error_code error;
+                if (std::filesystem::exists(nextToMap, error) || !std::filesystem::exists(value, error))
+                {
+                    value = nextToMap;
+                }
+            }
+            return values;
+        }
+    }
+
+    MapWatcher::MapWatcher(MapLoader &loader)
+        : loader{ loader }
+    {
+#ifdef __linux__
+        notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    }
+
+    MapWatcher::~MapWatcher()
+    {
+#ifdef __linux__
+        if (notify != -1)
+        {
+            close(notify);
+        }
+#endif
+    }
+
+    void MapWatcher::Watch(const std::string &fileName, Map &map, Callback onReload)
+    {
+        Unwatch(fileName);
+
+        watched.push_back(Watched{ fileName, &map, std::move(onReload), {}, false });
+        WatchFiles(watched.back());
+    }
+
+    void MapWatcher::Unwatch(const std::string &fileName)
+    {
+        const auto it = std::find_if(watched.begin(), watched.end(),
+            [&fileName](const auto &w) { return w.fileName == fileName; });
+        if (it == watched.end())
+        {
+            return;
+        }
+
+        watched.erase(it);
+        ReleaseDirectories();
+    }
+
+    void MapWatcher::WatchFiles(Watched &w)
+    {
+        std::vector<std::string> fileNames{ w.fileName };
+        for (auto &fileName : FindReferencedFiles(w.fileName))
+        {
+            fileNames.push_back(std::move(fileName));
+        }
+
+        w.files.clear();
+        for (const auto &fileName : fileNames)
+        {
+            const std::filesystem::path path{ fileName };
+            WatchedFile file{ fileName, path.filename().string(), GetLastWriteTime(fileName), -1 };
+
+#ifdef __linux__
+            // The directory is watched rather than the file, as editors often
+            // save by writing another file and renaming it over the old one.
+            // Watching a directory twice gives the same watch.
+            if (notify != -1)
+            {
+                const auto directory = path.has_parent_path() ? path.parent_path().string() : ".";
+                file.directory = inotify_add_watch(notify, directory.c_str(),
+                    IN_CLOSE_WRITE | IN_MOVED_TO);
+                if (file.directory != -1
+                    && std::find(directories.begin(), directories.end(), file.directory) == directories.end())
+                {
+                    directories.push_back(file.directory);
+                }
+            }
+#endif
+
+            w.files.push_back(std::move(file));
+        }
+
+        ReleaseDirectories();
+    }
+
+    void MapWatcher::ReleaseDirectories()
+    {
+        // A directory stays watched while files in it are.
+        const auto inUse = [this](int directory) {
+            return std::any_of(watched.begin(), watched.end(), [directory](const auto &w) {
+                return std::any_of(w.files.begin(), w.files.end(),
+                    [directory](const auto &file) { return file.directory == directory; });
+            });
+        };
+
+        const auto unused = std::stable_partition(directories.begin(), directories.end(), inUse);
+#ifdef __linux__
+        std::for_each(unused, directories.end(), [this](int directory) {
+            inotify_rm_watch(notify, directory);
+        });
+#endif
+        directories.erase(unused, directories.end());
+    }
+
+    int MapWatcher::Poll(std::chrono::milliseconds timeout)
+    {
+        if (!WaitForSaves(timeout))
+        {
+            return 0;
+        }
+
+        // The callbacks are called once the maps are reloaded, as they may
+        // watch or unwatch files and so change the list being walked.
+        struct Report
+        {
+            std::string fileName;
+            MapChangeSet changes;
+            Callback onReload;
+        };
+        std::vector<Report> reports;
+
+        int reloaded = 0;
+        for (auto &w : watched)
+        {
+            if (!w.saved)
+            {
+                continue;
+            }
+
+            w.saved = false;
+
+            auto changes = loader.Reload(*w.map, w.fileName);
+            if (!changes.HasError())
+            {
+                ++reloaded;
+            }
+
+            // The map may reference other files now.
+            WatchFiles(w);
+
+            if (w.onReload)
+            {
+                reports.push_back(Report{ w.fileName, std::move(changes), w.onReload });
+            }
+        }
+
+        for (const auto &report : reports)
+        {
+            report.onReload(report.fileName, report.changes);
+        }
+
+        return reloaded;
+    }
+
+    bool MapWatcher::WaitForSaves(std::chrono::milliseconds timeout)
+    {
+#ifdef __linux__
+        if (notify != -1)
+        {
+            pollfd fd{ notify, POLLIN, 0 };
+            if (poll(&fd, 1, static_cast<int>(timeout.count())) <= 0)
+            {
+                return false;
+            }
+
+            bool any = false;
+            alignas(inotify_event) char buffer[4096];
+            for (;;)
+            {
+                const auto size = read(notify, buffer, sizeof(buffer));
+                if (size <= 0)
+                {
+                    break;
+                }
+
+                for (auto at = buffer; at < buffer + size; )
+                {
+                    const auto event = reinterpret_cast<const inotify_event *>(at);
+                    for (auto &w : watched)
+                    {
+                        for (const auto &file : w.files)
+                        {
+                            if (event->len && file.directory == event->wd && file.name == event->name)
+                            {
+                                w.saved = any = true;
+                            }
+                        }
+                    }
+                    at += sizeof(inotify_event) + event->len;
+                }
+            }
+            return any;
+        }
+#endif
+
+        // Without notifications the modification times are checked until
+        // one of them moves or the time is up.
+        const auto end = std::chrono::steady_clock::now() + timeout;
+        while (!CheckTimes())
+        {
+            if (std::chrono::steady_clock::now() >= end)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 50 });
+        }
+        return true;
+    }
+
+    bool MapWatcher::CheckTimes()
+    {
+        bool any = false;
+        for (auto &w : watched)
+        {
+            for (const auto &file : w.files)
+            {
+                if (GetLastWriteTime(file.fileName) != file.lastWriteTime)
+                {
+                    w.saved = any = true;
+                }
+            }
+        }
+        return any;
+    }
+}
@@ -0,0 +1,169 @@
+//-----------------------------------------------------------------------------
+// TmxMappedFile.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+
+#include "TmxMappedFile.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Tmx
+{
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::string &fileName)
+    {
+        const auto file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        size = static_cast<std::size_t>(fileSize.QuadPart);
+        is_open = true;
+
+        // Mapping an empty file fails, an empty view is all we need.
+        if (size == 0)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        const auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping)
+        {
+            size = 0;
+            is_open = false;
+            return;
+        }
+
+        data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        if (!data)
+        {
+            size = 0;
+            is_open = false;
+        }
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (data)
+        {
+            UnmapViewOfFile(data);
+        }
+    }
+
+    void MappedFile::Discard(std::size_t end)
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+
+        end = std::min(end, size) / info.dwPageSize * info.dwPageSize;
+        if (end > discarded)
+        {
+            // Unlocking pages that are not locked removes them from the working set.
+            VirtualUnlock(const_cast<char *>(data) + discarded, end - discarded);
+            discarded = end;
+        }
+    }
+#else
+    MappedFile::MappedFile(const std::string &fileName)
+    {
+        const int fd = open(fileName.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            return;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            close(fd);
+            return;
+        }
+
+        size = static_cast<std::size_t>(st.st_size);
+        is_open = true;
+
+        // Mapping an empty file fails, an empty view is all we need.
+        if (size == 0)
+        {
+            close(fd);
+            return;
+        }
+
+        void *p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED)
+        {
+            size = 0;
+            is_open = false;
+            return;
+        }
+
+        // The whole file is read front to back by the XML parser.
+        madvise(p, size, MADV_SEQUENTIAL);
+        data = static_cast<const char *>(p);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (data)
+        {
+            munmap(const_cast<char *>(data), size);
+        }
+    }
+
+    void MappedFile::Discard(std::size_t end)
+    {
+        const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+
+        end = std::min(end, size) / pageSize * pageSize;
+        if (end > discarded)
+        {
+            madvise(const_cast<char *>(data) + discarded, end - discarded, MADV_DONTNEED);
+            discarded = end;
+        }
+    }
+#endif
+}
@@ -28,56 +28,50 @@
 
 #include "TmxObject.h"
 
+#include <string>
+#include <string_view>
+
 #include "TmxEllipse.h"
+#include "TmxJsonReader.h"
 #include "TmxMap.h"
+#include "TmxParseOptions.h"
 #include "TmxPolygon.h"
 #include "TmxPolyline.h"
+#include "TmxTemplateCache.h"
 #include "TmxText.h"
 
 namespace Tmx
 {
     namespace
     {
-        const auto *GetDefaultPattern()
+        const Object &GetDefaults(const Object *pattern)
         {
-            static Object defaultPattern;
-            return &defaultPattern;
+            // Made on the heap with strings of its own, whichever map asks
+            // first, so that it keeps neither that map's memory nor its pool.
+            static const Object defaultPattern = [] {
+                const ParseOptionsDetails::MemoryScope heap{ std::pmr::new_delete_resource() };
+                const ParseOptionsDetails::StringPoolScope strings;
+                return Object{};
+            }();
+
+            return pattern ? *pattern : defaultPattern;
         }
 
-        auto GetAttribute(const tinyxml2::XMLElement *element, const char *name,
+        std::string_view GetAttribute(const tinyxml2::XMLElement *element, const char *name,
             const std::string &defaultValue)
         {
             const auto value = element->Attribute(name);
-            return value ? std::string{ value } : defaultValue;
+            return value ? std::string_view{ value } : defaultValue;
         }
 
-        const auto *GetOrLoadPattern(Map *map, const std::string &templateName)
+        std::shared_ptr<const Object> GetOrLoadPattern(Map *map, const std::string &templateName)
         {
-            if (templateName.empty())
-            {
-                return GetDefaultPattern();
-            }
-
-            auto &templates = map->GetTemplates();
-            auto it = templates.find(templateName);
-            if (it == templates.end())
+            if (templateName.empty() || !map)
             {
-                tinyxml2::XMLDocument doc;
-
-                const auto fileName = map->GetFilepath() + templateName;
-                doc.LoadFile(fileName.c_str());
-
-                if (doc.Error())
-                {
-                    return GetDefaultPattern();
-                }
-
-                const auto &templateData =
-                    doc.FirstChildElement("template")->FirstChildElement("object");
-                it = templates.emplace(templateName, Object{ templateData, map }).first;
+                return nullptr;
             }
 
-            return &it->second;
+            return map->GetTemplates().FindOrLoad(map->GetFilepath() + templateName);
         }
 
         auto ParseTemplateName(const tinyxml2::XMLElement *data)
@@ -87,26 +81,39 @@ namespace Tmx
             return templateName ? std::string{ templateName } : std::string{};
         }
 
-        template <typename T, typename... Args>
-        std::unique_ptr<T> ParsePrimitive(const tinyxml2::XMLElement *data, const T *pattern,
-            Args&&... args)
+        std::pmr::vector<Point> ReadPoints(JsonReader &json)
         {
-            if (data)
-            {
-                return std::make_unique<T>(data, std::forward<Args>(args)...);
-            }
-
-            if (pattern)
-            {
-                return std::make_unique<T>(*pattern);
-            }
+            std::pmr::vector<Point> points{ ParseOptionsDetails::GetMemoryResource() };
+            json.ReadArray([&] {
+                Point point{};
+                json.ReadObject([&](const auto key) {
+                    if (key == "x") {
+                        point.x = json.ReadFloat();
+                    }
+                    else if (key == "y") {
+                        point.y = json.ReadFloat();
+                    }
+                });
+                points.push_back(point);
+            });
+
+            return points;
+        }
 
-            return {};
+        template <typename T, typename... Args>
+        ResourcePtr<T> ParsePrimitive(const tinyxml2::XMLElement *data, Args&&... args)
+        {
+            return data
+                ? NewObject<T>(ParseOptionsDetails::GetMemoryResource(), data,
+                    std::forward<Args>(args)...)
+                : nullptr;
         }
     }
 
     Object::Object()
         : properties{ nullptr }
+        , name{ &properties.strings->Intern({}) }
+        , type{ name }
     {
 
     }
@@ -116,23 +123,110 @@ namespace Tmx
     {
     }
 
-    Object::Object(const tinyxml2::XMLElement *data, const Tmx::Object *pattern)
-        : name{ GetAttribute(data, "name", pattern->name) }
-        , type{ GetAttribute(data, "type", pattern->type) }
-        , x{ data->IntAttribute("x", pattern->x) }
-        , y{ data->IntAttribute("y", pattern->y) }
-        , width{ data->IntAttribute("width", pattern->width) }
-        , height{ data->IntAttribute("height", pattern->height) }
+    Object::Object(const tinyxml2::XMLElement *data, std::shared_ptr<const Tmx::Object> pattern)
+        : Object{ data, pattern, GetDefaults(pattern.get()) }
+    {
+    }
+
+    Object::Object(const tinyxml2::XMLElement *data, std::shared_ptr<const Tmx::Object> pattern,
+        const Tmx::Object &defaults)
+        : properties{ data->FirstChildElement("properties") }
+        , name{ &properties.strings->Intern(GetAttribute(data, "name", *defaults.name)) }
+        , type{ &properties.strings->Intern(GetAttribute(data, "type", *defaults.type)) }
+        , x{ data->IntAttribute("x", defaults.x) }
+        , y{ data->IntAttribute("y", defaults.y) }
+        , width{ data->IntAttribute("width", defaults.width) }
+        , height{ data->IntAttribute("height", defaults.height) }
         , gid{ data->IntAttribute("gid") }
         , id{ data->IntAttribute("id") }
-        , rotation{ data->FloatAttribute("rotation", pattern->rotation) }
-        , visible{ data->BoolAttribute("visible", pattern->visible) }
-        , ellipse{ ParsePrimitive(data->FirstChildElement("ellipse"), pattern->ellipse.get(), x, y,
+        , rotation{ data->FloatAttribute("rotation", defaults.rotation) }
+        , visible{ data->BoolAttribute("visible", defaults.visible) }
+        , ellipse{ ParsePrimitive<Ellipse>(data->FirstChildElement("ellipse"), x, y,
             width, height) }
-        , polygon{ ParsePrimitive(data->FirstChildElement("polygon"), pattern->polygon.get()) }
-        , polyline{ ParsePrimitive(data->FirstChildElement("polyline"), pattern->polyline.get()) }
-        , text{ ParsePrimitive(data->FirstChildElement("text"), pattern->text.get()) }
-        , properties{ data->FirstChildElement("properties") }
+        , polygon{ ParsePrimitive<Polygon>(data->FirstChildElement("polygon")) }
+        , polyline{ ParsePrimitive<Polyline>(data->FirstChildElement("polyline")) }
+        , text{ ParsePrimitive<Text>(data->FirstChildElement("text")) }
+        , pattern{ std::move(pattern) }
     {
     }
+
+    Object::Object(JsonReader &json, Map *map)
+        : Object{ json, GetOrLoadPattern(map, json.FindString("template")) }
+    {
+    }
+
+    Object::Object(JsonReader &json, std::shared_ptr<const Tmx::Object> pattern)
+        : properties{ nullptr }
+        , pattern{ std::move(pattern) }
+    {
+        const auto &defaults = GetDefaults(this->pattern.get());
+        std::string nameText = *defaults.name;
+        std::string typeText = *defaults.type;
+        x = defaults.x;
+        y = defaults.y;
+        width = defaults.width;
+        height = defaults.height;
+        rotation = defaults.rotation;
+        visible = defaults.visible;
+
+        const auto resource = ParseOptionsDetails::GetMemoryResource();
+        bool isEllipse = false;
+        json.ReadObject([&](const auto key) {
+            if (key == "id") {
+                id = json.ReadInt();
+            }
+            else if (key == "name") {
+                nameText = json.ReadString();
+            }
+            else if (key == "type" || key == "class") {
+                typeText = json.ReadString();
+            }
+            else if (key == "x") {
+                x = json.ReadInt();
+            }
+            else if (key == "y") {
+                y = json.ReadInt();
+            }
+            else if (key == "width") {
+                width = json.ReadInt();
+            }
+            else if (key == "height") {
+                height = json.ReadInt();
+            }
+            else if (key == "gid") {
+                gid = static_cast<int>(json.ReadUnsigned());
+            }
+            else if (key == "rotation") {
+                rotation = json.ReadFloat();
+            }
+            else if (key == "visible") {
+                visible = json.ReadBool();
+            }
+            else if (key == "ellipse") {
+                isEllipse = json.ReadBool();
+            }
+            else if (key == "polygon") {
+                polygon = NewObject<Polygon>(resource, ReadPoints(json));
+            }
+            else if (key == "polyline") {
+                polyline = NewObject<Polyline>(resource, ReadPoints(json));
+            }
+            else if (key == "text") {
+                text = NewObject<Text>(resource, json);
+            }
+            else if (key == "properties") {
+                properties = PropertySet{ json };
+            }
+        });
+
+        // Interned once the properties, and so their pool, are read.
+        name = &properties.strings->Intern(nameText);
+        type = &properties.strings->Intern(typeText);
+
+        // The ellipse is made of the final bounds.
+        if (isEllipse)
+        {
+            ellipse = NewObject<Ellipse>(resource, nullptr, x, y, width, height);
+        }
+    }
 }
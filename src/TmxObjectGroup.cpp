@@ -28,6 +28,9 @@
 
 #include "TmxObjectGroup.h"
 
+#include "TmxJsonReader.h"
+#include "TmxParseOptions.h"
+
 namespace Tmx
 {
     namespace
@@ -40,10 +43,18 @@ namespace Tmx
 
         auto ParseObjects(const tinyxml2::XMLElement *data, Tmx::Map *map)
         {
-            std::vector<Tmx::Object> objects;
+            std::pmr::vector<Tmx::Object> objects{ ParseOptionsDetails::GetMemoryResource() };
 
             constexpr auto const object = "object";
 
+            // Growing the list would leave its old blocks unused in an arena.
+            std::size_t count = 0;
+            for (auto o = data->FirstChildElement(object); o; o = o->NextSiblingElement(object))
+            {
+                ++count;
+            }
+            objects.reserve(count);
+
             // Iterate through all of the object elements.
             for (auto o = data->FirstChildElement(object); o; o = o->NextSiblingElement(object))
             {
@@ -68,4 +79,31 @@ namespace Tmx
         , objects{ ParseObjects(data, map) }
     {
     }
+
+    ObjectGroup::ObjectGroup(Tmx::Map *_map, JsonReader &json)
+        : ObjectGroup{ _map, nullptr, json }
+    {
+    }
+
+    ObjectGroup::ObjectGroup(const Tmx::Tile *_tile, JsonReader &json)
+        : ObjectGroup{ nullptr, _tile, json }
+    {
+    }
+
+    ObjectGroup::ObjectGroup(Tmx::Map *_map, const Tmx::Tile *_tile, JsonReader &json)
+        : Layer{ _map, _tile, 0, 0, TMX_LAYERTYPE_OBJECTGROUP }
+        , objects{ ParseOptionsDetails::GetMemoryResource() }
+    {
+        json.ReadObject([&](const auto key) {
+            if (key == "color") {
+                color = Tmx::Color{ json.ReadString() };
+            }
+            else if (key == "objects") {
+                json.ReadArray([&] { objects.emplace_back(json, map); });
+            }
+            else {
+                ParseJsonMember(key, json);
+            }
+        });
+    }
 }
@@ -0,0 +1,162 @@
+//-----------------------------------------------------------------------------
+// TmxParseOptions.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include "TmxParseOptions.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include <tinyxml2.h>
+
+#include "TmxJsonReader.h"
+#include "TmxStringPool.h"
+
+namespace Tmx
+{
+    namespace
+    {
+        thread_local const ParseOptions *currentOptions = nullptr;
+        thread_local std::pmr::memory_resource *currentResource = nullptr;
+        thread_local const std::shared_ptr<StringPool> *currentStrings = nullptr;
+
+        // The layer type of a TMX element or of a JSON type, in which tile
+        // layers are called differently.
+        bool GetLayerType(std::string_view name, LayerType *type)
+        {
+            if (name == "layer" || name == "tilelayer") {
+                *type = TMX_LAYERTYPE_TILE;
+            }
+            else if (name == "objectgroup") {
+                *type = TMX_LAYERTYPE_OBJECTGROUP;
+            }
+            else if (name == "imagelayer") {
+                *type = TMX_LAYERTYPE_IMAGE_LAYER;
+            }
+            else if (name == "group") {
+                *type = TMX_LAYERTYPE_GROUP_LAYER;
+            }
+            else {
+                return false;
+            }
+
+            return true;
+        }
+    }
+
+    bool ParseOptions::IncludesLayer(std::string_view name, LayerType type) const
+    {
+        if (skipLayerTypes & type)
+        {
+            return false;
+        }
+
+        if (!layerNames.empty() && type != TMX_LAYERTYPE_GROUP_LAYER
+            && std::find(layerNames.begin(), layerNames.end(), name) == layerNames.end())
+        {
+            return false;
+        }
+
+        return !layerFilter || layerFilter(name, type);
+    }
+
+    bool ParseOptions::IncludesLayer(const tinyxml2::XMLElement *element) const
+    {
+        LayerType type;
+        if (!GetLayerType(element->Value(), &type))
+        {
+            return true;
+        }
+
+        const auto name = element->Attribute("name");
+        return IncludesLayer(name ? name : "", type);
+    }
+
+    bool ParseOptions::IncludesLayer(JsonReader &json, std::string_view type) const
+    {
+        LayerType layerType;
+        if (!GetLayerType(type, &layerType))
+        {
+            return true;
+        }
+
+        if (layerNames.empty() && !layerFilter)
+        {
+            return IncludesLayer("", layerType);
+        }
+
+        return IncludesLayer(json.FindString("name"), layerType);
+    }
+
+    namespace ParseOptionsDetails
+    {
+        const ParseOptions &GetCurrent()
+        {
+            static const ParseOptions defaults;
+            return currentOptions ? *currentOptions : defaults;
+        }
+
+        Scope::Scope(const ParseOptions &options)
+            : previous{ std::exchange(currentOptions, &options) }
+        {
+        }
+
+        Scope::~Scope()
+        {
+            currentOptions = previous;
+        }
+
+        std::pmr::memory_resource *GetMemoryResource()
+        {
+            return currentResource ? currentResource : std::pmr::new_delete_resource();
+        }
+
+        MemoryScope::MemoryScope(std::pmr::memory_resource *resource)
+            : previous{ std::exchange(currentResource, resource) }
+        {
+        }
+
+        MemoryScope::~MemoryScope()
+        {
+            currentResource = previous;
+        }
+    
+        std::shared_ptr<StringPool> GetStringPool()
+        {
+            return currentStrings ? *currentStrings : std::make_shared<StringPool>();
+        }
+
+        StringPoolScope::StringPoolScope(std::shared_ptr<StringPool> pool)
+            : strings{ pool ? std::move(pool) : std::make_shared<StringPool>() }
+            , previous{ std::exchange(currentStrings, &this->strings) }
+        {
+        }
+
+        StringPoolScope::~StringPoolScope()
+        {
+            currentStrings = previous;
+        }
+    }
+}
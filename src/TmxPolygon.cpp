@@ -28,6 +28,9 @@
 
 #include "TmxPolygon.h"
 
+#include <algorithm>
+
+#include "TmxParseOptions.h"
 #include "TmxUtil.h"
 
 namespace Tmx 
@@ -51,9 +54,18 @@ namespace Tmx
     }
 
     Polygon::Polygon(std::string_view data)
+        : points{ ParseOptionsDetails::GetMemoryResource() }
     {
+        // Growing the vector would leave its old blocks unused in an arena.
+        points.reserve(std::count(data.begin(), data.end(), ' ') + 1);
+
         Util::Iterate(data, ' ', [this](auto first, auto last) {
             points.push_back(ParsePoint(std::string_view{ first, last }));
         });
     }
+
+    Polygon::Polygon(std::pmr::vector<Point> points)
+        : points{ std::move(points) }
+    {
+    }
 }
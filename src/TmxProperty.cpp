@@ -28,10 +28,26 @@
 
 #include "TmxProperty.h"
 
+#include "TmxJsonReader.h"
+
 namespace Tmx
 {
     namespace
     {
+        PropertyType ParsePropertyType(std::string_view type)
+        {
+            return
+                type == "string" ? TMX_PROPERTY_STRING :
+                type == "bool"   ? TMX_PROPERTY_BOOL :
+                type == "float"  ? TMX_PROPERTY_FLOAT :
+                type == "int"    ? TMX_PROPERTY_INT :
+                type == "color"  ? TMX_PROPERTY_COLOR :
+                type == "file"   ? TMX_PROPERTY_FILE :
+                type == "object" ? TMX_PROPERTY_OBJECT :
+                type == "class"  ? TMX_PROPERTY_CLASS
+                                 : TMX_PROPERTY_STRING;
+        }
+
         PropertyType ParsePropertyType(const tinyxml2::XMLElement *data)
         {
             const auto typeAttribute = data->FindAttribute("type");
@@ -46,16 +62,7 @@ namespace Tmx
                 return TMX_PROPERTY_STRING;
             }
 
-            return
-                strcmp(typeAsCString, "string") == 0 ? TMX_PROPERTY_STRING :
-                strcmp(typeAsCString, "bool") == 0   ? TMX_PROPERTY_BOOL :
-                strcmp(typeAsCString, "float") == 0  ? TMX_PROPERTY_FLOAT :
-                strcmp(typeAsCString, "int") == 0    ? TMX_PROPERTY_INT :
-                strcmp(typeAsCString, "color") == 0  ? TMX_PROPERTY_COLOR :
-                strcmp(typeAsCString, "file") == 0   ? TMX_PROPERTY_FILE :
-                strcmp(typeAsCString, "object") == 0 ? TMX_PROPERTY_OBJECT :
-                strcmp(typeAsCString, "class") == 0  ? TMX_PROPERTY_CLASS
-                                                     : TMX_PROPERTY_STRING;
+            return ParsePropertyType(std::string_view{ typeAsCString });
         }
 
         std::string ParsePropertyValue(const tinyxml2::XMLElement *data)
@@ -134,4 +141,56 @@ namespace Tmx
             }
         }
     }
+
+    Property::Property(std::string_view typeName, JsonReader &json)
+        : type{ ParsePropertyType(typeName) }
+        , isEmpty{ false }
+    {
+        // JSON values carry their own type, only strings may be empty.
+        switch (type)
+        {
+            case TMX_PROPERTY_BOOL:
+            {
+                value = json.ReadBool();
+                break;
+            }
+
+            case TMX_PROPERTY_INT:
+            case TMX_PROPERTY_OBJECT:
+            {
+                value = json.ReadInt();
+                break;
+            }
+
+            case TMX_PROPERTY_FLOAT:
+            {
+                value = json.ReadFloat();
+                break;
+            }
+
+            case TMX_PROPERTY_COLOR:
+            {
+                const auto color = json.ReadString();
+                isEmpty = color.empty();
+                value = isEmpty ? Tmx::Color{} : Tmx::Color{ color };
+                break;
+            }
+
+            case TMX_PROPERTY_CLASS:
+            {
+                //TODO: implement
+                isEmpty = true;
+                json.Skip();
+                break;
+            }
+
+            default:
+            {
+                auto valueString = json.ReadString();
+                isEmpty = valueString.empty();
+                value = std::move(valueString);
+                break;
+            }
+        }
+    }
 }
@@ -29,14 +29,20 @@
 #include "TmxPropertySet.h"
 
 #include <cstdlib>
+#include <memory>
+#include <utility>
+
+#include "TmxJsonReader.h"
+#include "TmxParseOptions.h"
 
 namespace Tmx
 {
     namespace
     {
-        auto ParsePropertiesMap(const tinyxml2::XMLNode *node)
+        auto ParsePropertiesMap(const tinyxml2::XMLNode *node, StringPool &strings)
         {
-            std::unordered_map<std::string, Property> properties;
+            std::pmr::unordered_map<std::string_view, Property> properties{
+                ParseOptionsDetails::GetMemoryResource() };
             if (!node)
             {
                 return properties;
@@ -49,44 +55,113 @@ namespace Tmx
                 if (nameAttrib && nameAttrib->Value()[0] != 0)
                 {
                     // Read the attributes of the property and add it to the map
-                    properties.emplace(nameAttrib->Value(), Property{ n });
+                    properties.emplace(strings.Intern(nameAttrib->Value()), Property{ n });
                 }
             }
 
             return properties;
         }
 
-        auto AppendPatternProperties(std::unordered_map<std::string, Property> *properties,
-            const PropertySet *pattern)
+        auto ParsePropertiesMap(JsonReader &json, StringPool &strings)
+        {
+            std::pmr::unordered_map<std::string_view, Property> properties{
+                ParseOptionsDetails::GetMemoryResource() };
+
+            json.ReadArray([&] {
+                std::string name;
+                std::string type;
+                std::size_t valueAt = 0;
+
+                // The value is read once the type is known, whatever the order.
+                json.ReadObject([&](const auto key) {
+                    if (key == "name") {
+                        name = json.ReadString();
+                    }
+                    else if (key == "type") {
+                        type = json.ReadString();
+                    }
+                    else if (key == "value") {
+                        valueAt = json.Tell();
+                        json.Skip();
+                    }
+                });
+
+                if (!name.empty() && valueAt != 0)
+                {
+                    const auto end = json.Tell();
+                    json.Seek(valueAt);
+                    properties.emplace(strings.Intern(name), Property{ type, json });
+                    json.Seek(end);
+                }
+            });
+
+            return properties;
+        }
+
+        auto AppendPatternProperties(std::pmr::unordered_map<std::string_view, Property> *properties,
+            const PropertySet *pattern, StringPool &strings)
         {
             if (!pattern || !properties)
             {
                 return;
             }
 
+            // The names of the pattern are in the pool of its own map.
             for (const auto &p : pattern->GetPropertyMap())
             {
                 if (!properties->contains(p.first))
                 {
-                    properties->emplace(p.first, p.second);
+                    properties->emplace(strings.Intern(p.first), p.second);
                 }
             }
         }
 
-        auto ParsePropertiesMap(const tinyxml2::XMLNode *node, const PropertySet *pattern)
+        auto ParsePropertiesMap(const tinyxml2::XMLNode *node, const PropertySet *pattern,
+            StringPool &strings)
         {
-            auto properties = ParsePropertiesMap(node);
-            AppendPatternProperties(&properties, pattern);
+            auto properties = ParsePropertiesMap(node, strings);
+            AppendPatternProperties(&properties, pattern, strings);
             return properties;
         }
     }
 
     PropertySet::PropertySet(const tinyxml2::XMLNode *propertiesNode, const PropertySet *pattern)
-        : properties{ ParsePropertiesMap(propertiesNode, pattern) }
+        : strings{ ParseOptionsDetails::GetStringPool() }
+        , properties{ ParseOptionsDetails::GetMemoryResource() }
+    {
+        if (!ParseOptionsDetails::GetCurrent().skipProperties)
+        {
+            properties = ParsePropertiesMap(propertiesNode, pattern, *strings);
+        }
+    }
+
+    PropertySet::PropertySet(JsonReader &json, const PropertySet *pattern)
+        : strings{ ParseOptionsDetails::GetStringPool() }
+        , properties{ ParseOptionsDetails::GetMemoryResource() }
     {
+        if (ParseOptionsDetails::GetCurrent().skipProperties)
+        {
+            json.Skip();
+            return;
+        }
+
+        properties = ParsePropertiesMap(json, *strings);
+        AppendPatternProperties(&properties, pattern, *strings);
+    }
+
+    PropertySet &PropertySet::operator=(PropertySet &&other) noexcept
+    {
+        if (this != &other)
+        {
+            strings = std::move(other.strings);
+            std::destroy_at(&properties);
+            std::construct_at(&properties, std::move(other.properties));
+        }
+
+        return *this;
     }
 
-    std::string PropertySet::GetStringProperty(const std::string &name,
+    std::string PropertySet::GetStringProperty(std::string_view name,
         const std::string &defaultValue) const
     {
         const auto it = properties.find(name);
@@ -99,7 +174,7 @@ namespace Tmx
         return it->second.GetValue();
     }
 
-    int PropertySet::GetIntProperty(const std::string &name, int defaultValue) const
+    int PropertySet::GetIntProperty(std::string_view name, int defaultValue) const
     {
         const auto it = properties.find(name);
 
@@ -111,7 +186,7 @@ namespace Tmx
         return it->second.GetIntValue();
     }
 
-    float PropertySet::GetFloatProperty(const std::string &name, float defaultValue) const
+    float PropertySet::GetFloatProperty(std::string_view name, float defaultValue) const
     {
         const auto it = properties.find(name);
 
@@ -123,7 +198,7 @@ namespace Tmx
         return it->second.GetFloatValue();
     }
 
-    bool PropertySet::GetBoolProperty(const std::string &name, bool defaultValue) const
+    bool PropertySet::GetBoolProperty(std::string_view name, bool defaultValue) const
     {
         const auto it = properties.find(name);
 
@@ -135,7 +210,7 @@ namespace Tmx
         return it->second.GetBoolValue();
     }
 
-    Tmx::Color PropertySet::GetColorProperty(const std::string &name,
+    Tmx::Color PropertySet::GetColorProperty(std::string_view name,
         const Tmx::Color &defaultValue) const
     {
         const auto it = properties.find(name);
@@ -148,12 +223,12 @@ namespace Tmx
         return it->second.GetColorValue(defaultValue);
     }
 
-    bool PropertySet::HasProperty(const std::string &name) const
+    bool PropertySet::HasProperty(std::string_view name) const
     {
         return properties.contains(name);
     }
 
-    const std::unordered_map<std::string, Property> &PropertySet::GetPropertyMap() const
+    const std::pmr::unordered_map<std::string_view, Property> &PropertySet::GetPropertyMap() const
     {
         return properties;
     }
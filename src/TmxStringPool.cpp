@@ -0,0 +1,61 @@
+//-----------------------------------------------------------------------------
+// TmxStringPool.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include "TmxStringPool.h"
+
+namespace Tmx
+{
+    namespace
+    {
+        // The empty string is so common it is not worth a lookup.
+        const std::string &GetEmpty()
+        {
+            static const std::string empty;
+            return empty;
+        }
+    }
+
+    const std::string &StringPool::Intern(std::string_view text)
+    {
+        if (text.empty())
+        {
+            return GetEmpty();
+        }
+
+        const auto it = strings.find(text);
+        return it != strings.end() ? *it : *strings.emplace(text).first;
+    }
+
+    const std::string *StringPool::Find(std::string_view text) const
+    {
+        if (text.empty())
+        {
+            return &GetEmpty();
+        }
+
+        const auto it = strings.find(text);
+        return it != strings.end() ? &*it : nullptr;
+    }
+}
@@ -0,0 +1,137 @@
+//-----------------------------------------------------------------------------
+// TmxTemplateCache.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+
+#include "TmxTemplateCache.h"
+
+#include <filesystem>
+
+#include <tinyxml2.h>
+
+#include "TmxObject.h"
+#include "TmxParseOptions.h"
+
+namespace Tmx
+{
+    namespace
+    {
+        std::shared_ptr<const Object> LoadTemplate(const std::string &fileName)
+        {
+            // Templates are shared between maps, so they never go in the
+            // memory or the string pool of the map that loads them first.
+            const ParseOptionsDetails::MemoryScope heap{ std::pmr::new_delete_resource() };
+            const ParseOptionsDetails::StringPoolScope strings;
+
+            tinyxml2::XMLDocument doc;
+            doc.LoadFile(fileName.c_str());
+
+            if (doc.Error())
+            {
+                return nullptr;
+            }
+
+            const auto templateElement = doc.FirstChildElement("template");
+            const auto objectElement = templateElement
+                ? templateElement->FirstChildElement("object")
+                : nullptr;
+
+            return objectElement
+                ? std::make_shared<const Object>(objectElement, nullptr)
+                : nullptr;
+        }
+    }
+
+    std::shared_ptr<const Object> TemplateCache::FindOrLoad(const std::string &fileName)
+    {
+        std::error_code error;
+        const auto canonical = std::filesystem::canonical(fileName, error);
+        if (error)
+        {
+            return nullptr;
+        }
+
+        const auto lastWriteTime = std::filesystem::last_write_time(canonical, error);
+        if (error)
+        {
+            return nullptr;
+        }
+
+        const auto key = canonical.string();
+
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+
+            const auto it = templates.find(key);
+            if (it != templates.end() && it->second.lastWriteTime == lastWriteTime)
+            {
+                ++hits;
+                return it->second.pattern;
+            }
+        }
+
+        // Parse outside of the lock, other maps may be loading meanwhile.
+        auto pattern = LoadTemplate(key);
+        if (!pattern)
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock{ mutex };
+        ++misses;
+
+        // Another thread may have stored the same version meanwhile; all
+        // callers share the one that came first.
+        auto &cached = templates[key];
+        if (!cached.pattern || cached.lastWriteTime != lastWriteTime)
+        {
+            cached = CachedTemplate{ lastWriteTime, std::move(pattern) };
+        }
+        return cached.pattern;
+    }
+
+    std::size_t TemplateCache::GetHits() const
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        return hits;
+    }
+
+    std::size_t TemplateCache::GetMisses() const
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        return misses;
+    }
+
+    std::size_t TemplateCache::GetSize() const
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        return templates.size();
+    }
+
+    void TemplateCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        templates.clear();
+    }
+}
@@ -28,6 +28,8 @@
 
 #include "TmxText.h"
 
+#include "TmxJsonReader.h"
+
 #include "TmxUtil.h"
 
 namespace Tmx
@@ -69,4 +71,56 @@ namespace Tmx
         , vertical_alignment{ Util::ParseOrDefault(data, "valign", &ParseVerticalAlignment) }
     {
     }
+
+    Text::Text(JsonReader &json)
+        : font_family{ "sans-serif" }
+        , pixel_size{ 16 }
+        , wrap{ false }
+        , bold{ false }
+        , italic{ false }
+        , underline{ false }
+        , strikeout{ false }
+        , kerning{ true }
+        , horizontal_alignment{ LEFT }
+        , vertical_alignment{ TOP }
+    {
+        json.ReadObject([&](const auto key) {
+            if (key == "text") {
+                contents = json.ReadString();
+            }
+            else if (key == "fontfamily") {
+                font_family = json.ReadString();
+            }
+            else if (key == "pixelsize") {
+                pixel_size = json.ReadInt();
+            }
+            else if (key == "wrap") {
+                wrap = json.ReadBool();
+            }
+            else if (key == "color") {
+                color = Color{ json.ReadString() };
+            }
+            else if (key == "bold") {
+                bold = json.ReadBool();
+            }
+            else if (key == "italic") {
+                italic = json.ReadBool();
+            }
+            else if (key == "underline") {
+                underline = json.ReadBool();
+            }
+            else if (key == "strikeout") {
+                strikeout = json.ReadBool();
+            }
+            else if (key == "kerning") {
+                kerning = json.ReadBool();
+            }
+            else if (key == "halign") {
+                horizontal_alignment = ParseHorizontalAlignment(json.ReadString());
+            }
+            else if (key == "valign") {
+                vertical_alignment = ParseVerticalAlignment(json.ReadString());
+            }
+        });
+    }
 }
@@ -0,0 +1,237 @@
+//-----------------------------------------------------------------------------
+// TmxThreadPool.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+
+#include "TmxThreadPool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace Tmx
+{
+    namespace
+    {
+        // The pool and queue the current thread works for, if it is a worker.
+        thread_local const ThreadPool *currentPool{ nullptr };
+        thread_local std::size_t currentQueue{ 0 };
+
+        // Shared between the caller of ParallelFor and the tasks it queued,
+        // as a task may only start after the caller has returned.
+        struct ParallelForState
+        {
+            std::atomic<std::size_t> next{ 0 };
+            std::size_t count{ 0 };
+            const std::function<void(std::size_t)> *fn{ nullptr };
+
+            std::mutex mutex;
+            std::condition_variable finished;
+            std::size_t done{ 0 };
+
+            // The first exception thrown by fn, rethrown to the caller. The
+            // indices left are counted as done without calling fn.
+            std::exception_ptr error;
+            std::atomic<bool> failed{ false };
+
+            void Work()
+            {
+                std::size_t completed = 0;
+                for (auto i = next++; i < count; i = next++)
+                {
+                    if (!failed.load(std::memory_order_relaxed))
+                    {
+                        try
+                        {
+                            (*fn)(i);
+                        }
+                        catch (...)
+                        {
+                            std::lock_guard<std::mutex> lock{ mutex };
+                            if (!error)
+                            {
+                                error = std::current_exception();
+                            }
+                            failed = true;
+                        }
+                    }
+                    ++completed;
+                }
+
+                if (completed != 0)
+                {
+                    std::lock_guard<std::mutex> lock{ mutex };
+                    done += completed;
+                    if (done == count)
+                    {
+                        finished.notify_all();
+                    }
+                }
+            }
+        };
+    }
+
+    ThreadPool::ThreadPool(unsigned numThreads)
+    {
+        if (numThreads == 0)
+        {
+            numThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        queues.reserve(numThreads);
+        for (unsigned i = 0; i < numThreads; ++i)
+        {
+            queues.push_back(std::make_unique<Queue>());
+        }
+
+        workers.reserve(numThreads);
+        for (unsigned i = 0; i < numThreads; ++i)
+        {
+            workers.emplace_back([this, i] { Run(i); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            stopping = true;
+        }
+
+        wakeUp.notify_all();
+        for (auto &w : workers)
+        {
+            w.join();
+        }
+    }
+
+    void ThreadPool::Submit(std::function<void()> task)
+    {
+        // Workers keep their own tasks close, others spread them round robin.
+        const auto index = currentPool == this
+            ? currentQueue
+            : nextQueue++ % queues.size();
+
+        {
+            auto &queue = *queues[index];
+            std::lock_guard<std::mutex> lock{ queue.mutex };
+            queue.tasks.push_back(std::move(task));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            ++queued;
+        }
+
+        wakeUp.notify_one();
+    }
+
+    void ThreadPool::ParallelFor(std::size_t count, const std::function<void(std::size_t)> &fn)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        auto state = std::make_shared<ParallelForState>();
+        state->count = count;
+        state->fn = &fn;
+
+        // Tasks that start once every index is taken return without touching fn.
+        const auto helpers = std::min<std::size_t>(workers.size(), count - 1);
+        for (std::size_t i = 0; i < helpers; ++i)
+        {
+            Submit([state] { state->Work(); });
+        }
+
+        state->Work();
+
+        std::unique_lock<std::mutex> lock{ state->mutex };
+        state->finished.wait(lock, [&] { return state->done == state->count; });
+
+        if (state->error)
+        {
+            std::rethrow_exception(state->error);
+        }
+    }
+
+    bool ThreadPool::TryPop(std::size_t index, std::function<void()> *task)
+    {
+        // Newest first from the own queue, to stay on warm data.
+        {
+            auto &own = *queues[index];
+            std::lock_guard<std::mutex> lock{ own.mutex };
+            if (!own.tasks.empty())
+            {
+                *task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        // Oldest first from the others, as those tend to be the largest.
+        for (std::size_t i = 1; i < queues.size(); ++i)
+        {
+            auto &victim = *queues[(index + i) % queues.size()];
+            std::lock_guard<std::mutex> lock{ victim.mutex };
+            if (!victim.tasks.empty())
+            {
+                *task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::Run(std::size_t index)
+    {
+        currentPool = this;
+        currentQueue = index;
+
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock{ mutex };
+                wakeUp.wait(lock, [this] { return stopping || queued != 0; });
+
+                if (queued == 0)
+                {
+                    return;
+                }
+
+                // Claim one task; it is in one of the queues until taken below.
+                --queued;
+            }
+
+            std::function<void()> task;
+            while (!TryPop(index, &task))
+            {
+                std::this_thread::yield();
+            }
+
+            task();
+        }
+    }
+}
@@ -28,7 +28,9 @@
 
 #include "TmxTile.h"
 
+#include "TmxJsonReader.h"
 #include "TmxObject.h"
+#include "TmxParseOptions.h"
 
 namespace Tmx
 {
@@ -46,7 +48,7 @@ namespace Tmx
             std::vector<AnimationFrame> result;
 
             const auto animation = data->FirstChildElement("animation");
-            if (!animation)
+            if (!animation || ParseOptionsDetails::GetCurrent().skipTileAnimations)
             {
                 return result;
             }
@@ -71,7 +73,7 @@ namespace Tmx
             const tinyxml2::XMLElement *data)
         {
             const auto objectGroup = data->FirstChildElement("objectgroup");
-            if (!objectGroup)
+            if (!objectGroup || ParseOptionsDetails::GetCurrent().skipTileCollisions)
             {
                 return nullptr;
             }
@@ -98,6 +100,63 @@ namespace Tmx
     {
     }
 
+    Tile::Tile(JsonReader &json)
+        : properties{ nullptr }
+    {
+        const auto &options = ParseOptionsDetails::GetCurrent();
+        std::string imageSource;
+        int imageWidth = 0;
+        int imageHeight = 0;
+
+        json.ReadObject([&](const auto key) {
+            if (key == "id") {
+                id = json.ReadInt();
+            }
+            else if (key == "type" || key == "class") {
+                type = json.ReadString();
+            }
+            else if (key == "properties") {
+                properties = PropertySet{ json };
+            }
+            else if (key == "animation" && !options.skipTileAnimations) {
+                isAnimated = true;
+                json.ReadArray([&] {
+                    AnimationFrame frame;
+                    json.ReadObject([&](const auto frameKey) {
+                        if (frameKey == "tileid") {
+                            frame = AnimationFrame{ json.ReadInt(), frame.GetDuration() };
+                        }
+                        else if (frameKey == "duration") {
+                            frame = AnimationFrame{ frame.GetTileID(), json.ReadUnsigned() };
+                        }
+                    });
+                    frames.push_back(frame);
+                    totalDuration += frame.GetDuration();
+                });
+            }
+            else if (key == "objectgroup" && !options.skipTileCollisions) {
+                objectGroup = std::make_unique<ObjectGroup>(this, json);
+            }
+            else if (key == "image") {
+                imageSource = json.ReadString();
+            }
+            else if (key == "imagewidth") {
+                imageWidth = json.ReadInt();
+            }
+            else if (key == "imageheight") {
+                imageHeight = json.ReadInt();
+            }
+        });
+
+        hasObjects = objectGroup && objectGroup->GetNumObjects() > 0;
+
+        if (!imageSource.empty())
+        {
+            image = std::make_unique<Image>(std::move(imageSource), imageWidth, imageHeight,
+                Tmx::Color{});
+        }
+    }
+
     int Tile::GetFrameCount() const
     {
         return static_cast<int>(frames.size());
@@ -25,17 +25,15 @@
 #include "TmxTileLayer.h"
 
 #include <algorithm>
-#include <cassert>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <type_traits>
 
-#ifdef USE_MINIZ
-#define MINIZ_HEADER_FILE_ONLY
-#include "miniz.c"
-#else
-#include <zlib.h>
-#endif
-
+#include "TmxDecompressor.h"
+#include "TmxJsonReader.h"
 #include "TmxLayer.h"
 #include "TmxUtil.h"
 #include "TmxMap.h"
@@ -43,7 +41,190 @@
 
 namespace Tmx 
 {
-    TileLayer::TileLayer(Map *_map, const tinyxml2::XMLElement *data)
+    namespace
+    {
+        // The text of the element, without copying it.
+        std::string_view GetTextView(const tinyxml2::XMLElement *dataElem)
+        {
+            const auto text = dataElem->GetText();
+            return text ? std::string_view{ text } : std::string_view{};
+        }
+
+        // The encoded text of a layer to decode later, see below.
+        std::string ReadPayload(std::string_view dataText, TileLayerEncodingType encoding)
+        {
+            std::string text{ dataText };
+            return encoding == TMX_ENCODING_BASE64 ? Util::Trim(text) : text;
+        }
+
+        // The encoded data of a layer or chunk to decode later. Tiles stored as
+        // XML elements are turned into csv so that the elements can go.
+        std::string ReadPayload(const tinyxml2::XMLElement *dataElem,
+            TileLayerEncodingType encoding)
+        {
+            if (encoding != TMX_ENCODING_XML)
+            {
+                return ReadPayload(GetTextView(dataElem), encoding);
+            }
+
+            std::string csv;
+            Util::IterateChildren(dataElem, "tile", [&csv](const auto tile) {
+                const auto gid = tile->Attribute("gid");
+                csv += gid ? gid : "0";
+                csv += ',';
+            });
+
+            if (!csv.empty())
+            {
+                csv.pop_back();
+            }
+
+            return csv;
+        }
+
+        // Writes the decompressed gids to out, which has room for outSize bytes.
+        // Returns the number of bytes written, none if the data is not valid.
+        size_t Decompress(const Decompressor &decompressor, TileLayerCompressionType compression,
+            const char *data, size_t size, char *out, size_t outSize)
+        {
+            std::ptrdiff_t written = 0;
+            switch (compression)
+            {
+            case TMX_COMPRESSION_ZLIB:
+                written = decompressor.DecompressZlib(data, size, out, outSize);
+                break;
+
+            case TMX_COMPRESSION_GZIP:
+                written = decompressor.DecompressGzip(data, size, out, outSize);
+                break;
+
+            case TMX_COMPRESSION_ZSTD:
+                written = decompressor.DecompressZstd(data, size, out, outSize);
+                break;
+
+            default:
+                written = static_cast<std::ptrdiff_t>(std::min(size, outSize));
+                std::memcpy(out, data, written);
+                break;
+            }
+
+            return static_cast<size_t>(std::max<std::ptrdiff_t>(written, 0));
+        }
+
+        MapTile ResolveTile(const TilesetLookup &lookup, unsigned gid)
+        {
+            const auto tilesetIndex = lookup.FindIndex(gid);
+            return MapTile{ gid, lookup.GetFirstGid(tilesetIndex),
+                static_cast<unsigned>(tilesetIndex) };
+        }
+
+        // Turns the gids at the start of the memory of count tiles into the
+        // tiles. A MapTile is four times the size of a gid, so they are made
+        // from the last one back and no gid is overwritten before it is read.
+        void MakeTiles(const Map &map, MapTile *tiles, size_t count)
+        {
+            const auto gids = reinterpret_cast<const char *>(tiles);
+            const auto &lookup = map.GetTilesetLookup();
+            for (auto i = count; i-- > 0;)
+            {
+                unsigned gid;
+                std::memcpy(&gid, gids + i * 4, sizeof gid);
+                tiles[i] = ResolveTile(lookup, gid);
+            }
+        }
+
+        // Layers of gids keep them as they are.
+        void MakeTiles(const Map &, std::uint32_t *, size_t)
+        {
+        }
+
+        // Copies the raw gids of count cells from x on of a row holding the
+        // cells from 0 to its size. Cells out of it are 0.
+        template <typename Cell>
+        void CopyRow(std::span<const Cell> row, std::int64_t x, std::int64_t count,
+            std::uint32_t *out)
+        {
+            const auto begin = std::clamp<std::int64_t>(-x, 0, count);
+            const auto end = std::clamp<std::int64_t>(static_cast<std::int64_t>(row.size()) - x,
+                begin, count);
+
+            std::fill(out, out + begin, 0u);
+            if (end > begin)
+            {
+                const auto cells = row.data() + (x + begin);
+                if constexpr (std::is_same_v<Cell, std::uint32_t>)
+                {
+                    std::memcpy(out + begin, cells, (end - begin) * sizeof(std::uint32_t));
+                }
+                else
+                {
+                    std::transform(cells, cells + (end - begin), out + begin,
+                        [](const MapTile &tile) { return tile.GetRawGid(); });
+                }
+            }
+            std::fill(out + end, out + count, 0u);
+        }
+
+        std::uint32_t Length(const TileRun &run)
+        {
+            return run.length;
+        }
+
+        std::uint32_t Length(const TileCell &)
+        {
+            return 1;
+        }
+
+        // The gid of the cell at column x of a row of runs or cells.
+        template <typename Cell>
+        std::uint32_t FindInRow(std::span<const Cell> row, std::uint32_t x)
+        {
+            const auto it = std::upper_bound(row.begin(), row.end(), x,
+                [](std::uint32_t x, const Cell &cell) { return x < cell.x; });
+            return it != row.begin() && x - std::prev(it)->x < Length(*std::prev(it))
+                ? std::prev(it)->gid : 0;
+        }
+
+        // As CopyRow, for a row of runs or cells.
+        template <typename Cell>
+        void CopyPackedRow(std::span<const Cell> row, std::int64_t x, std::int64_t count,
+            std::uint32_t *out)
+        {
+            std::fill(out, out + count, 0u);
+
+            // Skip the cells left of the region, then fill in up to its end.
+            const auto cellEnd = [](const Cell &cell) {
+                return static_cast<std::int64_t>(cell.x) + Length(cell);
+            };
+            auto it = std::partition_point(row.begin(), row.end(),
+                [&](const Cell &cell) { return cellEnd(cell) <= x; });
+            for (; it != row.end() && it->x < x + count; ++it)
+            {
+                const auto begin = std::max<std::int64_t>(it->x, x) - x;
+                const auto end = std::min(cellEnd(*it), x + count) - x;
+                std::fill(out + begin, out + end, it->gid);
+            }
+        }
+
+        MapTile EmptyTile()
+        {
+            return MapTile{ 0, 0, static_cast<unsigned>(-1) };
+        }
+
+        // Rounds towards negative infinity, for chunks left of and above the origin.
+        int FloorDiv(int a, int b)
+        {
+            return a / b - (a % b != 0 && (a < 0) != (b < 0));
+        }
+
+        std::uint64_t ChunkKey(int chunkX, int chunkY)
+        {
+            return static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunkX)) << 32
+                | static_cast<std::uint32_t>(chunkY);
+        }
+    }
+
+    TileLayer::TileLayer(Map *_map, const tinyxml2::XMLElement *data, std::string_view dataText)
         : Layer{ _map, data->IntAttribute("x"), data->IntAttribute("y"),
             _map->GetWidth(), _map->GetHeight(), TMX_LAYERTYPE_TILE, data }
         , encoding(TMX_ENCODING_XML)
@@ -51,9 +232,6 @@ namespace Tmx
         , offsetX{ data->FloatAttribute("offsetx") }
         , offsetY{ data->FloatAttribute("offsety") }
     {
-        // Allocate memory for reading the tiles.
-        tile_map.reserve(width * height);
-
         const tinyxml2::XMLElement *dataElem = data->FirstChildElement("data");
 
         // Check for encoding.
@@ -70,136 +248,674 @@ namespace Tmx
         {
             compression =
                 strcmp(compressionStr, "gzip") == 0 ? TMX_COMPRESSION_GZIP :
-                strcmp(compressionStr, "zlib") == 0 ? TMX_COMPRESSION_ZLIB
+                strcmp(compressionStr, "zlib") == 0 ? TMX_COMPRESSION_ZLIB :
+                strcmp(compressionStr, "zstd") == 0 ? TMX_COMPRESSION_ZSTD
                                                     : compression;
         }
-        
-        // Decode.
-        switch (encoding)
+
+        // Layers of infinite maps come in chunks, the first one sets the grid.
+        if (const auto chunk = dataElem->FirstChildElement("chunk"))
         {
-        case TMX_ENCODING_XML:
-            ParseXML(dataElem);
-            break;
+            chunk_width = std::max(1, chunk->IntAttribute("width", 16));
+            chunk_height = std::max(1, chunk->IntAttribute("height", 16));
+        }
+        else
+        {
+            storage = requested_storage = map->GetParseOptions().tileStorage;
+        }
 
-        case TMX_ENCODING_BASE64:
-            ParseBase64(dataElem->GetText());
-            break;
+        // Keep only the encoded data until the tiles are asked for.
+        if (map->GetParseOptions().lazyDecode)
+        {
+            lazy = std::make_unique<LazyData>();
+            if (IsChunked())
+            {
+                Util::IterateChildren(dataElem, "chunk", [this](const auto chunk) {
+                    lazy->chunks.push_back(EncodedChunk{
+                        chunk->IntAttribute("x"), chunk->IntAttribute("y"),
+                        chunk->IntAttribute("width"), chunk->IntAttribute("height"),
+                        ReadPayload(chunk, encoding) });
+                });
+            }
+            else
+            {
+                lazy->payload = dataText.empty()
+                    ? ReadPayload(dataElem, encoding) : ReadPayload(dataText, encoding);
+            }
+            return;
+        }
 
-        case TMX_ENCODING_CSV:
-            ParseCSV(dataElem->GetText());
-            break;
+        // Leave the work to the map if it decodes its layers side by side.
+        if (map->GetParseOptions().decodeThreads != 1)
+        {
+            pending_data = dataElem;
+            pending_text = dataText;
+            return;
         }
+
+        DecodeData(dataElem, dataText);
     }
 
-    void TileLayer::ParseXML(const tinyxml2::XMLNode *data) 
+    TileLayer::TileLayer(Map *_map, JsonReader &json)
+        : Layer{ _map, nullptr, _map->GetWidth(), _map->GetHeight(), TMX_LAYERTYPE_TILE }
+        , requested_storage{ _map->GetParseOptions().tileStorage }
+        , storage{ requested_storage }
+        , encoding(TMX_ENCODING_CSV)
+        , compression(TMX_COMPRESSION_NONE)
     {
-        for (auto tile = data->FirstChildElement("tile"); tile;
-            tile = tile->NextSiblingElement("tile"))
+        // Base64 data can only be decoded once the compression is known,
+        // which Tiled writes after the data.
+        std::string payload;
+        std::vector<EncodedChunk> encodedChunks;
+
+        const auto readChunk = [&] {
+            EncodedChunk chunk{};
+            std::vector<MapTile> tiles;
+
+            json.ReadObject([&](const auto key) {
+                if (key == "data") {
+                    if (json.Peek() == TMX_JSON_STRING) {
+                        chunk.payload = json.ReadString();
+                    }
+                    else {
+                        ParseJsonArray(json, tiles);
+                    }
+                }
+                else if (key == "x") {
+                    chunk.x = json.ReadInt();
+                }
+                else if (key == "y") {
+                    chunk.y = json.ReadInt();
+                }
+                else if (key == "width") {
+                    chunk.width = json.ReadInt();
+                }
+                else if (key == "height") {
+                    chunk.height = json.ReadInt();
+                }
+            });
+
+            // The first chunk sets the grid.
+            if (!IsChunked())
+            {
+                chunk_width = std::max(1, chunk.width);
+                chunk_height = std::max(1, chunk.height);
+            }
+
+            if (chunk.payload.empty())
+            {
+                AddChunk(chunk.x, chunk.y, chunk.width, chunk.height, std::move(tiles));
+            }
+            else
+            {
+                encodedChunks.push_back(std::move(chunk));
+            }
+        };
+
+        json.ReadObject([&](const auto key) {
+            if (key == "data") {
+                if (json.Peek() == TMX_JSON_STRING) {
+                    payload = json.ReadString();
+                }
+                else if (HasTiles()) {
+                    tile_map.reserve(static_cast<std::size_t>(width) * height);
+                    ParseJsonArray(json, tile_map);
+                }
+                else {
+                    gids.reserve(static_cast<std::size_t>(width) * height);
+                    ParseJsonArray(json, gids);
+                }
+            }
+            else if (key == "chunks") {
+                json.ReadArray(readChunk);
+            }
+            else if (key == "encoding") {
+                encoding = json.ReadString() == "base64" ? TMX_ENCODING_BASE64 : TMX_ENCODING_CSV;
+            }
+            else if (key == "compression") {
+                const auto compressionStr = json.ReadString();
+                compression =
+                    compressionStr == "gzip" ? TMX_COMPRESSION_GZIP :
+                    compressionStr == "zlib" ? TMX_COMPRESSION_ZLIB :
+                    compressionStr == "zstd" ? TMX_COMPRESSION_ZSTD
+                                             : TMX_COMPRESSION_NONE;
+            }
+            else if (key == "offsetx") {
+                Layer::offsetX = offsetX = json.ReadFloat();
+            }
+            else if (key == "offsety") {
+                Layer::offsetY = offsetY = json.ReadFloat();
+            }
+            else {
+                ParseJsonMember(key, json);
+            }
+        });
+
+        // Chunks are always kept as MapTiles.
+        if (IsChunked())
         {
-            // Convert to an unsigned.
-            const auto gid = std::strtoul(tile->Attribute("gid"), nullptr, 10);
+            storage = requested_storage = TMX_STORAGE_TILES;
+        }
 
-            // Find the tileset index.
-            const int tilesetIndex = map->FindTilesetIndex(gid);
-            if (tilesetIndex != -1)
+        if (!payload.empty())
+        {
+            if (HasTiles())
             {
-                // If valid, set up the map tile with the tileset.
-                const Tmx::Tileset* tileset = map->GetTileset(tilesetIndex);
-                tile_map.emplace_back(gid, tileset->GetFirstGid(), tilesetIndex);
+                DecodeText(payload, width * height, tile_map);
             }
             else
             {
-                // Otherwise, make it null.
-                tile_map.emplace_back(gid, 0, -1);
+                DecodeText(payload, width * height, gids);
             }
         }
+
+        if (!IsChunked() && !HasTiles())
+        {
+            Pack();
+        }
+
+        for (const auto &chunk : encodedChunks)
+        {
+            std::vector<MapTile> tiles;
+            tiles.reserve(static_cast<std::size_t>(chunk.width) * chunk.height);
+            DecodeText(chunk.payload, chunk.width * chunk.height, tiles);
+            AddChunk(chunk.x, chunk.y, chunk.width, chunk.height, std::move(tiles));
+        }
     }
 
-    void TileLayer::ParseBase64(std::string innerText) 
+    void TileLayer::Decode() const
     {
-    	Util::Trim(innerText);
-
-        const std::string &text = Util::DecodeBase64(innerText);
+        if (!lazy)
+        {
+            return;
+        }
 
-        // Temporary array of gids to be converted to map tiles.
-        unsigned *out = 0;
+        std::lock_guard<std::mutex> lock{ lazy->mutex };
+        if (!lazy->decoded.load(std::memory_order_relaxed))
+        {
+            DecodePayload();
+            lazy->decoded.store(true, std::memory_order_release);
+        }
+    }
 
-        if (compression == TMX_COMPRESSION_ZLIB) 
+    void TileLayer::Release() const
+    {
+        if (!lazy)
         {
-            // Use zlib to uncompress the tile layer into the temporary array of tiles.
-            uLongf outlen = width * height * 4;
-            out = (unsigned *)malloc(outlen);
-            uncompress(
-                (Bytef*)out, &outlen, 
-                (const Bytef*)text.c_str(), text.size());
-    
-        } 
-        else if (compression == TMX_COMPRESSION_GZIP) 
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock{ lazy->mutex };
+        lazy->decoded.store(false, std::memory_order_release);
+        std::vector<MapTile>{}.swap(tile_map);
+        std::vector<std::uint32_t>{}.swap(gids);
+        std::vector<TileRun>{}.swap(runs);
+        std::vector<TileCell>{}.swap(cells);
+        std::vector<std::uint32_t>{}.swap(row_starts);
+        std::unordered_map<std::uint64_t, TileChunk>{}.swap(chunks);
+    }
+
+    std::optional<MapTile> TileLayer::FindTile(int x, int y) const
+    {
+        if (IsChunked())
         {
-            // Use the utility class for decompressing (which uses zlib)
-            out = (unsigned *)Util::DecompressGZIP(
-                text.c_str(), 
-                text.size(), 
-                width * height * 4);
-        } 
-        else 
+            const auto chunk = FindChunk(x, y);
+            return chunk ? std::optional{ chunk->GetTile(x, y) } : std::nullopt;
+        }
+
+        EnsureDecoded();
+        const auto size =
+            storage == TMX_STORAGE_TILES ? tile_map.size() :
+            storage == TMX_STORAGE_GIDS  ? gids.size()
+                                         : static_cast<std::size_t>(width) * height;
+        const auto index = static_cast<std::size_t>(y) * width + x;
+        return x >= 0 && y >= 0 && x < width && y < height && index < size
+            ? std::optional{ GetTile(static_cast<int>(index)) }
+            : std::nullopt;
+    }
+
+    void TileLayer::CopyRegion(const TileRect &rect, std::uint32_t *dst, std::size_t stride) const
+    {
+        // The rows below count on a positive width.
+        if (rect.width <= 0 || rect.height <= 0)
         {
-            out = (unsigned *)malloc(text.size());
-        
-            // Copy every gid into the temporary array since
-            // the decoded string is an array of 32-bit integers.
-            memcpy(out, text.c_str(), text.size());
+            return;
         }
 
-        assert(out);
+        EnsureDecoded();
 
-        // Convert the gids to map tiles.
-        for (int y = 0; y < height; y++)
+        for (int j = 0; j < rect.height; ++j)
         {
-            for (int x = 0; x < width; x++)
+            const auto out = dst + j * stride;
+            const auto y = rect.y + j;
+            if (!IsChunked())
             {
-                unsigned gid = out[y * width + x];
+                switch (storage)
+                {
+                case TMX_STORAGE_TILES:
+                    CopyRow(Row(std::span<const MapTile>{ tile_map }, y), rect.x, rect.width, out);
+                    break;
 
-                // Find the tileset index.
-                const int tilesetIndex = map->FindTilesetIndex(gid);
-                if (tilesetIndex != -1)
+                case TMX_STORAGE_GIDS:
+                    CopyRow(Row(std::span<const std::uint32_t>{ gids }, y), rect.x, rect.width, out);
+                    break;
+
+                case TMX_STORAGE_RUNS:
+                    CopyPackedRow(PackedRow(runs, y), rect.x, rect.width, out);
+                    break;
+
+                default:
+                    CopyPackedRow(PackedRow(cells, y), rect.x, rect.width, out);
+                    break;
+                }
+                continue;
+            }
+
+            // A piece of the row for each chunk it crosses.
+            const auto chunkY = FloorDiv(y, chunk_height);
+            for (std::int64_t i = 0; i < rect.width;)
+            {
+                const auto x = static_cast<int>(rect.x + i);
+                const auto chunkX = FloorDiv(x, chunk_width);
+                const auto end = std::min<std::int64_t>(rect.width,
+                    static_cast<std::int64_t>(chunkX + 1) * chunk_width - rect.x);
+
+                const auto it = chunks.find(ChunkKey(chunkX, chunkY));
+                if (it == chunks.end())
                 {
-                    // If valid, set up the map tile with the tileset.
-                    const Tmx::Tileset* tileset = map->GetTileset(tilesetIndex);
-                    tile_map.emplace_back(gid, tileset->GetFirstGid(), tilesetIndex);
+                    std::fill(out + i, out + end, 0u);
                 }
                 else
                 {
-                    // Otherwise, make it null.
-                    tile_map.emplace_back(gid, 0, -1);
+                    const auto &chunk = it->second;
+                    CopyRow(std::span<const MapTile>{ chunk.tiles }.subspan(
+                            static_cast<std::size_t>(y - chunk.y) * chunk.width, chunk.width),
+                        x - chunk.x, end - i, out + i);
                 }
+                i = end;
             }
         }
+    }
+
+    std::size_t TileLayer::GetTileMemory() const
+    {
+        EnsureDecoded();
+
+        auto bytes = tile_map.capacity() * sizeof(MapTile)
+            + gids.capacity() * sizeof(std::uint32_t)
+            + runs.capacity() * sizeof(TileRun)
+            + cells.capacity() * sizeof(TileCell)
+            + row_starts.capacity() * sizeof(std::uint32_t);
+        for (const auto &c : chunks)
+        {
+            bytes += sizeof(TileChunk) + c.second.tiles.capacity() * sizeof(MapTile);
+        }
+        return bytes;
+    }
+
+    std::size_t TileLayer::GetTileMemorySaved() const
+    {
+        if (IsChunked())
+        {
+            return 0;
+        }
+
+        const auto dense = static_cast<std::size_t>(width) * height * sizeof(MapTile);
+        return dense - std::min(dense, GetTileMemory());
+    }
 
-        // Free the temporary array from memory.
-        free(out);
+    std::uint32_t TileLayer::FindPackedGid(std::size_t index) const
+    {
+        const auto y = static_cast<int>(index / width);
+        const auto x = static_cast<std::uint32_t>(index % width);
+        return storage == TMX_STORAGE_RUNS
+            ? FindInRow(PackedRow(runs, y), x)
+            : FindInRow(PackedRow(cells, y), x);
     }
 
-    void TileLayer::ParseCSV(const std::string &innerText) 
+    void TileLayer::Pack() const
     {
-        Util::Iterate(innerText, ',', [this](auto first, auto last) {
-            std::string_view s{ first, last };
-            const auto gid = std::strtoul(s.data(), nullptr, 10);
+        // Readers may look at storage as soon as the layer is marked decoded,
+        // so it is written once the layout is settled.
+        if (requested_storage == TMX_STORAGE_GIDS)
+        {
+            storage = TMX_STORAGE_GIDS;
+            return;
+        }
+
+        // Count the runs and the non-empty cells to size the layouts.
+        const std::span<const std::uint32_t> all{ gids };
+        std::size_t numRuns = 0;
+        std::size_t numCells = 0;
+        for (int y = 0; y < height; ++y)
+        {
+            const auto row = Row(all, y);
+            for (std::size_t x = 0; x < row.size(); ++x)
+            {
+                if (row[x] != 0)
+                {
+                    ++numCells;
+                    numRuns += x == 0 || row[x - 1] != row[x];
+                }
+            }
+        }
+
+        auto layout = requested_storage;
+        if (layout == TMX_STORAGE_AUTO)
+        {
+            const auto rowBytes = (static_cast<std::size_t>(height) + 1) * sizeof(std::uint32_t);
+            const auto runBytes = numRuns * sizeof(TileRun) + rowBytes;
+            const auto cellBytes = numCells * sizeof(TileCell) + rowBytes;
+            if (std::min(runBytes, cellBytes) * 2 > gids.size() * sizeof(std::uint32_t))
+            {
+                storage = TMX_STORAGE_GIDS;
+                return;
+            }
+            layout = runBytes < cellBytes ? TMX_STORAGE_RUNS : TMX_STORAGE_SPARSE;
+        }
 
-            // Find the tileset index.
-            const int tilesetIndex = map->FindTilesetIndex(gid);
-            if (tilesetIndex != -1)
+        row_starts.reserve(static_cast<std::size_t>(height) + 1);
+        row_starts.push_back(0);
+        if (layout == TMX_STORAGE_RUNS)
+        {
+            runs.reserve(numRuns);
+            for (int y = 0; y < height; ++y)
             {
-                // If valid, set up the map tile with the tileset.
-                const Tmx::Tileset *tileset = map->GetTileset(tilesetIndex);
-                assert(tileset);
-                tile_map.emplace_back(gid, tileset->GetFirstGid(), tilesetIndex);
+                const auto row = Row(all, y);
+                for (std::uint32_t x = 0; x < row.size(); ++x)
+                {
+                    if (row[x] == 0)
+                    {
+                        continue;
+                    }
+
+                    if (x != 0 && row[x - 1] == row[x])
+                    {
+                        ++runs.back().length;
+                    }
+                    else
+                    {
+                        runs.push_back(TileRun{ x, 1, row[x] });
+                    }
+                }
+                row_starts.push_back(static_cast<std::uint32_t>(runs.size()));
+            }
+        }
+        else
+        {
+            cells.reserve(numCells);
+            for (int y = 0; y < height; ++y)
+            {
+                const auto row = Row(all, y);
+                for (std::uint32_t x = 0; x < row.size(); ++x)
+                {
+                    if (row[x] != 0)
+                    {
+                        cells.push_back(TileCell{ x, row[x] });
+                    }
+                }
+                row_starts.push_back(static_cast<std::uint32_t>(cells.size()));
+            }
+        }
+
+        std::vector<std::uint32_t>{}.swap(gids);
+        storage = layout;
+    }
+
+    const TileChunk *TileLayer::FindChunk(int x, int y) const
+    {
+        if (!IsChunked())
+        {
+            return nullptr;
+        }
+
+        EnsureDecoded();
+
+        const auto it = chunks.find(
+            ChunkKey(FloorDiv(x, chunk_width), FloorDiv(y, chunk_height)));
+        return it != chunks.end() ? &it->second : nullptr;
+    }
+
+    int TileLayer::GetNumChunks() const
+    {
+        EnsureDecoded();
+        return static_cast<int>(chunks.size());
+    }
+
+    void TileLayer::DecodeData(const tinyxml2::XMLElement *dataElem, std::string_view dataText)
+    {
+        if (IsChunked())
+        {
+            Util::IterateChildren(dataElem, "chunk", [this](const auto chunk) {
+                const auto w = chunk->IntAttribute("width");
+                const auto h = chunk->IntAttribute("height");
+
+                std::vector<MapTile> tiles;
+                tiles.reserve(w * h);
+                DecodeElement(chunk, w * h, tiles);
+                AddChunk(chunk->IntAttribute("x"), chunk->IntAttribute("y"), w, h,
+                    std::move(tiles));
+            });
+            return;
+        }
+
+        const auto decode = [&](auto &tiles) {
+            if (dataText.empty())
+            {
+                DecodeElement(dataElem, width * height, tiles);
             }
             else
             {
-                // Otherwise, make it null.
-                tile_map.emplace_back(gid, 0, -1);
+                DecodeText(dataText, width * height, tiles);
             }
+        };
+
+        if (HasTiles())
+        {
+            decode(tile_map);
+        }
+        else
+        {
+            decode(gids);
+            Pack();
+        }
+    }
+
+    void TileLayer::DecodePayload() const
+    {
+        if (IsChunked())
+        {
+            for (const auto &chunk : lazy->chunks)
+            {
+                std::vector<MapTile> tiles;
+                tiles.reserve(chunk.width * chunk.height);
+                DecodeText(chunk.payload, chunk.width * chunk.height, tiles);
+                AddChunk(chunk.x, chunk.y, chunk.width, chunk.height, std::move(tiles));
+            }
+            return;
+        }
+
+        if (HasTiles())
+        {
+            DecodeText(lazy->payload, width * height, tile_map);
+        }
+        else
+        {
+            DecodeText(lazy->payload, width * height, gids);
+            Pack();
+        }
+    }
+
+    template <typename Tile>
+    void TileLayer::DecodeElement(const tinyxml2::XMLElement *dataElem, int count,
+        std::vector<Tile> &tiles) const
+    {
+        switch (encoding)
+        {
+        case TMX_ENCODING_XML:
+            tiles.reserve(tiles.size() + count);
+            ParseXML(dataElem, tiles);
+            break;
+
+        case TMX_ENCODING_BASE64:
+            ParseBase64(GetTextView(dataElem), count, tiles);
+            break;
+
+        case TMX_ENCODING_CSV:
+            ParseCSV(GetTextView(dataElem), count, tiles);
+            break;
+        }
+    }
+
+    template <typename Tile>
+    void TileLayer::DecodeText(std::string_view payload, int count,
+        std::vector<Tile> &tiles) const
+    {
+        // XML tiles are kept as csv, see ReadPayload.
+        if (encoding == TMX_ENCODING_BASE64)
+        {
+            ParseBase64(payload, count, tiles);
+        }
+        else
+        {
+            ParseCSV(payload, count, tiles);
+        }
+    }
+
+    void TileLayer::AddChunk(int x, int y, int w, int h, std::vector<MapTile> tiles) const
+    {
+        tiles.resize(static_cast<std::size_t>(w) * h, EmptyTile());
+
+        // Empty space takes no memory.
+        if (std::all_of(tiles.begin(), tiles.end(), [](const auto &t) { return t.gid == 0; }))
+        {
+            return;
+        }
+
+        const auto chunkX = FloorDiv(x, chunk_width);
+        const auto chunkY = FloorDiv(y, chunk_height);
+
+        // Chunks written by Tiled are all aligned on the grid.
+        if (w == chunk_width && h == chunk_height
+            && chunkX * chunk_width == x && chunkY * chunk_height == y)
+        {
+            auto &chunk = chunks[ChunkKey(chunkX, chunkY)];
+            chunk = TileChunk{ x, y, w, h, std::move(tiles) };
+            return;
+        }
+
+        // Others are spread over the chunks of the grid they overlap.
+        for (int j = 0; j < h; ++j)
+        {
+            for (int i = 0; i < w; ++i)
+            {
+                const auto &tile = tiles[j * w + i];
+                if (tile.gid == 0)
+                {
+                    continue;
+                }
+
+                const auto cx = FloorDiv(x + i, chunk_width);
+                const auto cy = FloorDiv(y + j, chunk_height);
+
+                auto &chunk = chunks[ChunkKey(cx, cy)];
+                if (chunk.tiles.empty())
+                {
+                    chunk = TileChunk{ cx * chunk_width, cy * chunk_height,
+                        chunk_width, chunk_height,
+                        std::vector<MapTile>(chunk_width * chunk_height, EmptyTile()) };
+                }
+
+                chunk.tiles[(y + j - chunk.y) * chunk_width + (x + i - chunk.x)] = tile;
+            }
+        }
+    }
+
+    template <typename Tile>
+    void TileLayer::ParseXML(const tinyxml2::XMLNode *data, std::vector<Tile> &tiles) const
+    {
+        for (auto tile = data->FirstChildElement("tile"); tile;
+            tile = tile->NextSiblingElement("tile"))
+        {
+            // Convert to an unsigned.
+            tiles.push_back(FromGid<Tile>(std::strtoul(tile->Attribute("gid"), nullptr, 10)));
+        }
+    }
+
+    template <typename Tile>
+    void TileLayer::ParseBase64(std::string_view text, int count, std::vector<Tile> &tiles) const
+    {
+        // The layer is sized once and the gids are put at the start of the
+        // memory of its tiles, see MakeTiles. Layers of gids are given a
+        // little room for whitespace around the text.
+        const auto first = tiles.size();
+        const auto gidBytes = static_cast<size_t>(count) * 4;
+        const auto decodedSize = Util::Base64DecodedSize(text.size());
+        const bool inPlace = compression == TMX_COMPRESSION_NONE
+            && decodedSize <= count * sizeof(Tile) + 64;
+        tiles.resize(first + (inPlace
+            ? std::max<size_t>(count, (decodedSize + sizeof(Tile) - 1) / sizeof(Tile))
+            : count));
+
+        const auto gids = reinterpret_cast<char *>(tiles.data() + first);
+        size_t size = 0;
+
+        if (inPlace)
+        {
+            size = std::min(Util::DecodeBase64(text, gids), gidBytes);
+        }
+        else
+        {
+            auto decoded = std::make_unique_for_overwrite<char[]>(decodedSize);
+            const auto decompressor = map->GetParseOptions().decompressor;
+            size = Decompress(decompressor ? *decompressor : Decompressor::GetDefault(),
+                compression, decoded.get(),
+                Util::DecodeBase64(text, decoded.get()), gids, gidBytes);
+        }
+
+        // Missing gids are empty.
+        tiles.resize(first + count);
+        std::memset(gids + size, 0, gidBytes - size);
+        MakeTiles(*map, tiles.data() + first, count);
+    }
+
+    template <typename Tile>
+    void TileLayer::ParseCSV(std::string_view innerText, int count,
+        std::vector<Tile> &tiles) const
+    {
+        // As for base-64, the gids are parsed into the memory of the tiles.
+        const auto first = tiles.size();
+        tiles.resize(first + count);
+
+        const auto gids = reinterpret_cast<uint32_t *>(tiles.data() + first);
+        const auto parsed = Util::ParseCsv(innerText, gids, count);
+        std::fill(gids + parsed, gids + count, 0u);
+        MakeTiles(*map, tiles.data() + first, count);
+    }
+
+    template <typename Tile>
+    void TileLayer::ParseJsonArray(JsonReader &json, std::vector<Tile> &tiles) const
+    {
+        json.ReadUnsignedArray([&](const unsigned gid) {
+            tiles.push_back(FromGid<Tile>(gid));
         });
     }
+
+    template <typename Tile>
+    Tile TileLayer::FromGid(unsigned gid) const
+    {
+        if constexpr (std::is_same_v<Tile, MapTile>)
+        {
+            return MakeTile(gid);
+        }
+        else
+        {
+            return gid;
+        }
+    }
+
+    MapTile TileLayer::MakeTile(unsigned gid) const
+    {
+        return ResolveTile(map->GetTilesetLookup(), gid);
+    }
 }
@@ -35,4 +35,10 @@ namespace Tmx
         , y{ data ? data->IntAttribute("y") : 0 }
     {
     }
+
+    TileOffset::TileOffset(int x, int y)
+        : x{ x }
+        , y{ y }
+    {
+    }
 }
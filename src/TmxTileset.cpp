@@ -31,8 +31,13 @@
 #include <cassert> //RJCB
 
 #include "TmxImage.h"
+#include "TmxJsonReader.h"
 #include "TmxMap.h"
+#include "TmxMapLoader.h"
+#include "TmxMappedFile.h"
+#include "TmxParseOptions.h"
 #include "TmxTerrainArray.h"
+#include "TmxUtil.h"
 
 namespace Tmx
 {
@@ -52,6 +57,50 @@ namespace Tmx
             }
             return filename.substr(0, it);
         }
+
+        std::shared_ptr<const TilesetDetails::TilesetContents> LoadExternalContents(
+            const std::string &path, const std::string &source, MapLoader *loader)
+        {
+            if (loader)
+            {
+                if (auto cached = loader->FindOrLoadTileset(path, source))
+                {
+                    return cached;
+                }
+            }
+            else
+            {
+                for (const auto &fileName : { path + source, source })
+                {
+                    if (auto contents = TilesetDetails::LoadTilesetFile(fileName))
+                    {
+                        return contents;
+                    }
+                }
+            }
+
+            fprintf(stderr, "failed to load tileset file '%s'\n", source.c_str());
+            return std::make_shared<const TilesetDetails::TilesetContents>();
+        }
+
+        std::shared_ptr<const TilesetDetails::TilesetContents> LoadContents(
+            const std::string &path, const tinyxml2::XMLElement *data, MapLoader *loader)
+        {
+            // Contents may be shared between maps, so they never go in the
+            // memory or the string pool of the map being parsed.
+            const ParseOptionsDetails::MemoryScope heap{ std::pmr::new_delete_resource() };
+            const ParseOptionsDetails::StringPoolScope strings;
+
+            // A TMX map may refer to a JSON tileset as well.
+            const char *source = data->Attribute("source");
+            if (source && (loader || Util::IsJsonFileName(source)))
+            {
+                return LoadExternalContents(path, source, loader);
+            }
+
+            return std::make_shared<const TilesetDetails::TilesetContents>(
+                TilesetDetails::TilesetData{ path, data });
+        }
     }
 
     namespace TilesetDetails
@@ -69,23 +118,35 @@ namespace Tmx
 
             for (const auto &fileName : { path + source, std::string{ source } })
             {
-                doc->LoadFile( fileName.c_str() );
-                if (doc->ErrorID() == 0)
+                if (Load(fileName))
                 {
-                    filePath = GetFolderName(fileName);
-                    break;
+                    return;
                 }
             }
 
+            fprintf(stderr, "failed to load tileset file '%s'\n", source);
+        }
+
+        TilesetData::TilesetData(const std::string &fileName)
+            : doc{ std::make_unique<tinyxml2::XMLDocument>() }
+        {
+            Load(fileName);
+        }
+
+        bool TilesetData::Load(const std::string &fileName)
+        {
+            doc->LoadFile(fileName.c_str());
             if (doc->ErrorID() != 0)
             {
-                fprintf(stderr, "failed to load tileset file '%s'\n", source);
-                return;
+                return false;
             }
 
+            filePath = GetFolderName(fileName);
+
             // Update node and element references to the new node
-            this->data = doc->FirstChildElement("tileset");
-            assert(this->data); //RJCB
+            data = doc->FirstChildElement("tileset");
+            assert(data); //RJCB
+            return true;
         }
 
         std::string TilesetData::StringAttribute(const char *name, const char *value) const
@@ -103,43 +164,162 @@ namespace Tmx
         {
             return data ? data->FirstChildElement(name) : nullptr;
         }
+
+        TilesetContents::TilesetContents(TilesetData data)
+            : file_path{ std::move(data.filePath) }
+            , name{ data.StringAttribute("name") }
+            , tile_width{ data.IntAttribute("tilewidth") }
+            , tile_height{ data.IntAttribute("tileheight") }
+            , margin{ data.IntAttribute("margin") }
+            , spacing{ data.IntAttribute("spacing") }
+            , tile_count{ data.IntAttribute("tilecount") }
+            , columns{ data.IntAttribute("columns") }
+            , tileOffset{ data.FirstChildElement("tileoffset") }
+            , image{ CreateImage(data.FirstChildElement("image")) }
+            , properties{ data.FirstChildElement("properties") }
+        {
+            // Parse the terrain types if any.
+            if (const auto terrainTypesNode = data.FirstChildElement("terraintypes"))
+            {
+                TerrainArray::Parse(&terrainTypes, terrainTypesNode);
+            }
+
+            // Iterate through all of the tile elements and parse each.
+            for (auto e = data.FirstChildElement("tile"); e; e = e->NextSiblingElement("tile"))
+            {
+                tiles.emplace_back(e);
+            }
+        }
+
+        TilesetContents::TilesetContents(JsonReader &json, std::string filePath, int *firstGid)
+            : file_path{ std::move(filePath) }
+        {
+            std::string imageSource;
+            int imageWidth = 0;
+            int imageHeight = 0;
+            Tmx::Color transparentColor;
+
+            json.ReadObject([&](const auto key) {
+                if (key == "firstgid" && firstGid) {
+                    *firstGid = json.ReadInt();
+                }
+                else if (key == "name") {
+                    name = json.ReadString();
+                }
+                else if (key == "tilewidth") {
+                    tile_width = json.ReadInt();
+                }
+                else if (key == "tileheight") {
+                    tile_height = json.ReadInt();
+                }
+                else if (key == "margin") {
+                    margin = json.ReadInt();
+                }
+                else if (key == "spacing") {
+                    spacing = json.ReadInt();
+                }
+                else if (key == "tilecount") {
+                    tile_count = json.ReadInt();
+                }
+                else if (key == "columns") {
+                    columns = json.ReadInt();
+                }
+                else if (key == "tileoffset") {
+                    int x = 0;
+                    int y = 0;
+                    json.ReadObject([&](const auto offsetKey) {
+                        if (offsetKey == "x") {
+                            x = json.ReadInt();
+                        }
+                        else if (offsetKey == "y") {
+                            y = json.ReadInt();
+                        }
+                    });
+                    tileOffset = TileOffset{ x, y };
+                }
+                else if (key == "image") {
+                    imageSource = json.ReadString();
+                }
+                else if (key == "imagewidth") {
+                    imageWidth = json.ReadInt();
+                }
+                else if (key == "imageheight") {
+                    imageHeight = json.ReadInt();
+                }
+                else if (key == "transparentcolor") {
+                    transparentColor = Tmx::Color{ json.ReadString() };
+                }
+                else if (key == "tiles") {
+                    json.ReadArray([&] { tiles.emplace_back(json); });
+                }
+                else if (key == "properties") {
+                    properties = PropertySet{ json };
+                }
+            });
+
+            if (!imageSource.empty())
+            {
+                image = std::make_unique<Image>(std::move(imageSource), imageWidth, imageHeight,
+                    transparentColor);
+            }
+        }
+
+        std::shared_ptr<const TilesetContents> LoadTilesetFile(const std::string &fileName)
+        {
+            const ParseOptionsDetails::MemoryScope heap{ std::pmr::new_delete_resource() };
+            const ParseOptionsDetails::StringPoolScope strings;
+
+            if (!Util::IsJsonFileName(fileName))
+            {
+                TilesetData data{ fileName };
+                return data.data ? std::make_shared<const TilesetContents>(std::move(data)) : nullptr;
+            }
+
+            MappedFile file{ fileName };
+            if (!file.IsOpen())
+            {
+                return nullptr;
+            }
+
+            JsonReader json{ file.GetView() };
+            auto contents = std::make_shared<const TilesetContents>(json, GetFolderName(fileName));
+            return json.HasError() ? nullptr : contents;
+        }
     }
 
-    Tileset::Tileset(const std::string &file_path, const tinyxml2::XMLElement *data)
-        : Tileset{ { file_path, data }, data->IntAttribute("firstgid") }
+    Tileset::Tileset(const std::string &file_path, const tinyxml2::XMLElement *data,
+        MapLoader *loader)
+        : first_gid{ data->IntAttribute("firstgid") }
+        , contents{ LoadContents(file_path, data, loader) }
     {
     }
 
-    Tileset::Tileset(TilesetDetails::TilesetData data, int firstGid)
-        : first_gid{ firstGid }
-        , file_path{ std::move(data.filePath) }
-        , name{ data.StringAttribute("name") }
-        , tile_width{ data.IntAttribute("tilewidth") }
-        , tile_height{ data.IntAttribute("tileheight") }
-        , margin{ data.IntAttribute("margin") }
-        , spacing{ data.IntAttribute("spacing") }
-        , tile_count{ data.IntAttribute("tilecount") }
-        , columns{ data.IntAttribute("columns") }
-        , tileOffset{ data.FirstChildElement("tileoffset") }
-        , image{ CreateImage(data.FirstChildElement("image")) }
-        , properties{ data.FirstChildElement("properties") }
+    Tileset::Tileset(const std::string &file_path, JsonReader &json, MapLoader *loader)
+        : first_gid{ 0 }
     {
-        // Parse the terrain types if any.
-        if (const auto terrainTypesNode = data.FirstChildElement("terraintypes"))
-        {
-            TerrainArray::Parse(&terrainTypes, terrainTypesNode);
-        }
+        const ParseOptionsDetails::MemoryScope heap{ std::pmr::new_delete_resource() };
+        const ParseOptionsDetails::StringPoolScope strings;
 
-        // Iterate through all of the tile elements and parse each.
-        for (auto e = data.FirstChildElement("tile"); e; e = e->NextSiblingElement("tile"))
+        const auto source = json.FindString("source");
+        if (source.empty())
         {
-            tiles.emplace_back(e);
+            contents = std::make_shared<const TilesetDetails::TilesetContents>(
+                json, file_path, &first_gid);
+            return;
         }
+
+        json.ReadObject([&](const auto key) {
+            if (key == "firstgid") {
+                first_gid = json.ReadInt();
+            }
+        });
+
+        contents = LoadExternalContents(file_path, source, loader);
     }
 
     const Tile *Tileset::GetTile(const int index) const
     {
-        for (const auto &t : tiles)
+        for (const auto &t : contents->tiles)
         {
             if (t.GetId() == index)
             {
@@ -0,0 +1,176 @@
+//-----------------------------------------------------------------------------
+// TmxTilesetLookup.cpp
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include "TmxTilesetLookup.h"
+
+#include <cassert>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define TMX_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#include "TmxTileset.h"
+#include "TmxUtil.h"
+
+namespace Tmx
+{
+    namespace
+    {
+        constexpr auto flagMask = FlippedHorizontallyFlag | FlippedVerticallyFlag | FlippedDiagonallyFlag;
+
+        // The gids from first on, for one way to find their tileset.
+        template <typename Find>
+        void ResolveFrom(std::size_t first, std::span<const std::uint32_t> gids,
+            const std::uint32_t *firstGids, Find find, std::int32_t *tilesetIndices,
+            std::uint32_t *ids, std::uint8_t *flags)
+        {
+            for (auto i = first; i < gids.size(); ++i)
+            {
+                const auto id = gids[i] & ~flagMask;
+                const auto index = find(id);
+                tilesetIndices[i] = index;
+                ids[i] = id - firstGids[index + 1];
+                flags[i] = static_cast<std::uint8_t>(gids[i] >> 29);
+            }
+        }
+
+#ifdef TMX_SIMD_X86
+        // Eight gids at a time, gathering the tileset indices from the table
+        // or, without one, taking the same steps of the search in every lane.
+        // Returns the number of gids resolved.
+        __attribute__((target("avx2")))
+        std::size_t ResolveAvx2(std::span<const std::uint32_t> gids,
+            std::span<const std::uint32_t> firstGids, std::span<const std::int32_t> table,
+            std::int32_t *tilesetIndices, std::uint32_t *ids, std::uint8_t *flags)
+        {
+            const auto firstGidsData = reinterpret_cast<const int *>(firstGids.data());
+            const auto tableData = reinterpret_cast<const int *>(table.data());
+            const auto last = _mm256_set1_epi32(static_cast<int>(table.size()) - 1);
+            const auto one = _mm256_set1_epi32(1);
+
+            std::size_t i = 0;
+            for (; i + 8 <= gids.size(); i += 8)
+            {
+                const auto gid = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(gids.data() + i));
+                const auto id = _mm256_andnot_si256(_mm256_set1_epi32(static_cast<int>(flagMask)), gid);
+
+                // The position of the first gid of the tileset, one past its index.
+                __m256i at;
+                if (!table.empty())
+                {
+                    at = _mm256_add_epi32(
+                        _mm256_i32gather_epi32(tableData, _mm256_min_epu32(id, last), 4), one);
+                }
+                else
+                {
+                    // First gids and ids fit in 31 bits, so a signed compare will do.
+                    at = _mm256_setzero_si256();
+                    for (auto n = firstGids.size(); n > 1;)
+                    {
+                        const auto half = n / 2;
+                        const auto step = _mm256_set1_epi32(static_cast<int>(half));
+                        const auto probe = _mm256_i32gather_epi32(firstGidsData,
+                            _mm256_add_epi32(at, step), 4);
+                        at = _mm256_add_epi32(at,
+                            _mm256_andnot_si256(_mm256_cmpgt_epi32(probe, id), step));
+                        n -= half;
+                    }
+                }
+
+                const auto firstGid = _mm256_i32gather_epi32(firstGidsData, at, 4);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(tilesetIndices + i),
+                    _mm256_sub_epi32(at, one));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(ids + i),
+                    _mm256_sub_epi32(id, firstGid));
+
+                const auto flag = _mm256_srli_epi32(gid, 29);
+                const auto words = _mm_packus_epi32(_mm256_castsi256_si128(flag),
+                    _mm256_extracti128_si256(flag, 1));
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(flags + i),
+                    _mm_packus_epi16(words, words));
+            }
+
+            return i;
+        }
+#endif
+    }
+
+    TilesetLookup::TilesetLookup(const std::vector<Tileset> &tilesets)
+    {
+        first_gids.reserve(tilesets.size() + 1);
+        for (const auto &tileset : tilesets)
+        {
+            first_gids.push_back(static_cast<std::uint32_t>(tileset.GetFirstGid()));
+        }
+
+        if (tilesets.empty() || first_gids.back() >= MaxTableGid)
+        {
+            return;
+        }
+
+        // Each tileset takes the gids up to the first of the next one, so the
+        // later of two at the same gid wins, as with the search.
+        table.resize(first_gids.back() + 1);
+        for (std::size_t i = 0; i < first_gids.size(); ++i)
+        {
+            const auto end = i + 1 < first_gids.size() ? first_gids[i + 1] : table.size();
+            std::fill(table.begin() + std::min<std::size_t>(first_gids[i], end),
+                table.begin() + end, static_cast<std::int32_t>(i) - 1);
+        }
+    }
+
+    void TilesetLookup::Resolve(std::span<const std::uint32_t> gids,
+        std::span<std::int32_t> tilesetIndices, std::span<std::uint32_t> ids,
+        std::span<std::uint8_t> flags) const
+    {
+        assert(tilesetIndices.size() >= gids.size());
+        assert(ids.size() >= gids.size());
+        assert(flags.size() >= gids.size());
+
+        std::size_t done = 0;
+#ifdef TMX_SIMD_X86
+        if (Util::GetSimdLevel() >= Util::SimdLevel::AVX2)
+        {
+            done = ResolveAvx2(gids, first_gids, table, tilesetIndices.data(), ids.data(),
+                flags.data());
+        }
+#endif
+
+        if (!table.empty())
+        {
+            const auto last = static_cast<std::uint32_t>(table.size() - 1);
+            ResolveFrom(done, gids, first_gids.data(),
+                [this, last](std::uint32_t id) { return table[std::min(id, last)]; },
+                tilesetIndices.data(), ids.data(), flags.data());
+        }
+        else
+        {
+            ResolveFrom(done, gids, first_gids.data(),
+                [this](std::uint32_t id) { return Search(id); },
+                tilesetIndices.data(), ids.data(), flags.data());
+        }
+    }
+}
@@ -41,8 +41,6 @@
 #include <zlib.h>
 #endif
 
-#include "base64/base64.h"
-
 namespace Tmx {
 
     // trim from start
@@ -77,9 +75,10 @@ namespace Tmx {
         return trim( str );
     }
 
-    std::string Util::DecodeBase64(const std::string &str) 
+    bool Util::IsJsonFileName(std::string_view fileName)
     {
-        return base64_decode(str);
+        return fileName.ends_with(".tmj") || fileName.ends_with(".tsj")
+            || fileName.ends_with(".json");
     }
 
     char *Util::DecompressGZIP(const char *data, int dataSize, int expectedSize) 
@@ -149,4 +148,29 @@ namespace Tmx {
 
         return out;
     }
+
+    int Util::DecompressGZIP(const char *data, int dataSize, char *out, int outSize)
+    {
+        z_stream strm;
+
+        strm.zalloc = Z_NULL;
+        strm.zfree = Z_NULL;
+        strm.opaque = Z_NULL;
+        strm.next_in = (Bytef*)data;
+        strm.avail_in = dataSize;
+        strm.next_out = (Bytef*)out;
+        strm.avail_out = outSize;
+
+        if (inflateInit2(&strm, 15 + 32) != Z_OK)
+        {
+            return -1;
+        }
+
+        // Running out of room leaves the data cut short, but is no error.
+        const int ret = inflate(&strm, Z_FINISH);
+        const int size = outSize - static_cast<int>(strm.avail_out);
+        inflateEnd(&strm);
+
+        return ret == Z_STREAM_END || ret == Z_BUF_ERROR ? size : -1;
+    }
 }
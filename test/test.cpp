@@ -60,7 +60,7 @@ int main(int argc, char * argv[])
     printf("Tile Height: %d\n", map.GetTileHeight());
 
     // Iterate through map properties and print the type, name and value of each property.
-    const std::unordered_map<std::string, Tmx::Property> &mapProperties = map.GetProperties().GetPropertyMap();
+    const std::pmr::unordered_map<std::string_view, Tmx::Property> &mapProperties = map.GetProperties().GetPropertyMap();
     for (auto &pair : mapProperties)
     {
         const Tmx::Property &property = pair.second;
@@ -96,7 +96,7 @@ int main(int argc, char * argv[])
             type = "Unknown";
         }
 
-        printf("Map property %s (%s) = %s\n", pair.first.c_str(), type.c_str(),  property.GetValue().c_str());
+        printf("Map property %s (%s) = %s\n", std::string{ pair.first }.c_str(), type.c_str(),  property.GetValue().c_str());
     }
 
     // Make sure property parsing works correctly across the library.
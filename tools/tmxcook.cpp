@@ -0,0 +1,59 @@
+//-----------------------------------------------------------------------------
+// tmxcook
+//
+// Copyright (c) 2010-2014, Tamir Atias
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL TAMIR ATIAS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <fstream>
+
+#include "Tmx.h"
+
+// Converts a TMX map to the cooked binary format of Tmx::CookedMap.
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        std::fprintf(stderr, "usage: %s input.tmx output.tmxc\n", argv[0]);
+        return 2;
+    }
+
+    const auto map = Tmx::Map::ParseFile(argv[1]);
+    if (map.HasError())
+    {
+        std::fprintf(stderr, "%s: %s\n", argv[1], map.GetErrorText().c_str());
+        return 1;
+    }
+
+    const std::string cooked = Tmx::CookedMap::Cook(map);
+
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    out.write(cooked.data(), static_cast<std::streamsize>(cooked.size()));
+    out.close();
+    if (!out)
+    {
+        std::fprintf(stderr, "%s: could not write the file\n", argv[2]);
+        return 1;
+    }
+
+    return 0;
+}